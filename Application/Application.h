@@ -2,10 +2,18 @@
 
 #include "Core/Types.h"
 #include "Core/NonCopyable.h"
+#include "Core/FrameStats.h"
+#include "Core/InputQueue.h"
+#include "Core/FixedTimestep.h"
 #include "Graphics/Device.h"
 #include "Graphics/SwapChain.h"
+#include "Graphics/GpuTimer.h"
 #include "XeSS/XeSSContext.h"
 #include "Window.h"
+#include "FramePipeline.h"
+#include "HeadlessLoop.h"
+#include "BenchmarkRunner.h"
+#include "EngineMetrics.h"
 #include <memory>
 #include <chrono>
 
@@ -20,6 +28,38 @@ struct ApplicationConfig {
     int32 adapterId{-1};
     bool useWarp{false};
 
+    // Run OnUpdate on a game thread while the previous frame renders
+    bool pipelinedFrames{false};
+    uint32 maxFramesInFlight{1};
+
+    // Simulate OnFixedUpdate in fixed steps of 1/fixedUpdateRate seconds, at
+    // most maxFixedStepsPerFrame per frame; OnUpdate still runs once a frame
+    bool fixedTimestep{false};
+    uint32 fixedUpdateRate{60};
+    uint32 maxFixedStepsPerFrame{5};
+
+    // JobSystem workers, 0 for hardware concurrency minus one
+    uint32 jobWorkerThreads{0};
+
+    // Headless mode: null window, device, swap chain and upscaler. Runs
+    // headlessFrameCount frames, uncapped or paced to headlessRefreshRate Hz,
+    // then logs the frame-stats report and exits. No D3D objects exist.
+    bool headless{false};
+    uint32 headlessFrameCount{1000};
+    uint32 headlessRefreshRate{0};
+
+    // Scripted benchmark: when set, the scenario replaces wall-clock timing
+    // and results are written as JSON to benchmarkOutput
+    std::string benchmarkScenario;
+    std::string benchmarkOutput{"benchmark_results.json"};
+
+    // Optional shader manifest precompiled in parallel with the rest of startup
+    std::string shaderPrewarmManifest;
+
+    // Live telemetry endpoint in Prometheus text format, "unix:/path" or
+    // "localhost:PORT". Empty disables it.
+    std::string metricsEndpoint;
+
     // XeSS settings
     XeSSModule::QualityMode xessQuality{XeSSModule::QualityMode::Performance};
     XeSSModule::InitFlags xessFlags{XeSSModule::InitFlags::HighResMotionVectors};
@@ -42,22 +82,49 @@ public:
     void SetXeSSQuality(XeSSModule::QualityMode quality);
     XeSSModule::QualityMode GetXeSSQuality() const;
 
-    // Getters for subsystems
+    // Getters for subsystems. These are the D3D and Win32 objects, which do
+    // not exist in headless mode; check IsHeadless() first.
     Graphics::Device& GetDevice() { return *m_device; }
     Graphics::SwapChain& GetSwapChain() { return *m_swapChain; }
     XeSSModule::XeSSContext& GetXeSSContext() { return *m_xessContext; }
     Window& GetWindow() { return *m_window; }
 
+    // Valid in every mode; the null implementations when headless
+    Graphics::IDevice& GetDeviceInterface();
+    Graphics::ISwapChain& GetSwapChainInterface();
+    XeSSModule::IUpscaler& GetUpscaler();
+
     // Performance metrics
-    float GetFrameTime() const { return m_frameTime; }
-    float GetFPS() const { return m_fps; }
-    uint64 GetFrameCount() const { return m_frameCount; }
+    // Read from the MetricsRegistry ("frame.*"); frame time is in seconds
+    float GetFrameTime() const;
+    float GetFPS() const;
+    uint64 GetFrameCount() const;
+
+    const FrameStats& GetFrameStats() const { return m_frameStats; }
+    bool IsHeadless() const { return m_config.headless; }
+    bool IsBenchmarking() const { return m_benchmark != nullptr; }
+
+    // Pipelined frame loop
+    bool IsPipelined() const { return m_framePipeline != nullptr; }
+    FramePipelineStats GetPipelineStats() const;
+
+    // Input: the window (or a SyntheticInputSource) produces into this queue
+    InputQueue& GetInputQueue() { return m_inputQueue; }
 
 protected:
-    // Virtual methods for derived classes to override
+    // Virtual methods for derived classes to override. In headless mode there
+    // is no D3D device: OnInitialize must skip GPU resource creation when
+    // IsHeadless(), and OnRender is never called.
     virtual void OnInitialize() {}
+    // Runs on a worker thread during startup, concurrently with device, shader
+    // cache and XeSS setup. Load file data here; create GPU resources in
+    // OnInitialize, which runs on the main thread once startup has finished.
+    virtual void OnLoadAssets() {}
     virtual void OnShutdown() {}
     virtual void OnUpdate(float deltaTime) {}
+    // Fixed-step simulation. Independent work inside a step can be spread
+    // over the JobSystem with ParallelFor; steps themselves run in order.
+    virtual void OnFixedUpdate(float stepSeconds) {}
     virtual void OnRender() {}
     virtual void OnResize(const Resolution& newSize) {}
     virtual void OnKeyDown(uint32 key) {}
@@ -65,6 +132,26 @@ protected:
     virtual void OnMouseMove(int32 x, int32 y) {}
     virtual void OnMouseButton(uint32 button, bool pressed) {}
 
+    // Newest input state, lock-free. Read it from OnRender to apply camera
+    // input as late as possible before submission, after the events for the
+    // frame have already been dispatched.
+    InputSnapshot SampleInput() const { return m_inputQueue.SampleLatest(); }
+
+    // Pipelined mode only: called on the game thread right after OnUpdate to
+    // copy whatever OnRender needs into the packet. OnRender then reads it
+    // through GetRenderPacket() instead of touching simulation state.
+    virtual void OnPublishFrame(FramePacket& packet) {}
+    const FramePacket* GetRenderPacket() const { return m_renderPacket; }
+
+    // Fraction of a fixed step left over after the last OnFixedUpdate, for
+    // blending previous and current state in OnRender. 1 without fixed steps.
+    // Render side only: when pipelined, call it from OnRender, not OnUpdate.
+    float GetInterpolationAlpha() const;
+
+    // Benchmark mode: called before OnUpdate with the scripted state for this
+    // frame. Animation must be derived from it, not from wall-clock time.
+    virtual void OnBenchmarkFrame(const BenchmarkFrame& frame) {}
+
 private:
     void Initialize();
     void Shutdown();
@@ -75,6 +162,46 @@ private:
     void HandleResize();
     void UpdatePerformanceMetrics();
 
+    // Input dispatch (ApplicationInput.cpp)
+    void DispatchInput();
+
+    // Simulation stepping (ApplicationSimulation.cpp)
+    void StepSimulation(float deltaTime);
+    void ConfigureFixedTimestep();
+
+    // Startup (ApplicationStartup.cpp)
+    void CreateMainWindow();
+    void InitializeSubsystems();
+    void MarkFirstFramePresented();
+
+    // Telemetry (ApplicationMetrics.cpp)
+    void StartMetricsServer();
+    void OnFramePresented();
+    void PublishMetrics();
+
+    // Pipelined frame loop (ApplicationPipeline.cpp)
+    void StartFramePipeline();
+    void StopFramePipeline();
+    bool RenderPipelinedFrame();
+
+    // Headless mode (ApplicationHeadless.cpp)
+    void InitializeHeadless();
+    void RunHeadlessLoop();
+
+    // Render() and Present(), or the null Present when headless
+    void RenderFrame();
+
+    // Quality and resize changes that reach the D3D objects through
+    // SetXeSSQuality()/HandleResize(), or the null ones when headless
+    XeSSModule::QualityMode GetActiveQuality() const;
+    void ApplyQuality(XeSSModule::QualityMode quality);
+    void ApplyResize(const Resolution& size);
+
+    // Benchmark mode (ApplicationBenchmark.cpp)
+    void StartBenchmark();
+    bool RunBenchmarkFrame();
+    void FinishBenchmark();
+
     ApplicationConfig m_config;
 
     std::unique_ptr<Window> m_window;
@@ -82,20 +209,34 @@ private:
     std::unique_ptr<Graphics::SwapChain> m_swapChain;
     std::unique_ptr<XeSSModule::XeSSContext> m_xessContext;
 
+    // Headless mode only, in place of the four above
+    std::unique_ptr<HeadlessLoop> m_headless;
+
+    InputQueue m_inputQueue;
+    uint64 m_reportedDroppedInput{0};
+
+    FixedTimestep m_fixedTimestep;
+
+    std::unique_ptr<FramePipeline> m_framePipeline;
+    const FramePacket* m_renderPacket{nullptr};
+
+    std::unique_ptr<BenchmarkRunner> m_benchmark;
+    Graphics::GpuTimer m_gpuTimer;
+
     // Performance tracking
     std::chrono::high_resolution_clock::time_point m_lastFrameTime;
     std::chrono::high_resolution_clock::time_point m_fpsUpdateTime;
-    float m_frameTime{0.0f};
-    float m_fps{0.0f};
-    uint64 m_frameCount{0};
     uint32 m_fpsFrameCount{0};
+    FrameStats m_frameStats;
+    EngineMetrics m_engineMetrics;
 
     bool m_initialized{false};
+    bool m_firstFramePresented{false};
     bool m_running{false};
     bool m_resizePending{false};
     Resolution m_pendingSize;
 
-    friend class Window; // Allow window to call event handlers
+    friend class Window; // Allow window to push input events
 };
 
 } // namespace XeSS::Application
@@ -0,0 +1,135 @@
+#include "Application.h"
+#include "Graphics/ShaderManager.h"
+#include "Core/JsonWriter.h"
+#include "Core/StartupTimeline.h"
+#include "Core/Logger.h"
+#include "Core/Exception.h"
+#include "Core/Utils.h"
+
+namespace XeSS::Application {
+
+// Initialize() calls StartBenchmark() once all subsystems exist. While a
+// benchmark is active MainLoop calls RunBenchmarkFrame() in place of
+// Update/Render/Present and quits when it returns false; FinishBenchmark()
+// then writes the results before Shutdown().
+
+void Application::StartBenchmark() {
+    if (m_config.benchmarkScenario.empty()) {
+        return;
+    }
+
+    BenchmarkScenario scenario;
+    if (!scenario.LoadFromFile(m_config.benchmarkScenario)) {
+        throw Exception("Failed to load benchmark scenario: " + m_config.benchmarkScenario);
+    }
+
+    if (m_config.pipelinedFrames) {
+        XESS_WARNING("Pipelined frames disabled for deterministic benchmark run");
+        StopFramePipeline();
+    }
+
+    const XeSSModule::QualityMode initialQuality = GetActiveQuality();
+    const Resolution initialSize = GetSwapChainInterface().GetResolution();
+
+    BenchmarkCallbacks callbacks;
+    callbacks.simulate = [this](const BenchmarkFrame& frame) {
+        OnBenchmarkFrame(frame);
+        StepSimulation(frame.deltaTime);
+    };
+    callbacks.render = [this](const BenchmarkFrame&) {
+        if (m_headless) {
+            RenderFrame();
+            OnFramePresented();
+            return;
+        }
+        m_gpuTimer.BeginFrame(m_device->GetContext());
+        Render();
+        m_gpuTimer.EndFrame(m_device->GetContext());
+        Present();
+        OnFramePresented();
+    };
+    callbacks.applyEvent = [this](const BenchmarkEvent& event) {
+        switch (event.type) {
+            case BenchmarkEventType::SetQuality:
+                ApplyQuality(event.quality);
+                break;
+            case BenchmarkEventType::Resize:
+                ApplyResize(event.resolution);
+                break;
+        }
+    };
+    callbacks.resetState = [this, initialQuality, initialSize]() {
+        // Every repetition starts with an empty accumulator
+        m_fixedTimestep.Reset();
+        if (GetActiveQuality() != initialQuality) {
+            ApplyQuality(initialQuality);
+        }
+        const Resolution size = GetSwapChainInterface().GetResolution();
+        if (size.width != initialSize.width || size.height != initialSize.height) {
+            ApplyResize(initialSize);
+        }
+    };
+    callbacks.collectGpuTimes = [this](std::vector<float64>& gpuTimesMs, bool drain) {
+        // Headless runs have no device and so no timer queries to collect
+        if (!m_device) {
+            return;
+        }
+        ID3D11DeviceContext* context = m_device->GetContext();
+        if (drain) {
+            auto drained = m_gpuTimer.Drain(context);
+            gpuTimesMs.insert(gpuTimesMs.end(), drained.begin(), drained.end());
+            return;
+        }
+        float64 gpuTimeMs = 0.0;
+        while (m_gpuTimer.CollectFrame(context, gpuTimeMs)) {
+            gpuTimesMs.push_back(gpuTimeMs);
+        }
+    };
+
+    if (m_device) {
+        m_gpuTimer.Initialize(*m_device);
+    }
+    m_benchmark = std::make_unique<BenchmarkRunner>(std::move(scenario), std::move(callbacks));
+}
+
+bool Application::RunBenchmarkFrame() {
+    return m_benchmark && m_benchmark->RunFrame();
+}
+
+void Application::FinishBenchmark() {
+    if (!m_benchmark) {
+        return;
+    }
+
+    m_benchmark->LogSummary();
+    m_benchmark->WriteJsonFile(m_config.benchmarkOutput, [this](JsonWriter& writer) {
+        writer.BeginObject("engine")
+            .Field("adapter", Utils::WideToString(GetDeviceInterface().GetDescription()))
+            .Field("headless", m_config.headless)
+            .Field("output_width", GetSwapChainInterface().GetResolution().width)
+            .Field("output_height", GetSwapChainInterface().GetResolution().height)
+            .Field("xess_quality", XeSSModule::QualityToString(GetActiveQuality()))
+            .EndObject();
+
+        StartupTimeline::Instance().WriteJson(writer, "startup");
+
+        if (m_device && m_device->HasShaderManager()) {
+            const auto& stats = m_device->GetShaderManager().GetStatistics();
+            writer.BeginObject("shader_cache")
+                .Field("compilations", stats.totalCompilations)
+                .Field("cache_hits", stats.cacheHits)
+                .Field("cache_misses", stats.cacheMisses)
+                .Field("hit_ratio", stats.GetCacheHitRatio())
+                .Field("compile_errors", stats.compilationErrors)
+                .Field("total_compile_ms", stats.totalCompileTimeMs)
+                .Field("cache_size", stats.currentCacheSize)
+                .Field("cache_memory_mb", stats.currentMemoryUsageMB)
+                .EndObject();
+        }
+    });
+
+    m_gpuTimer.Shutdown();
+    m_benchmark.reset();
+}
+
+} // namespace XeSS::Application
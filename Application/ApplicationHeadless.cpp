@@ -0,0 +1,132 @@
+#include "Application.h"
+#include "Core/Logger.h"
+#include "Core/Utils.h"
+#include "Core/StartupTimeline.h"
+#include <limits>
+
+namespace XeSS::Application {
+
+// Initialize() calls InitializeHeadless() instead of creating the window,
+// device, swap chain and XeSS context when ApplicationConfig::headless is set,
+// and Run() then uses RunHeadlessLoop() in place of MainLoop(). Those D3D and
+// Win32 objects are never created in this mode; the HeadlessLoop owns null
+// implementations of all four, reached through the Get*Interface() getters.
+
+void Application::InitializeHeadless() {
+    XESS_INFO("Initializing headless application ({} frames)", m_config.headlessFrameCount);
+
+    StartupTimeline::Scope initPhase(StartupTimeline::Instance(), "initialize_headless");
+
+    HeadlessConfig headlessConfig;
+    headlessConfig.outputSize = m_config.windowSize;
+    headlessConfig.renderSize = XeSSModule::CalculateRenderResolution(m_config.windowSize, m_config.xessQuality);
+    headlessConfig.refreshRate = m_config.headlessRefreshRate;
+    m_headless = std::make_unique<HeadlessLoop>(headlessConfig);
+
+    OnLoadAssets();
+
+    m_frameStats.SetCapacity(m_config.headlessFrameCount);
+
+    StartMetricsServer();
+}
+
+void Application::RunHeadlessLoop() {
+    m_running = true;
+    m_lastFrameTime = std::chrono::high_resolution_clock::now();
+
+    // A benchmark scenario decides its own length
+    const uint64 maxFrames = m_benchmark ? std::numeric_limits<uint64>::max() : m_config.headlessFrameCount;
+
+    m_headless->Run(maxFrames, m_frameStats, [this](float) {
+        if (!m_running) {
+            return false;
+        }
+
+        if (m_benchmark) {
+            if (!RunBenchmarkFrame()) {
+                return false;
+            }
+        } else if (m_framePipeline) {
+            // No message pump to service, so wait for the game thread here
+            while (m_running && !RenderPipelinedFrame()) {
+            }
+        } else {
+            Update();
+            RenderFrame();
+            OnFramePresented();
+        }
+
+        UpdatePerformanceMetrics();
+        return true;
+    });
+
+    m_running = false;
+
+    if (m_benchmark) {
+        FinishBenchmark();
+        return;
+    }
+    m_frameStats.LogReport(Utils::WideToString(m_config.title) + " (headless)");
+}
+
+void Application::RenderFrame() {
+    if (m_headless) {
+        // Nothing to draw with; the null upscaler and swap chain count and pace
+        m_headless->PresentFrame();
+        return;
+    }
+
+    Render();
+    Present();
+}
+
+Graphics::IDevice& Application::GetDeviceInterface() {
+    if (m_headless) {
+        return m_headless->GetDevice();
+    }
+    return *m_device;
+}
+
+Graphics::ISwapChain& Application::GetSwapChainInterface() {
+    if (m_headless) {
+        return m_headless->GetSwapChain();
+    }
+    return *m_swapChain;
+}
+
+XeSSModule::IUpscaler& Application::GetUpscaler() {
+    if (m_headless) {
+        return m_headless->GetUpscaler();
+    }
+    return *m_xessContext;
+}
+
+XeSSModule::QualityMode Application::GetActiveQuality() const {
+    // The null upscaler has no quality setting; the config tracks it
+    return m_headless ? m_config.xessQuality : GetXeSSQuality();
+}
+
+void Application::ApplyQuality(XeSSModule::QualityMode quality) {
+    if (!m_headless) {
+        SetXeSSQuality(quality);
+        return;
+    }
+
+    m_config.xessQuality = quality;
+    const Resolution outputSize = m_headless->GetSwapChain().GetResolution();
+    m_headless->Resize(outputSize, XeSSModule::CalculateRenderResolution(outputSize, quality));
+}
+
+void Application::ApplyResize(const Resolution& size) {
+    if (!m_headless) {
+        m_pendingSize = size;
+        m_resizePending = true;
+        HandleResize();
+        return;
+    }
+
+    m_headless->Resize(size, XeSSModule::CalculateRenderResolution(size, m_config.xessQuality));
+    OnResize(size);
+}
+
+} // namespace XeSS::Application
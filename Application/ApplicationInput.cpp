@@ -0,0 +1,36 @@
+#include "Application.h"
+#include "Core/Logger.h"
+
+namespace XeSS::Application {
+
+// Window's message handler only pushes into m_inputQueue; it never calls the
+// OnKey*/OnMouse* handlers directly. Events reach them through DispatchInput(),
+// which Update() calls before OnUpdate (or the game thread, when frames are
+// pipelined), so handlers always run on the thread that owns simulation state.
+
+void Application::DispatchInput() {
+    m_inputQueue.Drain([this](const InputEvent& event) {
+        switch (event.type) {
+            case InputEventType::KeyDown:
+                OnKeyDown(event.code);
+                break;
+            case InputEventType::KeyUp:
+                OnKeyUp(event.code);
+                break;
+            case InputEventType::MouseMove:
+                OnMouseMove(event.x, event.y);
+                break;
+            case InputEventType::MouseButton:
+                OnMouseButton(event.code, event.pressed);
+                break;
+        }
+    });
+
+    uint64 dropped = m_inputQueue.GetDroppedEventCount();
+    if (dropped != m_reportedDroppedInput) {
+        XESS_WARNING("Input queue overflowed, {} events dropped so far", dropped);
+        m_reportedDroppedInput = dropped;
+    }
+}
+
+} // namespace XeSS::Application
@@ -0,0 +1,96 @@
+#include "Application.h"
+#include "Graphics/ShaderManager.h"
+#include "Core/Metrics.h"
+#include "Core/Logger.h"
+
+namespace XeSS::Application {
+
+namespace {
+    MetricsRegistry& Registry() { return MetricsRegistry::Instance(); }
+
+    MetricCounter& s_frames = Registry().Counter("frame.count", "Frames presented");
+    MetricGauge& s_frameTimeMs = Registry().Gauge("frame.time_ms", "CPU time of the last frame in ms");
+    MetricGauge& s_fps = Registry().Gauge("frame.fps", "Frames per second over the last second");
+    MetricHistogram& s_frameTimeHistogram = Registry().Histogram("frame.time_distribution_ms",
+        "Frame time distribution in ms", MetricHistogram::ExponentialBounds(1.0, 1.25, 24));
+}
+
+// The headless, pipelined and benchmark paths call OnFramePresented() after
+// every present and UpdatePerformanceMetrics() once per frame. MainLoop is
+// expected to do the same; where nothing calls OnFramePresented() the shader
+// creation queue falls back to pumping itself. Frame metrics always go to the
+// MetricsRegistry; the endpoint only exists when
+// ApplicationConfig::metricsEndpoint is set.
+
+void Application::UpdatePerformanceMetrics() {
+    auto now = std::chrono::high_resolution_clock::now();
+    if (m_fpsUpdateTime == std::chrono::high_resolution_clock::time_point{}) {
+        m_fpsUpdateTime = now;
+    }
+
+    float64 frameTimeMs = std::chrono::duration<float64, std::milli>(now - m_lastFrameTime).count();
+    m_lastFrameTime = now;
+
+    s_frames.Add();
+    s_frameTimeMs.Set(frameTimeMs);
+    s_frameTimeHistogram.Observe(frameTimeMs);
+
+    ++m_fpsFrameCount;
+    float64 windowSeconds = std::chrono::duration<float64>(now - m_fpsUpdateTime).count();
+    if (windowSeconds >= 1.0) {
+        s_fps.Set(m_fpsFrameCount / windowSeconds);
+        m_fpsFrameCount = 0;
+        m_fpsUpdateTime = now;
+    }
+}
+
+float Application::GetFrameTime() const {
+    return static_cast<float>(s_frameTimeMs.Value() / 1000.0);
+}
+
+float Application::GetFPS() const {
+    return static_cast<float>(s_fps.Value());
+}
+
+uint64 Application::GetFrameCount() const {
+    return s_frames.Value();
+}
+
+void Application::StartMetricsServer() {
+    if (m_config.metricsEndpoint.empty() || m_engineMetrics.IsRunning()) {
+        return;
+    }
+
+    if (!m_engineMetrics.Start(m_config.metricsEndpoint)) {
+        XESS_WARNING("Continuing without metrics endpoint");
+    }
+}
+
+void Application::OnFramePresented() {
+    MarkFirstFramePresented();
+
+    // Stamps first-use frames in the shader usage profile and starts this
+    // frame's budget of queued shader object creation
+    if (m_device && m_device->HasShaderManager()) {
+        m_device->GetShaderManager().BeginFrame(GetFrameCount());
+    }
+
+    if (m_engineMetrics.IsRunning()) {
+        PublishMetrics();
+    }
+}
+
+void Application::PublishMetrics() {
+    m_engineMetrics.PublishInput(m_inputQueue);
+    m_engineMetrics.PublishJobSystem();
+    m_engineMetrics.PublishMemory();
+
+    if (m_xessContext || m_headless) {
+        m_engineMetrics.PublishXeSS(GetUpscaler());
+    }
+    if (m_framePipeline) {
+        m_engineMetrics.PublishPipeline(m_framePipeline->GetStats());
+    }
+}
+
+} // namespace XeSS::Application
@@ -0,0 +1,66 @@
+#include "Application.h"
+#include "Core/Logger.h"
+
+namespace XeSS::Application {
+
+// MainLoop hands control here when ApplicationConfig::pipelinedFrames is set:
+// Initialize() starts the pipeline once all subsystems exist, each loop
+// iteration calls RenderPipelinedFrame() in place of Update/Render/Present,
+// and Shutdown() stops it before tearing the device down.
+
+void Application::StartFramePipeline() {
+    if (!m_config.pipelinedFrames || m_framePipeline) {
+        return;
+    }
+
+    FramePipelineConfig pipelineConfig;
+    pipelineConfig.maxFramesInFlight = m_config.maxFramesInFlight;
+
+    m_framePipeline = std::make_unique<FramePipeline>();
+    m_framePipeline->Start(pipelineConfig, [this](FramePacket& packet) {
+        DispatchInput();
+        StepSimulation(packet.deltaTime);
+        // Read the accumulator directly: GetInterpolationAlpha() looks at
+        // m_renderPacket, which the render thread owns
+        packet.interpolationAlpha = m_config.fixedTimestep ? m_fixedTimestep.GetAlpha() : 1.0f;
+        OnPublishFrame(packet);
+    });
+}
+
+void Application::StopFramePipeline() {
+    if (!m_framePipeline) {
+        return;
+    }
+
+    m_framePipeline->Stop();
+
+    FramePipelineStats stats = m_framePipeline->GetStats();
+    XESS_INFO("Pipeline stats: simulate {} ms, render {} ms, latency {} ms, stalls {}/{}",
+              stats.simulateTimeMs, stats.renderTimeMs, stats.latencyMs,
+              stats.simulationStalls, stats.renderStalls);
+
+    m_framePipeline.reset();
+}
+
+bool Application::RenderPipelinedFrame() {
+    bool rendered = m_framePipeline->RenderFrame([this](const FramePacket& packet) {
+        m_renderPacket = &packet;
+        RenderFrame();
+        OnFramePresented();
+        m_renderPacket = nullptr;
+    });
+
+    // The game thread stops itself if OnUpdate throws
+    if (!m_framePipeline->IsRunning()) {
+        XESS_ERROR("Game thread stopped unexpectedly, quitting");
+        Quit();
+    }
+
+    return rendered;
+}
+
+FramePipelineStats Application::GetPipelineStats() const {
+    return m_framePipeline ? m_framePipeline->GetStats() : FramePipelineStats{};
+}
+
+} // namespace XeSS::Application
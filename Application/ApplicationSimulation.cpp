@@ -0,0 +1,59 @@
+#include "Application.h"
+#include "Core/JobSystem.h"
+#include "Core/Logger.h"
+#include <algorithm>
+
+namespace XeSS::Application {
+
+// Initialize() starts the JobSystem with ApplicationConfig::jobWorkerThreads
+// before any subsystem and Shutdown() stops it last. Update() (or the game
+// thread, when frames are pipelined) calls DispatchInput() and then
+// StepSimulation() with the measured frame time.
+
+namespace {
+    // A rate of 0 runs one step a second rather than dividing by zero. The
+    // reconfigure check compares against this exact value, so it only fires
+    // when the rate changed.
+    float64 FixedStepSeconds(uint32 updateRate) {
+        return 1.0 / std::max<uint32>(updateRate, 1);
+    }
+}
+
+void Application::StepSimulation(float deltaTime) {
+    if (m_config.fixedTimestep) {
+        if (m_fixedTimestep.GetStepSeconds() != FixedStepSeconds(m_config.fixedUpdateRate)) {
+            ConfigureFixedTimestep();
+        }
+
+        uint64 clampedBefore = m_fixedTimestep.GetClampedFrames();
+        m_fixedTimestep.Run(deltaTime, [this](float64 stepSeconds, uint64) {
+            OnFixedUpdate(static_cast<float>(stepSeconds));
+        });
+
+        if (m_fixedTimestep.GetClampedFrames() != clampedBefore) {
+            XESS_DEBUG("Fixed timestep fell behind, {} s of simulation dropped in total",
+                       m_fixedTimestep.GetDroppedSeconds());
+        }
+    }
+
+    OnUpdate(deltaTime);
+}
+
+void Application::ConfigureFixedTimestep() {
+    FixedTimestepConfig config;
+    config.stepSeconds = FixedStepSeconds(m_config.fixedUpdateRate);
+    config.maxStepsPerFrame = m_config.maxFixedStepsPerFrame;
+    m_fixedTimestep.SetConfig(config);
+}
+
+float Application::GetInterpolationAlpha() const {
+    if (!m_config.fixedTimestep) {
+        return 1.0f;
+    }
+    // While pipelined the render thread must use the alpha captured with the
+    // packet, not the game thread's live accumulator. Game-thread code must
+    // not call this; m_renderPacket is set and cleared by the render thread.
+    return m_renderPacket ? m_renderPacket->interpolationAlpha : m_fixedTimestep.GetAlpha();
+}
+
+} // namespace XeSS::Application
@@ -0,0 +1,90 @@
+#include "Application.h"
+#include "Graphics/ShaderManager.h"
+#include "Core/JobSystem.h"
+#include "Core/StartupTimeline.h"
+#include "Core/TaskGraph.h"
+#include "Core/Logger.h"
+
+namespace XeSS::Application {
+
+// Initialize() starts the JobSystem, then calls InitializeSubsystems() (or
+// InitializeHeadless()) and finally OnInitialize() on the main thread. The
+// first Present() marks time-to-first-frame on the StartupTimeline, which is
+// logged and written to the benchmark JSON.
+
+void Application::InitializeSubsystems() {
+    auto& timeline = StartupTimeline::Instance();
+    StartupTimeline::Scope initPhase(timeline, "initialize_subsystems");
+
+    m_device = std::make_unique<Graphics::Device>();
+    m_swapChain = std::make_unique<Graphics::SwapChain>();
+    m_xessContext = std::make_unique<XeSSModule::XeSSContext>();
+
+    // Window and swap chain stay on the main thread (they own the message
+    // queue); everything else only needs the device and runs on workers.
+    TaskGraph graph("engine-init");
+    graph.SetTimeline(&timeline);
+
+    TaskId window = graph.AddTask("window", [this]() {
+        CreateMainWindow();
+    }, {}, TaskAffinity::MainThread);
+
+    TaskId device = graph.AddTask("device", [this]() {
+        m_device->Initialize(m_config.adapterId, m_config.useWarp, m_config.enableDebugLayer, true);
+    });
+
+    TaskId shaderCache = graph.AddTask("shader_cache", [this]() {
+        m_device->InitializeShaderManager();
+        m_device->GetShaderManager().LoadCacheFromDisk();
+    }, {device});
+
+    graph.AddTask("swap_chain", [this]() {
+        Graphics::SwapChainDesc swapChainDesc;
+        swapChainDesc.resolution = m_config.windowSize;
+        swapChainDesc.enableVSync = m_config.enableVSync;
+        swapChainDesc.windowed = !m_config.fullscreen;
+        swapChainDesc.windowHandle = m_window->GetHandle();
+        m_swapChain->Initialize(*m_device, swapChainDesc);
+    }, {window, device}, TaskAffinity::MainThread);
+
+    graph.AddTask("xess_context", [this]() {
+        m_xessContext->Initialize(*m_device, m_config.windowSize, m_config.xessQuality, m_config.xessFlags);
+    }, {device});
+
+    // Permutations the last session used, compiled in first-use order on
+    // workers; returns once the jobs are queued
+    graph.AddTask("shader_prefetch", [this]() {
+        m_device->GetShaderManager().PrefetchFromUsageProfile();
+    }, {shaderCache});
+
+    graph.AddTask("pipeline_prewarm", [this]() {
+        if (!m_config.shaderPrewarmManifest.empty()) {
+            m_device->GetShaderManager().PrecompileFromManifest(m_config.shaderPrewarmManifest);
+        }
+    }, {shaderCache});
+
+    graph.AddTask("assets", [this]() {
+        OnLoadAssets();
+    });
+
+    graph.Run();
+
+    StartMetricsServer();
+}
+
+void Application::MarkFirstFramePresented() {
+    if (m_firstFramePresented) {
+        return;
+    }
+    m_firstFramePresented = true;
+
+    auto& timeline = StartupTimeline::Instance();
+    timeline.MarkFirstFrame();
+    timeline.LogReport();
+
+    JobSystemStats jobStats = JobSystem::Instance().GetStats();
+    XESS_INFO("JobSystem during startup: {} jobs, {}% worker utilization",
+              jobStats.jobsExecuted, jobStats.Utilization() * 100.0);
+}
+
+} // namespace XeSS::Application
@@ -0,0 +1,187 @@
+#include "BenchmarkRunner.h"
+#include "Core/FrameStats.h"
+#include "Core/JsonWriter.h"
+#include "Core/Logger.h"
+#include "Core/Exception.h"
+#include <algorithm>
+
+namespace XeSS::Application {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<float32> Concatenate(const std::vector<BenchmarkRepetitionResult>& results,
+                                     std::vector<float32> BenchmarkRepetitionResult::* member) {
+        std::vector<float32> all;
+        for (const auto& result : results) {
+            const auto& samples = result.*member;
+            all.insert(all.end(), samples.begin(), samples.end());
+        }
+        return all;
+    }
+}
+
+BenchmarkRunner::BenchmarkRunner(BenchmarkScenario scenario, BenchmarkCallbacks callbacks)
+    : m_scenario(std::move(scenario)), m_callbacks(std::move(callbacks)) {
+    if (!m_callbacks.simulate || !m_callbacks.render) {
+        throw Exception("BenchmarkRunner requires simulate and render callbacks");
+    }
+
+    m_results.resize(m_scenario.repetitions);
+    for (auto& result : m_results) {
+        result.cpuFrameTimesMs.reserve(m_scenario.frameCount);
+        result.gpuFrameTimesMs.reserve(m_scenario.frameCount);
+    }
+}
+
+bool BenchmarkRunner::RunFrame() {
+    if (IsFinished()) {
+        return false;
+    }
+
+    // Warmup replays the start of the scenario once, before the first repetition
+    const bool warmup = m_step < m_scenario.warmupFrames;
+    const uint32 measuredStep = warmup ? 0 : m_step - m_scenario.warmupFrames;
+    const uint32 frameIndex = warmup ? m_step % m_scenario.frameCount
+                                     : measuredStep % m_scenario.frameCount;
+
+    if (frameIndex == 0) {
+        if (m_callbacks.resetState) {
+            m_callbacks.resetState();
+        }
+        m_nextEvent = 0;
+    }
+    ApplyEvents(frameIndex);
+
+    BenchmarkFrame frame = m_scenario.MakeFrame(m_repetition, frameIndex, warmup);
+
+    auto frameStart = Clock::now();
+    m_callbacks.simulate(frame);
+    m_callbacks.render(frame);
+    auto frameEnd = Clock::now();
+
+    ++m_step;
+
+    if (warmup) {
+        // Discard GPU timings that belong to warmup frames
+        if (m_step == m_scenario.warmupFrames) {
+            CollectGpuTimes(true, false);
+        }
+        return true;
+    }
+
+    auto& result = m_results[m_repetition];
+    result.cpuFrameTimesMs.push_back(std::chrono::duration<float32, std::milli>(frameEnd - frameStart).count());
+    CollectGpuTimes(false, true);
+
+    if (frameIndex + 1 == m_scenario.frameCount) {
+        CollectGpuTimes(true, true);
+
+        // peakBytes is the process-lifetime peak (VmHWM / PeakWorkingSetSize),
+        // so it never drops between repetitions and includes startup
+        result.memory = Utils::GetProcessMemoryUsage();
+        m_peakMemoryBytes = std::max(m_peakMemoryBytes, result.memory.peakBytes);
+
+        XESS_INFO("Benchmark repetition {}/{} complete", m_repetition + 1, m_scenario.repetitions);
+        ++m_repetition;
+    }
+
+    return !IsFinished();
+}
+
+void BenchmarkRunner::ApplyEvents(uint32 frameIndex) {
+    const auto& events = m_scenario.GetEvents();
+    while (m_nextEvent < events.size() && events[m_nextEvent].frame <= frameIndex) {
+        if (m_callbacks.applyEvent) {
+            m_callbacks.applyEvent(events[m_nextEvent]);
+        }
+        ++m_nextEvent;
+    }
+}
+
+void BenchmarkRunner::CollectGpuTimes(bool drain, bool keep) {
+    if (!m_callbacks.collectGpuTimes) {
+        return;
+    }
+
+    m_gpuScratch.clear();
+    m_callbacks.collectGpuTimes(m_gpuScratch, drain);
+
+    if (keep && m_repetition < m_results.size()) {
+        auto& gpuTimes = m_results[m_repetition].gpuFrameTimesMs;
+        for (float64 time : m_gpuScratch) {
+            gpuTimes.push_back(static_cast<float32>(time));
+        }
+    }
+}
+
+void BenchmarkRunner::LogSummary() const {
+    FrameTimeSummary cpu = FrameStats::Summarize(Concatenate(m_results, &BenchmarkRepetitionResult::cpuFrameTimesMs));
+    FrameTimeSummary gpu = FrameStats::Summarize(Concatenate(m_results, &BenchmarkRepetitionResult::gpuFrameTimesMs));
+
+    XESS_INFO("Benchmark '{}': CPU mean {} ms, p95 {} ms, p99 {} ms",
+              m_scenario.name, cpu.meanMs, cpu.p95Ms, cpu.p99Ms);
+    if (gpu.frameCount > 0) {
+        XESS_INFO("Benchmark '{}': GPU mean {} ms, p95 {} ms, p99 {} ms",
+                  m_scenario.name, gpu.meanMs, gpu.p95Ms, gpu.p99Ms);
+    }
+    XESS_INFO("Benchmark '{}': peak memory {} MB", m_scenario.name, m_peakMemoryBytes / (1024 * 1024));
+}
+
+void BenchmarkRunner::WriteJson(JsonWriter& writer, const std::function<void(JsonWriter&)>& extra) const {
+    writer.BeginObject();
+
+    writer.BeginObject("scenario")
+        .Field("name", m_scenario.name)
+        .Field("timestep", m_scenario.timestep)
+        .Field("frames", m_scenario.frameCount)
+        .Field("warmup_frames", m_scenario.warmupFrames)
+        .Field("repetitions", m_scenario.repetitions)
+        .Field("events", static_cast<uint64>(m_scenario.GetEvents().size()))
+        .EndObject();
+
+    FrameStats::WriteSummaryJson(writer, "cpu",
+        FrameStats::Summarize(Concatenate(m_results, &BenchmarkRepetitionResult::cpuFrameTimesMs)));
+    FrameStats::WriteSummaryJson(writer, "gpu",
+        FrameStats::Summarize(Concatenate(m_results, &BenchmarkRepetitionResult::gpuFrameTimesMs)));
+
+    writer.BeginArray("repetitions");
+    for (uint32 i = 0; i < m_results.size(); ++i) {
+        const auto& result = m_results[i];
+        writer.BeginObject().Field("index", i);
+        FrameStats::WriteSummaryJson(writer, "cpu", FrameStats::Summarize(result.cpuFrameTimesMs));
+        FrameStats::WriteSummaryJson(writer, "gpu", FrameStats::Summarize(result.gpuFrameTimesMs));
+        writer.Array("cpu_samples_ms", result.cpuFrameTimesMs);
+        writer.Array("gpu_samples_ms", result.gpuFrameTimesMs);
+        writer.BeginObject("memory")
+            .Field("current_bytes", result.memory.currentBytes)
+            .Field("peak_bytes", result.memory.peakBytes)
+            .EndObject();
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.BeginObject("memory")
+        .Field("peak_bytes", m_peakMemoryBytes)
+        .EndObject();
+
+    if (extra) {
+        extra(writer);
+    }
+
+    writer.EndObject();
+}
+
+bool BenchmarkRunner::WriteJsonFile(const std::string& filename, const std::function<void(JsonWriter&)>& extra) const {
+    JsonWriter writer;
+    WriteJson(writer, extra);
+
+    if (!writer.WriteToFile(filename)) {
+        return false;
+    }
+
+    XESS_INFO("Benchmark results written to {}", filename);
+    return true;
+}
+
+} // namespace XeSS::Application
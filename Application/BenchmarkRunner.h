@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include "Core/Utils.h"
+#include "BenchmarkScenario.h"
+#include <chrono>
+#include <functional>
+
+namespace XeSS {
+class JsonWriter;
+}
+
+namespace XeSS::Application {
+
+struct BenchmarkCallbacks {
+    std::function<void(const BenchmarkFrame&)> simulate;
+    std::function<void(const BenchmarkFrame&)> render;
+    std::function<void(const BenchmarkEvent&)> applyEvent;
+
+    // Restore the state scripted events change, called before every pass
+    // through frame 0 so repetitions start identically
+    std::function<void()> resetState;
+
+    // Optional: append resolved GPU frame times; drain = block until all are resolved
+    std::function<void(std::vector<float64>& gpuTimesMs, bool drain)> collectGpuTimes;
+};
+
+struct BenchmarkRepetitionResult {
+    std::vector<float32> cpuFrameTimesMs;
+    std::vector<float32> gpuFrameTimesMs;
+    Utils::ProcessMemoryUsage memory;
+};
+
+// Drives a BenchmarkScenario one frame at a time so it can run inside either
+// the windowed main loop or the headless loop.
+class BenchmarkRunner : public NonCopyable {
+public:
+    BenchmarkRunner(BenchmarkScenario scenario, BenchmarkCallbacks callbacks);
+
+    // Runs one frame; returns false once every repetition has completed
+    bool RunFrame();
+    bool IsFinished() const { return m_repetition >= m_scenario.repetitions; }
+
+    const BenchmarkScenario& GetScenario() const { return m_scenario; }
+    const std::vector<BenchmarkRepetitionResult>& GetResults() const { return m_results; }
+
+    void LogSummary() const;
+
+    // Writes the full result document; extra appends application sections
+    // (shader cache statistics, startup timings, ...) to the root object
+    void WriteJson(JsonWriter& writer, const std::function<void(JsonWriter&)>& extra = {}) const;
+    bool WriteJsonFile(const std::string& filename, const std::function<void(JsonWriter&)>& extra = {}) const;
+
+private:
+    void ApplyEvents(uint32 frameIndex);
+    void CollectGpuTimes(bool drain, bool keep);
+
+    BenchmarkScenario m_scenario;
+    BenchmarkCallbacks m_callbacks;
+
+    uint32 m_repetition{0};
+    uint32 m_step{0};        // Frames run since the start, warmup included
+    size_t m_nextEvent{0};
+
+    std::vector<BenchmarkRepetitionResult> m_results;
+    std::vector<float64> m_gpuScratch;
+    uint64 m_peakMemoryBytes{0};
+};
+
+} // namespace XeSS::Application
@@ -0,0 +1,190 @@
+#include "BenchmarkScenario.h"
+#include "Core/Logger.h"
+#include "Core/Utils.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace XeSS::Application {
+
+void BenchmarkTrack::AddKey(uint32 frame, const Vector3& value) {
+    auto it = std::lower_bound(m_keys.begin(), m_keys.end(), frame,
+        [](const Keyframe& key, uint32 f) { return key.frame < f; });
+
+    if (it != m_keys.end() && it->frame == frame) {
+        it->value = value;
+    } else {
+        m_keys.insert(it, Keyframe{frame, value});
+    }
+}
+
+Vector3 BenchmarkTrack::Sample(uint32 frame) const {
+    if (m_keys.empty()) {
+        return {};
+    }
+    if (frame <= m_keys.front().frame) {
+        return m_keys.front().value;
+    }
+    if (frame >= m_keys.back().frame) {
+        return m_keys.back().value;
+    }
+
+    auto next = std::upper_bound(m_keys.begin(), m_keys.end(), frame,
+        [](uint32 f, const Keyframe& key) { return f < key.frame; });
+    auto prev = next - 1;
+
+    float32 t = static_cast<float32>(frame - prev->frame) /
+                static_cast<float32>(next->frame - prev->frame);
+    return {
+        Utils::Lerp(prev->value.x, next->value.x, t),
+        Utils::Lerp(prev->value.y, next->value.y, t),
+        Utils::Lerp(prev->value.z, next->value.z, t)
+    };
+}
+
+Vector3 BenchmarkFrame::GetObjectPosition(const std::string& name) const {
+    if (!scenario) {
+        return {};
+    }
+
+    auto it = scenario->objects.find(name);
+    return it != scenario->objects.end() ? it->second.Sample(frameIndex) : Vector3{};
+}
+
+void BenchmarkScenario::AddQualitySwitch(uint32 frame, XeSSModule::QualityMode quality) {
+    BenchmarkEvent event;
+    event.frame = frame;
+    event.type = BenchmarkEventType::SetQuality;
+    event.quality = quality;
+    m_events.push_back(event);
+    SortEvents();
+}
+
+void BenchmarkScenario::AddResize(uint32 frame, const Resolution& resolution) {
+    BenchmarkEvent event;
+    event.frame = frame;
+    event.type = BenchmarkEventType::Resize;
+    event.resolution = resolution;
+    m_events.push_back(event);
+    SortEvents();
+}
+
+bool BenchmarkScenario::LoadFromFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        XESS_ERROR("Failed to open benchmark scenario: {}", filename);
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return LoadFromString(buffer.str(), filename);
+}
+
+bool BenchmarkScenario::LoadFromString(const std::string& script, const std::string& sourceName) {
+    std::istringstream input(script);
+    std::string line;
+    uint32 lineNumber = 0;
+
+    while (std::getline(input, line)) {
+        ++lineNumber;
+
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+
+        std::istringstream tokens(line);
+        std::string directive;
+        if (!(tokens >> directive)) {
+            continue;
+        }
+
+        bool ok = true;
+        if (directive == "name") {
+            ok = static_cast<bool>(tokens >> name);
+        } else if (directive == "timestep") {
+            ok = static_cast<bool>(tokens >> timestep) && timestep > 0.0f;
+        } else if (directive == "frames") {
+            ok = static_cast<bool>(tokens >> frameCount) && frameCount > 0;
+        } else if (directive == "warmup") {
+            ok = static_cast<bool>(tokens >> warmupFrames);
+        } else if (directive == "repetitions") {
+            ok = static_cast<bool>(tokens >> repetitions) && repetitions > 0;
+        } else if (directive == "camera" || directive == "target") {
+            uint32 frame;
+            Vector3 value;
+            ok = static_cast<bool>(tokens >> frame >> value.x >> value.y >> value.z);
+            if (ok) {
+                (directive == "camera" ? camera : cameraTarget).AddKey(frame, value);
+            }
+        } else if (directive == "object") {
+            std::string objectName;
+            uint32 frame;
+            Vector3 value;
+            ok = static_cast<bool>(tokens >> objectName >> frame >> value.x >> value.y >> value.z);
+            if (ok) {
+                objects[objectName].AddKey(frame, value);
+            }
+        } else if (directive == "quality") {
+            uint32 frame;
+            std::string qualityName;
+            XeSSModule::QualityMode quality;
+            ok = static_cast<bool>(tokens >> frame >> qualityName) && ParseQualityMode(qualityName, quality);
+            if (ok) {
+                AddQualitySwitch(frame, quality);
+            }
+        } else if (directive == "resize") {
+            uint32 frame;
+            Resolution resolution;
+            ok = static_cast<bool>(tokens >> frame >> resolution.width >> resolution.height) &&
+                 resolution.IsValid();
+            if (ok) {
+                AddResize(frame, resolution);
+            }
+        } else {
+            XESS_ERROR("{}:{}: unknown benchmark directive '{}'", sourceName, lineNumber, directive);
+            return false;
+        }
+
+        if (!ok) {
+            XESS_ERROR("{}:{}: malformed '{}' directive", sourceName, lineNumber, directive);
+            return false;
+        }
+    }
+
+    XESS_INFO("Loaded benchmark scenario '{}': {} frames x {} repetitions, {} events",
+              name, frameCount, repetitions, m_events.size());
+    return true;
+}
+
+BenchmarkFrame BenchmarkScenario::MakeFrame(uint32 repetition, uint32 frameIndex, bool warmup) const {
+    BenchmarkFrame frame;
+    frame.scenario = this;
+    frame.repetition = repetition;
+    frame.frameIndex = frameIndex;
+    frame.warmup = warmup;
+    frame.deltaTime = timestep;
+    frame.time = static_cast<float>(frameIndex) * timestep;
+    frame.cameraPosition = camera.Sample(frameIndex);
+    frame.cameraTarget = cameraTarget.Sample(frameIndex);
+    return frame;
+}
+
+void BenchmarkScenario::SortEvents() {
+    std::stable_sort(m_events.begin(), m_events.end(),
+        [](const BenchmarkEvent& a, const BenchmarkEvent& b) { return a.frame < b.frame; });
+}
+
+bool ParseQualityMode(const std::string& str, XeSSModule::QualityMode& quality) {
+    using XeSSModule::QualityMode;
+
+    if (str == "UltraPerformance") { quality = QualityMode::UltraPerformance; return true; }
+    if (str == "Performance") { quality = QualityMode::Performance; return true; }
+    if (str == "Balanced") { quality = QualityMode::Balanced; return true; }
+    if (str == "Quality") { quality = QualityMode::Quality; return true; }
+    if (str == "UltraQuality") { quality = QualityMode::UltraQuality; return true; }
+    return false;
+}
+
+} // namespace XeSS::Application
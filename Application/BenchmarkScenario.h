@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "XeSS/XeSSTypes.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace XeSS::Application {
+
+// Piecewise-linear path through keyframes, sampled by scenario frame
+class BenchmarkTrack {
+public:
+    void AddKey(uint32 frame, const Vector3& value);
+    Vector3 Sample(uint32 frame) const;
+    bool IsEmpty() const { return m_keys.empty(); }
+
+private:
+    struct Keyframe {
+        uint32 frame;
+        Vector3 value;
+    };
+
+    std::vector<Keyframe> m_keys; // Sorted by frame
+};
+
+enum class BenchmarkEventType : uint32 {
+    SetQuality,
+    Resize
+};
+
+struct BenchmarkEvent {
+    uint32 frame{0};
+    BenchmarkEventType type{BenchmarkEventType::SetQuality};
+    XeSSModule::QualityMode quality{XeSSModule::QualityMode::Performance};
+    Resolution resolution;
+};
+
+class BenchmarkScenario;
+
+// Deterministic per-frame input handed to the application
+struct BenchmarkFrame {
+    const BenchmarkScenario* scenario{nullptr};
+    uint32 repetition{0};
+    uint32 frameIndex{0};   // Scenario frame, restarts at 0 for each repetition
+    bool warmup{false};
+    float deltaTime{0.0f};  // Always the scenario timestep
+    float time{0.0f};       // frameIndex * deltaTime
+
+    Vector3 cameraPosition;
+    Vector3 cameraTarget;
+
+    // Position of a named object path at this frame (origin if unknown)
+    Vector3 GetObjectPosition(const std::string& name) const;
+};
+
+/**
+ * Scripted benchmark scenario: fixed timestep, camera and object paths,
+ * quality switches and resizes keyed to frame numbers.
+ *
+ * Script format, one directive per line ('#' starts a comment):
+ *   name <string>
+ *   timestep <seconds>
+ *   frames <count>
+ *   warmup <count>
+ *   repetitions <count>
+ *   camera <frame> <x> <y> <z>
+ *   target <frame> <x> <y> <z>
+ *   object <name> <frame> <x> <y> <z>
+ *   quality <frame> <UltraPerformance|Performance|Balanced|Quality|UltraQuality>
+ *   resize <frame> <width> <height>
+ */
+class BenchmarkScenario {
+public:
+    std::string name{"default"};
+    float timestep{1.0f / 60.0f};
+    uint32 frameCount{600};
+    uint32 warmupFrames{60};
+    uint32 repetitions{5};
+
+    BenchmarkTrack camera;
+    BenchmarkTrack cameraTarget;
+    std::map<std::string, BenchmarkTrack> objects;
+
+    void AddQualitySwitch(uint32 frame, XeSSModule::QualityMode quality);
+    void AddResize(uint32 frame, const Resolution& resolution);
+    const std::vector<BenchmarkEvent>& GetEvents() const { return m_events; }
+
+    bool LoadFromFile(const std::string& filename);
+    bool LoadFromString(const std::string& script, const std::string& sourceName = "<string>");
+
+    BenchmarkFrame MakeFrame(uint32 repetition, uint32 frameIndex, bool warmup) const;
+
+private:
+    void SortEvents();
+
+    std::vector<BenchmarkEvent> m_events; // Sorted by frame
+};
+
+bool ParseQualityMode(const std::string& str, XeSSModule::QualityMode& quality);
+
+} // namespace XeSS::Application
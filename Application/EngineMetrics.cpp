@@ -0,0 +1,109 @@
+#include "EngineMetrics.h"
+#include "FramePipeline.h"
+#include "XeSS/UpscalerInterface.h"
+#include "Core/InputQueue.h"
+#include "Core/JobSystem.h"
+#include "Core/MemoryTags.h"
+#include "Core/Metrics.h"
+#include "Core/Utils.h"
+#include <array>
+
+namespace XeSS::Application {
+
+namespace {
+    MetricsRegistry& Registry() { return MetricsRegistry::Instance(); }
+
+    MetricGauge& s_xessExecuteTimeMs = Registry().Gauge("upscaler.execute_cpu_ms", "CPU time of the last XeSS execute");
+    MetricCounter& s_xessExecutions = Registry().Counter("upscaler.executions", "XeSS executions");
+    MetricGauge& s_xessInputWidth = Registry().Gauge("upscaler.input_width", "XeSS render resolution width");
+    MetricGauge& s_xessInputHeight = Registry().Gauge("upscaler.input_height", "XeSS render resolution height");
+
+    MetricGauge& s_pipelineLatencyMs = Registry().Gauge("pipeline.latency_ms", "Simulation start to render completion");
+    MetricCounter& s_pipelineSimulationStalls = Registry().Counter("pipeline.simulation_stalls",
+        "Game thread waits on the latency budget");
+    MetricCounter& s_pipelineRenderStalls = Registry().Counter("pipeline.render_stalls",
+        "Render thread found no frame ready");
+
+    MetricCounter& s_inputDropped = Registry().Counter("input.dropped_events", "Input events lost to queue overflow");
+    MetricGauge& s_inputLatencyUs = Registry().Gauge("input.latency_us",
+        "Delivery to dispatch latency of the last input event");
+
+    MetricGauge& s_jobWorkers = Registry().Gauge("job.workers", "JobSystem worker threads");
+    MetricCounter& s_jobsExecuted = Registry().Counter("job.executed", "Jobs executed");
+    MetricGauge& s_jobUtilization = Registry().Gauge("job.utilization", "Fraction of worker time spent running jobs");
+
+    MetricGauge& s_processMemory = Registry().Gauge("process.memory_bytes", "Process resident memory");
+    MetricGauge& s_processPeakMemory = Registry().Gauge("process.memory_peak_bytes", "Peak process resident memory");
+
+    // One gauge per tag, "memory.tagged_bytes.textures" and so on
+    std::array<MetricGauge*, static_cast<size_t>(MemoryTag::Count)> RegisterTaggedBytes() {
+        std::array<MetricGauge*, static_cast<size_t>(MemoryTag::Count)> gauges{};
+        for (uint32 i = 0; i < static_cast<uint32>(MemoryTag::Count); ++i) {
+            const char* tag = MemoryTags::GetName(static_cast<MemoryTag>(i));
+            gauges[i] = &Registry().Gauge(std::string("memory.tagged_bytes.") + tag,
+                                          std::string("Memory owned by the ") + tag + " subsystem");
+        }
+        return gauges;
+    }
+    const std::array<MetricGauge*, static_cast<size_t>(MemoryTag::Count)> s_taggedBytes = RegisterTaggedBytes();
+
+    // The subsystems keep running totals; the counters only move forward by
+    // the difference, and this is the only writer
+    void PublishTotal(MetricCounter& counter, uint64 total) {
+        uint64 published = counter.Value();
+        if (total > published) {
+            counter.Add(total - published);
+        }
+    }
+}
+
+bool EngineMetrics::Start(const std::string& endpoint) {
+    return m_server.Start(endpoint);
+}
+
+void EngineMetrics::Stop() {
+    m_server.Stop();
+}
+
+void EngineMetrics::PublishXeSS(const XeSSModule::IUpscaler& upscaler) {
+    s_xessExecuteTimeMs.Set(upscaler.GetLastExecuteTimeMs());
+    PublishTotal(s_xessExecutions, upscaler.GetExecuteCount());
+    s_xessInputWidth.Set(upscaler.GetInputResolution().width);
+    s_xessInputHeight.Set(upscaler.GetInputResolution().height);
+}
+
+void EngineMetrics::PublishPipeline(const FramePipelineStats& stats) {
+    s_pipelineLatencyMs.Set(stats.latencyMs);
+    PublishTotal(s_pipelineSimulationStalls, stats.simulationStalls);
+    PublishTotal(s_pipelineRenderStalls, stats.renderStalls);
+}
+
+void EngineMetrics::PublishInput(const InputQueue& input) {
+    PublishTotal(s_inputDropped, input.GetDroppedEventCount());
+    s_inputLatencyUs.Set(static_cast<float64>(input.GetLastDrainLatencyUs()));
+}
+
+void EngineMetrics::PublishJobSystem() {
+    JobSystemStats stats = JobSystem::Instance().GetStats();
+    s_jobWorkers.Set(stats.workerCount);
+    PublishTotal(s_jobsExecuted, stats.jobsExecuted);
+    s_jobUtilization.Set(stats.Utilization());
+}
+
+void EngineMetrics::PublishMemory() {
+    for (uint32 i = 0; i < static_cast<uint32>(MemoryTag::Count); ++i) {
+        s_taggedBytes[i]->Set(static_cast<float64>(MemoryTags::GetBytes(static_cast<MemoryTag>(i))));
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now < m_nextMemorySample) {
+        return;
+    }
+    m_nextMemorySample = now + std::chrono::seconds(1);
+
+    Utils::ProcessMemoryUsage usage = Utils::GetProcessMemoryUsage();
+    s_processMemory.Set(static_cast<float64>(usage.currentBytes));
+    s_processPeakMemory.Set(static_cast<float64>(usage.peakBytes));
+}
+
+} // namespace XeSS::Application
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include "Core/MetricsServer.h"
+#include <chrono>
+
+namespace XeSS {
+class InputQueue;
+}
+
+namespace XeSS::XeSSModule {
+class IUpscaler;
+}
+
+namespace XeSS::Application {
+
+struct FramePipelineStats;
+
+/**
+ * Engine telemetry served through a MetricsServer. Every value lives in the
+ * MetricsRegistry, like the frame and shader metrics; the Publish* calls copy
+ * state owned by other subsystems into it on the frame thread and only store.
+ */
+class EngineMetrics : public NonCopyable {
+public:
+    bool Start(const std::string& endpoint);
+    void Stop();
+    bool IsRunning() const { return m_server.IsRunning(); }
+
+    MetricsServer& GetServer() { return m_server; }
+
+    void PublishXeSS(const XeSSModule::IUpscaler& upscaler);
+    void PublishPipeline(const FramePipelineStats& stats);
+    void PublishInput(const InputQueue& input);
+    void PublishJobSystem();
+
+    // Process memory needs a system call, so it is refreshed once a second
+    void PublishMemory();
+
+private:
+    MetricsServer m_server;
+    std::chrono::steady_clock::time_point m_nextMemorySample;
+};
+
+} // namespace XeSS::Application
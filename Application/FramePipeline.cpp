@@ -0,0 +1,165 @@
+#include "FramePipeline.h"
+#include "Core/Logger.h"
+#include "Core/Exception.h"
+#include "Core/Utils.h"
+
+namespace XeSS::Application {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    float ElapsedMs(Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<float, std::milli>(end - start).count();
+    }
+
+    // Exponential moving average so a single hitch doesn't dominate the stats
+    void Accumulate(std::atomic<float>& average, float sample) {
+        float previous = average.load(std::memory_order_relaxed);
+        float next = previous == 0.0f ? sample : Utils::Lerp(previous, sample, 0.1f);
+        average.store(next, std::memory_order_relaxed);
+    }
+}
+
+FramePipeline::FramePipeline() = default;
+
+FramePipeline::~FramePipeline() {
+    Stop();
+}
+
+void FramePipeline::Start(const FramePipelineConfig& config, SimulateCallback simulate) {
+    if (IsRunning()) {
+        XESS_WARNING("FramePipeline already running");
+        return;
+    }
+
+    if (!simulate) {
+        throw Exception("FramePipeline requires a simulation callback");
+    }
+
+    m_config = config;
+    m_config.maxFramesInFlight = Utils::Clamp<uint32>(config.maxFramesInFlight, 1, MaxFramesInFlight);
+    m_slotCount = m_config.maxFramesInFlight + 1;
+    m_simulate = std::move(simulate);
+
+    m_published.store(0, std::memory_order_relaxed);
+    m_consumed.store(0, std::memory_order_relaxed);
+    m_simulationStalls.store(0, std::memory_order_relaxed);
+    m_renderStalls.store(0, std::memory_order_relaxed);
+
+    m_running.store(true, std::memory_order_release);
+    m_gameThread = std::thread(&FramePipeline::GameThreadMain, this);
+
+    XESS_INFO("Pipelined frame loop started ({} frame(s) in flight)", m_config.maxFramesInFlight);
+}
+
+void FramePipeline::Stop() {
+    // The game thread clears m_running itself if simulation throws, so join
+    // whenever the thread exists rather than only on the first Stop()
+    m_running.store(false, std::memory_order_release);
+    if (!m_gameThread.joinable()) {
+        return;
+    }
+
+    // Wake the game thread if it is parked on the latency budget
+    m_renderSignal.fetch_add(1, std::memory_order_release);
+    m_renderSignal.notify_all();
+
+    m_gameThread.join();
+
+    XESS_INFO("Pipelined frame loop stopped after {} frames", m_consumed.load(std::memory_order_relaxed));
+}
+
+bool FramePipeline::RenderFrame(const RenderCallback& render) {
+    const uint64 sequence = m_consumed.load(std::memory_order_relaxed);
+
+    // Spin briefly, then yield, until the game thread publishes the next packet
+    const auto deadline = Clock::now() + m_config.renderWaitTimeout;
+    uint32 spins = 0;
+    while (m_published.load(std::memory_order_acquire) <= sequence) {
+        if (!IsRunning() || Clock::now() >= deadline) {
+            m_renderStalls.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (++spins > 64) {
+            std::this_thread::yield();
+        }
+    }
+
+    const FramePacket& packet = SlotFor(sequence);
+
+    auto renderStart = Clock::now();
+    render(packet);
+    auto renderEnd = Clock::now();
+
+    Accumulate(m_renderTimeMs, ElapsedMs(renderStart, renderEnd));
+    Accumulate(m_latencyMs, ElapsedMs(packet.simulationStart, renderEnd));
+
+    // Hand the slot back to the game thread
+    m_consumed.store(sequence + 1, std::memory_order_release);
+    m_renderSignal.fetch_add(1, std::memory_order_release);
+    m_renderSignal.notify_one();
+    return true;
+}
+
+FramePipelineStats FramePipeline::GetStats() const {
+    FramePipelineStats stats;
+    stats.simulateTimeMs = m_simulateTimeMs.load(std::memory_order_relaxed);
+    stats.renderTimeMs = m_renderTimeMs.load(std::memory_order_relaxed);
+    stats.latencyMs = m_latencyMs.load(std::memory_order_relaxed);
+    stats.framesSimulated = m_published.load(std::memory_order_relaxed);
+    stats.framesRendered = m_consumed.load(std::memory_order_relaxed);
+    stats.simulationStalls = m_simulationStalls.load(std::memory_order_relaxed);
+    stats.renderStalls = m_renderStalls.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void FramePipeline::GameThreadMain() {
+    auto lastFrameTime = Clock::now();
+
+    while (IsRunning()) {
+        const uint64 sequence = m_published.load(std::memory_order_relaxed);
+
+        // Respect the latency budget: never overwrite a packet the render
+        // thread has not finished with
+        uint64 consumed = m_consumed.load(std::memory_order_acquire);
+        if (sequence - consumed >= m_slotCount) {
+            m_simulationStalls.fetch_add(1, std::memory_order_relaxed);
+            while (IsRunning()) {
+                // Sample the signal before re-checking so a release between
+                // the check and the wait is never missed
+                uint32 signal = m_renderSignal.load(std::memory_order_acquire);
+                consumed = m_consumed.load(std::memory_order_acquire);
+                if (sequence - consumed < m_slotCount) {
+                    break;
+                }
+                m_renderSignal.wait(signal, std::memory_order_acquire);
+            }
+            if (!IsRunning()) {
+                break;
+            }
+        }
+
+        FramePacket& packet = SlotFor(sequence);
+        auto now = Clock::now();
+        packet.frameIndex = sequence;
+        packet.deltaTime = std::chrono::duration<float>(now - lastFrameTime).count();
+        packet.simulationStart = now;
+        lastFrameTime = now;
+
+        try {
+            m_simulate(packet);
+        }
+        catch (const std::exception& e) {
+            XESS_ERROR("Exception on game thread: {}", e.what());
+            m_running.store(false, std::memory_order_release);
+            break;
+        }
+
+        packet.simulationEnd = Clock::now();
+        Accumulate(m_simulateTimeMs, ElapsedMs(packet.simulationStart, packet.simulationEnd));
+
+        m_published.store(sequence + 1, std::memory_order_release);
+    }
+}
+
+} // namespace XeSS::Application
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace XeSS::Application {
+
+// Everything the render thread needs to draw one simulated frame.
+// Packets are recycled, so the payload keeps its capacity between frames.
+struct FramePacket {
+    uint64 frameIndex{0};
+    float deltaTime{0.0f};
+    float interpolationAlpha{1.0f};
+    std::chrono::steady_clock::time_point simulationStart;
+    std::chrono::steady_clock::time_point simulationEnd;
+
+    // Snapshot of simulation state written by the game thread
+    std::vector<uint8> payload;
+
+    template<typename T>
+    void Store(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Frame payload must be trivially copyable");
+        payload.resize(sizeof(T));
+        std::memcpy(payload.data(), &value, sizeof(T));
+    }
+
+    template<typename T>
+    bool Load(T& value) const {
+        static_assert(std::is_trivially_copyable_v<T>, "Frame payload must be trivially copyable");
+        if (payload.size() != sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, payload.data(), sizeof(T));
+        return true;
+    }
+};
+
+struct FramePipelineConfig {
+    // Latency budget: how many frames the game thread may run ahead of the
+    // render thread. 1 gives classic double buffering.
+    uint32 maxFramesInFlight{1};
+
+    // How long the render thread waits for a packet before returning to the
+    // message pump
+    std::chrono::microseconds renderWaitTimeout{2000};
+};
+
+struct FramePipelineStats {
+    float simulateTimeMs{0.0f};
+    float renderTimeMs{0.0f};
+    float latencyMs{0.0f};       // Simulation start to render completion
+    uint64 framesSimulated{0};
+    uint64 framesRendered{0};
+    uint64 simulationStalls{0};  // Game thread blocked on the latency budget
+    uint64 renderStalls{0};      // Render thread found no packet ready
+};
+
+// Runs simulation on a dedicated game thread and hands finished frames to the
+// render thread through a ring of packets. The handoff uses two monotonically
+// increasing counters, so neither side takes a lock.
+class FramePipeline : public NonCopyable {
+public:
+    static constexpr uint32 MaxFramesInFlight = 3;
+
+    using SimulateCallback = std::function<void(FramePacket& packet)>;
+    using RenderCallback = std::function<void(const FramePacket& packet)>;
+
+    FramePipeline();
+    ~FramePipeline();
+
+    // Game thread side
+    void Start(const FramePipelineConfig& config, SimulateCallback simulate);
+    void Stop();
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    // Render thread side. Returns false if no packet became ready within the
+    // configured timeout; the caller should pump messages and try again.
+    bool RenderFrame(const RenderCallback& render);
+
+    FramePipelineStats GetStats() const;
+    const FramePipelineConfig& GetConfig() const { return m_config; }
+
+private:
+    void GameThreadMain();
+    FramePacket& SlotFor(uint64 sequence) { return m_packets[sequence % m_slotCount]; }
+
+    FramePipelineConfig m_config;
+    SimulateCallback m_simulate;
+    std::thread m_gameThread;
+
+    std::array<FramePacket, MaxFramesInFlight + 1> m_packets;
+    uint32 m_slotCount{2};
+
+    // Producer and consumer cursors, each on its own cache line
+    alignas(64) std::atomic<uint64> m_published{0};
+    alignas(64) std::atomic<uint64> m_consumed{0};
+    alignas(64) std::atomic<uint32> m_renderSignal{0};
+    std::atomic<bool> m_running{false};
+
+    // Stage timings, written by their owning thread and read by anyone
+    std::atomic<float> m_simulateTimeMs{0.0f};
+    std::atomic<float> m_renderTimeMs{0.0f};
+    std::atomic<float> m_latencyMs{0.0f};
+    std::atomic<uint64> m_simulationStalls{0};
+    std::atomic<uint64> m_renderStalls{0};
+};
+
+} // namespace XeSS::Application
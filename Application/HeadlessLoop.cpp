@@ -0,0 +1,50 @@
+#include "HeadlessLoop.h"
+#include "Core/Logger.h"
+#include <chrono>
+
+namespace XeSS::Application {
+
+HeadlessLoop::HeadlessLoop(const HeadlessConfig& config)
+    : m_config(config)
+    , m_window(config.outputSize)
+    , m_swapChain(config.outputSize, config.refreshRate)
+    , m_upscaler(config.outputSize, config.renderSize) {
+    XESS_INFO("Null upscaler: {}x{} -> {}x{}", config.renderSize.width, config.renderSize.height,
+              config.outputSize.width, config.outputSize.height);
+}
+
+uint64 HeadlessLoop::Run(uint64 maxFrames, FrameStats& stats, const FrameFunc& frame) {
+    using Clock = std::chrono::steady_clock;
+
+    uint64 framesDone = 0;
+    auto lastFrameStart = Clock::now();
+    while (framesDone < maxFrames && m_window.ProcessMessages()) {
+        auto frameStart = Clock::now();
+        float deltaSeconds = std::chrono::duration<float>(frameStart - lastFrameStart).count();
+        lastFrameStart = frameStart;
+
+        stats.BeginFrame();
+        if (!frame(deltaSeconds)) {
+            // The call that ends the run is not a frame
+            break;
+        }
+        stats.EndFrame();
+        ++framesDone;
+    }
+    return framesDone;
+}
+
+void HeadlessLoop::PresentFrame() {
+    m_upscaler.Execute();
+    m_swapChain.Present(m_config.refreshRate > 0);
+}
+
+void HeadlessLoop::Resize(const Resolution& outputSize, const Resolution& renderSize) {
+    m_config.outputSize = outputSize;
+    m_config.renderSize = renderSize;
+    m_window.SetSize(outputSize);
+    m_swapChain.Resize(outputSize);
+    m_upscaler.Configure(outputSize, renderSize);
+}
+
+} // namespace XeSS::Application
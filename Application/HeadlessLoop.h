@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include "Core/FrameStats.h"
+#include "Graphics/NullDevice.h"
+#include "Graphics/NullSwapChain.h"
+#include "XeSS/NullUpscaler.h"
+#include "NullWindow.h"
+#include <functional>
+
+namespace XeSS::Application {
+
+struct HeadlessConfig {
+    Resolution outputSize{1920, 1080};
+    Resolution renderSize{1920, 1080};  // Upscaler input
+    uint32 refreshRate{0};              // Simulated vsync in Hz, 0 = uncapped
+};
+
+/**
+ * Frame loop of headless runs, over the null window, device, swap chain and
+ * upscaler. Nothing here touches D3D: Application runs its headless mode on
+ * it, and xess_headless runs it on platforms without D3D.
+ *
+ * Run() pumps the window and times each frame into a FrameStats; the frame
+ * callback simulates and ends with PresentFrame().
+ */
+class HeadlessLoop : public NonCopyable {
+public:
+    // deltaSeconds is the wall time since the previous frame started.
+    // Returning false ends the run.
+    using FrameFunc = std::function<bool(float deltaSeconds)>;
+
+    explicit HeadlessLoop(const HeadlessConfig& config);
+
+    // Runs up to maxFrames frames, fewer if the window is closed or frame
+    // returns false. Returns the number of frames completed.
+    uint64 Run(uint64 maxFrames, FrameStats& stats, const FrameFunc& frame);
+
+    // The null upscale and Present, paced to the simulated refresh rate
+    void PresentFrame();
+
+    void Resize(const Resolution& outputSize, const Resolution& renderSize);
+
+    NullWindow& GetWindow() { return m_window; }
+    Graphics::IDevice& GetDevice() { return m_device; }
+    Graphics::ISwapChain& GetSwapChain() { return m_swapChain; }
+    XeSSModule::IUpscaler& GetUpscaler() { return m_upscaler; }
+
+private:
+    HeadlessConfig m_config;
+    NullWindow m_window;
+    Graphics::NullDevice m_device;
+    Graphics::NullSwapChain m_swapChain;
+    XeSSModule::NullUpscaler m_upscaler;
+};
+
+} // namespace XeSS::Application
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "WindowInterface.h"
+#include <atomic>
+
+namespace XeSS::Application {
+
+// Headless window: no OS window or events, a fixed size, and a close request
+// that may come from any thread (a signal handler or a watchdog)
+class NullWindow : public IWindow {
+public:
+    explicit NullWindow(const Resolution& size) : m_size(size) {}
+
+    bool ProcessMessages() override { return !m_closeRequested.load(std::memory_order_relaxed); }
+    Resolution GetSize() const override { return m_size; }
+
+    void SetSize(const Resolution& size) { m_size = size; }
+    void RequestClose() { m_closeRequested.store(true, std::memory_order_relaxed); }
+
+private:
+    Resolution m_size;
+    std::atomic<bool> m_closeRequested{false};
+};
+
+} // namespace XeSS::Application
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+
+namespace XeSS::Application {
+
+// The window as the frame loop sees it, without platform types
+class IWindow : public NonCopyable {
+public:
+    virtual ~IWindow() = default;
+
+    // Handles pending OS events; false once the window was asked to close
+    virtual bool ProcessMessages() = 0;
+    virtual Resolution GetSize() const = 0;
+};
+
+} // namespace XeSS::Application
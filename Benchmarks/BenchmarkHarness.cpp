@@ -0,0 +1,435 @@
+#include "BenchmarkHarness.h"
+#include "Core/JsonWriter.h"
+#include "Core/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define XESS_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define XESS_HAS_TSC 1
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace XeSS::Benchmarks {
+
+namespace {
+    // Iteration counts grow at most this much between calibration runs
+    constexpr float64 MaxGrowth = 10.0;
+    constexpr uint64 MaxIterations = 1000000000ull;
+
+    float64 Median(std::vector<float64> values) {
+        if (values.empty()) {
+            return 0.0;
+        }
+        std::sort(values.begin(), values.end());
+        size_t mid = values.size() / 2;
+        return values.size() % 2 ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+    }
+
+    float64 Mean(const std::vector<float64>& values) {
+        if (values.empty()) {
+            return 0.0;
+        }
+        float64 total = 0.0;
+        for (float64 value : values) {
+            total += value;
+        }
+        return total / values.size();
+    }
+
+    float64 StdDev(const std::vector<float64>& values) {
+        if (values.size() < 2) {
+            return 0.0;
+        }
+        float64 mean = Mean(values);
+        float64 variance = 0.0;
+        for (float64 value : values) {
+            variance += (value - mean) * (value - mean);
+        }
+        return std::sqrt(variance / (values.size() - 1));
+    }
+
+    float64 Min(const std::vector<float64>& values) {
+        return values.empty() ? 0.0 : *std::min_element(values.begin(), values.end());
+    }
+
+    void WriteDistribution(JsonWriter& writer, const std::string& key, const std::vector<float64>& values) {
+        writer.BeginObject(key)
+            .Field("median", Median(values))
+            .Field("min", Min(values))
+            .Field("mean", Mean(values))
+            .Field("stddev", StdDev(values))
+            .Array("samples", values)
+            .EndObject();
+    }
+
+    std::string FormatNanoseconds(float64 ns) {
+        char buffer[32];
+        if (ns < 1000.0) {
+            std::snprintf(buffer, sizeof(buffer), "%.2f ns", ns);
+        } else if (ns < 1000000.0) {
+            std::snprintf(buffer, sizeof(buffer), "%.2f us", ns / 1000.0);
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "%.2f ms", ns / 1000000.0);
+        }
+        return buffer;
+    }
+
+    std::string FormatRate(float64 perSecond, const char* unit) {
+        const char* prefixes[] = {"", "k", "M", "G", "T"};
+        size_t prefix = 0;
+        while (perSecond >= 1000.0 && prefix + 1 < std::size(prefixes)) {
+            perSecond /= 1000.0;
+            ++prefix;
+        }
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.2f %s%s/s", perSecond, prefixes[prefix], unit);
+        return buffer;
+    }
+}
+
+void EscapePointer(const volatile void* pointer) {
+    // Defined out of line so the compiler must assume the pointee is read
+    [[maybe_unused]] static const volatile void* volatile sink;
+    sink = pointer;
+}
+
+// CycleCounter Implementation
+CycleCounter::CycleCounter() {
+#ifdef __linux__
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    // Counts this thread on whatever CPU it runs on
+    m_perfFd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    if (m_perfFd >= 0) {
+        uint64 probe = 0;
+        if (read(m_perfFd, &probe, sizeof(probe)) == sizeof(probe)) {
+            m_source = Source::PerfEvent;
+            return;
+        }
+        close(m_perfFd);
+        m_perfFd = -1;
+    }
+#endif
+
+#ifdef XESS_HAS_TSC
+    m_source = Source::Tsc;
+#endif
+}
+
+CycleCounter::~CycleCounter() {
+#ifdef __linux__
+    if (m_perfFd >= 0) {
+        close(m_perfFd);
+    }
+#endif
+}
+
+const char* CycleCounter::GetSourceName() const {
+    switch (m_source) {
+        case Source::PerfEvent: return "perf_event";
+        case Source::Tsc:       return "tsc";
+        default:                return "none";
+    }
+}
+
+uint64 CycleCounter::Read() const {
+    switch (m_source) {
+#ifdef __linux__
+        case Source::PerfEvent: {
+            uint64 value = 0;
+            return read(m_perfFd, &value, sizeof(value)) == sizeof(value) ? value : 0;
+        }
+#endif
+#ifdef XESS_HAS_TSC
+        case Source::Tsc:
+            return __rdtsc();
+#endif
+        default:
+            return 0;
+    }
+}
+
+// BenchmarkState Implementation
+BenchmarkState::BenchmarkState(uint64 iterations, const CycleCounter& cycles)
+    : m_cycles(cycles)
+    , m_iterations(iterations)
+    , m_remaining(iterations) {
+}
+
+void BenchmarkState::Skip(const std::string& reason) {
+    m_skipped = true;
+    m_skipReason = reason;
+}
+
+void BenchmarkState::Start() {
+    m_started = true;
+    m_startCycles = m_cycles.Read();
+    m_startTime = Clock::now();
+}
+
+void BenchmarkState::Stop() {
+    if (!m_started || m_stopped) {
+        return;
+    }
+    Clock::time_point end = Clock::now();
+    uint64 endCycles = m_cycles.Read();
+
+    m_stopped = true;
+    m_elapsedSeconds = std::chrono::duration<float64>(end - m_startTime).count();
+    m_elapsedCycles = endCycles - m_startCycles;
+}
+
+// BenchmarkRegistry Implementation
+BenchmarkRegistry& BenchmarkRegistry::Instance() {
+    static BenchmarkRegistry instance;
+    return instance;
+}
+
+void BenchmarkRegistry::Register(const std::string& name, BenchmarkFunction function,
+                                 BenchmarkHook setUp, BenchmarkHook tearDown) {
+    m_benchmarks.push_back({name, function, setUp, tearDown});
+}
+
+// Harness Implementation
+Harness::Harness(HarnessOptions options)
+    : m_options(std::move(options)) {
+    m_options.repetitions = std::max<uint32>(m_options.repetitions, 1);
+}
+
+bool Harness::PinCurrentThread(int32 cpu) {
+    if (cpu < 0) {
+        return false;
+    }
+#ifdef _WIN32
+    if (cpu >= 64) {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+bool Harness::Run() {
+    if (m_options.pinCpu >= 0) {
+        m_pinned = PinCurrentThread(m_options.pinCpu);
+        if (!m_pinned) {
+            XESS_WARNING("Could not pin benchmark thread to CPU {}", m_options.pinCpu);
+        }
+    }
+
+#ifndef NDEBUG
+    XESS_WARNING("Benchmarks were built without optimizations; timings are not representative");
+#endif
+
+    PrintHeader();
+
+    m_results.clear();
+    for (const BenchmarkInfo& benchmark : BenchmarkRegistry::Instance().GetBenchmarks()) {
+        if (!m_options.filter.empty() && benchmark.name.find(m_options.filter) == std::string::npos) {
+            continue;
+        }
+        m_results.push_back(RunBenchmark(benchmark));
+        PrintResult(m_results.back());
+    }
+
+    if (m_results.empty()) {
+        XESS_ERROR("No benchmark matches '{}'", m_options.filter);
+        return false;
+    }
+
+    return m_options.jsonOutput.empty() || WriteJson();
+}
+
+BenchmarkState Harness::RunOnce(const BenchmarkInfo& benchmark, uint64 iterations) const {
+    BenchmarkState state(iterations, m_cycles);
+    benchmark.function(state);
+    return state;
+}
+
+BenchmarkResult Harness::RunBenchmark(const BenchmarkInfo& benchmark) {
+    if (benchmark.setUp) {
+        benchmark.setUp();
+    }
+    BenchmarkResult result = RunRepetitions(benchmark);
+    if (benchmark.tearDown) {
+        benchmark.tearDown();
+    }
+    return result;
+}
+
+BenchmarkResult Harness::RunRepetitions(const BenchmarkInfo& benchmark) {
+    BenchmarkResult result;
+    result.name = benchmark.name;
+
+    // Grows the iteration count until a single run lasts targetSeconds
+    uint64 iterations = 1;
+    auto calibrate = [&](float64 targetSeconds, float64 budgetSeconds) -> bool {
+        float64 spent = 0.0;
+        while (true) {
+            BenchmarkState state = RunOnce(benchmark, iterations);
+            if (state.IsSkipped()) {
+                result.skipped = true;
+                result.skipReason = state.GetSkipReason();
+                return false;
+            }
+
+            float64 elapsed = state.GetElapsedSeconds();
+            spent += elapsed;
+            if (elapsed >= targetSeconds || spent >= budgetSeconds || iterations >= MaxIterations) {
+                return true;
+            }
+
+            float64 growth = elapsed > 0.0 ? 1.4 * targetSeconds / elapsed : MaxGrowth;
+            growth = std::clamp(growth, 2.0, MaxGrowth);
+            iterations = std::min<uint64>(static_cast<uint64>(iterations * growth), MaxIterations);
+        }
+    };
+
+    // Warmup brings caches, branch predictors and clocks to steady state;
+    // calibration then settles the count used for every repetition
+    if (!calibrate(m_options.warmupSeconds, m_options.warmupSeconds) ||
+        !calibrate(m_options.minTimeSeconds, 1e9)) {
+        return result;
+    }
+
+    result.iterations = iterations;
+    for (uint32 repetition = 0; repetition < m_options.repetitions; ++repetition) {
+        BenchmarkState state = RunOnce(benchmark, iterations);
+        result.nsPerIteration.push_back(state.GetElapsedSeconds() * 1e9 / iterations);
+        if (m_cycles.IsAvailable()) {
+            result.cyclesPerIteration.push_back(static_cast<float64>(state.GetElapsedCycles()) / iterations);
+        }
+        result.itemsPerIteration = state.GetItemsPerIteration();
+        result.bytesPerIteration = state.GetBytesPerIteration();
+    }
+
+    return result;
+}
+
+void Harness::PrintHeader() const {
+    std::printf("Cycle counter: %s, CPU: %s, %u repetitions of >= %.2fs\n",
+                m_cycles.GetSourceName(),
+                m_pinned ? std::to_string(m_options.pinCpu).c_str() : "not pinned",
+                m_options.repetitions, m_options.minTimeSeconds);
+    std::printf("%-40s %14s %10s %12s %12s %16s\n",
+                "Benchmark", "Iterations", "CV", "Time", "Cycles", "Throughput");
+    std::printf("%s\n", std::string(109, '-').c_str());
+}
+
+void Harness::PrintResult(const BenchmarkResult& result) const {
+    if (result.skipped) {
+        std::printf("%-40s skipped: %s\n", result.name.c_str(), result.skipReason.c_str());
+        return;
+    }
+
+    float64 ns = Median(result.nsPerIteration);
+    float64 mean = Mean(result.nsPerIteration);
+    float64 cv = mean > 0.0 ? 100.0 * StdDev(result.nsPerIteration) / mean : 0.0;
+
+    char cycles[32] = "-";
+    if (!result.cyclesPerIteration.empty()) {
+        std::snprintf(cycles, sizeof(cycles), "%.1f", Median(result.cyclesPerIteration));
+    }
+
+    std::string throughput;
+    if (ns > 0.0 && result.bytesPerIteration > 0) {
+        throughput = FormatRate(result.bytesPerIteration * 1e9 / ns, "B");
+    } else if (ns > 0.0 && result.itemsPerIteration > 0) {
+        throughput = FormatRate(result.itemsPerIteration * 1e9 / ns, "items");
+    }
+
+    std::printf("%-40s %14llu %9.1f%% %12s %12s %16s\n",
+                result.name.c_str(), static_cast<unsigned long long>(result.iterations), cv,
+                FormatNanoseconds(ns).c_str(), cycles, throughput.c_str());
+    std::fflush(stdout);
+}
+
+bool Harness::WriteJson() const {
+    char date[32] = {};
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    JsonWriter writer;
+    writer.BeginObject();
+
+    writer.BeginObject("context")
+        .Field("date", std::string(date))
+        .Field("cycle_counter", m_cycles.GetSourceName())
+        .Field("pinned_cpu", m_pinned ? m_options.pinCpu : -1)
+        .Field("hardware_threads", std::thread::hardware_concurrency())
+        .Field("repetitions", m_options.repetitions)
+        .Field("min_time_s", m_options.minTimeSeconds)
+        .Field("warmup_s", m_options.warmupSeconds)
+#ifdef NDEBUG
+        .Field("optimized", true)
+#else
+        .Field("optimized", false)
+#endif
+        .EndObject();
+
+    writer.BeginArray("benchmarks");
+    for (const BenchmarkResult& result : m_results) {
+        writer.BeginObject().Field("name", result.name);
+        if (result.skipped) {
+            writer.Field("skipped", result.skipReason).EndObject();
+            continue;
+        }
+
+        writer.Field("iterations", result.iterations);
+        WriteDistribution(writer, "ns_per_iteration", result.nsPerIteration);
+        if (!result.cyclesPerIteration.empty()) {
+            WriteDistribution(writer, "cycles_per_iteration", result.cyclesPerIteration);
+        }
+
+        float64 ns = Median(result.nsPerIteration);
+        if (ns > 0.0 && result.itemsPerIteration > 0) {
+            writer.Field("items_per_second", result.itemsPerIteration * 1e9 / ns);
+        }
+        if (ns > 0.0 && result.bytesPerIteration > 0) {
+            writer.Field("bytes_per_second", result.bytesPerIteration * 1e9 / ns);
+        }
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+
+    if (!writer.WriteToFile(m_options.jsonOutput)) {
+        return false;
+    }
+    XESS_INFO("Benchmark results written to {}", m_options.jsonOutput);
+    return true;
+}
+
+} // namespace XeSS::Benchmarks
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace XeSS::Benchmarks {
+
+// Keeps the compiler from discarding a value or the work that produced it
+void EscapePointer(const volatile void* pointer);
+
+template<typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    EscapePointer(&reinterpret_cast<const volatile char&>(value));
+#endif
+}
+
+inline void ClobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    EscapePointer(nullptr);
+#endif
+}
+
+/**
+ * Reads the CPU cycle counter of the calling thread. Uses the hardware
+ * cycle counter through perf_event on Linux when the kernel allows it,
+ * otherwise the time stamp counter (reference cycles) on x86.
+ */
+class CycleCounter : public NonCopyable {
+public:
+    CycleCounter();
+    ~CycleCounter();
+
+    bool IsAvailable() const { return m_source != Source::None; }
+    const char* GetSourceName() const;
+    uint64 Read() const;
+
+private:
+    enum class Source { None, PerfEvent, Tsc };
+
+    Source m_source{Source::None};
+    int m_perfFd{-1};
+};
+
+// Per-run state handed to a benchmark body. Timing starts at the first
+// KeepRunning() call, so setup before the loop is not measured.
+class BenchmarkState {
+public:
+    BenchmarkState(uint64 iterations, const CycleCounter& cycles);
+
+    bool KeepRunning() {
+        if (m_remaining > 0) {
+            if (!m_started) {
+                Start();
+            }
+            --m_remaining;
+            return true;
+        }
+        Stop();
+        return false;
+    }
+
+    uint64 GetIterations() const { return m_iterations; }
+
+    // Throughput units processed by one iteration
+    void SetItemsPerIteration(uint64 items) { m_itemsPerIteration = items; }
+    void SetBytesPerIteration(uint64 bytes) { m_bytesPerIteration = bytes; }
+
+    // Marks the benchmark as unable to run (missing device, ...)
+    void Skip(const std::string& reason);
+
+    float64 GetElapsedSeconds() const { return m_elapsedSeconds; }
+    uint64 GetElapsedCycles() const { return m_elapsedCycles; }
+    uint64 GetItemsPerIteration() const { return m_itemsPerIteration; }
+    uint64 GetBytesPerIteration() const { return m_bytesPerIteration; }
+    bool IsSkipped() const { return m_skipped; }
+    const std::string& GetSkipReason() const { return m_skipReason; }
+
+private:
+    void Start();
+    void Stop();
+
+    using Clock = std::chrono::steady_clock;
+
+    const CycleCounter& m_cycles;
+    uint64 m_iterations;
+    uint64 m_remaining;
+    bool m_started{false};
+    bool m_stopped{false};
+
+    Clock::time_point m_startTime;
+    uint64 m_startCycles{0};
+    float64 m_elapsedSeconds{0.0};
+    uint64 m_elapsedCycles{0};
+
+    uint64 m_itemsPerIteration{0};
+    uint64 m_bytesPerIteration{0};
+    bool m_skipped{false};
+    std::string m_skipReason;
+};
+
+using BenchmarkFunction = void (*)(BenchmarkState&);
+using BenchmarkHook = void (*)();
+
+// setUp and tearDown run once per benchmark, around warmup, calibration and
+// every repetition, for state too costly to rebuild on each run
+struct BenchmarkInfo {
+    std::string name;
+    BenchmarkFunction function;
+    BenchmarkHook setUp{nullptr};
+    BenchmarkHook tearDown{nullptr};
+};
+
+// Benchmarks register themselves at static initialization through
+// XESS_BENCHMARK; names are "area.case" so filters can select a group
+class BenchmarkRegistry {
+public:
+    static BenchmarkRegistry& Instance();
+
+    void Register(const std::string& name, BenchmarkFunction function,
+                  BenchmarkHook setUp = nullptr, BenchmarkHook tearDown = nullptr);
+    const std::vector<BenchmarkInfo>& GetBenchmarks() const { return m_benchmarks; }
+
+private:
+    std::vector<BenchmarkInfo> m_benchmarks;
+};
+
+struct BenchmarkRegistration {
+    BenchmarkRegistration(const char* name, BenchmarkFunction function,
+                          BenchmarkHook setUp = nullptr, BenchmarkHook tearDown = nullptr) {
+        BenchmarkRegistry::Instance().Register(name, function, setUp, tearDown);
+    }
+};
+
+#define XESS_BENCHMARK_CONCAT_INNER(a, b) a##b
+#define XESS_BENCHMARK_CONCAT(a, b) XESS_BENCHMARK_CONCAT_INNER(a, b)
+
+#define XESS_BENCHMARK(name) \
+    static void XESS_BENCHMARK_CONCAT(XeSSBenchmark_, __LINE__)(::XeSS::Benchmarks::BenchmarkState& state); \
+    static ::XeSS::Benchmarks::BenchmarkRegistration XESS_BENCHMARK_CONCAT(XeSSBenchmarkRegistration_, __LINE__)( \
+        name, &XESS_BENCHMARK_CONCAT(XeSSBenchmark_, __LINE__)); \
+    static void XESS_BENCHMARK_CONCAT(XeSSBenchmark_, __LINE__)(::XeSS::Benchmarks::BenchmarkState& state)
+
+// XESS_BENCHMARK with setUp/tearDown hooks, see BenchmarkInfo
+#define XESS_BENCHMARK_WITH_HOOKS(name, setUp, tearDown) \
+    static void XESS_BENCHMARK_CONCAT(XeSSBenchmark_, __LINE__)(::XeSS::Benchmarks::BenchmarkState& state); \
+    static ::XeSS::Benchmarks::BenchmarkRegistration XESS_BENCHMARK_CONCAT(XeSSBenchmarkRegistration_, __LINE__)( \
+        name, &XESS_BENCHMARK_CONCAT(XeSSBenchmark_, __LINE__), setUp, tearDown); \
+    static void XESS_BENCHMARK_CONCAT(XeSSBenchmark_, __LINE__)(::XeSS::Benchmarks::BenchmarkState& state)
+
+struct HarnessOptions {
+    std::string filter;             // Substring of the benchmark name; empty runs all
+    float64 warmupSeconds{0.05};    // Discarded runs before calibration
+    float64 minTimeSeconds{0.2};    // Target duration of one repetition
+    uint32 repetitions{5};
+    int32 pinCpu{-1};               // Pin the benchmark thread to this CPU; -1 leaves it floating
+    std::string jsonOutput;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    uint64 iterations{0};
+    std::vector<float64> nsPerIteration;        // One entry per repetition
+    std::vector<float64> cyclesPerIteration;
+    uint64 itemsPerIteration{0};
+    uint64 bytesPerIteration{0};
+    bool skipped{false};
+    std::string skipReason;
+};
+
+/**
+ * Runs registered benchmarks: a warmup phase, auto-scaling of the iteration
+ * count until one run lasts minTimeSeconds, then a fixed number of timed
+ * repetitions at that count. Results are printed as a table and optionally
+ * written as JSON.
+ */
+class Harness : public NonCopyable {
+public:
+    explicit Harness(HarnessOptions options);
+
+    // Returns false if nothing matched the filter or the JSON file failed
+    bool Run();
+
+    const std::vector<BenchmarkResult>& GetResults() const { return m_results; }
+
+    static bool PinCurrentThread(int32 cpu);
+
+private:
+    BenchmarkResult RunBenchmark(const BenchmarkInfo& benchmark);
+    BenchmarkResult RunRepetitions(const BenchmarkInfo& benchmark);
+    BenchmarkState RunOnce(const BenchmarkInfo& benchmark, uint64 iterations) const;
+    void PrintHeader() const;
+    void PrintResult(const BenchmarkResult& result) const;
+    bool WriteJson() const;
+
+    HarnessOptions m_options;
+    CycleCounter m_cycles;
+    bool m_pinned{false};
+    std::vector<BenchmarkResult> m_results;
+};
+
+} // namespace XeSS::Benchmarks
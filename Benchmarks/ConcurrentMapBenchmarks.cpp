@@ -0,0 +1,119 @@
+#include "BenchmarkHarness.h"
+#include "Core/ConcurrentHashMap.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace XeSS;
+using namespace XeSS::Benchmarks;
+
+namespace {
+    constexpr uint32 kKeyCount = 512;
+
+    // Stand-in for ShaderKey, which needs the D3D headers: a source string
+    // compared on a hash match, with the hash computed up front
+    struct CacheKey {
+        std::string source;
+        uint64 hash;
+
+        bool operator==(const CacheKey& other) const { return hash == other.hash && source == other.source; }
+
+        struct Hash {
+            size_t operator()(const CacheKey& key) const { return static_cast<size_t>(key.hash); }
+        };
+    };
+
+    using CacheValue = std::shared_ptr<const std::vector<uint8>>;
+
+    std::vector<CacheKey> MakeKeys() {
+        std::vector<CacheKey> keys;
+        for (uint32 i = 0; i < kKeyCount; ++i) {
+            std::string source = "float4 main() : SV_Target { return " + std::to_string(i) + "; }";
+            keys.push_back({source, std::hash<std::string>()(source)});
+        }
+        return keys;
+    }
+
+    // What ShaderManager used before: one mutex around an unordered_map
+    class MutexCache {
+    public:
+        void Insert(const CacheKey& key, CacheValue value) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_map[key] = std::move(value);
+        }
+        bool Find(const CacheKey& key, CacheValue& value) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_map.find(key);
+            if (it == m_map.end()) {
+                return false;
+            }
+            value = it->second;
+            return true;
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        std::unordered_map<CacheKey, CacheValue, CacheKey::Hash> m_map;
+    };
+
+    class ShardedCache {
+    public:
+        void Insert(const CacheKey& key, CacheValue value) { m_map.InsertOrAssign(key, std::move(value)); }
+        bool Find(const CacheKey& key, CacheValue& value) const { return m_map.Find(key, value); }
+
+    private:
+        ConcurrentHashMap<CacheKey, CacheValue, CacheKey::Hash> m_map;
+    };
+
+    // The measured thread looks up keys while Threads - 1 others hammer the
+    // same cache, so ns/iteration is one lookup's latency under contention
+    template <typename Cache, uint32 Threads>
+    void ContendedLookup(BenchmarkState& state) {
+        std::vector<CacheKey> keys = MakeKeys();
+        Cache cache;
+        for (const CacheKey& key : keys) {
+            cache.Insert(key, std::make_shared<const std::vector<uint8>>(1024));
+        }
+
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> background;
+        for (uint32 t = 1; t < Threads; ++t) {
+            background.emplace_back([&cache, &keys, &stop, t]() {
+                CacheValue value;
+                for (uint32 i = t * 97; !stop.load(std::memory_order_relaxed); ++i) {
+                    cache.Find(keys[i % kKeyCount], value);
+                }
+            });
+        }
+
+        CacheValue value;
+        uint32 i = 0;
+        while (state.KeepRunning()) {
+            DoNotOptimize(cache.Find(keys[i++ % kKeyCount], value));
+        }
+
+        stop.store(true, std::memory_order_relaxed);
+        for (std::thread& thread : background) {
+            thread.join();
+        }
+    }
+
+    const BenchmarkRegistration s_registrations[] = {
+        {"shader_cache.lookup_mutex_1t", &ContendedLookup<MutexCache, 1>},
+        {"shader_cache.lookup_mutex_2t", &ContendedLookup<MutexCache, 2>},
+        {"shader_cache.lookup_mutex_4t", &ContendedLookup<MutexCache, 4>},
+        {"shader_cache.lookup_mutex_8t", &ContendedLookup<MutexCache, 8>},
+        {"shader_cache.lookup_mutex_16t", &ContendedLookup<MutexCache, 16>},
+        {"shader_cache.lookup_mutex_32t", &ContendedLookup<MutexCache, 32>},
+        {"shader_cache.lookup_sharded_1t", &ContendedLookup<ShardedCache, 1>},
+        {"shader_cache.lookup_sharded_2t", &ContendedLookup<ShardedCache, 2>},
+        {"shader_cache.lookup_sharded_4t", &ContendedLookup<ShardedCache, 4>},
+        {"shader_cache.lookup_sharded_8t", &ContendedLookup<ShardedCache, 8>},
+        {"shader_cache.lookup_sharded_16t", &ContendedLookup<ShardedCache, 16>},
+        {"shader_cache.lookup_sharded_32t", &ContendedLookup<ShardedCache, 32>},
+    };
+}
@@ -0,0 +1,238 @@
+#include "BenchmarkHarness.h"
+#include "Core/Logger.h"
+#include "Core/Lz.h"
+#include "Core/Metrics.h"
+#include "Core/SPSCQueue.h"
+#include "Core/Task.h"
+#include "Core/Utils.h"
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace XeSS;
+using namespace XeSS::Benchmarks;
+
+// Logger
+
+XESS_BENCHMARK("logger.format_no_args") {
+    while (state.KeepRunning()) {
+        DoNotOptimize(Logger::Format("Frame presented"));
+    }
+}
+
+XESS_BENCHMARK("logger.format_3_args") {
+    std::string name = "ps_tonemap";
+    uint32 frame = 1234;
+    float64 ms = 16.667;
+    while (state.KeepRunning()) {
+        DoNotOptimize(Logger::Format("Shader {} compiled at frame {} in {} ms", name, frame, ms));
+    }
+}
+
+// A message below the log level: what every disabled XESS_DEBUG costs
+XESS_BENCHMARK("logger.filtered_level") {
+    Logger& logger = Logger::Instance();
+    LogLevel previous = logger.GetLevel();
+    logger.SetLevel(LogLevel::Info);
+    uint32 frame = 0;
+    while (state.KeepRunning()) {
+        XESS_DEBUG("Frame {} submitted", ++frame);
+    }
+    logger.SetLevel(previous);
+}
+
+// A site past its burst: the token bucket check without formatting
+XESS_BENCHMARK("logger.rate_limited_suppressed") {
+    Logger& logger = Logger::Instance();
+    LogLevel previous = logger.GetLevel();
+    logger.SetLevel(LogLevel::Critical);
+    static LogSite site;
+    uint32 frame = 0;
+    while (state.KeepRunning()) {
+        // Level filtering happens in Log(), so the one message that passes
+        // the bucket is dropped silently
+        logger.LogAtSite(site, LogLevel::Warning, 1, 1, "Bind failed at frame {}", ++frame);
+    }
+    logger.SetLevel(previous);
+}
+
+// Halton jitter
+
+XESS_BENCHMARK("halton.van_der_corput") {
+    uint32 index = 1;
+    while (state.KeepRunning()) {
+        DoNotOptimize(Utils::GetVanDerCorput(index++, 3));
+    }
+}
+
+XESS_BENCHMARK("halton.generate_32") {
+    state.SetItemsPerIteration(32);
+    while (state.KeepRunning()) {
+        DoNotOptimize(Utils::GenerateHalton(2, 3, 1, 32));
+    }
+}
+
+XESS_BENCHMARK("halton.generate_1024") {
+    state.SetItemsPerIteration(1024);
+    while (state.KeepRunning()) {
+        DoNotOptimize(Utils::GenerateHalton(2, 3, 1, 1024));
+    }
+}
+
+// UTF-8 conversion
+
+namespace {
+    // Shader-like ASCII text, optionally with a non-ASCII comment every line
+    std::string MakeSourceText(size_t size, bool mixed) {
+        std::string line = mixed ? "float4 color = tex.Sample(s, uv); // \xC3\xA9t\xC3\xA9 \xE2\x9C\x93\n"
+                                 : "float4 color = tex.Sample(s, uv); // sample the input\n";
+        std::string text;
+        while (text.size() + line.size() <= size) {
+            text += line;
+        }
+        return text;
+    }
+}
+
+XESS_BENCHMARK("utf.utf8_to_utf16_ascii_64k") {
+    std::string text = MakeSourceText(64 * 1024, false);
+    state.SetBytesPerIteration(text.size());
+    while (state.KeepRunning()) {
+        DoNotOptimize(Utils::Utf8ToUtf16(text));
+    }
+}
+
+XESS_BENCHMARK("utf.utf8_to_utf16_mixed_64k") {
+    std::string text = MakeSourceText(64 * 1024, true);
+    state.SetBytesPerIteration(text.size());
+    while (state.KeepRunning()) {
+        DoNotOptimize(Utils::Utf8ToUtf16(text));
+    }
+}
+
+XESS_BENCHMARK("utf.utf16_to_utf8_ascii_64k") {
+    std::u16string text = Utils::Utf8ToUtf16(MakeSourceText(64 * 1024, false));
+    state.SetBytesPerIteration(text.size() * sizeof(char16_t));
+    while (state.KeepRunning()) {
+        DoNotOptimize(Utils::Utf16ToUtf8(text));
+    }
+}
+
+XESS_BENCHMARK("utf.string_to_wide_short") {
+    std::string name = "Shaders/PostProcess/Tonemap.hlsl";
+    while (state.KeepRunning()) {
+        DoNotOptimize(Utils::StringToWide(name));
+    }
+}
+
+// Metrics
+
+XESS_BENCHMARK("metrics.counter_add") {
+    static MetricCounter& counter = MetricsRegistry::Instance().Counter(
+        "bench.counter", "Benchmark counter");
+    while (state.KeepRunning()) {
+        counter.Add();
+    }
+}
+
+XESS_BENCHMARK("metrics.histogram_observe") {
+    static MetricHistogram& histogram = MetricsRegistry::Instance().Histogram(
+        "bench.histogram_ms", "Benchmark histogram", MetricHistogram::ExponentialBounds(1.0, 1.25, 24));
+    float64 value = 0.5;
+    while (state.KeepRunning()) {
+        histogram.Observe(value);
+        value = value < 100.0 ? value * 1.1 : 0.5;
+    }
+}
+
+// Input queue
+
+XESS_BENCHMARK("spsc_queue.push_pop") {
+    SPSCQueue<uint64> queue(1024);
+    uint64 value = 0;
+    uint64 out = 0;
+    while (state.KeepRunning()) {
+        queue.TryPush(value++);
+        queue.TryPop(out);
+        DoNotOptimize(out);
+    }
+}
+
+// Coroutine tasks (JobSystem not started, so each task runs inline)
+
+namespace {
+    Task<uint32> Leaf(uint32 value) {
+        co_return value + 1;
+    }
+
+    Task<uint32> Chain(uint32 depth) {
+        uint32 sum = 0;
+        for (uint32 i = 0; i < depth; ++i) {
+            sum += co_await Leaf(i);
+        }
+        co_return sum;
+    }
+}
+
+// Frame allocation, scheduling and Get() of one task
+XESS_BENCHMARK("task.create_get") {
+    uint32 value = 0;
+    while (state.KeepRunning()) {
+        value = Leaf(value).Get();
+    }
+    DoNotOptimize(value);
+}
+
+XESS_BENCHMARK("task.await_chain_16") {
+    while (state.KeepRunning()) {
+        DoNotOptimize(Chain(16).Get());
+    }
+}
+
+// LZ codec, on bytecode-shaped input: instructions drawn from a small set
+// of 16-byte encodings, one word in eight a random immediate
+
+namespace {
+    std::vector<uint8> MakeBytecodeLike(size_t size) {
+        std::mt19937 rng(7);
+        uint32 instructions[64][4];
+        for (auto& instruction : instructions) {
+            for (uint32& word : instruction) {
+                word = ((rng() % 24) << 24) | ((rng() % 16) << 8) | (rng() % 4);
+            }
+        }
+
+        std::vector<uint8> data(size);
+        for (size_t i = 0; i + 16 <= size; i += 16) {
+            uint32 words[4];
+            memcpy(words, instructions[rng() % 64], sizeof(words));
+            if (rng() % 2 == 0) {
+                words[rng() % 4] = rng();
+            }
+            memcpy(data.data() + i, words, sizeof(words));
+        }
+        return data;
+    }
+}
+
+XESS_BENCHMARK("lz.compress_64k") {
+    std::vector<uint8> input = MakeBytecodeLike(64 * 1024);
+    std::vector<uint8> output(Lz::CompressBound(input.size()));
+    state.SetBytesPerIteration(input.size());
+    while (state.KeepRunning()) {
+        DoNotOptimize(Lz::Compress(input.data(), input.size(), output.data(), output.size()));
+    }
+}
+
+XESS_BENCHMARK("lz.decompress_64k") {
+    std::vector<uint8> input = MakeBytecodeLike(64 * 1024);
+    std::vector<uint8> compressed(Lz::CompressBound(input.size()));
+    compressed.resize(Lz::Compress(input.data(), input.size(), compressed.data(), compressed.size()));
+
+    std::vector<uint8> output(input.size());
+    state.SetBytesPerIteration(input.size());
+    while (state.KeepRunning()) {
+        DoNotOptimize(Lz::Decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+    }
+}
@@ -0,0 +1,78 @@
+#include "BenchmarkHarness.h"
+#include "Core/FileSystem.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace XeSS;
+using namespace XeSS::Benchmarks;
+
+namespace {
+    constexpr uint32 kFileSize = 256 * 1024;
+    constexpr uint32 kBatchSize = 16;
+
+    std::string FilePath(uint32 index) {
+        return (std::filesystem::temp_directory_path() / ("xess_benchmark_fs_" + std::to_string(index) + ".bin")).string();
+    }
+
+    // Writes the batch for one benchmark and deletes it when the benchmark
+    // returns. The files stay in the page cache between runs, so this
+    // measures the read path rather than the disk.
+    class ScopedTestFiles {
+    public:
+        ScopedTestFiles() {
+            std::string contents(kFileSize, '\0');
+            for (uint32 i = 0; i < kFileSize; ++i) {
+                contents[i] = static_cast<char>(i * 31);
+            }
+            for (uint32 i = 0; i < kBatchSize; ++i) {
+                std::ofstream file(FilePath(i), std::ios::binary);
+                file.write(contents.data(), contents.size());
+            }
+        }
+        ~ScopedTestFiles() {
+            for (uint32 i = 0; i < kBatchSize; ++i) {
+                std::error_code error;
+                std::filesystem::remove(FilePath(i), error);
+            }
+        }
+        ScopedTestFiles(const ScopedTestFiles&) = delete;
+        ScopedTestFiles& operator=(const ScopedTestFiles&) = delete;
+    };
+}
+
+XESS_BENCHMARK("fs.read_sync_256k") {
+    ScopedTestFiles files;
+    std::string path = FilePath(0);
+    std::vector<uint8> data;
+    state.SetBytesPerIteration(kFileSize);
+    while (state.KeepRunning()) {
+        FileSystem::Instance().ReadFile(path, data);
+        DoNotOptimize(data.data());
+    }
+}
+
+// One submission of the whole batch, waited on; completions run on the I/O thread
+XESS_BENCHMARK("fs.read_batch_16x256k") {
+    ScopedTestFiles files;
+    std::vector<std::string> paths;
+    for (uint32 i = 0; i < kBatchSize; ++i) {
+        paths.push_back(FilePath(i));
+    }
+    state.SetBytesPerIteration(static_cast<uint64>(kFileSize) * kBatchSize);
+    while (state.KeepRunning()) {
+        FileSystem::Instance().ReadBatchAsync(paths, [](std::vector<FileReadResult>&& results) {
+            DoNotOptimize(results.data());
+        });
+        FileSystem::Instance().WaitIdle();
+    }
+}
+
+// Mapping a file that is already mapped: one stat to revalidate, then the shared view
+XESS_BENCHMARK("fs.map_shared") {
+    ScopedTestFiles files;     // Declared first, so the mapping is released before the delete
+    std::string path = FilePath(0);
+    std::shared_ptr<const MappedFile> held = FileSystem::Instance().Map(path);
+    while (state.KeepRunning()) {
+        DoNotOptimize(FileSystem::Instance().Map(path));
+    }
+}
@@ -0,0 +1,185 @@
+#include "BenchmarkHarness.h"
+#include "Device.h"
+#include "Shader.h"
+#include "ShaderManager.h"
+#include "Core/Exception.h"
+#include "Core/Logger.h"
+#include <filesystem>
+#include <memory>
+#include <unordered_map>
+
+using namespace XeSS;
+using namespace XeSS::Benchmarks;
+using namespace XeSS::Graphics;
+
+namespace {
+    const std::string TestShaderSource = R"(
+        cbuffer Params : register(b0) { float4 testData[64]; }
+        float4 main(float2 uv : TEXCOORD0) : SV_Target { return testData[0] * uv.x; }
+    )";
+
+    std::filesystem::path BenchmarkCacheDirectory() {
+        return std::filesystem::temp_directory_path() / "xess_benchmark_cache";
+    }
+
+    std::vector<uint8> MakeBytecode(size_t size) {
+        std::vector<uint8> bytecode(size);
+        for (size_t i = 0; i < size; ++i) {
+            bytecode[i] = static_cast<uint8>(i * 31);
+        }
+        return bytecode;
+    }
+
+    // Shared WARP device; its deferred context records commands without
+    // ever reaching a GPU, so Apply() is measured on its own
+    struct ApplyFixture {
+        Device device;
+        ComPtr<ID3D11DeviceContext> context;
+        ShaderBinding binding;
+        ShaderParameters parameters;
+
+        ApplyFixture() {
+            device.Initialize(-1, true, false, true);
+            if (FAILED(device.GetDevice()->CreateDeferredContext(0, &context))) {
+                throw Exception("Failed to create deferred context");
+            }
+
+            for (uint32 i = 0; i < 2; ++i) {
+                std::string name = "Constants" + std::to_string(i);
+                binding.constantBuffers.push_back({name, i, 1, D3D_SIT_CBUFFER, 256});
+                std::vector<uint8> data(256, static_cast<uint8>(i));
+                parameters.SetConstantBuffer(name, data.data(), static_cast<uint32>(data.size()));
+            }
+            for (uint32 i = 0; i < 4; ++i) {
+                std::string name = "Texture" + std::to_string(i);
+                binding.textures.push_back({name, i, 1, D3D_SIT_TEXTURE, 0});
+                parameters.SetTexture(name, nullptr);
+            }
+            for (uint32 i = 0; i < 2; ++i) {
+                std::string name = "Sampler" + std::to_string(i);
+                binding.samplers.push_back({name, i, 1, D3D_SIT_SAMPLER, 0});
+                parameters.SetSampler(name, nullptr);
+            }
+
+            parameters.SetDevice(&device);
+        }
+
+        // Deferred contexts keep every recorded call; drop them periodically
+        void Flush() {
+            ComPtr<ID3D11CommandList> commandList;
+            context->FinishCommandList(FALSE, &commandList);
+        }
+    };
+
+    ApplyFixture* GetApplyFixture(BenchmarkState& state) {
+        static std::unique_ptr<ApplyFixture> fixture;
+        static bool attempted = false;
+        if (!attempted) {
+            attempted = true;
+            try {
+                fixture = std::make_unique<ApplyFixture>();
+            }
+            catch (const std::exception& e) {
+                XESS_WARNING("ShaderParameters benchmarks disabled: {}", e.what());
+            }
+        }
+        if (!fixture) {
+            state.Skip("no D3D11 WARP device");
+        }
+        return fixture.get();
+    }
+}
+
+// ShaderCache
+
+XESS_BENCHMARK("shader_cache.memory_hit") {
+    ShaderCache cache;
+    cache.SetCacheDirectory(BenchmarkCacheDirectory().string());
+    cache.CacheShader("Shaders/Tonemap.hlsl", 0x1234, MakeBytecode(16 * 1024));
+
+    std::vector<uint8> bytecode;
+    state.SetBytesPerIteration(16 * 1024);
+    while (state.KeepRunning()) {
+        DoNotOptimize(cache.GetCachedShader("Shaders/Tonemap.hlsl", 0x1234, bytecode));
+    }
+}
+
+// A hash mismatch falls through to the disk lookup
+XESS_BENCHMARK("shader_cache.miss") {
+    ShaderCache cache;
+    cache.SetCacheDirectory(BenchmarkCacheDirectory().string());
+
+    std::vector<uint8> bytecode;
+    while (state.KeepRunning()) {
+        DoNotOptimize(cache.GetCachedShader("Shaders/Missing.hlsl", 0x5678, bytecode));
+    }
+}
+
+// ShaderKey
+
+XESS_BENCHMARK("shader_key.construct_hash") {
+    CompileOptions options;
+    options.macros = {{"USE_JITTER", "1"}, {"QUALITY", "3"}};
+    state.SetBytesPerIteration(TestShaderSource.size());
+    while (state.KeepRunning()) {
+        ShaderKey key(TestShaderSource, "main", ShaderType::Pixel, options);
+        DoNotOptimize(key.hash);
+    }
+}
+
+XESS_BENCHMARK("shader_key.map_lookup") {
+    std::unordered_map<ShaderKey, uint32, ShaderKey::Hash> map;
+    std::vector<ShaderKey> keys;
+    for (uint32 i = 0; i < 256; ++i) {
+        CompileOptions options;
+        options.macros = {{"VARIANT", std::to_string(i)}};
+        keys.emplace_back(TestShaderSource, "main", ShaderType::Pixel, options);
+        map.emplace(keys.back(), i);
+    }
+
+    size_t index = 0;
+    while (state.KeepRunning()) {
+        DoNotOptimize(map.find(keys[index]));
+        index = (index + 1) & 255;
+    }
+}
+
+// ShaderParameters
+
+XESS_BENCHMARK("shader_parameters.apply_clean") {
+    ApplyFixture* fixture = GetApplyFixture(state);
+    if (!fixture) {
+        return;
+    }
+
+    uint32 recorded = 0;
+    while (state.KeepRunning()) {
+        fixture->parameters.Apply(fixture->context.Get(), fixture->binding, ShaderType::Pixel);
+        if (++recorded == 4096) {
+            fixture->Flush();
+            recorded = 0;
+        }
+    }
+    fixture->Flush();
+}
+
+// One constant buffer changes every call, as per-frame constants do
+XESS_BENCHMARK("shader_parameters.apply_dirty_constants") {
+    ApplyFixture* fixture = GetApplyFixture(state);
+    if (!fixture) {
+        return;
+    }
+
+    std::vector<uint8> data(256);
+    uint32 recorded = 0;
+    while (state.KeepRunning()) {
+        ++data[0];
+        fixture->parameters.SetConstantBuffer("Constants0", data.data(), static_cast<uint32>(data.size()));
+        fixture->parameters.Apply(fixture->context.Get(), fixture->binding, ShaderType::Pixel);
+        if (++recorded == 4096) {
+            fixture->Flush();
+            recorded = 0;
+        }
+    }
+    fixture->Flush();
+}
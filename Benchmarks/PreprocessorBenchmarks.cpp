@@ -0,0 +1,78 @@
+#include "BenchmarkHarness.h"
+#include "Graphics/ShaderCompiler/ShaderPreprocessor.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace XeSS;
+using namespace XeSS::Benchmarks;
+using namespace XeSS::Graphics;
+
+namespace {
+    std::filesystem::path IncludeDirectory() {
+        return std::filesystem::temp_directory_path() / "xess_benchmark_includes";
+    }
+
+    // A guarded common header and a #pragma once header, like a shader library
+    void WriteIncludes() {
+        std::filesystem::create_directories(IncludeDirectory());
+
+        std::ofstream common(IncludeDirectory() / "Common.hlsli");
+        common << "#ifndef COMMON_HLSLI\n#define COMMON_HLSLI\n";
+        for (uint32 i = 0; i < 64; ++i) {
+            common << "// Helper " << i << "\n"
+                   << "#define SCALE_" << i << "(x) ((x) * " << i << ".0f)\n"
+                   << "float Helper" << i << "(float v) { return SCALE_" << i << "(v) + 1.0f; }\n";
+        }
+        common << "#endif\n";
+
+        std::ofstream color(IncludeDirectory() / "Color.hlsli");
+        color << "#pragma once\n#include \"Common.hlsli\"\n"
+              << "float3 Tonemap(float3 c) { return c / (c + 1.0f); }\n";
+    }
+
+    std::string MakeShaderSource() {
+        std::string source = "#include \"Color.hlsli\"\n#include \"Common.hlsli\"\n";
+        source += "#if QUALITY > 1 && defined(USE_JITTER)\n#define TAPS 8\n#else\n#define TAPS 4\n#endif\n";
+        source += "cbuffer Params : register(b0) { float4 data[TAPS]; }\n";
+        source += "float4 main(float2 uv : TEXCOORD0) : SV_Target {\n    float4 sum = 0;\n";
+        for (uint32 i = 0; i < 32; ++i) {
+            source += "    sum += data[" + std::to_string(i % 4) + "] * Helper" + std::to_string(i) + "(uv.x);\n";
+        }
+        source += "    return float4(Tonemap(sum.rgb), 1);\n}\n";
+        return source;
+    }
+
+    PreprocessOptions MakeOptions() {
+        PreprocessOptions options;
+        options.macros = {{"QUALITY", "3"}, {"USE_JITTER", "1"}};
+        options.baseDirectory = IncludeDirectory().string();
+        return options;
+    }
+}
+
+// Includes come from the shared cache, so this is lexing and expansion only
+XESS_BENCHMARK("preprocessor.cached_includes") {
+    WriteIncludes();
+    std::string source = MakeShaderSource();
+    PreprocessOptions options = MakeOptions();
+    ShaderPreprocessor preprocessor;
+
+    state.SetBytesPerIteration(source.size());
+    while (state.KeepRunning()) {
+        DoNotOptimize(preprocessor.Preprocess(source, "Bench.hlsl", options));
+    }
+}
+
+// A private cache per run: every include is read from disk again
+XESS_BENCHMARK("preprocessor.cold_includes") {
+    WriteIncludes();
+    std::string source = MakeShaderSource();
+    PreprocessOptions options = MakeOptions();
+
+    state.SetBytesPerIteration(source.size());
+    while (state.KeepRunning()) {
+        IncludeCache cache;
+        ShaderPreprocessor preprocessor(cache);
+        DoNotOptimize(preprocessor.Preprocess(source, "Bench.hlsl", options));
+    }
+}
@@ -0,0 +1,455 @@
+#include "BenchmarkHarness.h"
+#include "Core/JobSystem.h"
+#include "Rendering/DrawQueue.h"
+#include "Rendering/FrustumCuller.h"
+#include "Rendering/OcclusionCuller.h"
+#include "Rendering/TransformSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using namespace XeSS;
+using namespace XeSS::Benchmarks;
+using namespace XeSS::Rendering;
+
+// Draw queue
+
+namespace {
+    constexpr uint32 FrameDraws = 100000;
+
+    // A scene's worth of keys in submission order: a few passes, tens of
+    // pipelines, thousands of materials, and depth all over the place
+    std::vector<DrawItem> MakeSceneDraws(uint32 count) {
+        std::mt19937 random(7);
+        std::uniform_int_distribution<uint32> pass(0, 3);
+        std::uniform_int_distribution<uint32> pipeline(0, 63);
+        std::uniform_int_distribution<uint32> material(0, 1999);
+        std::uniform_real_distribution<float32> depth(0.1f, 500.0f);
+
+        std::vector<DrawItem> draws;
+        draws.reserve(count);
+        for (uint32 i = 0; i < count; ++i) {
+            uint64 key = DrawKey::Make(pass(random), pipeline(random), material(random),
+                                       DrawKey::QuantizeDepth(depth(random)));
+            draws.push_back({key, i});
+        }
+        return draws;
+    }
+
+    // Per-draw data the submit loop reads, about what a DrawCommand holds
+    struct SimulatedCommand {
+        uint64 geometry;
+        uint64 constants;
+        uint32 count;
+        uint32 start;
+    };
+}
+
+XESS_BENCHMARK("draw_queue.push_100k") {
+    std::vector<DrawItem> draws = MakeSceneDraws(FrameDraws);
+    DrawQueue queue;
+    queue.Reserve(FrameDraws);
+    state.SetItemsPerIteration(FrameDraws);
+    while (state.KeepRunning()) {
+        queue.Clear();
+        for (const DrawItem& draw : draws) {
+            queue.Push(draw.key, draw.payload);
+        }
+        DoNotOptimize(queue.GetItems().data());
+    }
+}
+
+// Both sorts include restoring the unsorted input, a 1.6 MB copy
+XESS_BENCHMARK("draw_queue.radix_sort_100k") {
+    std::vector<DrawItem> draws = MakeSceneDraws(FrameDraws);
+    std::vector<DrawItem> items;
+    std::vector<DrawItem> scratch;
+    state.SetItemsPerIteration(FrameDraws);
+    while (state.KeepRunning()) {
+        items.assign(draws.begin(), draws.end());
+        DrawQueue::RadixSort(items, scratch);
+        DoNotOptimize(items.data());
+    }
+}
+
+XESS_BENCHMARK("draw_queue.std_sort_100k") {
+    std::vector<DrawItem> draws = MakeSceneDraws(FrameDraws);
+    std::vector<DrawItem> items;
+    state.SetItemsPerIteration(FrameDraws);
+    while (state.KeepRunning()) {
+        items.assign(draws.begin(), draws.end());
+        std::sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; });
+        DoNotOptimize(items.data());
+    }
+}
+
+// The submit walk without a driver: change detection plus a read of each
+// draw's command, which is what SubmitDrawQueue adds on top of D3D
+XESS_BENCHMARK("draw_queue.submit_100k") {
+    std::vector<DrawItem> draws = MakeSceneDraws(FrameDraws);
+    std::vector<SimulatedCommand> commands(FrameDraws);
+    for (uint32 i = 0; i < FrameDraws; ++i) {
+        commands[i] = {i * 3ull, i * 7ull, 36, i};
+    }
+    DrawQueue queue;
+    for (const DrawItem& draw : draws) {
+        queue.Push(draw.key, draw.payload);
+    }
+    queue.Sort();
+
+    state.SetItemsPerIteration(FrameDraws);
+    while (state.KeepRunning()) {
+        uint64 stateChanges = 0;
+        uint64 work = 0;
+        queue.Submit([&](const DrawItem& item, const DrawStateChanges& changes) {
+            stateChanges += changes.pipeline + changes.material;
+            const SimulatedCommand& command = commands[item.payload];
+            work += command.geometry ^ command.constants ^ command.count;
+        });
+        DoNotOptimize(stateChanges);
+        DoNotOptimize(work);
+    }
+}
+
+XESS_BENCHMARK("draw_queue.frame_100k") {
+    std::vector<DrawItem> draws = MakeSceneDraws(FrameDraws);
+    std::vector<SimulatedCommand> commands(FrameDraws);
+    DrawQueue queue;
+    queue.Reserve(FrameDraws);
+    state.SetItemsPerIteration(FrameDraws);
+    while (state.KeepRunning()) {
+        queue.Clear();
+        for (const DrawItem& draw : draws) {
+            queue.Push(draw.key, draw.payload);
+        }
+        queue.Sort();
+
+        uint64 work = 0;
+        queue.Submit([&](const DrawItem& item, const DrawStateChanges& changes) {
+            work += changes.material + commands[item.payload].count;
+        });
+        DoNotOptimize(work);
+    }
+}
+
+// Frustum culling
+
+namespace {
+    constexpr uint32 CullObjects = 1000000;
+
+    // A 90 degree camera at the origin looking down +z
+    void MakeCameraViewProjection(float32 (&viewProjection)[16]) {
+        const float32 nearZ = 0.1f;
+        const float32 farZ = 1000.0f;
+        const float32 scale = 1.0f / std::tan(0.785398f);
+        const float32 aspect = 16.0f / 9.0f;
+        const float32 range = farZ / (farZ - nearZ);
+        const float32 matrix[16] = {
+            scale / aspect, 0.0f, 0.0f, 0.0f,
+            0.0f, scale, 0.0f, 0.0f,
+            0.0f, 0.0f, range, 1.0f,
+            0.0f, 0.0f, -nearZ * range, 0.0f,
+        };
+        std::copy(std::begin(matrix), std::end(matrix), viewProjection);
+    }
+
+    // Objects below are spread through a cube around the camera, so a bit
+    // under a tenth end up visible
+    Frustum MakeCameraFrustum() {
+        float32 viewProjection[16];
+        MakeCameraViewProjection(viewProjection);
+        return Frustum::FromViewProjection(viewProjection);
+    }
+
+    CullingBounds MakeSceneBounds(uint32 count) {
+        std::mt19937 random(11);
+        std::uniform_real_distribution<float32> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float32> size(0.2f, 4.0f);
+
+        CullingBounds bounds;
+        bounds.Reserve(count);
+        for (uint32 i = 0; i < count; ++i) {
+            Vector3 center{position(random), position(random), position(random)};
+            float32 extent = size(random);
+            bounds.AddBox(center, {extent, extent * 0.5f, extent});
+        }
+        return bounds;
+    }
+
+    // Benchmark hooks: workers for one benchmark only, started before its
+    // warmup and stopped after its last repetition, so the ones after it
+    // still measure the calling thread alone
+    bool s_ownsJobSystem = false;
+
+    void StartJobSystem() {
+        s_ownsJobSystem = !JobSystem::Instance().IsInitialized();
+        if (s_ownsJobSystem) {
+            JobSystem::Instance().Initialize();
+        }
+    }
+
+    void StopJobSystem() {
+        if (s_ownsJobSystem) {
+            JobSystem::Instance().Shutdown();
+            s_ownsJobSystem = false;
+        }
+    }
+}
+
+XESS_BENCHMARK("culling.frustum_scalar_1m") {
+    Frustum frustum = MakeCameraFrustum();
+    CullingBounds bounds = MakeSceneBounds(CullObjects);
+    std::vector<uint32> visible(CullObjects);
+    state.SetItemsPerIteration(CullObjects);
+    while (state.KeepRunning()) {
+        DoNotOptimize(FrustumCuller::CullRangeScalar(frustum, bounds, 0, CullObjects, visible.data()));
+    }
+}
+
+// AVX2 when the CPU has it, on the calling thread only
+XESS_BENCHMARK("culling.frustum_simd_1m") {
+    if (!FrustumCuller::HasAvx2()) {
+        state.Skip("no AVX2");
+        return;
+    }
+    Frustum frustum = MakeCameraFrustum();
+    CullingBounds bounds = MakeSceneBounds(CullObjects);
+    std::vector<uint32> visible(CullObjects);
+    state.SetItemsPerIteration(CullObjects);
+    while (state.KeepRunning()) {
+        DoNotOptimize(FrustumCuller::CullRange(frustum, bounds, 0, CullObjects, visible.data()));
+    }
+}
+
+// Full Cull(): chunks on every hardware thread plus the packing pass
+XESS_BENCHMARK_WITH_HOOKS("culling.frustum_parallel_1m", StartJobSystem, StopJobSystem) {
+    Frustum frustum = MakeCameraFrustum();
+    CullingBounds bounds = MakeSceneBounds(CullObjects);
+    FrustumCuller culler;
+    state.SetItemsPerIteration(CullObjects);
+    while (state.KeepRunning()) {
+        DoNotOptimize(culler.Cull(frustum, bounds));
+    }
+}
+
+// Occlusion culling
+
+namespace {
+    constexpr uint32 OcclusionObjects = 100000;
+
+    // A street-level view down a city grid: 40 x 25 blocks of buildings
+    // (12k occluder triangles) with small props scattered in front of,
+    // between and behind them
+    struct OcclusionScene {
+        float32 viewProjection[16];
+        std::vector<Vector3> occluderCenters;
+        std::vector<Vector3> occluderExtents;
+        CullingBounds bounds;
+        std::vector<uint32> candidates;
+    };
+
+    void AddProps(OcclusionScene& scene, uint32 count, float32 minZ, float32 maxZ) {
+        std::mt19937 random(5);
+        std::uniform_real_distribution<float32> x(-400.0f, 400.0f);
+        std::uniform_real_distribution<float32> y(-1.5f, 3.0f);
+        std::uniform_real_distribution<float32> z(minZ, maxZ);
+        std::uniform_real_distribution<float32> size(0.2f, 1.5f);
+
+        scene.bounds.Reserve(count);
+        for (uint32 i = 0; i < count; ++i) {
+            float32 extent = size(random);
+            scene.bounds.AddBox({x(random), y(random), z(random)}, {extent, extent, extent});
+        }
+
+        // Frustum culled first, as in a frame
+        FrustumCuller frustumCuller;
+        frustumCuller.Cull(Frustum::FromViewProjection(scene.viewProjection), scene.bounds);
+        std::span<const uint32> visible = frustumCuller.GetVisible();
+        scene.candidates.assign(visible.begin(), visible.end());
+    }
+
+    const OcclusionScene& GetCityScene() {
+        static OcclusionScene scene = [] {
+            OcclusionScene city;
+            MakeCameraViewProjection(city.viewProjection);
+            std::mt19937 random(3);
+            std::uniform_real_distribution<float32> height(6.0f, 40.0f);
+            for (int32 row = 0; row < 25; ++row) {
+                for (int32 column = -20; column < 20; ++column) {
+                    float32 top = height(random);
+                    city.occluderCenters.push_back({column * 20.0f + 10.0f, top * 0.5f - 2.0f, 20.0f + row * 30.0f});
+                    city.occluderExtents.push_back({7.0f, top * 0.5f, 10.0f});
+                }
+            }
+            AddProps(city, OcclusionObjects, 1.0f, 800.0f);
+            return city;
+        }();
+        return scene;
+    }
+
+    // One wall across the view with everything behind it; the test side
+    // at its busiest, since every object reaches the per-pixel check
+    const OcclusionScene& GetWallScene() {
+        static OcclusionScene scene = [] {
+            OcclusionScene wall;
+            MakeCameraViewProjection(wall.viewProjection);
+            wall.occluderCenters.push_back({0.0f, 10.0f, 15.0f});
+            wall.occluderExtents.push_back({400.0f, 30.0f, 0.5f});
+            AddProps(wall, OcclusionObjects, 20.0f, 800.0f);
+            return wall;
+        }();
+        return scene;
+    }
+
+    void RenderSceneOccluders(const OcclusionScene& scene, OcclusionCuller& culler) {
+        culler.BeginFrame(scene.viewProjection);
+        for (size_t i = 0; i < scene.occluderCenters.size(); ++i) {
+            culler.AddOccluderBox(scene.occluderCenters[i], scene.occluderExtents[i]);
+        }
+        culler.RenderOccluders();
+    }
+}
+
+XESS_BENCHMARK("occlusion.city_rasterize") {
+    const OcclusionScene& scene = GetCityScene();
+    OcclusionCuller culler;
+    culler.Initialize();
+    state.SetItemsPerIteration(scene.occluderCenters.size() * 12);
+    while (state.KeepRunning()) {
+        RenderSceneOccluders(scene, culler);
+        DoNotOptimize(culler.GetDepth().data());
+    }
+}
+
+XESS_BENCHMARK("occlusion.city_test") {
+    const OcclusionScene& scene = GetCityScene();
+    OcclusionCuller culler;
+    culler.Initialize();
+    RenderSceneOccluders(scene, culler);
+    state.SetItemsPerIteration(scene.candidates.size());
+    while (state.KeepRunning()) {
+        DoNotOptimize(culler.Cull(scene.bounds, scene.candidates));
+    }
+}
+
+XESS_BENCHMARK("occlusion.wall_test") {
+    const OcclusionScene& scene = GetWallScene();
+    OcclusionCuller culler;
+    culler.Initialize();
+    RenderSceneOccluders(scene, culler);
+    state.SetItemsPerIteration(scene.candidates.size());
+    while (state.KeepRunning()) {
+        DoNotOptimize(culler.Cull(scene.bounds, scene.candidates));
+    }
+}
+
+// Occluders plus the test, on every hardware thread
+XESS_BENCHMARK_WITH_HOOKS("occlusion.city_frame_parallel", StartJobSystem, StopJobSystem) {
+    const OcclusionScene& scene = GetCityScene();
+    OcclusionCuller culler;
+    culler.Initialize();
+    state.SetItemsPerIteration(scene.candidates.size());
+    while (state.KeepRunning()) {
+        RenderSceneOccluders(scene, culler);
+        DoNotOptimize(culler.Cull(scene.bounds, scene.candidates));
+    }
+}
+
+// Transforms
+
+namespace {
+    constexpr uint32 TransformRoots = 1000;
+    constexpr uint32 TransformFanout = 10;
+
+    // 1000 roots with three levels of ten children each: 1,111,000
+    // transforms, each child offset and turned a little from its parent
+    struct TransformScene {
+        TransformSystem system;
+        std::vector<TransformHandle> roots;
+    };
+
+    void AddChildren(TransformScene& scene, TransformHandle parent, uint32 depth) {
+        if (depth == 0) {
+            return;
+        }
+        for (uint32 i = 0; i < TransformFanout; ++i) {
+            float32 angle = 0.6f * static_cast<float32>(i);
+            Transform3x4 local = Transform3x4::FromTranslationRotationScale(
+                {2.0f * static_cast<float32>(i), 0.5f, 0.0f}, {0.0f, std::sin(angle * 0.5f), 0.0f, std::cos(angle * 0.5f)},
+                {0.9f, 0.9f, 0.9f});
+            TransformHandle child = scene.system.Create(local, parent);
+            scene.system.SetLocalBounds(child, {0.0f, 0.0f, 0.0f}, {0.5f, 0.5f, 0.5f});
+            AddChildren(scene, child, depth - 1);
+        }
+    }
+
+    void BuildTransformScene(TransformScene& scene) {
+        for (uint32 i = 0; i < TransformRoots; ++i) {
+            Vector3 position{static_cast<float32>(i % 40) * 50.0f, 0.0f, static_cast<float32>(i / 40) * 50.0f};
+            TransformHandle root = scene.system.Create(Transform3x4::FromTranslation(position));
+            scene.system.SetLocalBounds(root, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f});
+            scene.roots.push_back(root);
+            AddChildren(scene, root, 3);
+        }
+        scene.system.Update();
+    }
+
+    // Moves every step-th root, which dirties its whole subtree
+    void MoveRoots(TransformScene& scene, uint32 step, uint32 frame) {
+        float32 offset = static_cast<float32>(frame & 1);
+        for (size_t i = 0; i < scene.roots.size(); i += step) {
+            Vector3 position{static_cast<float32>(i % 40) * 50.0f + offset, 0.0f, static_cast<float32>(i / 40) * 50.0f};
+            scene.system.SetLocal(scene.roots[i], Transform3x4::FromTranslation(position));
+        }
+    }
+
+    void RunTransformUpdate(BenchmarkState& state, uint32 step) {
+        TransformScene scene;
+        BuildTransformScene(scene);
+        state.SetItemsPerIteration(scene.system.GetCount());
+        uint32 frame = 0;
+        while (state.KeepRunning()) {
+            MoveRoots(scene, step, ++frame);
+            scene.system.Update();
+            DoNotOptimize(scene.system.GetStats().updated);
+        }
+    }
+}
+
+// Every root moves, so all 1.1M world matrices are recomputed
+XESS_BENCHMARK("transforms.update_all_1m") {
+    RunTransformUpdate(state, 1);
+}
+
+XESS_BENCHMARK_WITH_HOOKS("transforms.update_all_1m_parallel", StartJobSystem, StopJobSystem) {
+    RunTransformUpdate(state, 1);
+}
+
+XESS_BENCHMARK("transforms.update_10pct_1m") {
+    RunTransformUpdate(state, 10);
+}
+
+// Nothing moves: the cost of skipping clean transforms
+XESS_BENCHMARK("transforms.update_static_1m") {
+    TransformScene scene;
+    BuildTransformScene(scene);
+    scene.system.Update();
+    state.SetItemsPerIteration(scene.system.GetCount());
+    while (state.KeepRunning()) {
+        scene.system.Update();
+        DoNotOptimize(scene.system.GetStats().updated);
+    }
+}
+
+XESS_BENCHMARK("transforms.export_bounds_1m") {
+    TransformScene scene;
+    BuildTransformScene(scene);
+    CullingBounds bounds;
+    state.SetItemsPerIteration(scene.system.GetCount());
+    while (state.KeepRunning()) {
+        scene.system.ExportBounds(bounds);
+        DoNotOptimize(bounds.GetCenterX());
+    }
+}
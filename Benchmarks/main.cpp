@@ -0,0 +1,56 @@
+#include "BenchmarkHarness.h"
+#include "Core/Logger.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace XeSS;
+using namespace XeSS::Benchmarks;
+
+namespace {
+    void PrintUsage() {
+        std::printf(
+            "Usage: xess_benchmarks [options]\n"
+            "  --filter <text>      Run benchmarks whose name contains text\n"
+            "  --list               List benchmark names and exit\n"
+            "  --min-time <s>       Target duration of one repetition (default 0.2)\n"
+            "  --warmup <s>         Warmup time before calibration (default 0.05)\n"
+            "  --repetitions <n>    Timed repetitions per benchmark (default 5)\n"
+            "  --cpu <n>            Pin the benchmark thread to CPU n\n"
+            "  --json <file>        Write results as JSON\n");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    HarnessOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time" && hasValue) {
+            options.minTimeSeconds = std::atof(argv[++i]);
+        } else if (arg == "--warmup" && hasValue) {
+            options.warmupSeconds = std::atof(argv[++i]);
+        } else if (arg == "--repetitions" && hasValue) {
+            options.repetitions = static_cast<uint32>(std::atoi(argv[++i]));
+        } else if (arg == "--cpu" && hasValue) {
+            options.pinCpu = std::atoi(argv[++i]);
+        } else if (arg == "--json" && hasValue) {
+            options.jsonOutput = argv[++i];
+        } else if (arg == "--list") {
+            for (const BenchmarkInfo& benchmark : BenchmarkRegistry::Instance().GetBenchmarks()) {
+                std::printf("%s\n", benchmark.name.c_str());
+            }
+            return 0;
+        } else {
+            PrintUsage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    Harness harness(options);
+    return harness.Run() ? 0 : 1;
+}
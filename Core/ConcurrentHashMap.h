@@ -0,0 +1,318 @@
+#pragma once
+
+#include "Types.h"
+#include "NonCopyable.h"
+#include "Epoch.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace XeSS {
+
+/**
+ * Read-mostly hash map for caches shared between threads. Keys are spread
+ * over shards, each an open-addressing table of node pointers guarded by its
+ * own mutex. Lookups take no lock: they run under an EpochGuard, and nodes
+ * or tables a writer replaces are retired to the EpochManager instead of
+ * being deleted while a reader may hold them. Writers lock only their shard.
+ *
+ * Values are immutable once inserted; replacing one swaps in a new node.
+ * Fields a reader updates (access stamps, counters) have to be atomics.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class ConcurrentHashMap : public NonCopyable {
+public:
+    explicit ConcurrentHashMap(uint32 shardCount = 16, uint32 initialCapacity = 16)
+        : m_shardCount(std::bit_ceil(std::max<uint32>(shardCount, 1))),
+          m_shardShift(64 - std::countr_zero(m_shardCount)),
+          m_initialCapacity(std::bit_ceil(std::max<uint32>(initialCapacity, 4))),
+          m_shards(std::make_unique<Shard[]>(m_shardCount)) {
+        for (uint32 i = 0; i < m_shardCount; ++i) {
+            m_shards[i].table.store(new Table(m_initialCapacity), std::memory_order_relaxed);
+        }
+    }
+
+    // No lookups may run concurrently with destruction
+    ~ConcurrentHashMap() {
+        for (uint32 i = 0; i < m_shardCount; ++i) {
+            Table* table = m_shards[i].table.load(std::memory_order_relaxed);
+            DeleteNodes(*table);
+            delete table;
+        }
+    }
+
+    // Lock-free. Calls visitor(const Value&) if the key is present; the
+    // reference is only valid inside the call.
+    template <typename Visitor>
+    bool Visit(const Key& key, Visitor&& visitor) const {
+        uint64 hash = HashKey(key);
+        const Shard& shard = ShardFor(hash);
+
+        EpochGuard guard;
+        const Table* table = shard.table.load(std::memory_order_acquire);
+        for (uint32 i = Home(*table, hash), probes = 0; probes <= table->mask; i = (i + 1) & table->mask, ++probes) {
+            const Node* node = table->slots[i].load(std::memory_order_acquire);
+            if (!node) {
+                return false;
+            }
+            if (node != Tombstone() && node->hash == hash && m_equal(node->key, key)) {
+                visitor(node->value);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Lock-free; copies the value out
+    bool Find(const Key& key, Value& value) const {
+        return Visit(key, [&value](const Value& found) { value = found; });
+    }
+
+    bool Contains(const Key& key) const {
+        return Visit(key, [](const Value&) {});
+    }
+
+    // Inserts or replaces; the value is constructed in place from args.
+    // Returns true if the key was not present.
+    template <typename... Args>
+    bool InsertOrAssign(const Key& key, Args&&... args) {
+        uint64 hash = HashKey(key);
+        Shard& shard = ShardFor(hash);
+        auto node = std::make_unique<Node>(hash, key, std::forward<Args>(args)...);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Table* table = shard.table.load(std::memory_order_relaxed);
+
+        int64 freeSlot = -1;
+        for (uint32 i = Home(*table, hash), probes = 0; probes <= table->mask; i = (i + 1) & table->mask, ++probes) {
+            Node* existing = table->slots[i].load(std::memory_order_relaxed);
+            if (!existing) {
+                if (freeSlot < 0) {
+                    freeSlot = i;
+                }
+                break;
+            }
+            if (existing == Tombstone()) {
+                if (freeSlot < 0) {
+                    freeSlot = i;
+                }
+                continue;
+            }
+            if (existing->hash == hash && m_equal(existing->key, key)) {
+                table->slots[i].store(node.release(), std::memory_order_release);
+                EpochManager::Instance().Retire(existing);
+                return false;
+            }
+        }
+
+        bool reusesTombstone = freeSlot >= 0 && table->slots[freeSlot].load(std::memory_order_relaxed) == Tombstone();
+        if (!reusesTombstone && (table->used + 1) * 4 > table->Capacity() * 3) {
+            table = Rehash(shard, shard.count.load(std::memory_order_relaxed) + 1);
+            freeSlot = FindEmpty(*table, hash);
+        } else if (!reusesTombstone) {
+            ++table->used;
+        }
+
+        table->slots[freeSlot].store(node.release(), std::memory_order_release);
+        shard.count.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool Erase(const Key& key) {
+        uint64 hash = HashKey(key);
+        Shard& shard = ShardFor(hash);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Table* table = shard.table.load(std::memory_order_relaxed);
+        for (uint32 i = Home(*table, hash), probes = 0; probes <= table->mask; i = (i + 1) & table->mask, ++probes) {
+            Node* node = table->slots[i].load(std::memory_order_relaxed);
+            if (!node) {
+                return false;
+            }
+            if (node != Tombstone() && node->hash == hash && m_equal(node->key, key)) {
+                RemoveAt(shard, *table, i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Removes every entry for which predicate(key, value) is true; locks one
+    // shard at a time
+    template <typename Predicate>
+    size_t EraseIf(Predicate&& predicate) {
+        size_t erased = 0;
+        for (uint32 s = 0; s < m_shardCount; ++s) {
+            Shard& shard = m_shards[s];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            Table* table = shard.table.load(std::memory_order_relaxed);
+            for (uint32 i = 0; i <= table->mask; ++i) {
+                Node* node = table->slots[i].load(std::memory_order_relaxed);
+                if (node && node != Tombstone() && predicate(node->key, static_cast<const Value&>(node->value))) {
+                    RemoveAt(shard, *table, i);
+                    ++erased;
+                }
+            }
+        }
+        return erased;
+    }
+
+    void Clear() {
+        for (uint32 i = 0; i < m_shardCount; ++i) {
+            Shard& shard = m_shards[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            Table* old = shard.table.exchange(new Table(m_initialCapacity), std::memory_order_acq_rel);
+            shard.count.store(0, std::memory_order_relaxed);
+            RetireTable(old, true);
+        }
+    }
+
+    // Lock-free and weakly consistent: sees entries present for the whole call
+    template <typename Visitor>
+    void ForEach(Visitor&& visitor) const {
+        EpochGuard guard;
+        for (uint32 s = 0; s < m_shardCount; ++s) {
+            const Table* table = m_shards[s].table.load(std::memory_order_acquire);
+            for (uint32 i = 0; i <= table->mask; ++i) {
+                const Node* node = table->slots[i].load(std::memory_order_acquire);
+                if (node && node != Tombstone()) {
+                    visitor(node->key, node->value);
+                }
+            }
+        }
+    }
+
+    size_t Size() const {
+        size_t size = 0;
+        for (uint32 i = 0; i < m_shardCount; ++i) {
+            size += m_shards[i].count.load(std::memory_order_relaxed);
+        }
+        return size;
+    }
+
+    uint32 GetShardCount() const { return m_shardCount; }
+
+private:
+    struct Node {
+        template <typename... Args>
+        Node(uint64 h, const Key& k, Args&&... args)
+            : hash(h), key(k), value(std::forward<Args>(args)...) {}
+
+        uint64 hash;
+        Key key;
+        Value value;
+    };
+
+    struct Table {
+        explicit Table(uint32 capacity)
+            : mask(capacity - 1), slots(std::make_unique<std::atomic<Node*>[]>(capacity)) {}
+
+        uint32 Capacity() const { return mask + 1; }
+
+        uint32 mask;
+        uint32 used{0};     // Live nodes plus tombstones; written under the shard lock
+        std::unique_ptr<std::atomic<Node*>[]> slots;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::atomic<Table*> table{nullptr};
+        std::atomic<size_t> count{0};
+    };
+
+    // Marks an erased slot so probes continue past it
+    static Node* Tombstone() {
+        static char marker;
+        return reinterpret_cast<Node*>(&marker);
+    }
+
+    uint64 HashKey(const Key& key) const {
+        // Finalizer of splitmix64: the top bits pick the shard, the low bits the slot
+        uint64 x = static_cast<uint64>(m_hash(key));
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    Shard& ShardFor(uint64 hash) const {
+        return m_shards[m_shardCount > 1 ? hash >> m_shardShift : 0];
+    }
+
+    static uint32 Home(const Table& table, uint64 hash) {
+        return static_cast<uint32>(hash) & table.mask;
+    }
+
+    static uint32 FindEmpty(const Table& table, uint64 hash) {
+        uint32 i = Home(table, hash);
+        while (table.slots[i].load(std::memory_order_relaxed)) {
+            i = (i + 1) & table.mask;
+        }
+        return i;
+    }
+
+    // Copies the live nodes into a table sized for liveCount and publishes it;
+    // the nodes themselves are shared, only the old slot array is retired
+    Table* Rehash(Shard& shard, size_t liveCount) {
+        uint32 capacity = m_initialCapacity;
+        while (liveCount * 2 > capacity) {
+            capacity *= 2;
+        }
+
+        auto table = std::make_unique<Table>(capacity);
+        Table* old = shard.table.load(std::memory_order_relaxed);
+        for (uint32 i = 0; i <= old->mask; ++i) {
+            Node* node = old->slots[i].load(std::memory_order_relaxed);
+            if (node && node != Tombstone()) {
+                table->slots[FindEmpty(*table, node->hash)].store(node, std::memory_order_relaxed);
+                ++table->used;
+            }
+        }
+        ++table->used; // The slot the caller is about to fill
+
+        shard.table.store(table.get(), std::memory_order_release);
+        RetireTable(old, false);
+        return table.release();
+    }
+
+    void RemoveAt(Shard& shard, Table& table, uint32 slot) {
+        Node* node = table.slots[slot].exchange(Tombstone(), std::memory_order_acq_rel);
+        shard.count.fetch_sub(1, std::memory_order_relaxed);
+        EpochManager::Instance().Retire(node);
+    }
+
+    static void DeleteNodes(Table& table) {
+        for (uint32 i = 0; i <= table.mask; ++i) {
+            Node* node = table.slots[i].load(std::memory_order_relaxed);
+            if (node && node != Tombstone()) {
+                delete node;
+            }
+        }
+    }
+
+    static void RetireTable(Table* table, bool withNodes) {
+        if (withNodes) {
+            for (uint32 i = 0; i <= table->mask; ++i) {
+                Node* node = table->slots[i].load(std::memory_order_relaxed);
+                if (node && node != Tombstone()) {
+                    EpochManager::Instance().Retire(node);
+                }
+            }
+        }
+        EpochManager::Instance().Retire(table);
+    }
+
+    const uint32 m_shardCount;
+    const uint32 m_shardShift;
+    const uint32 m_initialCapacity;
+    std::unique_ptr<Shard[]> m_shards;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+};
+
+} // namespace XeSS
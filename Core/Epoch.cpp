@@ -0,0 +1,139 @@
+#include "Epoch.h"
+#include <algorithm>
+#include <thread>
+
+namespace XeSS {
+
+// Returns the thread's record to the pool when the thread exits
+struct EpochThreadSlot {
+    EpochManager::ThreadRecord* record{nullptr};
+
+    ~EpochThreadSlot() {
+        if (record) {
+            record->inUse.store(false, std::memory_order_release);
+        }
+    }
+};
+
+namespace {
+    thread_local EpochThreadSlot t_epochSlot;
+}
+
+EpochManager& EpochManager::Instance() {
+    static EpochManager instance;
+    return instance;
+}
+
+EpochManager::~EpochManager() {
+    // No readers are left at static destruction
+    std::vector<RetiredObject> retired = std::move(m_retired);
+    for (const RetiredObject& object : retired) {
+        object.deleter(object.object);
+    }
+}
+
+EpochManager::ThreadRecord& EpochManager::LocalRecord() {
+    if (!t_epochSlot.record) {
+        t_epochSlot.record = AcquireRecord();
+    }
+    return *t_epochSlot.record;
+}
+
+EpochManager::ThreadRecord* EpochManager::AcquireRecord() {
+    std::lock_guard<std::mutex> lock(m_recordMutex);
+    for (ThreadRecord& record : m_records) {
+        if (!record.inUse.load(std::memory_order_acquire)) {
+            record.inUse.store(true, std::memory_order_relaxed);
+            return &record;
+        }
+    }
+    ThreadRecord& record = m_records.emplace_back();
+    record.inUse.store(true, std::memory_order_relaxed);
+    return &record;
+}
+
+void EpochManager::Enter() {
+    ThreadRecord& record = LocalRecord();
+    if (record.nesting++ == 0) {
+        // A stale epoch only delays reclamation; the fence orders the
+        // announcement before any read of shared nodes
+        record.epoch.store(m_globalEpoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+void EpochManager::Leave() {
+    ThreadRecord& record = *t_epochSlot.record;
+    if (--record.nesting == 0) {
+        record.epoch.store(0, std::memory_order_release);
+    }
+}
+
+void EpochManager::Retire(void* object, void (*deleter)(void*)) {
+    bool collect = false;
+    {
+        std::lock_guard<std::mutex> lock(m_retiredMutex);
+        m_retired.push_back({object, deleter, m_globalEpoch.load(std::memory_order_seq_cst)});
+        collect = ++m_retiredSinceCollect >= CollectInterval;
+    }
+    if (collect) {
+        Collect();
+    }
+}
+
+void EpochManager::Collect() {
+    TryAdvance();
+    FreeRetired(m_globalEpoch.load(std::memory_order_acquire));
+}
+
+void EpochManager::Synchronize() {
+    // Two advances put every object retired so far behind all readers
+    uint64 target = m_globalEpoch.load(std::memory_order_acquire) + 2;
+    while (m_globalEpoch.load(std::memory_order_acquire) < target) {
+        if (!TryAdvance()) {
+            std::this_thread::yield();
+        }
+    }
+    FreeRetired(m_globalEpoch.load(std::memory_order_acquire));
+}
+
+size_t EpochManager::GetRetiredCount() const {
+    std::lock_guard<std::mutex> lock(m_retiredMutex);
+    return m_retired.size();
+}
+
+bool EpochManager::TryAdvance() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64 epoch = m_globalEpoch.load(std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(m_recordMutex);
+        for (const ThreadRecord& record : m_records) {
+            uint64 local = record.epoch.load(std::memory_order_seq_cst);
+            if (local != 0 && local != epoch) {
+                return false;
+            }
+        }
+    }
+    return m_globalEpoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+}
+
+void EpochManager::FreeRetired(uint64 safeEpoch) {
+    // An object retired in epoch E may be held by readers of E-1 or E
+    std::vector<RetiredObject> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_retiredMutex);
+        auto reachable = std::partition(m_retired.begin(), m_retired.end(), [safeEpoch](const RetiredObject& retired) {
+            return retired.epoch + 2 > safeEpoch;
+        });
+        ready.assign(reachable, m_retired.end());
+        m_retired.erase(reachable, m_retired.end());
+        m_retiredSinceCollect = 0;
+    }
+
+    // Outside the lock: deleters may retire further objects
+    for (const RetiredObject& retired : ready) {
+        retired.deleter(retired.object);
+    }
+}
+
+} // namespace XeSS
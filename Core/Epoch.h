@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Types.h"
+#include "NonCopyable.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace XeSS {
+
+/**
+ * Epoch-based reclamation for lock-free readers. A reader holds an EpochGuard
+ * while it dereferences shared nodes; a writer unlinks a node and retires it,
+ * and the node is deleted once every guard that could still see it has ended.
+ * Entering a guard is a store to the thread's own cache line, so readers
+ * never contend with each other.
+ */
+class EpochManager : public NonCopyable {
+public:
+    static EpochManager& Instance();
+
+    // Guards nest; only the outermost one publishes the thread's epoch
+    void Enter();
+    void Leave();
+
+    template <typename T>
+    void Retire(T* object) {
+        Retire(object, [](void* pointer) { delete static_cast<T*>(pointer); });
+    }
+    void Retire(void* object, void (*deleter)(void*));
+
+    // Frees what no reader can reach any more; Retire() calls this periodically
+    void Collect();
+
+    // Waits until every current guard ended and frees all retired objects.
+    // Must not be called while holding a guard.
+    void Synchronize();
+
+    size_t GetRetiredCount() const;
+    uint64 GetEpoch() const { return m_globalEpoch.load(std::memory_order_acquire); }
+
+private:
+    EpochManager() = default;
+    ~EpochManager();
+
+    struct alignas(64) ThreadRecord {
+        std::atomic<uint64> epoch{0};   // 0 while outside a guard
+        uint32 nesting{0};
+        std::atomic<bool> inUse{false};
+    };
+
+    struct RetiredObject {
+        void* object;
+        void (*deleter)(void*);
+        uint64 epoch;
+    };
+
+    static constexpr size_t CollectInterval = 64;
+
+    ThreadRecord& LocalRecord();
+    ThreadRecord* AcquireRecord();
+    bool TryAdvance();
+    void FreeRetired(uint64 safeEpoch);
+
+    std::atomic<uint64> m_globalEpoch{1};
+
+    std::mutex m_recordMutex;
+    std::deque<ThreadRecord> m_records;     // Stable addresses; reused after thread exit
+
+    mutable std::mutex m_retiredMutex;
+    std::vector<RetiredObject> m_retired;
+    size_t m_retiredSinceCollect{0};
+
+    friend struct EpochThreadSlot;
+};
+
+class EpochGuard : public NonCopyable {
+public:
+    EpochGuard() { EpochManager::Instance().Enter(); }
+    ~EpochGuard() { EpochManager::Instance().Leave(); }
+};
+
+} // namespace XeSS
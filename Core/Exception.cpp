@@ -3,6 +3,8 @@
 
 #ifdef _WIN32
 #include <comdef.h>
+#else
+#define FAILED(hr) ((hr) < 0)
 #endif
 
 namespace XeSS {
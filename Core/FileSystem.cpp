@@ -0,0 +1,829 @@
+#include "FileSystem.h"
+#include "JobSystem.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define XESS_FS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace XeSS {
+
+namespace {
+    MetricsRegistry& Registry() { return MetricsRegistry::Instance(); }
+
+    MetricCounter& s_reads = Registry().Counter("fs.reads", "Completed file reads");
+    MetricCounter& s_readFailures = Registry().Counter("fs.read_failures", "Failed file reads");
+    MetricCounter& s_bytesRead = Registry().Counter("fs.bytes_read", "Bytes read from files");
+    MetricCounter& s_bytesMapped = Registry().Counter("fs.bytes_mapped", "Bytes of newly mapped files");
+    MetricHistogram& s_readLatency = Registry().Histogram("fs.read_latency_ms", "File read latency in ms",
+                                                          MetricHistogram::ExponentialBounds(0.05, 2.0, 16));
+
+    float64 MillisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<float64, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Whole-file read on the calling thread, into a byte vector or a string;
+    // used by ReadFile/ReadText and the reader pool
+    template<typename Buffer>
+    bool ReadWholeFile(const std::string& path, Buffer& data, std::string& error) {
+#ifdef _WIN32
+        HANDLE file = CreateFileW(Utils::StringToWide(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                  nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            error = "cannot open file";
+            return false;
+        }
+
+        LARGE_INTEGER size{};
+        GetFileSizeEx(file, &size);
+        data.resize(static_cast<size_t>(size.QuadPart));
+
+        size_t offset = 0;
+        while (offset < data.size()) {
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(data.size() - offset, 1u << 30));
+            DWORD read = 0;
+            if (!::ReadFile(file, data.data() + offset, chunk, &read, nullptr)) {
+                CloseHandle(file);
+                error = "read failed";
+                return false;
+            }
+            if (read == 0) {
+                break;
+            }
+            offset += read;
+        }
+        CloseHandle(file);
+        data.resize(offset);
+        return true;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            error = std::strerror(errno);
+            return false;
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0) {
+            error = std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        data.resize(static_cast<size_t>(info.st_size));
+
+        size_t offset = 0;
+        while (offset < data.size()) {
+            ssize_t read = ::pread(fd, data.data() + offset, data.size() - offset, static_cast<off_t>(offset));
+            if (read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (read < 0) {
+                error = std::strerror(errno);
+                ::close(fd);
+                return false;
+            }
+            if (read == 0) {
+                break;  // Truncated while reading
+            }
+            offset += static_cast<size_t>(read);
+        }
+        ::close(fd);
+        data.resize(offset);
+        return true;
+#endif
+    }
+
+    const char* BackendName(FileIoBackend backend) {
+        switch (backend) {
+            case FileIoBackend::IoUring: return "io_uring";
+            case FileIoBackend::ThreadPool: return "thread_pool";
+            default: return "none";
+        }
+    }
+}
+
+/**
+ * Executes queued read requests. Backends take requests from the FileSystem
+ * queue and hand every finished read to Complete().
+ */
+class FileSystem::Backend {
+public:
+    explicit Backend(FileSystem& fileSystem) : m_fileSystem(fileSystem) {}
+    virtual ~Backend() = default;
+
+    virtual FileIoBackend GetType() const = 0;
+
+    // New requests were queued
+    virtual void Wake() {}
+
+    // Stopping was requested; returns once every thread has exited
+    virtual void Stop() = 0;
+
+protected:
+    using Request = FileSystem::Request;
+
+    bool PopRequests(std::vector<Request>& out, uint32 maxCount, bool wait) {
+        return m_fileSystem.PopRequests(out, maxCount, wait);
+    }
+    void BeginRead() { m_fileSystem.BeginRead(); }
+    void Complete(Request& request, FileReadResult&& result) {
+        m_fileSystem.Complete(request, std::move(result));
+    }
+
+    FileSystem& m_fileSystem;
+};
+
+namespace {
+    // Blocking reads on a few dedicated threads, so job workers never wait on disk
+    class ThreadPoolBackend : public FileSystem::Backend {
+    public:
+        ThreadPoolBackend(FileSystem& fileSystem, uint32 threadCount) : Backend(fileSystem) {
+            for (uint32 i = 0; i < std::max(threadCount, 1u); ++i) {
+                m_threads.emplace_back([this]() { Run(); });
+            }
+        }
+
+        ~ThreadPoolBackend() override {
+            Stop();
+        }
+
+        FileIoBackend GetType() const override { return FileIoBackend::ThreadPool; }
+
+        void Stop() override {
+            for (std::thread& thread : m_threads) {
+                if (thread.joinable()) {
+                    thread.join();
+                }
+            }
+            m_threads.clear();
+        }
+
+    private:
+        void Run() {
+            std::vector<Request> requests;
+            while (PopRequests(requests, 1, true)) {
+                for (Request& request : requests) {
+                    BeginRead();
+                    FileReadResult result;
+                    result.path = request.path;
+                    result.success = ReadWholeFile(request.path, result.data, result.error);
+                    Complete(request, std::move(result));
+                }
+            }
+        }
+
+        std::vector<std::thread> m_threads;
+    };
+
+#ifdef XESS_FS_IO_URING
+    /**
+     * Minimal io_uring ring over the raw system calls: one submitter and one
+     * reaper (the I/O thread), so the ring indices need no locking.
+     */
+    class Ring : public NonCopyable {
+    public:
+        ~Ring() {
+            if (m_sqes) munmap(m_sqes, m_sqesSize);
+            if (m_cqRing && m_cqRing != m_sqRing) munmap(m_cqRing, m_cqRingSize);
+            if (m_sqRing) munmap(m_sqRing, m_sqRingSize);
+            if (m_fd >= 0) ::close(m_fd);
+        }
+
+        // Returns 0 or a negative errno
+        int Initialize(uint32 entries) {
+            io_uring_params params{};
+            m_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (m_fd < 0) {
+                return -errno;
+            }
+
+            m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32);
+            m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMap) {
+                m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+            }
+
+            m_sqRing = Map(m_sqRingSize, IORING_OFF_SQ_RING);
+            m_cqRing = singleMap ? m_sqRing : Map(m_cqRingSize, IORING_OFF_CQ_RING);
+            m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            m_sqes = static_cast<io_uring_sqe*>(Map(m_sqesSize, IORING_OFF_SQES));
+            if (!m_sqRing || !m_cqRing || !m_sqes) {
+                return -ENOMEM;
+            }
+
+            auto* sq = static_cast<uint8*>(m_sqRing);
+            m_sqHead = reinterpret_cast<uint32*>(sq + params.sq_off.head);
+            m_sqTail = reinterpret_cast<uint32*>(sq + params.sq_off.tail);
+            m_sqMask = *reinterpret_cast<uint32*>(sq + params.sq_off.ring_mask);
+            m_sqArray = reinterpret_cast<uint32*>(sq + params.sq_off.array);
+            m_sqEntries = params.sq_entries;
+            m_localTail = *m_sqTail;
+
+            auto* cq = static_cast<uint8*>(m_cqRing);
+            m_cqHead = reinterpret_cast<uint32*>(cq + params.cq_off.head);
+            m_cqTail = reinterpret_cast<uint32*>(cq + params.cq_off.tail);
+            m_cqMask = *reinterpret_cast<uint32*>(cq + params.cq_off.ring_mask);
+            m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            return SupportsRead() ? 0 : -EOPNOTSUPP;
+        }
+
+        // Null when the submission queue is full
+        io_uring_sqe* NextSqe() {
+            uint32 head = std::atomic_ref<uint32>(*m_sqHead).load(std::memory_order_acquire);
+            if (m_localTail - head >= m_sqEntries) {
+                return nullptr;
+            }
+            uint32 index = m_localTail & m_sqMask;
+            io_uring_sqe* sqe = &m_sqes[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            m_sqArray[index] = index;
+            ++m_localTail;
+            ++m_unsubmitted;
+            return sqe;
+        }
+
+        // Publishes queued entries and waits for at least waitCount completions
+        int Submit(uint32 waitCount) {
+            std::atomic_ref<uint32>(*m_sqTail).store(m_localTail, std::memory_order_release);
+            while (true) {
+                int result = static_cast<int>(syscall(__NR_io_uring_enter, m_fd, m_unsubmitted, waitCount,
+                                                      waitCount > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+                if (result >= 0) {
+                    m_unsubmitted -= std::min<uint32>(static_cast<uint32>(result), m_unsubmitted);
+                    return result;
+                }
+                if (errno != EINTR) {
+                    return -errno;
+                }
+            }
+        }
+
+        template<typename Handler>
+        void Reap(Handler&& handler) {
+            uint32 head = *m_cqHead;
+            uint32 tail = std::atomic_ref<uint32>(*m_cqTail).load(std::memory_order_acquire);
+            while (head != tail) {
+                io_uring_cqe cqe = m_cqes[head & m_cqMask];
+                ++head;
+                std::atomic_ref<uint32>(*m_cqHead).store(head, std::memory_order_release);
+                handler(cqe);
+            }
+        }
+
+    private:
+        void* Map(size_t size, off_t offset) {
+            void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, offset);
+            return memory == MAP_FAILED ? nullptr : memory;
+        }
+
+        bool SupportsRead() {
+            // Room for every opcode the header knows about
+            constexpr uint32 opCount = IORING_OP_LAST;
+            std::vector<uint8> buffer(sizeof(io_uring_probe) + opCount * sizeof(io_uring_probe_op));
+            auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+            if (syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, probe, opCount) < 0) {
+                return false;
+            }
+            return probe->last_op >= IORING_OP_READ &&
+                   (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) != 0;
+        }
+
+        int m_fd{-1};
+        void* m_sqRing{nullptr};
+        void* m_cqRing{nullptr};
+        size_t m_sqRingSize{0};
+        size_t m_cqRingSize{0};
+        io_uring_sqe* m_sqes{nullptr};
+        size_t m_sqesSize{0};
+
+        uint32* m_sqHead{nullptr};
+        uint32* m_sqTail{nullptr};
+        uint32* m_sqArray{nullptr};
+        uint32 m_sqMask{0};
+        uint32 m_sqEntries{0};
+        uint32 m_localTail{0};
+        uint32 m_unsubmitted{0};
+
+        uint32* m_cqHead{nullptr};
+        uint32* m_cqTail{nullptr};
+        io_uring_cqe* m_cqes{nullptr};
+        uint32 m_cqMask{0};
+    };
+
+    /**
+     * One I/O thread driving an io_uring. New requests are opened and their
+     * reads submitted in one io_uring_enter per wake-up; an eventfd read that
+     * is always in flight lets Wake() interrupt the completion wait.
+     */
+    class IoUringBackend : public FileSystem::Backend {
+    public:
+        static constexpr uint64 WakeTag = 0;
+        static constexpr size_t MaxReadChunk = 1u << 30;
+
+        IoUringBackend(FileSystem& fileSystem, uint32 queueDepth)
+            : Backend(fileSystem), m_slots(std::max(queueDepth, 1u)) {
+        }
+
+        ~IoUringBackend() override {
+            Stop();
+            if (m_wakeFd >= 0) {
+                ::close(m_wakeFd);
+            }
+        }
+
+        // Returns 0 or a negative errno; the backend is unusable on failure
+        int Start() {
+            // Entries for every slot plus the wake-up read
+            int result = m_ring.Initialize(static_cast<uint32>(m_slots.size()) + 1);
+            if (result < 0) {
+                return result;
+            }
+            m_wakeFd = eventfd(0, EFD_CLOEXEC);
+            if (m_wakeFd < 0) {
+                return -errno;
+            }
+            for (uint32 i = 0; i < m_slots.size(); ++i) {
+                m_freeSlots.push_back(i);
+            }
+            m_thread = std::thread([this]() { Run(); });
+            return 0;
+        }
+
+        FileIoBackend GetType() const override { return FileIoBackend::IoUring; }
+
+        void Wake() override {
+            uint64 one = 1;
+            ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+            (void)written;  // A full counter already means a pending wake-up
+        }
+
+        void Stop() override {
+            if (m_thread.joinable()) {
+                Wake();
+                m_thread.join();
+            }
+        }
+
+    private:
+        struct Slot {
+            Request request;
+            FileReadResult result;
+            int fd{-1};
+            size_t offset{0};
+        };
+
+        void Run() {
+            ArmWake();
+            std::vector<Request> incoming;
+            bool accepting = true;
+
+            while (accepting || m_inFlight > 0) {
+                if (accepting && !m_freeSlots.empty()) {
+                    accepting = PopRequests(incoming, static_cast<uint32>(m_freeSlots.size()), false);
+                    for (Request& request : incoming) {
+                        StartRead(std::move(request));
+                    }
+                }
+                if (!accepting && m_inFlight == 0) {
+                    break;
+                }
+
+                int result = m_ring.Submit(1);
+                if (result < 0 && result != -EBUSY && result != -EAGAIN) {
+                    XESS_ERROR("io_uring_enter failed: {}", std::strerror(-result));
+                }
+
+                m_ring.Reap([this](const io_uring_cqe& cqe) {
+                    if (cqe.user_data == WakeTag) {
+                        ArmWake();
+                    } else {
+                        OnReadComplete(static_cast<uint32>(cqe.user_data - 1), cqe.res);
+                    }
+                });
+            }
+        }
+
+        void ArmWake() {
+            if (io_uring_sqe* sqe = m_ring.NextSqe()) {
+                sqe->opcode = IORING_OP_READ;
+                sqe->fd = m_wakeFd;
+                sqe->addr = reinterpret_cast<uint64>(&m_wakeValue);
+                sqe->len = sizeof(m_wakeValue);
+                sqe->user_data = WakeTag;
+            }
+        }
+
+        void StartRead(Request&& request) {
+            BeginRead();
+
+            FileReadResult result;
+            result.path = request.path;
+
+            int fd = ::open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat info{};
+            if (fd < 0 || fstat(fd, &info) != 0) {
+                result.error = std::strerror(errno);
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                Complete(request, std::move(result));
+                return;
+            }
+
+            if (info.st_size == 0) {
+                ::close(fd);
+                result.success = true;
+                Complete(request, std::move(result));
+                return;
+            }
+
+            uint32 index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            Slot& slot = m_slots[index];
+            slot.request = std::move(request);
+            slot.result = std::move(result);
+            slot.result.data.resize(static_cast<size_t>(info.st_size));
+            slot.fd = fd;
+            slot.offset = 0;
+            ++m_inFlight;
+            SubmitRead(index);
+        }
+
+        void SubmitRead(uint32 index) {
+            Slot& slot = m_slots[index];
+            io_uring_sqe* sqe = m_ring.NextSqe();
+            if (!sqe) {
+                // Sized for every slot, so only a broken ring gets here
+                slot.result.error = "io_uring submission queue full";
+                FinishSlot(index);
+                return;
+            }
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = slot.fd;
+            sqe->addr = reinterpret_cast<uint64>(slot.result.data.data() + slot.offset);
+            sqe->len = static_cast<uint32>(std::min(slot.result.data.size() - slot.offset, MaxReadChunk));
+            sqe->off = slot.offset;
+            sqe->user_data = index + 1;
+        }
+
+        void OnReadComplete(uint32 index, int32 result) {
+            Slot& slot = m_slots[index];
+            if (result == -EINTR || result == -EAGAIN) {
+                SubmitRead(index);
+                return;
+            }
+            if (result < 0) {
+                slot.result.error = std::strerror(-result);
+                FinishSlot(index);
+                return;
+            }
+
+            slot.offset += static_cast<size_t>(result);
+            if (result > 0 && slot.offset < slot.result.data.size()) {
+                SubmitRead(index);  // Short read: continue where it stopped
+                return;
+            }
+
+            slot.result.data.resize(slot.offset);
+            slot.result.success = true;
+            FinishSlot(index);
+        }
+
+        void FinishSlot(uint32 index) {
+            Slot& slot = m_slots[index];
+            ::close(slot.fd);
+            slot.fd = -1;
+            --m_inFlight;
+            m_freeSlots.push_back(index);
+
+            Request request = std::move(slot.request);
+            Complete(request, std::move(slot.result));
+            slot.result = {};
+        }
+
+        Ring m_ring;
+        int m_wakeFd{-1};
+        uint64 m_wakeValue{0};
+        std::vector<Slot> m_slots;
+        std::vector<uint32> m_freeSlots;
+        uint32 m_inFlight{0};
+        std::thread m_thread;
+    };
+#endif
+}
+
+// FileSystem Implementation
+FileSystem& FileSystem::Instance() {
+    static FileSystem instance;
+    return instance;
+}
+
+FileSystem::FileSystem() = default;
+
+FileSystem::~FileSystem() {
+    Shutdown();
+}
+
+void FileSystem::Initialize(const FileSystemConfig& config) {
+    Shutdown();
+    std::lock_guard<std::mutex> lock(m_backendMutex);
+    m_config = config;
+}
+
+void FileSystem::Shutdown() {
+    WaitIdle();
+
+    std::unique_ptr<Backend> backend;
+    {
+        std::lock_guard<std::mutex> lock(m_backendMutex);
+        if (!m_backend) {
+            return;
+        }
+        m_stopping = true;
+        backend = std::move(m_backend);
+    }
+    m_requestCondition.notify_all();
+    backend->Stop();
+    backend.reset();
+
+    std::lock_guard<std::mutex> lock(m_backendMutex);
+    m_stopping = false;
+}
+
+void FileSystem::EnsureBackend() {
+    // Called with m_backendMutex held
+    if (m_backend) {
+        return;
+    }
+
+#ifdef XESS_FS_IO_URING
+    if (m_config.backend != FileIoBackend::ThreadPool) {
+        auto backend = std::make_unique<IoUringBackend>(*this, m_config.queueDepth);
+        int result = backend->Start();
+        if (result == 0) {
+            XESS_INFO("File I/O backend: io_uring, queue depth {}", m_config.queueDepth);
+            m_backend = std::move(backend);
+            return;
+        }
+        XESS_WARNING("io_uring unavailable ({}), using reader threads", std::strerror(-result));
+    }
+#else
+    if (m_config.backend == FileIoBackend::IoUring) {
+        XESS_WARNING("io_uring is not available on this platform, using reader threads");
+    }
+#endif
+
+    XESS_INFO("File I/O backend: {} reader threads", m_config.threadPoolSize);
+    m_backend = std::make_unique<ThreadPoolBackend>(*this, m_config.threadPoolSize);
+}
+
+namespace {
+    template<typename Buffer>
+    bool ReadAndRecord(const std::string& path, Buffer& data) {
+        auto start = std::chrono::steady_clock::now();
+        std::string error;
+        if (!ReadWholeFile(path, data, error)) {
+            s_readFailures.Add();
+            XESS_ERROR("Failed to read file {}: {}", path, error);
+            return false;
+        }
+        s_reads.Add();
+        s_bytesRead.Add(data.size());
+        s_readLatency.Observe(MillisecondsSince(start));
+        return true;
+    }
+}
+
+bool FileSystem::ReadFile(const std::string& path, std::vector<uint8>& data) {
+    BeginRead();
+    bool success = ReadAndRecord(path, data);
+    EndRead();
+    return success;
+}
+
+bool FileSystem::ReadText(const std::string& path, std::string& text) {
+    BeginRead();
+    bool success = ReadAndRecord(path, text);
+    EndRead();
+    return success;
+}
+
+std::shared_ptr<const MappedFile> FileSystem::Map(const std::string& path) {
+    std::error_code error;
+    int64 writeTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    uint64 size = error ? 0 : std::filesystem::file_size(path, error);
+
+    std::lock_guard<std::mutex> lock(m_mappingMutex);
+    if (!error) {
+        auto it = m_mappings.find(path);
+        if (it != m_mappings.end() && it->second.writeTime == writeTime && it->second.size == size) {
+            if (auto mapping = it->second.mapping.lock()) {
+                return mapping;
+            }
+        }
+    }
+
+    auto mapping = std::make_shared<MappedFile>();
+    if (!mapping->Open(path)) {
+        return nullptr;
+    }
+    s_bytesMapped.Add(mapping->GetSize());
+
+    // Drop entries whose mappings are gone, so the table tracks live views only
+    std::erase_if(m_mappings, [](const auto& entry) { return entry.second.mapping.expired(); });
+    m_mappings[path] = {mapping, writeTime, mapping->GetSize()};
+    return mapping;
+}
+
+void FileSystem::ReadAsync(const std::string& path, ReadCallback callback) {
+    std::vector<Request> requests;
+    requests.push_back({path, std::move(callback), std::chrono::steady_clock::now()});
+    Enqueue(std::move(requests));
+}
+
+std::future<FileReadResult> FileSystem::ReadAsync(const std::string& path) {
+    auto promise = std::make_shared<std::promise<FileReadResult>>();
+    std::future<FileReadResult> future = promise->get_future();
+    ReadAsync(path, [promise](FileReadResult&& result) {
+        promise->set_value(std::move(result));
+    });
+    return future;
+}
+
+Task<FileReadResult> FileSystem::ReadTask(std::string path) {
+    // The completion already runs as a job, so the coroutine resumes inside it
+    co_return co_await AwaitCallback<FileReadResult>([this, &path](auto complete) {
+        ReadAsync(path, std::move(complete));
+    });
+}
+
+void FileSystem::ReadBatchAsync(const std::vector<std::string>& paths, BatchCallback callback) {
+    if (paths.empty()) {
+        JobSystem::Instance().Submit([callback]() { callback({}); });
+        return;
+    }
+
+    struct Batch {
+        std::vector<FileReadResult> results;
+        std::atomic<uint32> remaining;
+        BatchCallback callback;
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->results.resize(paths.size());
+    batch->remaining.store(static_cast<uint32>(paths.size()), std::memory_order_relaxed);
+    batch->callback = std::move(callback);
+
+    auto now = std::chrono::steady_clock::now();
+    std::vector<Request> requests;
+    requests.reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        requests.push_back({paths[i], [batch, i](FileReadResult&& result) {
+            batch->results[i] = std::move(result);
+            if (batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                batch->callback(std::move(batch->results));
+            }
+        }, now});
+    }
+    Enqueue(std::move(requests));
+}
+
+void FileSystem::Enqueue(std::vector<Request> requests) {
+    m_pending.fetch_add(static_cast<uint32>(requests.size()), std::memory_order_acq_rel);
+
+    Backend* backend;
+    {
+        std::lock_guard<std::mutex> lock(m_backendMutex);
+        EnsureBackend();
+        for (Request& request : requests) {
+            m_requests.push_back(std::move(request));
+        }
+        backend = m_backend.get();
+    }
+    m_requestCondition.notify_all();
+    backend->Wake();
+}
+
+bool FileSystem::PopRequests(std::vector<Request>& out, uint32 maxCount, bool wait) {
+    out.clear();
+    std::unique_lock<std::mutex> lock(m_backendMutex);
+    if (wait) {
+        m_requestCondition.wait(lock, [this]() { return m_stopping || !m_requests.empty(); });
+    }
+    while (!m_requests.empty() && out.size() < maxCount) {
+        out.push_back(std::move(m_requests.front()));
+        m_requests.pop_front();
+    }
+    return !(m_stopping && m_requests.empty() && out.empty());
+}
+
+void FileSystem::BeginRead() {
+    std::lock_guard<std::mutex> lock(m_busyMutex);
+    if (m_inFlight++ == 0) {
+        m_busyStart = std::chrono::steady_clock::now();
+    }
+}
+
+void FileSystem::EndRead() {
+    std::lock_guard<std::mutex> lock(m_busyMutex);
+    if (--m_inFlight == 0) {
+        auto busy = std::chrono::steady_clock::now() - m_busyStart;
+        m_busyNanoseconds.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count(), std::memory_order_relaxed);
+    }
+}
+
+void FileSystem::Complete(Request& request, FileReadResult&& result) {
+    EndRead();
+
+    if (result.success) {
+        s_reads.Add();
+        s_bytesRead.Add(result.data.size());
+        s_readLatency.Observe(MillisecondsSince(request.queued));
+    } else {
+        s_readFailures.Add();
+        XESS_ERROR("Failed to read file {}: {}", request.path, result.error);
+    }
+
+    // The pending count drops only after the callback ran, so WaitIdle()
+    // also covers the work done in callbacks
+    JobSystem::Instance().Submit([this, callback = std::move(request.callback), result = std::move(result)]() mutable {
+        struct PendingScope {
+            FileSystem& fileSystem;
+            ~PendingScope() {
+                if (fileSystem.m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(fileSystem.m_idleMutex);
+                    fileSystem.m_idleCondition.notify_all();
+                }
+            }
+        } scope{*this};
+
+        if (callback) {
+            callback(std::move(result));
+        }
+    });
+}
+
+void FileSystem::WaitIdle() {
+    while (m_pending.load(std::memory_order_acquire) > 0) {
+        if (JobSystem::Instance().RunPendingJob()) {
+            continue;
+        }
+        // Completions may also arrive as new jobs, so the wait is bounded
+        std::unique_lock<std::mutex> lock(m_idleMutex);
+        m_idleCondition.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+            return m_pending.load(std::memory_order_acquire) == 0;
+        });
+    }
+}
+
+FileIoBackend FileSystem::GetActiveBackend() const {
+    std::lock_guard<std::mutex> lock(m_backendMutex);
+    return m_backend ? m_backend->GetType() : FileIoBackend::Auto;
+}
+
+FileSystemStats FileSystem::GetStats() const {
+    FileSystemStats stats;
+    stats.backend = BackendName(GetActiveBackend());
+    stats.readsCompleted = s_reads.Value();
+    stats.readsFailed = s_readFailures.Value();
+    stats.bytesRead = s_bytesRead.Value();
+    stats.bytesMapped = s_bytesMapped.Value();
+
+    uint64 busyNanoseconds = m_busyNanoseconds.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_busyMutex);
+        if (m_inFlight > 0) {
+            busyNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_busyStart).count();
+        }
+    }
+    stats.busySeconds = static_cast<float64>(busyNanoseconds) * 1e-9;
+
+    uint64 latencyCount = 0;
+    for (uint64 bucket : s_readLatency.BucketCounts()) {
+        latencyCount += bucket;
+    }
+    stats.averageLatencyMs = latencyCount > 0 ? s_readLatency.Sum() / latencyCount : 0.0;
+    return stats;
+}
+
+} // namespace XeSS
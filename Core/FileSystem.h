@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Types.h"
+#include "NonCopyable.h"
+#include "MappedFile.h"
+#include "Task.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace XeSS {
+
+struct FileReadResult {
+    std::string path;
+    std::vector<uint8> data;
+    bool success{false};
+    std::string error;
+
+    std::string_view GetText() const {
+        return {reinterpret_cast<const char*>(data.data()), data.size()};
+    }
+};
+
+enum class FileIoBackend : uint8 {
+    Auto,       // io_uring where the kernel allows it, otherwise the thread pool
+    IoUring,
+    ThreadPool
+};
+
+struct FileSystemConfig {
+    FileIoBackend backend = FileIoBackend::Auto;
+    uint32 queueDepth = 64;         // Reads in flight at once
+    uint32 threadPoolSize = 2;      // Reader threads of the fallback backend
+};
+
+struct FileSystemStats {
+    const char* backend{"none"};
+    uint64 readsCompleted{0};
+    uint64 readsFailed{0};
+    uint64 bytesRead{0};
+    uint64 bytesMapped{0};
+    float64 busySeconds{0.0};       // Wall time with at least one read in flight
+    float64 averageLatencyMs{0.0};  // Request to completion, queueing included
+
+    float64 ThroughputMBps() const {
+        return busySeconds > 0.0 ? static_cast<float64>(bytesRead) / (1024.0 * 1024.0) / busySeconds : 0.0;
+    }
+};
+
+/**
+ * Process-wide file service. Read-mostly files are memory mapped and shared;
+ * whole-file reads run on a background I/O thread (io_uring on Linux, a small
+ * reader pool elsewhere) and complete through the JobSystem, so loading never
+ * blocks the frame thread. The I/O backend starts on the first asynchronous
+ * read; Initialize() only needs to be called to change the configuration.
+ *
+ * Before JobSystem::Initialize() completion callbacks run on the I/O thread.
+ */
+class FileSystem : public NonCopyable {
+public:
+    using ReadCallback = std::function<void(FileReadResult&& result)>;
+    using BatchCallback = std::function<void(std::vector<FileReadResult>&& results)>;
+
+    static FileSystem& Instance();
+
+    void Initialize(const FileSystemConfig& config = {});
+    void Shutdown();
+
+    // Blocking read on the calling thread; paths are UTF-8
+    bool ReadFile(const std::string& path, std::vector<uint8>& data);
+    bool ReadText(const std::string& path, std::string& text);
+
+    // Shared read-only mapping; callers mapping an unchanged file get the same
+    // view. Returns null (and logs) if the file cannot be mapped.
+    std::shared_ptr<const MappedFile> Map(const std::string& path);
+
+    // The callback runs as a job once the whole file is in memory
+    void ReadAsync(const std::string& path, ReadCallback callback);
+    std::future<FileReadResult> ReadAsync(const std::string& path);
+
+    // Coroutine form: co_await ReadTask(path) resumes as a job once the file is read
+    Task<FileReadResult> ReadTask(std::string path);
+
+    // All paths are queued with one wake-up; the callback gets the results in
+    // path order after the last read finished
+    void ReadBatchAsync(const std::vector<std::string>& paths, BatchCallback callback);
+
+    // Blocks until every queued read and its callback finished, running jobs meanwhile
+    void WaitIdle();
+
+    uint32 GetPendingCount() const { return m_pending.load(std::memory_order_acquire); }
+    FileIoBackend GetActiveBackend() const;
+    FileSystemStats GetStats() const;
+
+    // I/O backend interface, implemented in FileSystem.cpp
+    class Backend;
+
+private:
+
+    FileSystem();
+    ~FileSystem();
+
+    struct Request {
+        std::string path;
+        ReadCallback callback;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    struct MappingEntry {
+        std::weak_ptr<const MappedFile> mapping;
+        int64 writeTime{0};
+        uint64 size{0};
+    };
+
+    void EnsureBackend();
+    void Enqueue(std::vector<Request> requests);
+    void Complete(Request& request, FileReadResult&& result);
+
+    // Used by backends; m_backendMutex guards the request queue
+    bool PopRequests(std::vector<Request>& out, uint32 maxCount, bool wait);
+    void BeginRead();
+    void EndRead();
+
+    FileSystemConfig m_config;
+
+    mutable std::mutex m_backendMutex;
+    std::condition_variable m_requestCondition;
+    std::deque<Request> m_requests;
+    std::unique_ptr<Backend> m_backend;
+    bool m_stopping{false};
+
+    std::atomic<uint32> m_pending{0};
+    std::mutex m_idleMutex;
+    std::condition_variable m_idleCondition;
+
+    // Busy time: intervals with at least one read in flight
+    mutable std::mutex m_busyMutex;
+    uint32 m_inFlight{0};
+    std::chrono::steady_clock::time_point m_busyStart;
+    std::atomic<uint64> m_busyNanoseconds{0};
+
+    std::mutex m_mappingMutex;
+    std::unordered_map<std::string, MappingEntry> m_mappings;
+};
+
+} // namespace XeSS
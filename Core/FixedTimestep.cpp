@@ -0,0 +1,56 @@
+#include "FixedTimestep.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace XeSS {
+
+FixedTimestep::FixedTimestep(const FixedTimestepConfig& config) {
+    SetConfig(config);
+}
+
+void FixedTimestep::SetConfig(const FixedTimestepConfig& config) {
+    m_config = config;
+    if (!(m_config.stepSeconds > 0.0)) {
+        XESS_WARNING("Invalid fixed timestep {}, using 1/60 s", m_config.stepSeconds);
+        m_config.stepSeconds = 1.0 / 60.0;
+    }
+    m_config.maxStepsPerFrame = std::max<uint32>(m_config.maxStepsPerFrame, 1);
+    Reset();
+}
+
+uint32 FixedTimestep::Advance(float64 frameDeltaSeconds) {
+    if (!std::isfinite(frameDeltaSeconds) || frameDeltaSeconds < 0.0) {
+        frameDeltaSeconds = 0.0;
+    }
+
+    m_accumulator += frameDeltaSeconds;
+
+    uint32 steps = static_cast<uint32>(m_accumulator / m_config.stepSeconds);
+    if (steps > m_config.maxStepsPerFrame) {
+        // Falling behind: run the budgeted steps and drop the backlog so one
+        // hitch doesn't make every following frame slower too
+        float64 dropped = m_accumulator - m_config.maxStepsPerFrame * m_config.stepSeconds;
+        m_droppedSeconds += dropped;
+        ++m_clampedFrames;
+        steps = m_config.maxStepsPerFrame;
+        m_accumulator = 0.0;
+    } else {
+        m_accumulator -= steps * m_config.stepSeconds;
+    }
+
+    // Guard against the remainder drifting to a full step through rounding
+    m_accumulator = std::clamp(m_accumulator, 0.0, m_config.stepSeconds * 0.999999);
+
+    m_stepIndex += steps;
+    return steps;
+}
+
+void FixedTimestep::Reset() {
+    m_accumulator = 0.0;
+    m_stepIndex = 0;
+    m_clampedFrames = 0;
+    m_droppedSeconds = 0.0;
+}
+
+} // namespace XeSS
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Types.h"
+
+namespace XeSS {
+
+struct FixedTimestepConfig {
+    float64 stepSeconds{1.0 / 60.0};
+
+    // Spiral-of-death guard: time beyond this many steps is dropped rather
+    // than carried into the next frame
+    uint32 maxStepsPerFrame{5};
+};
+
+/**
+ * Accumulates variable frame time and converts it into whole fixed-size
+ * simulation steps. The remainder is exposed as an interpolation alpha so
+ * rendering can blend between the previous and current simulation states.
+ */
+class FixedTimestep {
+public:
+    explicit FixedTimestep(const FixedTimestepConfig& config = {});
+
+    void SetConfig(const FixedTimestepConfig& config);
+    const FixedTimestepConfig& GetConfig() const { return m_config; }
+
+    // Adds frame time and returns the number of steps to simulate this frame
+    uint32 Advance(float64 frameDeltaSeconds);
+
+    // Runs step(stepSeconds, stepIndex) for each step due this frame
+    template<typename StepFunc>
+    uint32 Run(float64 frameDeltaSeconds, StepFunc&& step) {
+        uint32 steps = Advance(frameDeltaSeconds);
+        for (uint32 i = 0; i < steps; ++i) {
+            step(m_config.stepSeconds, m_stepIndex - steps + i);
+        }
+        return steps;
+    }
+
+    void Reset();
+
+    // Remaining fraction of a step, in [0, 1)
+    float32 GetAlpha() const { return static_cast<float32>(m_accumulator / m_config.stepSeconds); }
+    float64 GetStepSeconds() const { return m_config.stepSeconds; }
+
+    uint64 GetTotalSteps() const { return m_stepIndex; }
+    uint64 GetClampedFrames() const { return m_clampedFrames; }
+    float64 GetDroppedSeconds() const { return m_droppedSeconds; }
+
+private:
+    FixedTimestepConfig m_config;
+    float64 m_accumulator{0.0};
+    uint64 m_stepIndex{0};
+    uint64 m_clampedFrames{0};
+    float64 m_droppedSeconds{0.0};
+};
+
+} // namespace XeSS
@@ -0,0 +1,140 @@
+#include "FrameStats.h"
+#include "Logger.h"
+#include "JsonWriter.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace XeSS {
+
+namespace {
+    // Nearest-rank percentile over sorted samples
+    float64 Percentile(const std::vector<float32>& sorted, float64 percentile) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted.size()));
+        rank = std::clamp<size_t>(rank, 1, sorted.size());
+        return sorted[rank - 1];
+    }
+}
+
+FrameStats::FrameStats(uint32 capacity)
+    : m_capacity(std::max<uint32>(capacity, 1)) {
+    m_samples.reserve(m_capacity);
+}
+
+void FrameStats::BeginFrame() {
+    m_frameStart = Clock::now();
+    m_inFrame = true;
+}
+
+void FrameStats::EndFrame() {
+    if (!m_inFrame) {
+        return;
+    }
+    m_inFrame = false;
+    AddSample(std::chrono::duration<float64, std::milli>(Clock::now() - m_frameStart).count());
+}
+
+void FrameStats::AddSample(float64 frameTimeMs) {
+    // Keep the most recent m_capacity samples in a ring
+    if (m_samples.size() < m_capacity) {
+        m_samples.push_back(static_cast<float32>(frameTimeMs));
+    } else {
+        m_samples[m_writeIndex] = static_cast<float32>(frameTimeMs);
+        m_writeIndex = (m_writeIndex + 1) % m_capacity;
+    }
+
+    m_lastFrameTimeMs = frameTimeMs;
+    ++m_frameCount;
+}
+
+void FrameStats::Reset() {
+    m_samples.clear();
+    m_writeIndex = 0;
+    m_frameCount = 0;
+    m_lastFrameTimeMs = 0.0;
+    m_inFrame = false;
+}
+
+void FrameStats::SetCapacity(uint32 capacity) {
+    m_capacity = std::max<uint32>(capacity, 1);
+    Reset();
+    m_samples.reserve(m_capacity);
+}
+
+FrameTimeSummary FrameStats::Summarize() const {
+    return Summarize(m_samples);
+}
+
+FrameTimeSummary FrameStats::Summarize(std::vector<float32> samples) {
+    FrameTimeSummary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    float64 total = 0.0;
+    for (float32 sample : samples) {
+        total += sample;
+    }
+
+    float64 mean = total / samples.size();
+    float64 variance = 0.0;
+    for (float32 sample : samples) {
+        float64 delta = sample - mean;
+        variance += delta * delta;
+    }
+
+    summary.frameCount = samples.size();
+    summary.totalMs = total;
+    summary.minMs = samples.front();
+    summary.maxMs = samples.back();
+    summary.meanMs = mean;
+    summary.stdDevMs = samples.size() > 1 ? std::sqrt(variance / (samples.size() - 1)) : 0.0;
+    summary.p50Ms = Percentile(samples, 50.0);
+    summary.p90Ms = Percentile(samples, 90.0);
+    summary.p95Ms = Percentile(samples, 95.0);
+    summary.p99Ms = Percentile(samples, 99.0);
+    return summary;
+}
+
+std::string FrameStats::FormatReport(const std::string& title) const {
+    FrameTimeSummary summary = Summarize();
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "=== " << title << " ===\n";
+    oss << "  Frames:   " << m_frameCount << " (" << summary.frameCount << " sampled)\n";
+    oss << "  Avg FPS:  " << std::setprecision(1) << summary.AverageFPS() << std::setprecision(3) << "\n";
+    oss << "  Mean:     " << summary.meanMs << " ms (stddev " << summary.stdDevMs << ")\n";
+    oss << "  Min/Max:  " << summary.minMs << " / " << summary.maxMs << " ms\n";
+    oss << "  P50/P90:  " << summary.p50Ms << " / " << summary.p90Ms << " ms\n";
+    oss << "  P95/P99:  " << summary.p95Ms << " / " << summary.p99Ms << " ms";
+    return oss.str();
+}
+
+void FrameStats::WriteSummaryJson(JsonWriter& writer, const std::string& key,
+                                  const FrameTimeSummary& summary) {
+    writer.BeginObject(key)
+        .Field("frames", summary.frameCount)
+        .Field("mean_ms", summary.meanMs)
+        .Field("stddev_ms", summary.stdDevMs)
+        .Field("min_ms", summary.minMs)
+        .Field("max_ms", summary.maxMs)
+        .Field("p50_ms", summary.p50Ms)
+        .Field("p90_ms", summary.p90Ms)
+        .Field("p95_ms", summary.p95Ms)
+        .Field("p99_ms", summary.p99Ms)
+        .Field("avg_fps", summary.AverageFPS())
+        .EndObject();
+}
+
+void FrameStats::LogReport(const std::string& title) const {
+    XESS_INFO("{}", FormatReport(title));
+}
+
+} // namespace XeSS
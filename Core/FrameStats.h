@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Types.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace XeSS {
+
+class JsonWriter;
+
+// Distribution summary of a set of frame-time samples (milliseconds)
+struct FrameTimeSummary {
+    uint64 frameCount{0};
+    float64 totalMs{0.0};
+    float64 minMs{0.0};
+    float64 maxMs{0.0};
+    float64 meanMs{0.0};
+    float64 stdDevMs{0.0};
+    float64 p50Ms{0.0};
+    float64 p90Ms{0.0};
+    float64 p95Ms{0.0};
+    float64 p99Ms{0.0};
+
+    float64 AverageFPS() const {
+        return meanMs > 0.0 ? 1000.0 / meanMs : 0.0;
+    }
+};
+
+/**
+ * Records per-frame CPU timings and reports their distribution.
+ * Samples are kept in a preallocated buffer so recording never allocates
+ * inside the frame once the capacity is reached.
+ */
+class FrameStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FrameStats(uint32 capacity = 10000);
+
+    // Frame timing: BeginFrame/EndFrame bracket one frame, or add samples directly
+    void BeginFrame();
+    void EndFrame();
+    void AddSample(float64 frameTimeMs);
+
+    void Reset();
+    void SetCapacity(uint32 capacity);
+
+    uint64 GetFrameCount() const { return m_frameCount; }
+    const std::vector<float32>& GetSamples() const { return m_samples; }
+    float64 GetLastFrameTimeMs() const { return m_lastFrameTimeMs; }
+
+    // Summary over the retained samples
+    FrameTimeSummary Summarize() const;
+
+    // Human readable report, logged at Info level by LogReport
+    std::string FormatReport(const std::string& title) const;
+    void LogReport(const std::string& title) const;
+
+    static FrameTimeSummary Summarize(std::vector<float32> samples);
+    static void WriteSummaryJson(JsonWriter& writer, const std::string& key,
+                                 const FrameTimeSummary& summary);
+
+private:
+    std::vector<float32> m_samples;
+    uint32 m_capacity;
+    uint32 m_writeIndex{0};
+    uint64 m_frameCount{0};
+    float64 m_lastFrameTimeMs{0.0};
+    Clock::time_point m_frameStart;
+    bool m_inFrame{false};
+};
+
+} // namespace XeSS
@@ -0,0 +1,174 @@
+#include "InputQueue.h"
+#include "Logger.h"
+#include <algorithm>
+
+namespace XeSS {
+
+InputQueue::InputQueue(uint32 capacity)
+    : m_events(capacity) {
+}
+
+void InputQueue::PushKey(uint32 key, bool down) {
+    InputEvent event;
+    event.type = down ? InputEventType::KeyDown : InputEventType::KeyUp;
+    event.code = key;
+    Push(event);
+}
+
+void InputQueue::PushMouseMove(int32 x, int32 y) {
+    InputEvent event;
+    event.type = InputEventType::MouseMove;
+    event.x = x;
+    event.y = y;
+    Push(event);
+}
+
+void InputQueue::PushMouseButton(uint32 button, bool pressed) {
+    InputEvent event;
+    event.type = InputEventType::MouseButton;
+    event.code = button;
+    event.pressed = pressed;
+    Push(event);
+}
+
+void InputQueue::Push(const InputEvent& event) {
+    InputEvent stamped = event;
+    if (stamped.timestampUs == 0) {
+        stamped.timestampUs = NowUs();
+    }
+
+    // The snapshot is updated even if the queue overflows, so late sampling
+    // stays correct when the frame loop stalls
+    UpdateSnapshot(stamped);
+
+    if (!m_events.TryPush(stamped)) {
+        m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+InputSnapshot InputQueue::SampleLatest() const {
+    InputSnapshot snapshot;
+
+    uint64 position = m_mousePosition.load(std::memory_order_acquire);
+    snapshot.mouseX = static_cast<int32>(static_cast<uint32>(position));
+    snapshot.mouseY = static_cast<int32>(static_cast<uint32>(position >> 32));
+    snapshot.mouseButtons = m_mouseButtons.load(std::memory_order_acquire);
+    for (size_t i = 0; i < m_keys.size(); ++i) {
+        snapshot.keys[i] = m_keys[i].load(std::memory_order_acquire);
+    }
+    snapshot.timestampUs = m_lastTimestampUs.load(std::memory_order_acquire);
+
+    return snapshot;
+}
+
+uint64 InputQueue::NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void InputQueue::UpdateSnapshot(const InputEvent& event) {
+    switch (event.type) {
+        case InputEventType::KeyDown:
+        case InputEventType::KeyUp:
+            if (event.code < 256) {
+                uint64 bit = 1ull << (event.code & 63);
+                auto& word = m_keys[event.code >> 6];
+                if (event.type == InputEventType::KeyDown) {
+                    word.fetch_or(bit, std::memory_order_release);
+                } else {
+                    word.fetch_and(~bit, std::memory_order_release);
+                }
+            }
+            break;
+        case InputEventType::MouseMove: {
+            uint64 position = static_cast<uint64>(static_cast<uint32>(event.x)) |
+                              (static_cast<uint64>(static_cast<uint32>(event.y)) << 32);
+            m_mousePosition.store(position, std::memory_order_release);
+            break;
+        }
+        case InputEventType::MouseButton:
+            if (event.code < 32) {
+                uint32 bit = 1u << event.code;
+                if (event.pressed) {
+                    m_mouseButtons.fetch_or(bit, std::memory_order_release);
+                } else {
+                    m_mouseButtons.fetch_and(~bit, std::memory_order_release);
+                }
+            }
+            break;
+    }
+
+    m_lastTimestampUs.store(event.timestampUs, std::memory_order_release);
+}
+
+// SyntheticInputSource Implementation
+SyntheticInputSource::~SyntheticInputSource() {
+    Stop();
+}
+
+void SyntheticInputSource::AddEvent(std::chrono::microseconds offset, const InputEvent& event) {
+    m_events.push_back({offset, event});
+}
+
+void SyntheticInputSource::AddKeyPress(std::chrono::microseconds offset, uint32 key,
+                                       std::chrono::microseconds holdTime) {
+    InputEvent down;
+    down.type = InputEventType::KeyDown;
+    down.code = key;
+    AddEvent(offset, down);
+
+    InputEvent up = down;
+    up.type = InputEventType::KeyUp;
+    AddEvent(offset + holdTime, up);
+}
+
+void SyntheticInputSource::AddMouseMove(std::chrono::microseconds offset, int32 x, int32 y) {
+    InputEvent event;
+    event.type = InputEventType::MouseMove;
+    event.x = x;
+    event.y = y;
+    AddEvent(offset, event);
+}
+
+void SyntheticInputSource::Start(InputQueue& queue) {
+    Stop();
+
+    std::stable_sort(m_events.begin(), m_events.end(),
+        [](const ScheduledEvent& a, const ScheduledEvent& b) { return a.offset < b.offset; });
+
+    m_stopRequested = false;
+    m_finished.store(false, std::memory_order_release);
+
+    m_thread = std::thread([this, &queue]() {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& scheduled : m_events) {
+            {
+                // Sleep until the event is due, or return as soon as Stop() asks
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_stopCondition.wait_until(lock, start + scheduled.offset, [this] { return m_stopRequested; })) {
+                    break;
+                }
+            }
+
+            InputEvent event = scheduled.event;
+            event.timestampUs = 0; // Stamp at delivery time
+            queue.Push(event);
+        }
+        m_finished.store(true, std::memory_order_release);
+    });
+
+    XESS_DEBUG("Synthetic input source started with {} events", m_events.size());
+}
+
+void SyntheticInputSource::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+    m_stopCondition.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+} // namespace XeSS
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Types.h"
+#include "NonCopyable.h"
+#include "SPSCQueue.h"
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace XeSS {
+
+enum class InputEventType : uint8 {
+    KeyDown,
+    KeyUp,
+    MouseMove,
+    MouseButton
+};
+
+struct InputEvent {
+    InputEventType type{InputEventType::KeyDown};
+    bool pressed{false};     // MouseButton
+    uint32 code{0};          // Virtual key or mouse button index
+    int32 x{0};              // MouseMove
+    int32 y{0};
+    uint64 timestampUs{0};   // Steady clock time the OS delivered the event
+};
+
+// Most recent input state, readable from any thread at any time
+struct InputSnapshot {
+    int32 mouseX{0};
+    int32 mouseY{0};
+    uint32 mouseButtons{0};  // Bit per button
+    uint64 timestampUs{0};   // Time of the newest event folded into the snapshot
+    std::array<uint64, 4> keys{};
+
+    bool IsKeyDown(uint32 key) const {
+        return key < 256 && (keys[key >> 6] & (1ull << (key & 63))) != 0;
+    }
+    bool IsMouseButtonDown(uint32 button) const {
+        return button < 32 && (mouseButtons & (1u << button)) != 0;
+    }
+};
+
+/**
+ * Timestamped input event queue between the OS event thread (producer) and
+ * the frame loop (consumer). Events are drained at a defined point of the
+ * frame; SampleLatest() additionally exposes the newest state so mouse/key
+ * state can be read as late as possible before render submission.
+ */
+class InputQueue : public NonCopyable {
+public:
+    explicit InputQueue(uint32 capacity = 1024);
+
+    // Producer side (OS event thread)
+    void PushKey(uint32 key, bool down);
+    void PushMouseMove(int32 x, int32 y);
+    void PushMouseButton(uint32 button, bool pressed);
+    void Push(const InputEvent& event);
+
+    // Consumer side: invokes handler for every queued event in order
+    template<typename Handler>
+    uint32 Drain(Handler&& handler) {
+        uint32 count = 0;
+        InputEvent event;
+        while (m_events.TryPop(event)) {
+            // Read per event: the producer may stamp one after the loop began
+            const uint64 now = NowUs();
+            m_lastDrainLatencyUs.store(now > event.timestampUs ? now - event.timestampUs : 0,
+                                       std::memory_order_relaxed);
+            handler(event);
+            ++count;
+        }
+        m_drainedEvents.store(m_drainedEvents.load(std::memory_order_relaxed) + count,
+                              std::memory_order_relaxed);
+        return count;
+    }
+
+    // Lock-free read of the newest state, from any thread
+    InputSnapshot SampleLatest() const;
+
+    // Statistics
+    uint64 GetDroppedEventCount() const { return m_droppedEvents.load(std::memory_order_relaxed); }
+    uint64 GetDrainedEventCount() const { return m_drainedEvents.load(std::memory_order_relaxed); }
+    uint64 GetLastDrainLatencyUs() const { return m_lastDrainLatencyUs.load(std::memory_order_relaxed); }
+
+    static uint64 NowUs();
+
+private:
+    void UpdateSnapshot(const InputEvent& event);
+
+    SPSCQueue<InputEvent> m_events;
+    std::atomic<uint64> m_droppedEvents{0};
+
+    // Snapshot state, written only by the producer
+    alignas(64) std::atomic<uint64> m_mousePosition{0}; // x in low 32 bits, y in high
+    std::atomic<uint32> m_mouseButtons{0};
+    std::atomic<uint64> m_lastTimestampUs{0};
+    std::array<std::atomic<uint64>, 4> m_keys{};
+
+    // Consumer statistics, written only by the consumer but read by metrics
+    // publishing from other threads
+    alignas(64) std::atomic<uint64> m_drainedEvents{0};
+    std::atomic<uint64> m_lastDrainLatencyUs{0};
+};
+
+/**
+ * Scripted input for headless runs and tests: events are delivered from a
+ * background thread at their scheduled offsets, like an OS event thread.
+ */
+class SyntheticInputSource : public NonCopyable {
+public:
+    SyntheticInputSource() = default;
+    ~SyntheticInputSource();
+
+    void AddEvent(std::chrono::microseconds offset, const InputEvent& event);
+    void AddKeyPress(std::chrono::microseconds offset, uint32 key,
+                     std::chrono::microseconds holdTime = std::chrono::milliseconds(50));
+    void AddMouseMove(std::chrono::microseconds offset, int32 x, int32 y);
+
+    void Start(InputQueue& queue);
+    void Stop();
+    bool IsFinished() const { return m_finished.load(std::memory_order_acquire); }
+
+private:
+    struct ScheduledEvent {
+        std::chrono::microseconds offset;
+        InputEvent event;
+    };
+
+    std::vector<ScheduledEvent> m_events;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_stopCondition;    // Wakes the thread early on Stop()
+    bool m_stopRequested{false};                // Guarded by m_mutex
+    std::atomic<bool> m_finished{false};
+};
+
+} // namespace XeSS
@@ -0,0 +1,226 @@
+#include "JobSystem.h"
+#include "Logger.h"
+#include <algorithm>
+
+namespace XeSS {
+
+namespace {
+    thread_local bool t_isWorker = false;
+}
+
+void JobCounter::Fail(std::exception_ptr error) {
+    bool expected = false;
+    if (m_failed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        m_error = error;
+    }
+}
+
+JobSystem& JobSystem::Instance() {
+    static JobSystem instance;
+    return instance;
+}
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+void JobSystem::Initialize(uint32 workerCount) {
+    if (IsInitialized()) {
+        XESS_WARNING("JobSystem already initialized");
+        return;
+    }
+
+    if (workerCount == 0) {
+        uint32 hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = std::max<uint32>(hardwareThreads, 2) - 1;
+    }
+
+    m_running.store(true, std::memory_order_release);
+    ResetStats();
+
+    m_workers.reserve(workerCount);
+    for (uint32 i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&JobSystem::WorkerMain, this);
+    }
+
+    XESS_INFO("JobSystem initialized with {} worker threads", workerCount);
+}
+
+void JobSystem::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running.exchange(false, std::memory_order_acq_rel) && m_workers.empty()) {
+            return;
+        }
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+
+    // Anything still queued runs on the caller so counters always complete
+    while (TryRunOne()) {
+    }
+}
+
+void JobSystem::Submit(Job job, JobCounter* counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    QueuedJob queued{std::move(job), counter};
+    if (!IsInitialized()) {
+        Execute(queued);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(queued));
+    }
+    m_condition.notify_one();
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    while (!counter.IsDone()) {
+        if (TryRunOne()) {
+            continue;
+        }
+
+        // Nothing left to help with: sleep until one of our jobs finishes
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_waitCondition.wait(lock, [&counter]() { return counter.IsDone(); });
+    }
+
+    if (counter.m_failed.load(std::memory_order_acquire)) {
+        std::exception_ptr error = counter.m_error;
+        counter.m_error = nullptr;
+        counter.m_failed.store(false, std::memory_order_release);
+        std::rethrow_exception(error);
+    }
+}
+
+void JobSystem::ParallelFor(uint32 count, uint32 batchSize, const RangeJob& body) {
+    if (count == 0) {
+        return;
+    }
+
+    batchSize = std::max<uint32>(batchSize, 1);
+    if (!IsInitialized() || count <= batchSize) {
+        body(0, count);
+        return;
+    }
+
+    // Queue all but the first batch, which the caller runs itself
+    JobCounter counter;
+    for (uint32 begin = batchSize; begin < count; begin += batchSize) {
+        uint32 end = std::min(begin + batchSize, count);
+        Submit([&body, begin, end]() { body(begin, end); }, &counter);
+    }
+
+    try {
+        body(0, batchSize);
+    }
+    catch (...) {
+        counter.Fail(std::current_exception());
+    }
+
+    Wait(counter);
+}
+
+JobSystemStats JobSystem::GetStats() const {
+    JobSystemStats stats;
+    stats.workerCount = GetWorkerCount();
+    stats.jobsExecuted = m_jobsExecuted.load(std::memory_order_relaxed);
+    stats.busySeconds = m_busyNanoseconds.load(std::memory_order_relaxed) * 1e-9;
+
+    int64 nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    stats.elapsedSeconds = (nowNs - m_statsStartNs.load(std::memory_order_relaxed)) * 1e-9;
+    return stats;
+}
+
+void JobSystem::ResetStats() {
+    m_jobsExecuted.store(0, std::memory_order_relaxed);
+    m_busyNanoseconds.store(0, std::memory_order_relaxed);
+    m_statsStartNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
+}
+
+bool JobSystem::IsWorkerThread() {
+    return t_isWorker;
+}
+
+bool JobSystem::TryRunOne() {
+    QueuedJob queued;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) {
+            return false;
+        }
+        queued = std::move(m_queue.front());
+        m_queue.pop_front();
+    }
+
+    Execute(queued);
+    return true;
+}
+
+void JobSystem::Execute(QueuedJob& queued) {
+    auto start = std::chrono::steady_clock::now();
+
+    try {
+        queued.job();
+    }
+    catch (...) {
+        if (queued.counter) {
+            queued.counter->Fail(std::current_exception());
+        } else {
+            XESS_ERROR("Unhandled exception in detached job");
+        }
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    m_busyNanoseconds.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+    m_jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+
+    if (queued.counter) {
+        bool finished;
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            finished = queued.counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+        if (finished) {
+            m_waitCondition.notify_all();
+        }
+    }
+}
+
+void JobSystem::WorkerMain() {
+    t_isWorker = true;
+
+    while (true) {
+        QueuedJob queued;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() {
+                return !m_queue.empty() || !m_running.load(std::memory_order_acquire);
+            });
+            if (m_queue.empty()) {
+                break;
+            }
+            queued = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        Execute(queued);
+    }
+}
+
+} // namespace XeSS
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Types.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace XeSS {
+
+/**
+ * Tracks completion of a group of jobs. The first exception thrown by any
+ * job in the group is captured and rethrown by JobSystem::Wait.
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+    uint32 GetPending() const { return m_pending.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+
+    void Fail(std::exception_ptr error);
+
+    std::atomic<uint32> m_pending{0};
+    std::atomic<bool> m_failed{false};
+    std::exception_ptr m_error;
+};
+
+struct JobSystemStats {
+    uint32 workerCount{0};
+    uint64 jobsExecuted{0};
+    float64 busySeconds{0.0};     // Summed over all threads that ran jobs
+    float64 elapsedSeconds{0.0};  // Wall time since Initialize/ResetStats
+
+    // Fraction of worker capacity spent running jobs
+    float64 Utilization() const {
+        return workerCount > 0 && elapsedSeconds > 0.0
+            ? busySeconds / (elapsedSeconds * workerCount) : 0.0;
+    }
+};
+
+/**
+ * Process-wide pool of worker threads. Until Initialize() is called (or after
+ * Shutdown()) every job runs inline on the submitting thread, so code using
+ * the job system also works in tools and tests that never start it.
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(uint32 begin, uint32 end)>;
+
+    static JobSystem& Instance();
+
+    // workerCount 0 picks hardware concurrency minus one for the calling thread
+    void Initialize(uint32 workerCount = 0);
+    void Shutdown();
+    bool IsInitialized() const { return m_running.load(std::memory_order_acquire); }
+    uint32 GetWorkerCount() const { return static_cast<uint32>(m_workers.size()); }
+
+    void Submit(Job job, JobCounter* counter = nullptr);
+
+    // Blocks until the counter reaches zero, running queued jobs meanwhile
+    void Wait(JobCounter& counter);
+
+    // Runs one queued job on the calling thread, if any; for custom waits
+    bool RunPendingJob() { return TryRunOne(); }
+
+    // Splits [0, count) into batches of batchSize and blocks until all ran
+    void ParallelFor(uint32 count, uint32 batchSize, const RangeJob& body);
+
+    JobSystemStats GetStats() const;
+    void ResetStats();
+
+    static bool IsWorkerThread();
+
+private:
+    JobSystem() = default;
+    ~JobSystem();
+
+    struct QueuedJob {
+        Job job;
+        JobCounter* counter;
+    };
+
+    bool TryRunOne();
+    void Execute(QueuedJob& queued);
+    void WorkerMain();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<QueuedJob> m_queue;
+    std::vector<std::thread> m_workers;
+    std::atomic<bool> m_running{false};
+
+    // Counters are usually stack objects, so completion is published under
+    // m_waitMutex and signalled through m_waitCondition, never the counter
+    std::mutex m_waitMutex;
+    std::condition_variable m_waitCondition;
+
+    std::atomic<uint64> m_jobsExecuted{0};
+    std::atomic<uint64> m_busyNanoseconds{0};
+    std::atomic<int64> m_statsStartNs{0}; // steady_clock epoch offset
+};
+
+} // namespace XeSS
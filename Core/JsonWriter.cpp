@@ -0,0 +1,172 @@
+#include "JsonWriter.h"
+#include "Logger.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace XeSS {
+
+JsonWriter::JsonWriter(bool pretty)
+    : m_pretty(pretty) {
+    m_stream << std::setprecision(9);
+}
+
+JsonWriter& JsonWriter::BeginObject() {
+    BeforeValue();
+    m_stream << '{';
+    m_firstInScope.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::BeginObject(const std::string& key) {
+    WriteKey(key);
+    return BeginObject();
+}
+
+JsonWriter& JsonWriter::EndObject() {
+    bool empty = m_firstInScope.back();
+    m_firstInScope.pop_back();
+    if (!empty) {
+        Newline();
+    }
+    m_stream << '}';
+    return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray() {
+    BeforeValue();
+    m_stream << '[';
+    m_firstInScope.push_back(true);
+    return *this;
+}
+
+JsonWriter& JsonWriter::BeginArray(const std::string& key) {
+    WriteKey(key);
+    return BeginArray();
+}
+
+JsonWriter& JsonWriter::EndArray() {
+    bool empty = m_firstInScope.back();
+    m_firstInScope.pop_back();
+    if (!empty) {
+        Newline();
+    }
+    m_stream << ']';
+    return *this;
+}
+
+JsonWriter& JsonWriter::Value(const std::string& value) {
+    BeforeValue();
+    m_stream << '"' << Escape(value) << '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::Value(const char* value) {
+    return Value(std::string(value ? value : ""));
+}
+
+JsonWriter& JsonWriter::Value(float64 value) {
+    BeforeValue();
+    // JSON has no representation for NaN/Inf
+    if (std::isfinite(value)) {
+        m_stream << value;
+    } else {
+        m_stream << "null";
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::Value(int64 value) {
+    BeforeValue();
+    m_stream << value;
+    return *this;
+}
+
+JsonWriter& JsonWriter::Value(uint64 value) {
+    BeforeValue();
+    m_stream << value;
+    return *this;
+}
+
+JsonWriter& JsonWriter::Value(bool value) {
+    BeforeValue();
+    m_stream << (value ? "true" : "false");
+    return *this;
+}
+
+bool JsonWriter::WriteToFile(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        XESS_ERROR("Failed to open JSON output file: {}", filename);
+        return false;
+    }
+
+    file << m_stream.str() << '\n';
+    return file.good();
+}
+
+std::string JsonWriter::Escape(const std::string& value) {
+    std::string result;
+    result.reserve(value.size());
+
+    for (char c : value) {
+        switch (c) {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    result += buffer;
+                } else {
+                    result += c;
+                }
+                break;
+        }
+    }
+
+    return result;
+}
+
+void JsonWriter::WriteKey(const std::string& key) {
+    BeforeValue();
+    m_stream << '"' << Escape(key) << "\":";
+    if (m_pretty) {
+        m_stream << ' ';
+    }
+    m_afterKey = true;
+}
+
+void JsonWriter::BeforeValue() {
+    // A value directly following its key needs no separator
+    if (m_afterKey) {
+        m_afterKey = false;
+        return;
+    }
+
+    if (m_firstInScope.empty()) {
+        return;
+    }
+
+    if (!m_firstInScope.back()) {
+        m_stream << ',';
+    }
+    m_firstInScope.back() = false;
+    Newline();
+}
+
+void JsonWriter::Newline() {
+    if (!m_pretty) {
+        return;
+    }
+
+    m_stream << '\n';
+    for (size_t i = 0; i < m_firstInScope.size(); ++i) {
+        m_stream << "  ";
+    }
+}
+
+} // namespace XeSS
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Types.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace XeSS {
+
+/**
+ * Minimal streaming JSON writer for reports (benchmarks, startup timelines).
+ * Keys and values are written in call order; commas and nesting are tracked
+ * internally. Output is compact unless pretty printing is enabled.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(bool pretty = true);
+
+    JsonWriter& BeginObject();
+    JsonWriter& BeginObject(const std::string& key);
+    JsonWriter& EndObject();
+
+    JsonWriter& BeginArray();
+    JsonWriter& BeginArray(const std::string& key);
+    JsonWriter& EndArray();
+
+    // Array elements
+    JsonWriter& Value(const std::string& value);
+    JsonWriter& Value(const char* value);
+    JsonWriter& Value(float64 value);
+    JsonWriter& Value(int64 value);
+    JsonWriter& Value(uint64 value);
+    JsonWriter& Value(uint32 value) { return Value(static_cast<uint64>(value)); }
+    JsonWriter& Value(int32 value) { return Value(static_cast<int64>(value)); }
+    JsonWriter& Value(float32 value) { return Value(static_cast<float64>(value)); }
+    JsonWriter& Value(bool value);
+
+    // Object members
+    template<typename T>
+    JsonWriter& Field(const std::string& key, const T& value) {
+        WriteKey(key);
+        return Value(value);
+    }
+
+    template<typename T>
+    JsonWriter& Array(const std::string& key, const std::vector<T>& values) {
+        BeginArray(key);
+        for (const auto& value : values) {
+            Value(value);
+        }
+        return EndArray();
+    }
+
+    std::string Str() const { return m_stream.str(); }
+    bool WriteToFile(const std::string& filename) const;
+
+    static std::string Escape(const std::string& value);
+
+private:
+    void WriteKey(const std::string& key);
+    void BeforeValue();
+    void Newline();
+
+    std::ostringstream m_stream;
+    std::vector<bool> m_firstInScope;
+    bool m_pretty;
+    bool m_afterKey{false};
+};
+
+} // namespace XeSS
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -14,23 +15,205 @@ Logger& Logger::Instance() {
     return instance;
 }
 
+namespace {
+    constexpr uint64 TimeMask = 0xFFFFFFFFull;
+    constexpr uint32 SpentShift = 32;
+    constexpr uint64 SpentMask = 0xFF;
+    constexpr uint32 SuppressedShift = 40;
+    constexpr uint64 SuppressedMax = (1ull << 24) - 1;
+    constexpr uint64 RepeatCountMask = (1ull << 24) - 1;
+
+    // The hash bits LogSite::repeat keeps, never 0 so 0 can mean "none"
+    uint64 RepeatKey(uint64 hash) {
+        uint64 key = hash & ~RepeatCountMask;
+        return key != 0 ? key : RepeatCountMask + 1;
+    }
+
+    // A repeated message is written again after this long, with its count,
+    // so one that never changes still shows up now and then
+    constexpr uint32 CollapseWindowMs = 5000;
+
+    uint32 NowMs() {
+        static const auto start = std::chrono::steady_clock::now();
+        return static_cast<uint32>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+Logger::~Logger() {
+    Flush();
+}
+
 void Logger::SetLevel(LogLevel level) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_level = level;
+    m_level.store(level, std::memory_order_relaxed);
 }
 
 LogLevel Logger::GetLevel() const {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_level;
+    return m_level.load(std::memory_order_relaxed);
+}
+
+void Logger::SetRateLimit(uint32 ratePerSecond, uint32 burst) {
+    m_defaultRate.store(ratePerSecond, std::memory_order_relaxed);
+    m_defaultBurst.store(burst, std::memory_order_relaxed);
+}
+
+bool Logger::AcquireSite(LogSite& site, uint32 ratePerSecond, uint32 burst, uint32& dropped) {
+    if (ratePerSecond == 0) {
+        ratePerSecond = m_defaultRate.load(std::memory_order_relaxed);
+        burst = m_defaultBurst.load(std::memory_order_relaxed);
+        if (ratePerSecond == 0) {
+            dropped = 0;
+            return true;
+        }
+    }
+    burst = std::clamp<uint32>(burst, 1, static_cast<uint32>(SpentMask));
+
+    // Token bucket stored as tokens *spent*, so a zero-initialized site
+    // starts with a full bucket
+    const uint32 now = NowMs();
+    uint64 state = site.state.load(std::memory_order_relaxed);
+    while (true) {
+        uint32 lastRefill = static_cast<uint32>(state & TimeMask);
+        uint64 spent = (state >> SpentShift) & SpentMask;
+        uint64 suppressed = state >> SuppressedShift;
+
+        uint64 refill = static_cast<uint64>(static_cast<uint32>(now - lastRefill)) * ratePerSecond / 1000;
+        if (spent == 0 || refill >= spent) {
+            spent = 0;
+            lastRefill = now;
+        } else if (refill > 0) {
+            // Keep the fractional part of the refill period
+            spent -= refill;
+            lastRefill += static_cast<uint32>(refill * 1000 / ratePerSecond);
+        }
+
+        bool allowed = spent < burst;
+        uint64 next;
+        if (allowed) {
+            next = lastRefill | ((spent + 1) << SpentShift);
+        } else {
+            next = lastRefill | (spent << SpentShift) |
+                   (std::min(suppressed + 1, SuppressedMax) << SuppressedShift);
+        }
+
+        if (site.state.compare_exchange_weak(state, next, std::memory_order_relaxed)) {
+            dropped = allowed ? static_cast<uint32>(suppressed) : 0;
+            return allowed;
+        }
+    }
 }
 
 void Logger::Log(LogLevel level, const std::string& message) {
-    if (level < m_level) {
+    if (!IsEnabled(level)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    WritePendingRepeats();
+    Write(level, message);
+}
+
+void Logger::Flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (SiteRecord& record : m_sites) {
+        // Drops since the site's last message that got through
+        uint64 state = record.site->state.fetch_and(~(SuppressedMax << SuppressedShift), std::memory_order_relaxed);
+        record.dropped += static_cast<uint32>(state >> SuppressedShift);
+        WritePending(record);
+    }
+    m_repeatingSites.clear();
+    std::cout.flush();
+    std::cerr.flush();
+}
+
+bool Logger::CountRepeat(LogSite& site, uint64 hash) {
+    if (hash == 0 || NowMs() - site.lastWriteMs.load(std::memory_order_relaxed) >= CollapseWindowMs) {
+        return false;
+    }
+
+    const uint64 key = RepeatKey(hash);
+    uint64 repeat = site.repeat.load(std::memory_order_relaxed);
+    do {
+        if ((repeat & ~RepeatCountMask) != key || (repeat & RepeatCountMask) == RepeatCountMask) {
+            return false;
+        }
+    } while (!site.repeat.compare_exchange_weak(repeat, repeat + 1, std::memory_order_relaxed));
+
+    // Only the first repeat locks, so the count is written before the next message
+    if ((repeat & RepeatCountMask) == 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_repeatingSites.push_back(site.index - 1);
+    }
+    return true;
+}
+
+void Logger::LogFromSite(LogSite& site, LogLevel level, std::string message, uint32 dropped, uint64 hash) {
+    if (!IsEnabled(level)) {
         return;
     }
 
+    const uint32 now = NowMs();
     std::lock_guard<std::mutex> lock(m_mutex);
+    if (site.index == 0) {
+        // Starts with its window already over, so the first message is written
+        m_sites.push_back({&site, {}, level, now - CollapseWindowMs, 0, 0});
+        site.index = static_cast<uint32>(m_sites.size());
+    }
+
+    SiteRecord& record = m_sites[site.index - 1];
+    record.dropped += dropped;
+    if (level == record.level && message == record.lastMessage && now - record.lastWriteMs < CollapseWindowMs) {
+        if (record.repeats++ == 0) {
+            m_repeatingSites.push_back(site.index - 1);
+        }
+        return;
+    }
+
+    // Counts go out before anything newer, so they stay next to their
+    // message. Repeats of the old text stop matching while this one is written.
+    uint64 repeat = site.repeat.exchange(0, std::memory_order_relaxed);
+    record.repeats += static_cast<uint32>(repeat & RepeatCountMask);
+    WritePendingRepeats();
+    WritePending(record);
+    Write(level, message);
+    record.lastMessage = std::move(message);
+    record.level = level;
+    record.lastWriteMs = now;
+    site.lastWriteMs.store(now, std::memory_order_relaxed);
+    site.repeat.store(hash != 0 ? RepeatKey(hash) : 0, std::memory_order_relaxed);
+}
+
+void Logger::CollectRepeats(SiteRecord& record) {
+    uint64 repeat = record.site->repeat.fetch_and(~RepeatCountMask, std::memory_order_relaxed);
+    record.repeats += static_cast<uint32>(repeat & RepeatCountMask);
+}
+
+void Logger::WritePending(SiteRecord& record) {
+    CollectRepeats(record);
+    if (record.repeats > 0) {
+        Write(record.level, record.lastMessage + " (repeated " + std::to_string(record.repeats) + " more times)");
+        record.repeats = 0;
+    }
+    if (record.dropped > 0) {
+        Write(record.level, "Rate limit dropped " + std::to_string(record.dropped) +
+                            " messages from the site of: " + record.lastMessage);
+        record.dropped = 0;
+    }
+}
+
+void Logger::WritePendingRepeats() {
+    for (uint32 index : m_repeatingSites) {
+        SiteRecord& record = m_sites[index];
+        CollectRepeats(record);
+        if (record.repeats > 0) {
+            Write(record.level, record.lastMessage + " (repeated " + std::to_string(record.repeats) + " more times)");
+            record.repeats = 0;
+        }
+    }
+    m_repeatingSites.clear();
+}
 
+void Logger::Write(LogLevel level, const std::string& message) {
     // Get current time
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
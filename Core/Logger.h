@@ -4,6 +4,12 @@
 #include <iostream>
 #include <sstream>
 #include <mutex>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 namespace XeSS {
 
@@ -16,15 +22,41 @@ enum class LogLevel : uint32 {
     Critical = 5
 };
 
+// Per-call-site state. The rate limit is packed into one word so the check
+// is a single CAS: bits 0-31 last refill time (ms), 32-39 tokens spent,
+// 40-63 messages dropped since the last one that got through. repeat packs
+// the same way: bits 0-23 repeats counted without the lock, 24-63 the hash
+// of the last message written, 0 while a repeat has to be compared as text.
+// index links the site to the logger's record of its last message, 0 until
+// it first logs.
+struct LogSite {
+    std::atomic<uint64> state{0};
+    std::atomic<uint64> repeat{0};
+    std::atomic<uint32> lastWriteMs{0};
+    uint32 index = 0;
+};
+
 class Logger {
 public:
     static Logger& Instance();
 
     void SetLevel(LogLevel level);
     LogLevel GetLevel() const;
+    bool IsEnabled(LogLevel level) const {
+        return level >= m_level.load(std::memory_order_relaxed);
+    }
+
+    // Per-call-site budget for the plain XESS_* macros: burst messages at
+    // once, refilled at ratePerSecond. 0, the default, leaves them unlimited;
+    // the *_RATE_LIMITED macros always use their own budget.
+    void SetRateLimit(uint32 ratePerSecond, uint32 burst);
 
     void Log(LogLevel level, const std::string& message);
 
+    // Writes the repeat and drop counts every site still holds, then flushes
+    // the output streams. Also runs when the logger is destroyed.
+    void Flush();
+
     template<typename... Args>
     void Trace(const std::string& format, Args&&... args) {
         LogFormatted(LogLevel::Trace, format, std::forward<Args>(args)...);
@@ -55,52 +87,158 @@ public:
         LogFormatted(LogLevel::Critical, format, std::forward<Args>(args)...);
     }
 
+    // Logging from a call site. A message with the same text as the site's
+    // previous one is only counted, and "repeated N more times" is written
+    // before the next message from anywhere, or by Flush(). Messages over
+    // the rate limit are dropped without being formatted and reported the
+    // same way. ratePerSecond 0 uses the logger-wide limit set with
+    // SetRateLimit.
+    template<typename... Args>
+    void LogAtSite(LogSite& site, LogLevel level, uint32 ratePerSecond, uint32 burst,
+                   const std::string& format, Args&&... args) {
+        uint32 dropped = 0;
+        if (!AcquireSite(site, ratePerSecond, burst, dropped)) {
+            return;
+        }
+
+        // A repeat is recognised by the hash of the format and arguments,
+        // so it costs neither the formatting nor the lock
+        uint64 hash = HashMessage(level, format, args...);
+        if (dropped == 0 && CountRepeat(site, hash)) {
+            return;
+        }
+
+        std::ostringstream oss;
+        FormatMessage(oss, format, std::forward<Args>(args)...);
+        LogFromSite(site, level, oss.str(), dropped, hash);
+    }
+
+    // Formats without logging; "{}" placeholders are replaced in order
+    template<typename... Args>
+    static std::string Format(std::string_view format, Args&&... args) {
+        std::ostringstream oss;
+        FormatMessage(oss, format, std::forward<Args>(args)...);
+        return oss.str();
+    }
+
 private:
+    // What a site last wrote and what it held back since, guarded by m_mutex
+    struct SiteRecord {
+        LogSite* site;
+        std::string lastMessage;
+        LogLevel level;
+        uint32 lastWriteMs;
+        uint32 repeats;
+        uint32 dropped;
+    };
+
     Logger() = default;
-    ~Logger() = default;
+    ~Logger();
+
+    bool AcquireSite(LogSite& site, uint32 ratePerSecond, uint32 burst, uint32& dropped);
+    bool CountRepeat(LogSite& site, uint64 hash);
+    void LogFromSite(LogSite& site, LogLevel level, std::string message, uint32 dropped, uint64 hash);
+
+    // All expect m_mutex held
+    void CollectRepeats(SiteRecord& record);
+    void WritePending(SiteRecord& record);
+    void WritePendingRepeats();
+    void Write(LogLevel level, const std::string& message);
 
     template<typename... Args>
     void LogFormatted(LogLevel level, const std::string& format, Args&&... args) {
-        if (level >= m_level) {
+        if (IsEnabled(level)) {
             std::ostringstream oss;
             FormatMessage(oss, format, std::forward<Args>(args)...);
             Log(level, oss.str());
         }
     }
 
+    static uint64 MixHash(uint64 seed, uint64 value) {
+        uint64 x = seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    // Strings, numbers, enums and pointers; anything else streams in a way
+    // only formatting shows, so the message is compared as text instead
     template<typename T>
-    void FormatMessage(std::ostringstream& oss, const std::string& format, T&& value) {
-        size_t pos = format.find("{}");
-        if (pos != std::string::npos) {
-            oss << format.substr(0, pos) << std::forward<T>(value) << format.substr(pos + 2);
+    static bool HashArgument(uint64& hash, const T& value) {
+        using Value = std::decay_t<T>;
+        if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            hash = MixHash(hash, std::hash<std::string_view>{}(std::string_view(value)));
+            return true;
+        } else if constexpr (std::is_floating_point_v<Value>) {
+            // By bits: std::hash folds -0.0 into 0.0, which print differently
+            hash = MixHash(hash, std::hash<std::string_view>{}(
+                std::string_view(reinterpret_cast<const char*>(&value), sizeof(value))));
+            return true;
+        } else if constexpr (std::is_arithmetic_v<Value> || std::is_enum_v<Value> || std::is_pointer_v<Value>) {
+            hash = MixHash(hash, static_cast<uint64>(std::hash<Value>{}(value)));
+            return true;
         } else {
-            oss << format;
+            return false;
         }
     }
 
+    // Never 0 for a hashable message, 0 if any argument is not hashable
+    template<typename... Args>
+    static uint64 HashMessage(LogLevel level, std::string_view format, const Args&... args) {
+        uint64 hash = MixHash(std::hash<std::string_view>{}(format), static_cast<uint64>(level));
+        bool hashable = (HashArgument(hash, args) && ...);
+        return hashable ? (hash != 0 ? hash : 1) : 0;
+    }
+
+    // Replaces each "{}" in order with the streamed argument
+    static void FormatMessage(std::ostringstream& oss, std::string_view format) {
+        oss << format;
+    }
+
     template<typename T, typename... Args>
-    void FormatMessage(std::ostringstream& oss, const std::string& format, T&& value, Args&&... args) {
+    static void FormatMessage(std::ostringstream& oss, std::string_view format, T&& value, Args&&... args) {
         size_t pos = format.find("{}");
-        if (pos != std::string::npos) {
-            std::string newFormat = format.substr(0, pos) + std::to_string(value) + format.substr(pos + 2);
-            FormatMessage(oss, newFormat, std::forward<Args>(args)...);
-        } else {
+        if (pos == std::string_view::npos) {
             oss << format;
+            return;
         }
+        oss << format.substr(0, pos) << value;
+        FormatMessage(oss, format.substr(pos + 2), std::forward<Args>(args)...);
     }
 
     const char* LevelToString(LogLevel level) const;
 
-    LogLevel m_level{LogLevel::Info};
+    std::atomic<LogLevel> m_level{LogLevel::Info};
+    std::atomic<uint32> m_defaultRate{0};
+    std::atomic<uint32> m_defaultBurst{0};
     mutable std::mutex m_mutex;
+    std::vector<SiteRecord> m_sites;
+    std::vector<uint32> m_repeatingSites;   // Records with repeats > 0
 };
 
+// Every macro use gets its own LogSite, so a line repeating the same text
+// collapses into a count without affecting any other line.
+#define XESS_LOG_AT_SITE(level, ratePerSecond, burst, ...) \
+    do { \
+        static ::XeSS::LogSite xessLogSite; \
+        ::XeSS::Logger& xessLogger = ::XeSS::Logger::Instance(); \
+        if (xessLogger.IsEnabled(level)) { \
+            xessLogger.LogAtSite(xessLogSite, level, ratePerSecond, burst, __VA_ARGS__); \
+        } \
+    } while (0)
+
 // Convenience macros
-#define XESS_TRACE(...) XeSS::Logger::Instance().Trace(__VA_ARGS__)
-#define XESS_DEBUG(...) XeSS::Logger::Instance().Debug(__VA_ARGS__)
-#define XESS_INFO(...) XeSS::Logger::Instance().Info(__VA_ARGS__)
-#define XESS_WARNING(...) XeSS::Logger::Instance().Warning(__VA_ARGS__)
-#define XESS_ERROR(...) XeSS::Logger::Instance().Error(__VA_ARGS__)
-#define XESS_CRITICAL(...) XeSS::Logger::Instance().Critical(__VA_ARGS__)
+#define XESS_TRACE(...) XESS_LOG_AT_SITE(::XeSS::LogLevel::Trace, 0, 0, __VA_ARGS__)
+#define XESS_DEBUG(...) XESS_LOG_AT_SITE(::XeSS::LogLevel::Debug, 0, 0, __VA_ARGS__)
+#define XESS_INFO(...) XESS_LOG_AT_SITE(::XeSS::LogLevel::Info, 0, 0, __VA_ARGS__)
+#define XESS_WARNING(...) XESS_LOG_AT_SITE(::XeSS::LogLevel::Warning, 0, 0, __VA_ARGS__)
+#define XESS_ERROR(...) XESS_LOG_AT_SITE(::XeSS::LogLevel::Error, 0, 0, __VA_ARGS__)
+#define XESS_CRITICAL(...) XESS_LOG_AT_SITE(::XeSS::LogLevel::Critical, 0, 0, __VA_ARGS__)
+
+// Explicit budget for sites known to fire every frame when something is wrong
+#define XESS_WARNING_RATE_LIMITED(ratePerSecond, burst, ...) \
+    XESS_LOG_AT_SITE(::XeSS::LogLevel::Warning, ratePerSecond, burst, __VA_ARGS__)
+#define XESS_ERROR_RATE_LIMITED(ratePerSecond, burst, ...) \
+    XESS_LOG_AT_SITE(::XeSS::LogLevel::Error, ratePerSecond, burst, __VA_ARGS__)
 
 } // namespace XeSS
@@ -0,0 +1,242 @@
+#include "Lz.h"
+#include <bit>
+#include <cstring>
+#include <memory>
+
+namespace XeSS::Lz {
+
+namespace {
+    constexpr size_t MinMatch = 4;
+    constexpr size_t LastLiterals = 5;      // A block ends with at least this many literals
+    constexpr size_t MatchSearchEnd = 12;   // No match starts in the last 12 bytes
+    constexpr size_t MaxOffset = 65535;
+    constexpr uint32 HashLog = 14;
+
+    uint32 Read32(const uint8* p) {
+        uint32 value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint64 Read64(const uint8* p) {
+        uint64 value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32 Hash(uint32 sequence) {
+        return (sequence * 2654435761u) >> (32 - HashLog);
+    }
+
+    // Length of the common prefix of a and b, with a not reaching past limit
+    size_t CountMatch(const uint8* a, const uint8* b, const uint8* limit) {
+        const uint8* start = a;
+        while (a + 8 <= limit) {
+            uint64 diff = Read64(a) ^ Read64(b);
+            if (diff != 0) {
+                if constexpr (std::endian::native == std::endian::little) {
+                    return static_cast<size_t>(a - start) + (std::countr_zero(diff) >> 3);
+                } else {
+                    return static_cast<size_t>(a - start) + (std::countl_zero(diff) >> 3);
+                }
+            }
+            a += 8;
+            b += 8;
+        }
+        while (a < limit && *a == *b) {
+            ++a;
+            ++b;
+        }
+        return static_cast<size_t>(a - start);
+    }
+
+    uint8* WriteLength(uint8* out, size_t length) {
+        while (length >= 255) {
+            *out++ = 255;
+            length -= 255;
+        }
+        *out++ = static_cast<uint8>(length);
+        return out;
+    }
+
+    uint8* WriteSequence(uint8* out, const uint8* literals, size_t literalLength, size_t offset, size_t matchLength) {
+        size_t matchCode = matchLength - MinMatch;
+        uint8* token = out++;
+        *token = static_cast<uint8>(((literalLength < 15 ? literalLength : 15) << 4) |
+                                    (matchCode < 15 ? matchCode : 15));
+        if (literalLength >= 15) {
+            out = WriteLength(out, literalLength - 15);
+        }
+        memcpy(out, literals, literalLength);
+        out += literalLength;
+
+        *out++ = static_cast<uint8>(offset);
+        *out++ = static_cast<uint8>(offset >> 8);
+        if (matchCode >= 15) {
+            out = WriteLength(out, matchCode - 15);
+        }
+        return out;
+    }
+
+    bool ReadLength(const uint8*& in, const uint8* end, size_t& length) {
+        uint8 byte;
+        do {
+            if (in >= end) {
+                return false;
+            }
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+}
+
+size_t CompressBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t Compress(const uint8* src, size_t srcSize, uint8* dst, size_t dstCapacity) {
+    if (dstCapacity < CompressBound(srcSize)) {
+        return 0;
+    }
+
+    uint8* out = dst;
+    const uint8* anchor = src;
+    const uint8* end = src + srcSize;
+
+    if (srcSize > MatchSearchEnd) {
+        const uint8* matchLimit = end - LastLiterals;
+        const uint8* searchEnd = end - MatchSearchEnd;
+        auto table = std::make_unique<uint32[]>(size_t(1) << HashLog);
+
+        const uint8* ip = src + 1;
+        while (ip < searchEnd) {
+            uint32 sequence = Read32(ip);
+            uint32 hash = Hash(sequence);
+            const uint8* candidate = src + table[hash];
+            table[hash] = static_cast<uint32>(ip - src);
+
+            if (candidate >= ip || static_cast<size_t>(ip - candidate) > MaxOffset || Read32(candidate) != sequence) {
+                // Step faster through data that keeps missing
+                ip += 1 + (static_cast<size_t>(ip - anchor) >> 6);
+                continue;
+            }
+
+            while (ip > anchor && candidate > src && ip[-1] == candidate[-1]) {
+                --ip;
+                --candidate;
+            }
+
+            size_t matchLength = MinMatch + CountMatch(ip + MinMatch, candidate + MinMatch, matchLimit);
+            out = WriteSequence(out, anchor, static_cast<size_t>(ip - anchor),
+                                static_cast<size_t>(ip - candidate), matchLength);
+            ip += matchLength;
+            anchor = ip;
+
+            // Seed the table inside the match so the next one can start there
+            if (ip < searchEnd) {
+                table[Hash(Read32(ip - 2))] = static_cast<uint32>(ip - 2 - src);
+            }
+        }
+    }
+
+    // Final sequence: literals only
+    size_t literalLength = static_cast<size_t>(end - anchor);
+    *out++ = static_cast<uint8>((literalLength < 15 ? literalLength : 15) << 4);
+    if (literalLength >= 15) {
+        out = WriteLength(out, literalLength - 15);
+    }
+    if (literalLength > 0) {
+        memcpy(out, anchor, literalLength);
+        out += literalLength;
+    }
+
+    return static_cast<size_t>(out - dst);
+}
+
+bool Decompress(const uint8* src, size_t srcSize, uint8* dst, size_t dstSize) {
+    const uint8* in = src;
+    const uint8* inEnd = src + srcSize;
+    uint8* out = dst;
+    uint8* outEnd = dst + dstSize;
+
+    while (in < inEnd) {
+        uint8 token = *in++;
+
+        size_t literalLength = token >> 4;
+
+        // Short literals with slack on both sides: one fixed-size copy
+        if (literalLength < 15 && inEnd - in >= 16 && outEnd - out >= 16) {
+            memcpy(out, in, 16);
+            in += literalLength;
+            out += literalLength;
+        } else {
+            if (literalLength == 15 && !ReadLength(in, inEnd, literalLength)) {
+                return false;
+            }
+            if (literalLength > static_cast<size_t>(inEnd - in) || literalLength > static_cast<size_t>(outEnd - out)) {
+                return false;
+            }
+            if (literalLength > 0) {
+                memcpy(out, in, literalLength);
+            }
+            in += literalLength;
+            out += literalLength;
+
+            if (in == inEnd) {
+                return out == outEnd;
+            }
+        }
+
+        if (inEnd - in < 2) {
+            return false;
+        }
+        size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        if (offset == 0 || offset > static_cast<size_t>(out - dst)) {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+        const uint8* match = out - offset;
+
+        // Short match far enough back: two 16-byte copies, each reading only
+        // bytes already final
+        if (matchLength < 15 && offset >= 16 && outEnd - out >= 32) {
+            memcpy(out, match, 16);
+            memcpy(out + 16, match + 16, 16);
+            out += matchLength + MinMatch;
+            continue;
+        }
+
+        if (matchLength == 15 && !ReadLength(in, inEnd, matchLength)) {
+            return false;
+        }
+        matchLength += MinMatch;
+        if (matchLength > static_cast<size_t>(outEnd - out)) {
+            return false;
+        }
+
+        if (offset >= matchLength) {
+            memcpy(out, match, matchLength);
+        } else if (offset >= 8) {
+            // Overlapping, but each 8-byte step reads bytes already written
+            size_t i = 0;
+            for (; i + 8 <= matchLength; i += 8) {
+                memcpy(out + i, match + i, 8);
+            }
+            for (; i < matchLength; ++i) {
+                out[i] = match[i];
+            }
+        } else {
+            for (size_t i = 0; i < matchLength; ++i) {
+                out[i] = match[i];
+            }
+        }
+        out += matchLength;
+    }
+
+    return false;
+}
+
+} // namespace XeSS::Lz
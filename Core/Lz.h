@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Types.h"
+#include <cstddef>
+
+namespace XeSS::Lz {
+
+/**
+ * Fast byte-oriented LZ77 codec in the LZ4 block layout: a token with
+ * literal and match length nibbles, the literals, a 16-bit offset and
+ * extended lengths. Meant for cache files that are written once and read
+ * on every cold start, so decoding is a tight copy loop.
+ *
+ * Blocks carry no size; the caller stores the decompressed size and hands
+ * Decompress() a buffer of exactly that size.
+ */
+
+// Worst case compressed size of size input bytes
+size_t CompressBound(size_t size);
+
+// Returns the compressed size, or 0 if dstCapacity is below CompressBound(srcSize)
+size_t Compress(const uint8* src, size_t srcSize, uint8* dst, size_t dstCapacity);
+
+// Decodes into dst, which must be exactly the original size. Returns false on
+// corrupt or truncated input; never reads or writes out of bounds.
+bool Decompress(const uint8* src, size_t srcSize, uint8* dst, size_t dstSize);
+
+} // namespace XeSS::Lz
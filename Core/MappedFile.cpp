@@ -0,0 +1,124 @@
+#include "MappedFile.h"
+#include "Logger.h"
+#include "Utils.h"
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace XeSS {
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    Swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        Swap(other);
+    }
+    return *this;
+}
+
+void MappedFile::Swap(MappedFile& other) noexcept {
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_open, other.m_open);
+#ifdef _WIN32
+    std::swap(m_mapping, other.m_mapping);
+#endif
+}
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(Utils::StringToWide(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        XESS_ERROR("Failed to open file for mapping: {}", path);
+        return false;
+    }
+
+    LARGE_INTEGER size{};
+    GetFileSizeEx(file, &size);
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    // Empty files cannot be mapped; they open as an empty view
+    if (m_size > 0) {
+        m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping) {
+            m_data = static_cast<const uint8*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+    CloseHandle(file);
+
+    if (m_size > 0 && !m_data) {
+        XESS_ERROR("Failed to map file: {}", path);
+        Close();
+        return false;
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        XESS_ERROR("Failed to open file for mapping: {}", path);
+        return false;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        XESS_ERROR("Failed to stat file: {}", path);
+        ::close(fd);
+        return false;
+    }
+    m_size = static_cast<size_t>(info.st_size);
+
+    // Empty files cannot be mapped; they open as an empty view
+    if (m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            XESS_ERROR("Failed to map file: {}", path);
+            ::close(fd);
+            m_size = 0;
+            return false;
+        }
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const uint8*>(data);
+    }
+    ::close(fd);
+#endif
+
+    m_open = true;
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+#else
+    if (m_data) {
+        munmap(const_cast<uint8*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+} // namespace XeSS
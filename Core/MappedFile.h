@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Types.h"
+#include "NonCopyable.h"
+#include <string>
+#include <string_view>
+
+namespace XeSS {
+
+/**
+ * Read-only memory mapping of a whole file. The contents are paged in on
+ * first touch and never copied, so a view can be handed straight to parsers
+ * and compilers. The view stays valid until the mapping is closed or moved.
+ */
+class MappedFile : public NonCopyable {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Path is UTF-8; returns false (and logs) if the file cannot be mapped
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_open; }
+    const uint8* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+    std::string_view GetText() const {
+        return {reinterpret_cast<const char*>(m_data), m_size};
+    }
+
+private:
+    void Swap(MappedFile& other) noexcept;
+
+    const uint8* m_data{nullptr};
+    size_t m_size{0};
+    bool m_open{false};
+#ifdef _WIN32
+    void* m_mapping{nullptr};
+#endif
+};
+
+} // namespace XeSS
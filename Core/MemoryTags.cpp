@@ -0,0 +1,50 @@
+#include "MemoryTags.h"
+
+namespace XeSS {
+
+std::array<MemoryTags::Counter, static_cast<size_t>(MemoryTag::Count)> MemoryTags::s_counters;
+
+void MemoryTags::Allocate(MemoryTag tag, uint64 bytes) {
+    Counter& counter = s_counters[static_cast<size_t>(tag)];
+    uint64 current = counter.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+    uint64 peak = counter.peakBytes.load(std::memory_order_relaxed);
+    while (current > peak &&
+           !counter.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+void MemoryTags::Free(MemoryTag tag, uint64 bytes) {
+    s_counters[static_cast<size_t>(tag)].bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+uint64 MemoryTags::GetBytes(MemoryTag tag) {
+    return s_counters[static_cast<size_t>(tag)].bytes.load(std::memory_order_relaxed);
+}
+
+uint64 MemoryTags::GetPeakBytes(MemoryTag tag) {
+    return s_counters[static_cast<size_t>(tag)].peakBytes.load(std::memory_order_relaxed);
+}
+
+uint64 MemoryTags::GetTotalBytes() {
+    uint64 total = 0;
+    for (const auto& counter : s_counters) {
+        total += counter.bytes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+const char* MemoryTags::GetName(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::General:       return "general";
+        case MemoryTag::SwapChain:     return "swap_chain";
+        case MemoryTag::RenderTargets: return "render_targets";
+        case MemoryTag::Buffers:       return "buffers";
+        case MemoryTag::Textures:      return "textures";
+        case MemoryTag::Shaders:       return "shaders";
+        case MemoryTag::XeSS:          return "xess";
+        default:                       return "unknown";
+    }
+}
+
+} // namespace XeSS
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Types.h"
+#include <array>
+#include <atomic>
+
+namespace XeSS {
+
+enum class MemoryTag : uint32 {
+    General = 0,
+    SwapChain,
+    RenderTargets,
+    Buffers,
+    Textures,
+    Shaders,
+    XeSS,
+    Count
+};
+
+/**
+ * Per-category byte counters for memory owned by engine subsystems.
+ * Tracking is a pair of relaxed atomic adds, so it is safe on any thread.
+ */
+class MemoryTags {
+public:
+    static void Allocate(MemoryTag tag, uint64 bytes);
+    static void Free(MemoryTag tag, uint64 bytes);
+
+    static uint64 GetBytes(MemoryTag tag);
+    static uint64 GetPeakBytes(MemoryTag tag);
+    static uint64 GetTotalBytes();
+
+    static const char* GetName(MemoryTag tag);
+
+private:
+    struct Counter {
+        std::atomic<uint64> bytes{0};
+        std::atomic<uint64> peakBytes{0};
+    };
+
+    static std::array<Counter, static_cast<size_t>(MemoryTag::Count)> s_counters;
+};
+
+} // namespace XeSS
@@ -0,0 +1,200 @@
+#include "Metrics.h"
+#include "Exception.h"
+#include <algorithm>
+
+namespace XeSS {
+
+namespace Detail {
+    uint32 ThreadShardIndex() {
+        static std::atomic<uint32> s_nextIndex{0};
+        thread_local uint32 t_index = s_nextIndex.fetch_add(1, std::memory_order_relaxed) %
+                                      MetricCounter::ShardCount;
+        return t_index;
+    }
+}
+
+// MetricHistogram Implementation
+MetricHistogram::MetricHistogram(std::vector<float64> bounds)
+    : m_bounds(std::move(bounds)) {
+    std::sort(m_bounds.begin(), m_bounds.end());
+    m_buckets = std::make_unique<std::atomic<uint64>[]>(m_bounds.size() + 1);
+    for (size_t i = 0; i <= m_bounds.size(); ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::Observe(float64 value) {
+    size_t bucket = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin();
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    Detail::AtomicAddFloat(m_sum, value);
+}
+
+std::vector<uint64> MetricHistogram::BucketCounts() const {
+    std::vector<uint64> counts(m_bounds.size() + 1);
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+std::vector<float64> MetricHistogram::ExponentialBounds(float64 start, float64 factor, uint32 count) {
+    std::vector<float64> bounds;
+    bounds.reserve(count);
+    float64 bound = start;
+    for (uint32 i = 0; i < count; ++i) {
+        bounds.push_back(bound);
+        bound *= factor;
+    }
+    return bounds;
+}
+
+// MetricSample Implementation
+float64 MetricSample::Percentile(float64 percentile) const {
+    if (type != MetricType::Histogram || count == 0) {
+        return 0.0;
+    }
+
+    float64 target = std::clamp(percentile, 0.0, 100.0) / 100.0 * count;
+    uint64 cumulative = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        if (buckets[i] == 0) {
+            continue;
+        }
+        if (cumulative + buckets[i] >= target) {
+            // Interpolate within the bucket; the overflow bucket has no upper bound
+            float64 lower = i > 0 ? bounds[i - 1] : 0.0;
+            if (i >= bounds.size()) {
+                return lower;
+            }
+            float64 fraction = (target - cumulative) / buckets[i];
+            return lower + (bounds[i] - lower) * fraction;
+        }
+        cumulative += buckets[i];
+    }
+    return bounds.empty() ? 0.0 : bounds.back();
+}
+
+// MetricsSnapshot Implementation
+const MetricSample* MetricsSnapshot::Find(const std::string& name) const {
+    for (const auto& sample : samples) {
+        if (sample.name == name) {
+            return &sample;
+        }
+    }
+    return nullptr;
+}
+
+float64 MetricsSnapshot::Value(const std::string& name) const {
+    const MetricSample* sample = Find(name);
+    return sample ? sample->value : 0.0;
+}
+
+MetricsSnapshot MetricsSnapshot::Diff(const MetricsSnapshot& earlier) const {
+    MetricsSnapshot result = *this;
+    for (auto& sample : result.samples) {
+        const MetricSample* before = earlier.Find(sample.name);
+        if (!before || sample.type == MetricType::Gauge) {
+            continue;
+        }
+
+        sample.value -= before->value;
+        if (sample.type == MetricType::Histogram && before->buckets.size() == sample.buckets.size()) {
+            for (size_t i = 0; i < sample.buckets.size(); ++i) {
+                sample.buckets[i] -= before->buckets[i];
+            }
+            sample.sum -= before->sum;
+            sample.count -= before->count;
+            sample.value = static_cast<float64>(sample.count);
+        }
+    }
+    return result;
+}
+
+// MetricsRegistry Implementation
+MetricsRegistry& MetricsRegistry::Instance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+MetricCounter& MetricsRegistry::Counter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = FindOrAdd(name, help, MetricType::Counter);
+    if (!entry.counter) {
+        entry.counter = std::make_unique<MetricCounter>();
+    }
+    return *entry.counter;
+}
+
+MetricGauge& MetricsRegistry::Gauge(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = FindOrAdd(name, help, MetricType::Gauge);
+    if (!entry.gauge) {
+        entry.gauge = std::make_unique<MetricGauge>();
+    }
+    return *entry.gauge;
+}
+
+MetricHistogram& MetricsRegistry::Histogram(const std::string& name, const std::string& help,
+                                            std::vector<float64> bounds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = FindOrAdd(name, help, MetricType::Histogram);
+    if (!entry.histogram) {
+        entry.histogram = std::make_unique<MetricHistogram>(std::move(bounds));
+    }
+    return *entry.histogram;
+}
+
+MetricsSnapshot MetricsRegistry::Snapshot() const {
+    MetricsSnapshot snapshot;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    snapshot.samples.reserve(m_entries.size());
+    for (const auto& entry : m_entries) {
+        MetricSample sample;
+        sample.name = entry->name;
+        sample.help = entry->help;
+        sample.type = entry->type;
+
+        switch (entry->type) {
+            case MetricType::Counter:
+                sample.value = static_cast<float64>(entry->counter->Value());
+                break;
+            case MetricType::Gauge:
+                sample.value = entry->gauge->Value();
+                break;
+            case MetricType::Histogram:
+                sample.bounds = entry->histogram->GetBounds();
+                sample.buckets = entry->histogram->BucketCounts();
+                sample.sum = entry->histogram->Sum();
+                for (uint64 bucket : sample.buckets) {
+                    sample.count += bucket;
+                }
+                sample.value = static_cast<float64>(sample.count);
+                break;
+        }
+
+        snapshot.samples.push_back(std::move(sample));
+    }
+    return snapshot;
+}
+
+MetricsRegistry::Entry& MetricsRegistry::FindOrAdd(const std::string& name, const std::string& help,
+                                                   MetricType type) {
+    for (auto& entry : m_entries) {
+        if (entry->name == name) {
+            if (entry->type != type) {
+                throw Exception("Metric '" + name + "' registered with two different types");
+            }
+            return *entry;
+        }
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->help = help;
+    entry->type = type;
+    m_entries.push_back(std::move(entry));
+    return *m_entries.back();
+}
+
+} // namespace XeSS
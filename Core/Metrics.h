@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Types.h"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace XeSS {
+
+enum class MetricType : uint8 {
+    Counter,
+    Gauge,
+    Histogram
+};
+
+namespace Detail {
+    // Small per-thread index used to pick a counter shard
+    uint32 ThreadShardIndex();
+
+    inline void AtomicAddFloat(std::atomic<uint64>& bits, float64 delta) {
+        uint64 expected = bits.load(std::memory_order_relaxed);
+        while (!bits.compare_exchange_weak(expected,
+                   std::bit_cast<uint64>(std::bit_cast<float64>(expected) + delta),
+                   std::memory_order_relaxed)) {
+        }
+    }
+}
+
+/**
+ * Monotonic counter sharded per thread: Add() touches only the calling
+ * thread's cache line, Value() sums the shards.
+ */
+class MetricCounter {
+public:
+    static constexpr uint32 ShardCount = 16;
+
+    void Add(uint64 amount = 1) {
+        m_shards[Detail::ThreadShardIndex()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    uint64 Value() const {
+        uint64 total = 0;
+        for (const auto& shard : m_shards) {
+            total += shard.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64> value{0};
+    };
+    std::array<Shard, ShardCount> m_shards;
+};
+
+// Last-written value; Add() is a CAS loop for accumulated quantities
+class MetricGauge {
+public:
+    void Set(float64 value) { m_bits.store(std::bit_cast<uint64>(value), std::memory_order_relaxed); }
+    void Add(float64 delta) { Detail::AtomicAddFloat(m_bits, delta); }
+    float64 Value() const { return std::bit_cast<float64>(m_bits.load(std::memory_order_relaxed)); }
+
+private:
+    std::atomic<uint64> m_bits{0}; // Bit pattern of 0.0
+};
+
+// Fixed-bucket histogram; bucket i counts values <= bounds[i], the last
+// bucket everything above
+class MetricHistogram {
+public:
+    explicit MetricHistogram(std::vector<float64> bounds);
+
+    void Observe(float64 value);
+
+    const std::vector<float64>& GetBounds() const { return m_bounds; }
+    std::vector<uint64> BucketCounts() const;
+    float64 Sum() const { return std::bit_cast<float64>(m_sum.load(std::memory_order_relaxed)); }
+
+    // count bounds starting at start, each factor times the previous
+    static std::vector<float64> ExponentialBounds(float64 start, float64 factor, uint32 count);
+
+private:
+    std::vector<float64> m_bounds;
+    std::unique_ptr<std::atomic<uint64>[]> m_buckets;
+    std::atomic<uint64> m_sum{0};
+};
+
+struct MetricSample {
+    std::string name;
+    std::string help;
+    MetricType type{MetricType::Counter};
+    float64 value{0.0};             // Counter total or gauge value
+
+    // Histograms only
+    std::vector<float64> bounds;
+    std::vector<uint64> buckets;
+    float64 sum{0.0};
+    uint64 count{0};
+
+    // Bucket-interpolated estimate, for histograms
+    float64 Percentile(float64 percentile) const;
+};
+
+class MetricsSnapshot {
+public:
+    std::vector<MetricSample> samples;
+
+    const MetricSample* Find(const std::string& name) const;
+    float64 Value(const std::string& name) const;
+
+    // Counters and histograms become the change since earlier; gauges keep
+    // their current value
+    MetricsSnapshot Diff(const MetricsSnapshot& earlier) const;
+};
+
+/**
+ * Process-wide registry of named metrics. Register once, typically into a
+ * static reference at the call site:
+ *
+ *     static MetricCounter& s_hits = MetricsRegistry::Instance().Counter("shader.cache_hits", "...");
+ *
+ * Registration takes a lock; updating a metric never does. Registering an
+ * existing name returns the existing metric.
+ */
+class MetricsRegistry {
+public:
+    static MetricsRegistry& Instance();
+
+    MetricCounter& Counter(const std::string& name, const std::string& help);
+    MetricGauge& Gauge(const std::string& name, const std::string& help);
+    MetricHistogram& Histogram(const std::string& name, const std::string& help,
+                               std::vector<float64> bounds);
+
+    MetricsSnapshot Snapshot() const;
+
+private:
+    MetricsRegistry() = default;
+
+    struct Entry {
+        std::string name;
+        std::string help;
+        MetricType type;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    Entry& FindOrAdd(const std::string& name, const std::string& help, MetricType type);
+
+    std::vector<std::unique_ptr<Entry>> m_entries;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace XeSS
@@ -0,0 +1,341 @@
+#include "MetricsServer.h"
+#include "Logger.h"
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+#pragma comment(lib, "ws2_32.lib")
+using SocketHandle = SOCKET;
+#define XESS_CLOSE_SOCKET closesocket
+#define XESS_POLL WSAPoll
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+using SocketHandle = int;
+#define INVALID_SOCKET (-1)
+#define XESS_CLOSE_SOCKET ::close
+#define XESS_POLL ::poll
+#endif
+
+// A scraper hanging up mid-response must not raise SIGPIPE and kill the
+// process. Linux takes a per-send flag; Apple sets SO_NOSIGPIPE on the
+// socket instead (see ServerMain).
+#ifdef MSG_NOSIGNAL
+#define XESS_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define XESS_SEND_FLAGS 0
+#endif
+
+namespace XeSS {
+
+namespace {
+    constexpr const char* UnixPrefix = "unix:";
+    constexpr const char* LocalhostPrefix = "localhost:";
+
+    // How often the server thread checks for Stop()
+    constexpr int PollIntervalMs = 100;
+
+    const char* TypeName(MetricType type) {
+        switch (type) {
+            case MetricType::Counter:   return "counter";
+            case MetricType::Histogram: return "histogram";
+            default:                    return "gauge";
+        }
+    }
+
+    // "shader.cache_hits" -> "xess_shader_cache_hits_total"
+    std::string ExportName(const MetricSample& sample) {
+        std::string name = "xess_" + sample.name;
+        for (char& c : name) {
+            if (!std::isalnum(static_cast<unsigned char>(c))) {
+                c = '_';
+            }
+        }
+        if (sample.type == MetricType::Counter) {
+            name += "_total";
+        }
+        return name;
+    }
+
+    void WriteValue(std::ostringstream& oss, float64 value) {
+        if (std::isnan(value)) {
+            oss << "NaN";
+        } else if (std::isinf(value)) {
+            oss << (value > 0 ? "+Inf" : "-Inf");
+        } else {
+            oss << value;
+        }
+    }
+
+    void WriteRegistrySample(std::ostringstream& oss, const MetricSample& sample) {
+        const std::string name = ExportName(sample);
+        oss << "# HELP " << name << ' ' << sample.help << '\n';
+        oss << "# TYPE " << name << ' ' << TypeName(sample.type) << '\n';
+
+        if (sample.type != MetricType::Histogram) {
+            oss << name << ' ';
+            WriteValue(oss, sample.value);
+            oss << '\n';
+            return;
+        }
+
+        // Prometheus buckets are cumulative
+        uint64 cumulative = 0;
+        for (size_t i = 0; i < sample.buckets.size(); ++i) {
+            cumulative += sample.buckets[i];
+            oss << name << "_bucket{le=\"";
+            if (i < sample.bounds.size()) {
+                oss << sample.bounds[i];
+            } else {
+                oss << "+Inf";
+            }
+            oss << "\"} " << cumulative << '\n';
+        }
+        oss << name << "_sum ";
+        WriteValue(oss, sample.sum);
+        oss << '\n' << name << "_count " << sample.count << '\n';
+    }
+
+    void SendAll(SocketHandle socket, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            auto result = ::send(socket, data.data() + sent, static_cast<int>(data.size() - sent), XESS_SEND_FLAGS);
+            if (result <= 0) {
+                return;
+            }
+            sent += static_cast<size_t>(result);
+        }
+    }
+
+    // A socket file left by a previous run would make bind fail. Anything
+    // else at the path is left alone, so a mistyped endpoint can't delete a
+    // regular file.
+    bool RemoveStaleSocket(const std::string& path) {
+#ifdef _WIN32
+        // Windows AF_UNIX sockets are reparse points
+        DWORD attributes = GetFileAttributesA(path.c_str());
+        if (attributes == INVALID_FILE_ATTRIBUTES) {
+            return true;
+        }
+        if (!(attributes & FILE_ATTRIBUTE_REPARSE_POINT) || !DeleteFileA(path.c_str())) {
+            XESS_ERROR("Metrics server: '{}' exists and is not a socket", path);
+            return false;
+        }
+#else
+        struct stat status{};
+        if (::lstat(path.c_str(), &status) != 0) {
+            return true;
+        }
+        if (!S_ISSOCK(status.st_mode) || ::unlink(path.c_str()) != 0) {
+            XESS_ERROR("Metrics server: '{}' exists and is not a socket", path);
+            return false;
+        }
+#endif
+        return true;
+    }
+}
+
+MetricsServer::MetricsServer() = default;
+
+MetricsServer::~MetricsServer() {
+    Stop();
+}
+
+bool MetricsServer::Start(const std::string& endpoint) {
+    if (IsRunning()) {
+        XESS_WARNING("Metrics server already running on {}", m_endpoint);
+        return true;
+    }
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        XESS_ERROR("Metrics server: WSAStartup failed");
+        return false;
+    }
+#endif
+
+    if (!OpenListenSocket(endpoint)) {
+        CloseListenSocket();
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    m_endpoint = endpoint;
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&MetricsServer::ServerMain, this);
+
+    XESS_INFO("Metrics server listening on {}", endpoint);
+    return true;
+}
+
+void MetricsServer::Stop() {
+    m_running.store(false, std::memory_order_release);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    if (m_listenSocket != -1) {
+        CloseListenSocket();
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+}
+
+std::string MetricsServer::FormatText() const {
+    std::ostringstream oss;
+    oss.precision(12);
+    for (const auto& sample : MetricsRegistry::Instance().Snapshot().samples) {
+        WriteRegistrySample(oss, sample);
+    }
+    return oss.str();
+}
+
+bool MetricsServer::OpenListenSocket(const std::string& endpoint) {
+    SocketHandle listenSocket = INVALID_SOCKET;
+
+    if (endpoint.rfind(UnixPrefix, 0) == 0) {
+        std::string path = endpoint.substr(std::strlen(UnixPrefix));
+
+        sockaddr_un address{};
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            XESS_ERROR("Metrics server: invalid Unix socket path '{}'", path);
+            return false;
+        }
+
+        if (!RemoveStaleSocket(path)) {
+            return false;
+        }
+
+        listenSocket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenSocket == INVALID_SOCKET) {
+            XESS_ERROR("Metrics server: failed to create Unix socket");
+            return false;
+        }
+        m_listenSocket = static_cast<intptr_t>(listenSocket);
+
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size());
+        if (::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            XESS_ERROR("Metrics server: failed to bind {}", path);
+            return false;
+        }
+        m_unixSocketPath = path;
+    }
+    else if (endpoint.rfind(LocalhostPrefix, 0) == 0) {
+        int port = std::atoi(endpoint.c_str() + std::strlen(LocalhostPrefix));
+        if (port <= 0 || port > 65535) {
+            XESS_ERROR("Metrics server: invalid port in '{}'", endpoint);
+            return false;
+        }
+
+        listenSocket = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listenSocket == INVALID_SOCKET) {
+            XESS_ERROR("Metrics server: failed to create TCP socket");
+            return false;
+        }
+        m_listenSocket = static_cast<intptr_t>(listenSocket);
+
+        int reuse = 1;
+        ::setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR,
+                     reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            XESS_ERROR("Metrics server: failed to bind 127.0.0.1:{}", port);
+            return false;
+        }
+    }
+    else {
+        XESS_ERROR("Metrics server: endpoint must be unix:<path> or localhost:<port>, got '{}'", endpoint);
+        return false;
+    }
+
+    if (::listen(listenSocket, 4) != 0) {
+        XESS_ERROR("Metrics server: listen failed on {}", endpoint);
+        return false;
+    }
+
+    return true;
+}
+
+void MetricsServer::CloseListenSocket() {
+    if (m_listenSocket != -1) {
+        XESS_CLOSE_SOCKET(static_cast<SocketHandle>(m_listenSocket));
+        m_listenSocket = -1;
+    }
+    if (!m_unixSocketPath.empty()) {
+        std::remove(m_unixSocketPath.c_str());
+        m_unixSocketPath.clear();
+    }
+}
+
+void MetricsServer::ServerMain() {
+    const SocketHandle listenSocket = static_cast<SocketHandle>(m_listenSocket);
+
+    while (IsRunning()) {
+        pollfd descriptor{};
+        descriptor.fd = listenSocket;
+        descriptor.events = POLLIN;
+
+        int ready = XESS_POLL(&descriptor, 1, PollIntervalMs);
+        if (ready <= 0 || !(descriptor.revents & POLLIN)) {
+            continue;
+        }
+
+        SocketHandle client = ::accept(listenSocket, nullptr, nullptr);
+        if (client == INVALID_SOCKET) {
+            continue;
+        }
+#ifdef SO_NOSIGPIPE
+        int noSigPipe = 1;
+        ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+        HandleClient(static_cast<intptr_t>(client));
+        XESS_CLOSE_SOCKET(client);
+    }
+}
+
+void MetricsServer::HandleClient(intptr_t clientHandle) {
+    const SocketHandle client = static_cast<SocketHandle>(clientHandle);
+
+    // Every request gets the snapshot; only wait briefly for the request
+    // line so a silent client can't stall the server
+    pollfd descriptor{};
+    descriptor.fd = client;
+    descriptor.events = POLLIN;
+    if (XESS_POLL(&descriptor, 1, PollIntervalMs) > 0) {
+        char request[1024];
+        ::recv(client, request, sizeof(request), 0);
+    }
+
+    std::string body = FormatText();
+    std::ostringstream response;
+    response << "HTTP/1.0 200 OK\r\n"
+             << "Content-Type: text/plain; version=0.0.4\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+
+    SendAll(client, response.str());
+    m_scrapeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace XeSS
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Types.h"
+#include "NonCopyable.h"
+#include "Metrics.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace XeSS {
+
+/**
+ * Optional local telemetry endpoint serving the MetricsRegistry in the
+ * Prometheus text format over HTTP. Bind to "unix:/path/to/socket" or
+ * "localhost:PORT"; only loopback TCP is ever bound.
+ *
+ * The server only serializes; every metric, engine-wide, is registered and
+ * updated through the registry, so publishing never takes a lock.
+ */
+class MetricsServer : public NonCopyable {
+public:
+    MetricsServer();
+    ~MetricsServer();
+
+    bool Start(const std::string& endpoint);
+    void Stop();
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+    const std::string& GetEndpoint() const { return m_endpoint; }
+
+    // Current snapshot in the text exposition format
+    std::string FormatText() const;
+    uint64 GetScrapeCount() const { return m_scrapeCount.load(std::memory_order_relaxed); }
+
+private:
+    bool OpenListenSocket(const std::string& endpoint);
+    void CloseListenSocket();
+    void ServerMain();
+    void HandleClient(intptr_t client);
+
+    std::string m_endpoint;
+    std::string m_unixSocketPath;
+    intptr_t m_listenSocket{-1};
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64> m_scrapeCount{0};
+};
+
+} // namespace XeSS
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Types.h"
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+namespace XeSS {
+
+/**
+ * Bounded single-producer/single-consumer ring buffer.
+ * Push and Pop never block or allocate; capacity is rounded up to a power
+ * of two. Exactly one thread may push and exactly one thread may pop.
+ */
+template<typename T>
+class SPSCQueue {
+    static_assert(std::is_trivially_copyable_v<T>, "SPSCQueue elements must be trivially copyable");
+
+public:
+    explicit SPSCQueue(uint32 capacity = 1024) {
+        uint32 size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_buffer = std::make_unique<T[]>(size);
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // Producer side: returns false if the queue is full
+    bool TryPush(const T& value) {
+        const uint64 tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                return false;
+            }
+        }
+
+        m_buffer[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: returns false if the queue is empty
+    bool TryPop(T& value) {
+        const uint64 head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+
+        value = m_buffer[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called concurrently with push/pop
+    uint32 Size() const {
+        return static_cast<uint32>(m_tail.load(std::memory_order_acquire) -
+                                   m_head.load(std::memory_order_acquire));
+    }
+
+    bool IsEmpty() const { return Size() == 0; }
+    uint32 Capacity() const { return m_mask + 1; }
+
+private:
+    std::unique_ptr<T[]> m_buffer;
+    uint64 m_mask{0};
+
+    // Each side keeps a cached copy of the other's cursor to avoid touching
+    // the shared cache line on every operation
+    alignas(64) std::atomic<uint64> m_head{0};
+    uint64 m_cachedTail{0};
+    alignas(64) std::atomic<uint64> m_tail{0};
+    uint64 m_cachedHead{0};
+};
+
+} // namespace XeSS
@@ -0,0 +1,197 @@
+#include "StartupTimeline.h"
+#include "JsonWriter.h"
+#include "Logger.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fstream>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace XeSS {
+
+namespace {
+    // How long the process has been running, or zero when the OS can't say
+    std::chrono::nanoseconds ProcessAge() {
+#ifdef _WIN32
+        FILETIME creation, exitTime, kernel, user;
+        if (!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user)) {
+            return {};
+        }
+        FILETIME now;
+        GetSystemTimePreciseAsFileTime(&now);
+        auto ticks = [](const FILETIME& time) {
+            return (static_cast<int64>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+        };
+        // FILETIME counts 100 ns intervals
+        return std::chrono::nanoseconds((ticks(now) - ticks(creation)) * 100);
+#elif defined(__linux__)
+        // Field 22 of /proc/self/stat is the start time in clock ticks since
+        // boot; the name in field 2 may hold spaces, so count from its ')'
+        std::ifstream file("/proc/self/stat");
+        std::string stat((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        size_t nameEnd = stat.rfind(')');
+        if (nameEnd == std::string::npos) {
+            return {};
+        }
+        std::istringstream fields(stat.substr(nameEnd + 1));
+        std::string field;
+        for (int index = 3; index <= 22; ++index) {
+            if (!(fields >> field)) {
+                return {};
+            }
+        }
+        long ticksPerSecond = ::sysconf(_SC_CLK_TCK);
+        timespec boot{};
+        if (ticksPerSecond <= 0 || ::clock_gettime(CLOCK_BOOTTIME, &boot) != 0) {
+            return {};
+        }
+        float64 startSeconds = std::stod(field) / static_cast<float64>(ticksPerSecond);
+        float64 nowSeconds = static_cast<float64>(boot.tv_sec) + boot.tv_nsec * 1e-9;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<float64>(nowSeconds - startSeconds));
+#else
+        return {};
+#endif
+    }
+}
+
+StartupTimeline& StartupTimeline::Instance() {
+    static StartupTimeline instance;
+    return instance;
+}
+
+StartupTimeline::StartupTimeline() {
+    // Anchored at process start rather than at the first Instance() call,
+    // which only happens once the application initializes
+    auto age = std::max(ProcessAge(), std::chrono::nanoseconds::zero());
+    m_origin = Clock::now() - std::chrono::duration_cast<Clock::duration>(age);
+}
+
+void StartupTimeline::SetOrigin(Clock::time_point origin) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_origin = origin;
+}
+
+StartupTimeline::Clock::time_point StartupTimeline::GetOrigin() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_origin;
+}
+
+uint32 StartupTimeline::BeginPhase(const std::string& name) {
+    auto now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    StartupPhase phase;
+    phase.name = name;
+    phase.thread = std::this_thread::get_id();
+    phase.startMs = ElapsedMs(now);
+    m_phases.push_back(std::move(phase));
+    m_phaseStarts.push_back(now);
+    return static_cast<uint32>(m_phases.size() - 1);
+}
+
+void StartupTimeline::EndPhase(uint32 id) {
+    auto now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (id >= m_phases.size()) {
+        return;
+    }
+    m_phases[id].durationMs = std::chrono::duration<float64, std::milli>(now - m_phaseStarts[id]).count();
+}
+
+void StartupTimeline::MarkFirstFrame() {
+    auto now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_timeToFirstFrameMs >= 0.0) {
+        return;
+    }
+    m_timeToFirstFrameMs = ElapsedMs(now);
+    XESS_INFO("Time to first frame: {} ms", m_timeToFirstFrameMs);
+}
+
+bool StartupTimeline::HasFirstFrame() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_timeToFirstFrameMs >= 0.0;
+}
+
+float64 StartupTimeline::GetTimeToFirstFrameMs() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_timeToFirstFrameMs;
+}
+
+std::vector<StartupPhase> StartupTimeline::GetPhases() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_phases;
+}
+
+void StartupTimeline::WriteJson(JsonWriter& writer, const std::string& key) const {
+    std::vector<StartupPhase> phases = GetPhases();
+    float64 timeToFirstFrame = GetTimeToFirstFrameMs();
+
+    // Threads are reported as small indices in order of first appearance
+    std::unordered_map<std::thread::id, uint32> threadIndices;
+
+    writer.BeginObject(key);
+    if (timeToFirstFrame >= 0.0) {
+        writer.Field("time_to_first_frame_ms", timeToFirstFrame);
+    }
+    writer.BeginArray("phases");
+    for (const auto& phase : phases) {
+        auto [it, inserted] = threadIndices.try_emplace(phase.thread, static_cast<uint32>(threadIndices.size()));
+        writer.BeginObject()
+            .Field("name", phase.name)
+            .Field("thread", it->second)
+            .Field("start_ms", phase.startMs)
+            .Field("duration_ms", phase.durationMs)
+            .EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+}
+
+void StartupTimeline::LogReport() const {
+    std::vector<StartupPhase> phases = GetPhases();
+    std::stable_sort(phases.begin(), phases.end(),
+        [](const StartupPhase& a, const StartupPhase& b) { return a.startMs < b.startMs; });
+
+    std::unordered_map<std::thread::id, uint32> threadIndices;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << "=== Startup timeline ===";
+    for (const auto& phase : phases) {
+        auto [it, inserted] = threadIndices.try_emplace(phase.thread, static_cast<uint32>(threadIndices.size()));
+        oss << "\n  [T" << it->second << "] " << std::setw(9) << phase.startMs << " ms  "
+            << std::setw(9) << phase.durationMs << " ms  " << phase.name;
+    }
+
+    float64 timeToFirstFrame = GetTimeToFirstFrameMs();
+    if (timeToFirstFrame >= 0.0) {
+        oss << "\n  Time to first frame: " << timeToFirstFrame << " ms";
+    }
+
+    XESS_INFO("{}", oss.str());
+}
+
+void StartupTimeline::Reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_origin = Clock::now();
+    m_phases.clear();
+    m_phaseStarts.clear();
+    m_timeToFirstFrameMs = -1.0;
+}
+
+float64 StartupTimeline::ElapsedMs(Clock::time_point time) const {
+    return std::chrono::duration<float64, std::milli>(time - m_origin).count();
+}
+
+} // namespace XeSS
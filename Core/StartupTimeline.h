@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Types.h"
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace XeSS {
+
+class JsonWriter;
+
+struct StartupPhase {
+    std::string name;
+    std::thread::id thread;
+    float64 startMs{0.0};     // Relative to the timeline origin
+    float64 durationMs{-1.0}; // Negative while the phase is still open
+};
+
+/**
+ * Records when each initialization phase ran, on which thread, relative to
+ * process start, plus the time until the first frame was presented.
+ * Thread-safe; meant for startup only, so phases are kept in a plain vector.
+ */
+class StartupTimeline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // RAII phase
+    class Scope {
+    public:
+        Scope(StartupTimeline& timeline, const std::string& name)
+            : m_timeline(timeline), m_id(timeline.BeginPhase(name)) {}
+        ~Scope() { m_timeline.EndPhase(m_id); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        StartupTimeline& m_timeline;
+        uint32 m_id;
+    };
+
+    static StartupTimeline& Instance();
+
+    // The origin defaults to the process start time as reported by the OS
+    // (the first use of Instance() where it can't be read). Override it to
+    // measure from somewhere else.
+    void SetOrigin(Clock::time_point origin);
+    Clock::time_point GetOrigin() const;
+
+    uint32 BeginPhase(const std::string& name);
+    void EndPhase(uint32 id);
+
+    // Only the first call has an effect
+    void MarkFirstFrame();
+    bool HasFirstFrame() const;
+    float64 GetTimeToFirstFrameMs() const;
+
+    std::vector<StartupPhase> GetPhases() const;
+
+    void WriteJson(JsonWriter& writer, const std::string& key) const;
+    void LogReport() const;
+
+    void Reset();
+
+private:
+    StartupTimeline();
+
+    float64 ElapsedMs(Clock::time_point time) const;
+
+    mutable std::mutex m_mutex;
+    Clock::time_point m_origin;
+    std::vector<StartupPhase> m_phases;
+    std::vector<Clock::time_point> m_phaseStarts;
+    float64 m_timeToFirstFrameMs{-1.0};
+};
+
+} // namespace XeSS
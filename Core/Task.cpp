@@ -0,0 +1,76 @@
+#include "Task.h"
+#include "JobSystem.h"
+
+namespace XeSS {
+
+namespace Detail {
+
+    void ResumeAsJob(std::coroutine_handle<> handle) {
+        JobSystem::Instance().Submit([handle]() { handle.resume(); });
+    }
+
+    bool WaiterList::Add(TaskWaiter& waiter) {
+        TaskWaiter* head = m_head.load(std::memory_order_acquire);
+        do {
+            if (head == Closed()) {
+                return false;
+            }
+            waiter.next = head;
+        } while (!m_head.compare_exchange_weak(head, &waiter,
+                                               std::memory_order_release, std::memory_order_acquire));
+        return true;
+    }
+
+    TaskWaiter* WaiterList::Complete() {
+        TaskWaiter* waiters = m_head.exchange(Closed(), std::memory_order_acq_rel);
+        m_head.notify_all();
+        return waiters == Closed() ? nullptr : waiters;
+    }
+
+    void WaiterList::Wait() const {
+        TaskWaiter* head = m_head.load(std::memory_order_acquire);
+        while (head != Closed()) {
+            // Help with queued jobs; sleep only when there is nothing to run
+            if (!JobSystem::Instance().RunPendingJob()) {
+                m_head.wait(head, std::memory_order_acquire);
+            }
+            head = m_head.load(std::memory_order_acquire);
+        }
+    }
+
+    void TaskPromiseBase::Release() {
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_self.destroy();
+        }
+    }
+
+    std::coroutine_handle<> TaskPromiseBase::Finish() noexcept {
+        TaskWaiter* waiter = m_waiters.Complete();
+        std::coroutine_handle<> next = std::noop_coroutine();
+        if (waiter) {
+            // Symmetric transfer: the first waiter continues without growing the stack
+            next = waiter->handle;
+            for (waiter = waiter->next; waiter;) {
+                TaskWaiter* following = waiter->next;
+                ResumeAsJob(waiter->handle);
+                waiter = following;
+            }
+        }
+
+        // Waiters hold a Task handle, so this only frees a detached coroutine
+        Release();
+        return next;
+    }
+
+} // namespace Detail
+
+void AsyncEvent::Set() {
+    Detail::TaskWaiter* waiter = m_waiters.Complete();
+    while (waiter) {
+        Detail::TaskWaiter* following = waiter->next;
+        Detail::ResumeAsJob(waiter->handle);
+        waiter = following;
+    }
+}
+
+} // namespace XeSS
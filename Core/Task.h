@@ -0,0 +1,406 @@
+#pragma once
+
+#include "Types.h"
+#include "Exception.h"
+#include "NonCopyable.h"
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace XeSS {
+
+template <typename T = void>
+class Task;
+
+class TaskCancelledException : public Exception {
+public:
+    TaskCancelledException() : Exception("Task cancelled") {}
+};
+
+/**
+ * Observes a CancellationSource. A default-constructed token is never
+ * cancelled. Cancellation is cooperative: tasks check the token between
+ * stages and stop by throwing TaskCancelledException.
+ */
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    bool IsCancelled() const { return m_state && m_state->load(std::memory_order_acquire); }
+    void ThrowIfCancelled() const {
+        if (IsCancelled()) {
+            throw TaskCancelledException();
+        }
+    }
+
+private:
+    friend class CancellationSource;
+    explicit CancellationToken(std::shared_ptr<std::atomic<bool>> state) : m_state(std::move(state)) {}
+
+    std::shared_ptr<std::atomic<bool>> m_state;
+};
+
+class CancellationSource {
+public:
+    CancellationSource() : m_state(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void Cancel() { m_state->store(true, std::memory_order_release); }
+    bool IsCancelled() const { return m_state->load(std::memory_order_acquire); }
+    CancellationToken GetToken() const { return CancellationToken(m_state); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_state;
+};
+
+namespace Detail {
+
+    // Submits the coroutine to the JobSystem (inline if it is not running)
+    void ResumeAsJob(std::coroutine_handle<> handle);
+
+    // A suspended awaiter; lives in the awaiting coroutine's frame
+    struct TaskWaiter {
+        std::coroutine_handle<> handle;
+        TaskWaiter* next{nullptr};
+    };
+
+    // Lock-free list of waiters that is closed once, on completion
+    class WaiterList {
+    public:
+        bool IsComplete() const { return m_head.load(std::memory_order_acquire) == Closed(); }
+
+        // Returns false if already complete; the caller then must not suspend
+        bool Add(TaskWaiter& waiter);
+
+        // Closes the list and returns the waiters registered so far
+        TaskWaiter* Complete();
+
+        // Blocks until complete, running queued jobs meanwhile
+        void Wait() const;
+
+    private:
+        static TaskWaiter* Closed() { return reinterpret_cast<TaskWaiter*>(&s_closed); }
+        static inline char s_closed;
+
+        std::atomic<TaskWaiter*> m_head{nullptr};
+    };
+
+    class TaskPromiseBase {
+    public:
+        // Tasks start as a job, so creating one never runs its body inline
+        struct InitialAwaiter {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) const { ResumeAsJob(handle); }
+            void await_resume() const noexcept {}
+        };
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+                return handle.promise().Finish();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        InitialAwaiter initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void unhandled_exception() noexcept { m_error = std::current_exception(); }
+
+        bool IsReady() const { return m_waiters.IsComplete(); }
+        bool AddWaiter(TaskWaiter& waiter) { return m_waiters.Add(waiter); }
+        void Wait() const { m_waiters.Wait(); }
+
+        // One reference for the running coroutine, one per Task handle
+        void AddRef() { m_refs.fetch_add(1, std::memory_order_relaxed); }
+        void Release();
+
+    protected:
+        void RethrowIfFailed() const {
+            if (m_error) {
+                std::rethrow_exception(m_error);
+            }
+        }
+
+        std::coroutine_handle<> m_self;
+
+    private:
+        // Wakes the waiters: the first continues on this thread, the rest as jobs
+        std::coroutine_handle<> Finish() noexcept;
+
+        WaiterList m_waiters;
+        std::atomic<uint32> m_refs{2};
+        std::exception_ptr m_error;
+    };
+
+    template <typename T>
+    class TaskPromise : public TaskPromiseBase {
+    public:
+        Task<T> get_return_object() noexcept;
+        void return_value(T value) { m_value.emplace(std::move(value)); }
+
+        T& Result() & {
+            RethrowIfFailed();
+            return *m_value;
+        }
+        T Result() && {
+            RethrowIfFailed();
+            return std::move(*m_value);
+        }
+
+    private:
+        std::optional<T> m_value;
+    };
+
+    template <>
+    class TaskPromise<void> : public TaskPromiseBase {
+    public:
+        Task<void> get_return_object() noexcept;
+        void return_void() const noexcept {}
+        void Result() const { RethrowIfFailed(); }
+    };
+
+    struct TaskAccess;
+
+} // namespace Detail
+
+/**
+ * Coroutine running on the JobSystem. The body starts as a job as soon as the
+ * task is created; co_await suspends the awaiting coroutine until the task
+ * finished and returns its value or rethrows its exception. A task can be
+ * awaited by several coroutines and blocked on with Get(). Dropping the last
+ * Task handle detaches a running coroutine rather than cancelling it.
+ *
+ * Awaiting an rvalue task moves the value out; awaiting an lvalue returns a
+ * reference valid while the task is held.
+ */
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = Detail::TaskPromise<T>;
+
+    Task() = default;
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { Reset(); }
+
+    bool IsValid() const { return static_cast<bool>(m_handle); }
+    bool IsReady() const { return m_handle && m_handle.promise().IsReady(); }
+
+    // Blocks until the task finished, running queued jobs meanwhile
+    void Wait() const {
+        if (m_handle) {
+            m_handle.promise().Wait();
+        }
+    }
+
+    decltype(auto) Get() & {
+        Wait();
+        return m_handle.promise().Result();
+    }
+    T Get() && {
+        Wait();
+        return std::move(m_handle.promise()).Result();
+    }
+
+    auto operator co_await() & noexcept { return Awaiter<false>{m_handle, {}}; }
+    auto operator co_await() && noexcept { return Awaiter<true>{m_handle, {}}; }
+
+private:
+    friend class Detail::TaskPromise<T>;
+    friend struct Detail::TaskAccess;
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle handle) : m_handle(handle) {}
+
+    void Reset() {
+        if (m_handle) {
+            std::exchange(m_handle, {}).promise().Release();
+        }
+    }
+
+    template <bool MoveResult>
+    struct Awaiter {
+        Handle task;
+        Detail::TaskWaiter waiter;
+
+        bool await_ready() const noexcept { return task.promise().IsReady(); }
+        bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            waiter.handle = awaiting;
+            return task.promise().AddWaiter(waiter);
+        }
+        decltype(auto) await_resume() {
+            if constexpr (MoveResult) {
+                return std::move(task.promise()).Result();
+            } else {
+                return task.promise().Result();
+            }
+        }
+    };
+
+    Handle m_handle;
+};
+
+namespace Detail {
+
+    template <typename T>
+    Task<T> TaskPromise<T>::get_return_object() noexcept {
+        m_self = std::coroutine_handle<TaskPromise>::from_promise(*this);
+        return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+        m_self = std::coroutine_handle<TaskPromise>::from_promise(*this);
+        return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+    }
+
+    struct TaskAccess {
+        // A second handle to the same coroutine, for combinators that outlive the caller's
+        template <typename T>
+        static Task<T> Retain(const Task<T>& task) {
+            task.m_handle.promise().AddRef();
+            return Task<T>(task.m_handle);
+        }
+    };
+
+} // namespace Detail
+
+/**
+ * One-shot event for coroutines. Set() resumes every waiter as a job; awaiting
+ * an event that is already set does not suspend.
+ */
+class AsyncEvent : public NonCopyable {
+public:
+    bool IsSet() const { return m_waiters.IsComplete(); }
+    void Set();
+
+    // Blocks until set, running queued jobs meanwhile
+    void Wait() const { m_waiters.Wait(); }
+
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            AsyncEvent& event;
+            Detail::TaskWaiter waiter;
+
+            bool await_ready() const noexcept { return event.IsSet(); }
+            bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                waiter.handle = awaiting;
+                return event.m_waiters.Add(waiter);
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this, {}};
+    }
+
+private:
+    Detail::WaiterList m_waiters;
+};
+
+/**
+ * Adapts a callback API: start(complete) begins the operation and calling
+ * complete(value), from any thread, resumes the awaiting coroutine there.
+ * If complete runs before start returns, the coroutine just continues
+ * without suspending.
+ */
+template <typename T, typename Start>
+auto AwaitCallback(Start start) {
+    struct Awaiter {
+        Start start;
+        std::optional<T> value;
+        std::coroutine_handle<> awaiting;
+        std::atomic<bool> handedOff{false};
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            awaiting = handle;
+            // Whichever of the callback and this function gets here second
+            // continues the coroutine. Resuming from inside start() instead
+            // could finish it and free this frame while start() still runs.
+            start([this](T&& result) {
+                value.emplace(std::move(result));
+                if (handedOff.exchange(true, std::memory_order_acq_rel)) {
+                    awaiting.resume();
+                }
+            });
+            return !handedOff.exchange(true, std::memory_order_acq_rel);
+        }
+        T await_resume() { return std::move(*value); }
+    };
+    return Awaiter{std::move(start), std::nullopt, {}, false};
+}
+
+// Awaits every task in order; they already run concurrently, so this finishes
+// with the slowest. The first failure is rethrown once all earlier ones ended.
+template <typename T>
+    requires (!std::is_void_v<T>)
+Task<std::vector<T>> WhenAll(std::vector<Task<T>> tasks) {
+    std::vector<T> results;
+    results.reserve(tasks.size());
+    for (Task<T>& task : tasks) {
+        results.push_back(co_await std::move(task));
+    }
+    co_return results;
+}
+
+inline Task<> WhenAll(std::vector<Task<>> tasks) {
+    for (Task<>& task : tasks) {
+        co_await task;
+    }
+}
+
+namespace Detail {
+
+    struct WhenAnyState {
+        std::atomic<size_t> winner{SIZE_MAX};
+        AsyncEvent done;
+    };
+
+    template <typename T>
+    Task<> NotifyWhenAny(Task<T> task, std::shared_ptr<WhenAnyState> state, size_t index) {
+        try {
+            co_await task;
+        }
+        catch (...) {
+            // Failures count as finishing; the caller sees them through the task
+        }
+
+        size_t expected = SIZE_MAX;
+        if (state->winner.compare_exchange_strong(expected, index, std::memory_order_acq_rel)) {
+            state->done.Set();
+        }
+    }
+
+} // namespace Detail
+
+// Index of the first task to finish, successfully or not. The tasks stay with
+// the caller, who must keep the vector alive until the returned task finished.
+template <typename T>
+Task<size_t> WhenAny(std::vector<Task<T>>& tasks) {
+    if (tasks.empty()) {
+        throw Exception("WhenAny needs at least one task");
+    }
+
+    auto state = std::make_shared<Detail::WhenAnyState>();
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        // Detached: each watcher finishes on its own once its task did
+        Task<> watcher = Detail::NotifyWhenAny(Detail::TaskAccess::Retain(tasks[i]), state, i);
+    }
+
+    co_await state->done;
+    co_return state->winner.load(std::memory_order_acquire);
+}
+
+} // namespace XeSS
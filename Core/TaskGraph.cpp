@@ -0,0 +1,142 @@
+#include "TaskGraph.h"
+#include "JobSystem.h"
+#include "StartupTimeline.h"
+#include "Exception.h"
+#include "Logger.h"
+#include <optional>
+
+namespace XeSS {
+
+TaskGraph::TaskGraph(std::string name)
+    : m_name(std::move(name)) {
+}
+
+TaskId TaskGraph::AddTask(const std::string& name, std::function<void()> work,
+                          std::initializer_list<TaskId> dependencies, TaskAffinity affinity) {
+    const TaskId id = static_cast<TaskId>(m_tasks.size());
+
+    auto task = std::make_unique<Task>();
+    task->name = name;
+    task->work = std::move(work);
+    task->affinity = affinity;
+
+    for (TaskId dependency : dependencies) {
+        if (dependency >= id) {
+            throw Exception("TaskGraph '" + m_name + "': task '" + name +
+                            "' depends on a task that was not added before it");
+        }
+        task->dependencies.push_back(dependency);
+        m_tasks[dependency]->dependents.push_back(id);
+    }
+
+    m_tasks.push_back(std::move(task));
+    return id;
+}
+
+void TaskGraph::Run() {
+    Validate();
+
+    const uint32 taskCount = GetTaskCount();
+    m_completed = 0;
+    m_mainQueue.clear();
+    m_failed.store(false, std::memory_order_relaxed);
+    m_error = nullptr;
+
+    for (auto& task : m_tasks) {
+        task->remaining.store(static_cast<uint32>(task->dependencies.size()), std::memory_order_relaxed);
+    }
+
+    for (TaskId id = 0; id < taskCount; ++id) {
+        if (m_tasks[id]->dependencies.empty()) {
+            Schedule(id);
+        }
+    }
+
+    // The caller runs main-thread tasks and otherwise helps the workers
+    while (true) {
+        std::optional<TaskId> mainTask;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_completed == taskCount) {
+                break;
+            }
+            if (!m_mainQueue.empty()) {
+                mainTask = m_mainQueue.front();
+                m_mainQueue.pop_front();
+            }
+        }
+
+        if (mainTask) {
+            RunTask(*mainTask);
+            continue;
+        }
+
+        if (JobSystem::Instance().RunPendingJob()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this, taskCount]() {
+            return m_completed == taskCount || !m_mainQueue.empty();
+        });
+    }
+
+    if (m_failed.load(std::memory_order_acquire)) {
+        std::rethrow_exception(m_error);
+    }
+}
+
+void TaskGraph::Validate() const {
+    // Dependencies always point at earlier tasks (checked in AddTask), so the
+    // graph is acyclic by construction; only reject empty work here
+    for (const auto& task : m_tasks) {
+        if (!task->work) {
+            throw Exception("TaskGraph '" + m_name + "': task '" + task->name + "' has no work");
+        }
+    }
+}
+
+void TaskGraph::Schedule(TaskId id) {
+    if (m_tasks[id]->affinity == TaskAffinity::MainThread) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_mainQueue.push_back(id);
+        m_condition.notify_all();
+        return;
+    }
+
+    JobSystem::Instance().Submit([this, id]() { RunTask(id); });
+}
+
+void TaskGraph::RunTask(TaskId id) {
+    Task& task = *m_tasks[id];
+
+    if (!m_failed.load(std::memory_order_acquire)) {
+        try {
+            if (m_timeline) {
+                StartupTimeline::Scope phase(*m_timeline, task.name);
+                task.work();
+            } else {
+                task.work();
+            }
+        }
+        catch (...) {
+            bool expected = false;
+            if (m_failed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                m_error = std::current_exception();
+            }
+            XESS_ERROR("TaskGraph '{}': task failed", m_name);
+        }
+    }
+
+    for (TaskId dependent : task.dependents) {
+        if (m_tasks[dependent]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Schedule(dependent);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_completed;
+    m_condition.notify_all();
+}
+
+} // namespace XeSS
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Types.h"
+#include "NonCopyable.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace XeSS {
+
+class StartupTimeline;
+
+using TaskId = uint32;
+
+enum class TaskAffinity : uint8 {
+    Any,        // Runs on a JobSystem worker (or the caller, while it waits)
+    MainThread  // Runs on the thread that called Run(), e.g. window creation
+};
+
+/**
+ * One-shot dependency graph of tasks executed on the JobSystem. A task starts
+ * once all of its dependencies have finished. If a task throws, tasks that
+ * have not started yet are skipped and Run() rethrows the first failure.
+ */
+class TaskGraph : public NonCopyable {
+public:
+    explicit TaskGraph(std::string name = "tasks");
+
+    TaskId AddTask(const std::string& name, std::function<void()> work,
+                   std::initializer_list<TaskId> dependencies = {},
+                   TaskAffinity affinity = TaskAffinity::Any);
+
+    // Records every task as a phase of the timeline
+    void SetTimeline(StartupTimeline* timeline) { m_timeline = timeline; }
+
+    // Blocks until every task has finished; the caller helps run jobs
+    void Run();
+
+    uint32 GetTaskCount() const { return static_cast<uint32>(m_tasks.size()); }
+
+private:
+    struct Task {
+        std::string name;
+        std::function<void()> work;
+        std::vector<TaskId> dependencies;
+        std::vector<TaskId> dependents;
+        TaskAffinity affinity{TaskAffinity::Any};
+        std::atomic<uint32> remaining{0};
+    };
+
+    void Validate() const;
+    void Schedule(TaskId id);
+    void RunTask(TaskId id);
+
+    std::string m_name;
+    std::vector<std::unique_ptr<Task>> m_tasks;
+    StartupTimeline* m_timeline{nullptr};
+
+    // Completion is tracked under the mutex and signalled while holding it,
+    // so Run() can't return while a worker is still touching the graph
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<TaskId> m_mainQueue;
+    uint32 m_completed{0};
+
+    std::atomic<bool> m_failed{false};
+    std::exception_ptr m_error;
+};
+
+} // namespace XeSS
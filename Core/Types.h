@@ -28,8 +28,8 @@ struct Vector2 {
     float32 x{0.0f};
     float32 y{0.0f};
 
-    Vector2() = default;
-    Vector2(float32 x_, float32 y_) : x(x_), y(y_) {}
+    constexpr Vector2() = default;
+    constexpr Vector2(float32 x_, float32 y_) : x(x_), y(y_) {}
 
     Vector2 operator+(const Vector2& other) const {
         return {x + other.x, y + other.y};
@@ -50,8 +50,8 @@ struct Vector3 {
     float32 y{0.0f};
     float32 z{0.0f};
 
-    Vector3() = default;
-    Vector3(float32 x_, float32 y_, float32 z_) : x(x_), y(y_), z(z_) {}
+    constexpr Vector3() = default;
+    constexpr Vector3(float32 x_, float32 y_, float32 z_) : x(x_), y(y_), z(z_) {}
 };
 
 // 4D Vector
@@ -61,8 +61,8 @@ struct Vector4 {
     float32 z{0.0f};
     float32 w{0.0f};
 
-    Vector4() = default;
-    Vector4(float32 x_, float32 y_, float32 z_, float32 w_) : x(x_), y(y_), z(z_), w(w_) {}
+    constexpr Vector4() = default;
+    constexpr Vector4(float32 x_, float32 y_, float32 z_, float32 w_) : x(x_), y(y_), z(z_), w(w_) {}
 };
 
 // Resolution
@@ -70,8 +70,8 @@ struct Resolution {
     uint32 width{0};
     uint32 height{0};
 
-    Resolution() = default;
-    Resolution(uint32 w, uint32 h) : width(w), height(h) {}
+    constexpr Resolution() = default;
+    constexpr Resolution(uint32 w, uint32 h) : width(w), height(h) {}
 
     bool IsValid() const {
         return width > 0 && height > 0;
@@ -1,15 +1,223 @@
 #include "Utils.h"
-#include <codecvt>
-#include <locale>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XESS_UTF_SSE2 1
+#endif
 
 #ifdef _WIN32
 #include <windows.h>
 #include <shlwapi.h>
+#include <psapi.h>
 #pragma comment(lib, "shlwapi.lib")
+#pragma comment(lib, "psapi.lib")
+#else
+#include <fstream>
 #endif
 
 namespace XeSS::Utils {
 
+namespace {
+    constexpr char32_t ReplacementCharacter = 0xFFFD;
+
+    bool IsContinuation(unsigned char c) {
+        return (c & 0xC0) == 0x80;
+    }
+
+    // Decodes the multi-byte sequence at in[i]; on malformed input returns
+    // U+FFFD and consumes one byte so decoding resynchronizes
+    char32_t DecodeSequence(const unsigned char* in, size_t size, size_t& i) {
+        unsigned char lead = in[i];
+        size_t remaining = size - i;
+
+        if (lead >= 0xC2 && lead <= 0xDF && remaining >= 2 && IsContinuation(in[i + 1])) {
+            char32_t cp = ((lead & 0x1Fu) << 6) | (in[i + 1] & 0x3Fu);
+            i += 2;
+            return cp;
+        }
+
+        if (lead >= 0xE0 && lead <= 0xEF && remaining >= 3) {
+            unsigned char c1 = in[i + 1];
+            // Reject overlong forms (E0 80..9F) and surrogates (ED A0..BF)
+            unsigned char low = lead == 0xE0 ? 0xA0 : 0x80;
+            unsigned char high = lead == 0xED ? 0x9F : 0xBF;
+            if (c1 >= low && c1 <= high && IsContinuation(in[i + 2])) {
+                char32_t cp = ((lead & 0x0Fu) << 12) | ((c1 & 0x3Fu) << 6) | (in[i + 2] & 0x3Fu);
+                i += 3;
+                return cp;
+            }
+        }
+
+        if (lead >= 0xF0 && lead <= 0xF4 && remaining >= 4) {
+            unsigned char c1 = in[i + 1];
+            // Reject overlong forms (F0 80..8F) and code points above U+10FFFF
+            unsigned char low = lead == 0xF0 ? 0x90 : 0x80;
+            unsigned char high = lead == 0xF4 ? 0x8F : 0xBF;
+            if (c1 >= low && c1 <= high && IsContinuation(in[i + 2]) && IsContinuation(in[i + 3])) {
+                char32_t cp = ((lead & 0x07u) << 18) | ((c1 & 0x3Fu) << 12) |
+                              ((in[i + 2] & 0x3Fu) << 6) | (in[i + 3] & 0x3Fu);
+                i += 4;
+                return cp;
+            }
+        }
+
+        ++i;
+        return ReplacementCharacter;
+    }
+
+    // Works for 16-bit (UTF-16) and 32-bit (UTF-32) code units. Neither needs
+    // more units than the input has bytes, so the output is sized once.
+    template<typename CharT>
+    void DecodeUtf8(std::string_view utf8, std::basic_string<CharT>& out) {
+        static_assert(sizeof(CharT) == 2 || sizeof(CharT) == 4);
+
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(utf8.data());
+        const size_t size = utf8.size();
+        out.resize(size);
+        CharT* dst = out.data();
+
+        size_t i = 0;
+        while (i < size) {
+#ifdef XESS_UTF_SSE2
+            // ASCII fast path: widen 16 bytes at a time until a lead byte shows up
+            const __m128i zero = _mm_setzero_si128();
+            while (i + 16 <= size) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                if (_mm_movemask_epi8(bytes) != 0) {
+                    break;
+                }
+                __m128i low = _mm_unpacklo_epi8(bytes, zero);
+                __m128i high = _mm_unpackhi_epi8(bytes, zero);
+                if constexpr (sizeof(CharT) == 2) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), low);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), high);
+                } else {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(low, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(low, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), _mm_unpacklo_epi16(high, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 12), _mm_unpackhi_epi16(high, zero));
+                }
+                dst += 16;
+                i += 16;
+            }
+            if (i >= size) {
+                break;
+            }
+#endif
+            if (in[i] < 0x80) {
+                *dst++ = static_cast<CharT>(in[i++]);
+                continue;
+            }
+
+            char32_t cp = DecodeSequence(in, size, i);
+            if (sizeof(CharT) == 2 && cp >= 0x10000) {
+                cp -= 0x10000;
+                *dst++ = static_cast<CharT>(0xD800 + (cp >> 10));
+                *dst++ = static_cast<CharT>(0xDC00 + (cp & 0x3FF));
+            } else {
+                *dst++ = static_cast<CharT>(cp);
+            }
+        }
+
+        out.resize(static_cast<size_t>(dst - out.data()));
+    }
+
+    size_t AppendUtf8(char32_t cp, char* dst) {
+        if (cp < 0x80) {
+            dst[0] = static_cast<char>(cp);
+            return 1;
+        }
+        if (cp < 0x800) {
+            dst[0] = static_cast<char>(0xC0 | (cp >> 6));
+            dst[1] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 2;
+        }
+        if (cp < 0x10000) {
+            dst[0] = static_cast<char>(0xE0 | (cp >> 12));
+            dst[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            dst[2] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 3;
+        }
+        dst[0] = static_cast<char>(0xF0 | (cp >> 18));
+        dst[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        dst[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        dst[3] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 4;
+    }
+
+    // One UTF-16 unit needs at most 3 bytes (a surrogate pair takes 4 for
+    // two units); one UTF-32 unit at most 4
+    template<typename CharT>
+    void EncodeUtf8(const CharT* in, size_t size, std::string& out) {
+        static_assert(sizeof(CharT) == 2 || sizeof(CharT) == 4);
+
+        out.resize(size * (sizeof(CharT) == 2 ? 3 : 4));
+        char* dst = out.data();
+
+        size_t i = 0;
+        while (i < size) {
+#ifdef XESS_UTF_SSE2
+            // ASCII fast path: narrow 16 units at a time while none exceeds 0x7F
+            if constexpr (sizeof(CharT) == 2) {
+                const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+                while (i + 16 <= size) {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+                    __m128i high = _mm_and_si128(_mm_or_si128(a, b), mask);
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF) {
+                        break;
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(a, b));
+                    dst += 16;
+                    i += 16;
+                }
+            } else {
+                const __m128i mask = _mm_set1_epi32(static_cast<int>(0xFFFFFF80u));
+                while (i + 16 <= size) {
+                    const __m128i* src = reinterpret_cast<const __m128i*>(in + i);
+                    __m128i a = _mm_loadu_si128(src);
+                    __m128i b = _mm_loadu_si128(src + 1);
+                    __m128i c = _mm_loadu_si128(src + 2);
+                    __m128i d = _mm_loadu_si128(src + 3);
+                    __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), mask);
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF) {
+                        break;
+                    }
+                    __m128i words = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), words);
+                    dst += 16;
+                    i += 16;
+                }
+            }
+            if (i >= size) {
+                break;
+            }
+#endif
+            char32_t cp = static_cast<char32_t>(in[i++]);
+            if (cp < 0x80) {
+                *dst++ = static_cast<char>(cp);
+                continue;
+            }
+
+            if (cp >= 0xD800 && cp <= 0xDFFF) {
+                // Only a high surrogate followed by a low one forms a code point
+                if (sizeof(CharT) == 2 && cp <= 0xDBFF && i < size &&
+                    in[i] >= 0xDC00 && in[i] <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (static_cast<char32_t>(in[i++]) - 0xDC00);
+                } else {
+                    cp = ReplacementCharacter;
+                }
+            } else if (cp > 0x10FFFF) {
+                cp = ReplacementCharacter;
+            }
+
+            dst += AppendUtf8(cp, dst);
+        }
+
+        out.resize(static_cast<size_t>(dst - out.data()));
+    }
+}
+
 float32 GetVanDerCorput(uint32 index, uint32 base) {
     float32 result = 0.0f;
     float32 bk = 1.0f;
@@ -39,36 +247,28 @@ std::vector<std::pair<float32, float32>> GenerateHalton(
     return result;
 }
 
-std::string WideToString(const std::wstring& wstr) {
-    if (wstr.empty()) return {};
+std::u16string Utf8ToUtf16(std::string_view utf8) {
+    std::u16string result;
+    DecodeUtf8(utf8, result);
+    return result;
+}
 
-#ifdef _WIN32
-    int size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0],
-        static_cast<int>(wstr.size()), nullptr, 0, nullptr, nullptr);
-    std::string result(size_needed, 0);
-    WideCharToMultiByte(CP_UTF8, 0, &wstr[0], static_cast<int>(wstr.size()),
-        &result[0], size_needed, nullptr, nullptr);
+std::string Utf16ToUtf8(std::u16string_view utf16) {
+    std::string result;
+    EncodeUtf8(utf16.data(), utf16.size(), result);
     return result;
-#else
-    std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
-    return converter.to_bytes(wstr);
-#endif
 }
 
-std::wstring StringToWide(const std::string& str) {
-    if (str.empty()) return {};
+std::string WideToString(std::wstring_view wstr) {
+    std::string result;
+    EncodeUtf8(wstr.data(), wstr.size(), result);
+    return result;
+}
 
-#ifdef _WIN32
-    int size_needed = MultiByteToWideChar(CP_UTF8, 0, &str[0],
-        static_cast<int>(str.size()), nullptr, 0);
-    std::wstring result(size_needed, 0);
-    MultiByteToWideChar(CP_UTF8, 0, &str[0], static_cast<int>(str.size()),
-        &result[0], size_needed);
+std::wstring StringToWide(std::string_view str) {
+    std::wstring result;
+    DecodeUtf8(str, result);
     return result;
-#else
-    std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
-    return converter.from_bytes(str);
-#endif
 }
 
 std::wstring GetExecutableDirectory() {
@@ -95,4 +295,29 @@ bool FileExists(const std::wstring& path) {
 #endif
 }
 
+ProcessMemoryUsage GetProcessMemoryUsage() {
+    ProcessMemoryUsage usage;
+
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        usage.currentBytes = counters.WorkingSetSize;
+        usage.peakBytes = counters.PeakWorkingSetSize;
+    }
+#else
+    // VmRSS / VmHWM are reported in kB
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            usage.currentBytes = std::stoull(line.substr(6)) * 1024;
+        } else if (line.rfind("VmHWM:", 0) == 0) {
+            usage.peakBytes = std::stoull(line.substr(6)) * 1024;
+        }
+    }
+#endif
+
+    return usage;
+}
+
 } // namespace XeSS::Utils
@@ -4,6 +4,7 @@
 #include <vector>
 #include <utility>
 #include <string>
+#include <string_view>
 
 namespace XeSS::Utils {
 
@@ -30,14 +31,21 @@ std::vector<std::pair<float32, float32>> GenerateHalton(
 float32 GetVanDerCorput(uint32 index, uint32 base);
 
 /**
- * Convert wide string to string
+ * UTF-8 <-> UTF-16 conversion. ASCII runs are converted 16 bytes at a time
+ * with SSE2; malformed sequences and unpaired surrogates become U+FFFD.
  */
-std::string WideToString(const std::wstring& wstr);
+std::u16string Utf8ToUtf16(std::string_view utf8);
+std::string Utf16ToUtf8(std::u16string_view utf16);
 
 /**
- * Convert string to wide string
+ * Convert wide string (UTF-16 on Windows, UTF-32 elsewhere) to UTF-8
  */
-std::wstring StringToWide(const std::string& str);
+std::string WideToString(std::wstring_view wstr);
+
+/**
+ * Convert UTF-8 string to wide string
+ */
+std::wstring StringToWide(std::string_view str);
 
 /**
  * Get the directory containing the executable
@@ -54,6 +62,16 @@ std::wstring GetAssetPath(const std::wstring& assetName);
  */
 bool FileExists(const std::wstring& path);
 
+/**
+ * Resident memory of the current process, in bytes
+ */
+struct ProcessMemoryUsage {
+    uint64 currentBytes{0};
+    uint64 peakBytes{0};
+};
+
+ProcessMemoryUsage GetProcessMemoryUsage();
+
 /**
  * String formatting utility
  */
@@ -2,6 +2,7 @@
 #include "Core/Logger.h"
 #include "Core/Exception.h"
 #include <iostream>
+#include <sstream>
 
 using namespace BasicExample;
 using namespace XeSS;
@@ -16,8 +17,24 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 
         XESS_INFO("Starting XeSS Engine Basic Example");
 
+        // Command line: [--benchmark <scenario>] [--output <results.json>] [--headless]
+        Application::ApplicationConfig config;
+        config.title = L"XeSS Engine - Basic Example";
+
+        std::istringstream args(lpCmdLine ? lpCmdLine : "");
+        std::string arg;
+        while (args >> arg) {
+            if (arg == "--benchmark") {
+                args >> config.benchmarkScenario;
+            } else if (arg == "--output") {
+                args >> config.benchmarkOutput;
+            } else if (arg == "--headless") {
+                config.headless = true;
+            }
+        }
+
         // Create and run application
-        BasicExampleApp app;
+        BasicExampleApp app(config);
         int result = app.Run();
 
         XESS_INFO("Application finished with code: {}", result);
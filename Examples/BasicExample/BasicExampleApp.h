@@ -12,6 +12,7 @@ using namespace XeSS;
 class BasicExampleApp : public Application::Application {
 public:
     BasicExampleApp();
+    explicit BasicExampleApp(const XeSS::Application::ApplicationConfig& config);
     ~BasicExampleApp() override;
 
 protected:
@@ -20,6 +21,7 @@ protected:
     void OnUpdate(float deltaTime) override;
     void OnRender() override;
     void OnKeyUp(uint32 key) override;
+    void OnBenchmarkFrame(const XeSS::Application::BenchmarkFrame& frame) override;
 
 private:
     void CreateTriangleGeometry();
@@ -31,6 +33,10 @@ private:
     void RunXeSS();
     void PresentToScreen();
 
+    // OnUpdate advances the animation only when this is false. A benchmark
+    // run positions it from the scenario in OnBenchmarkFrame instead.
+    bool IsAnimationPaused() const { return m_paused || IsBenchmarking(); }
+
     // Vertex structure matching the original sample
     struct Vertex {
         Vector3 position;
@@ -84,7 +90,7 @@ private:
     std::vector<std::pair<float, float>> m_haltonSequence;
     size_t m_haltonIndex{0};
     float m_animationOffset{0.0f};
-    bool m_paused{false};
+    bool m_paused{false};   // User toggle only
 
     // Clear colors
     static constexpr float ClearColor[4] = {0.0f, 0.2f, 0.4f, 1.0f};
@@ -0,0 +1,22 @@
+#include "BasicExampleApp.h"
+
+namespace BasicExample {
+
+BasicExampleApp::BasicExampleApp(const XeSS::Application::ApplicationConfig& config)
+    : Application(config) {
+}
+
+void BasicExampleApp::OnBenchmarkFrame(const XeSS::Application::BenchmarkFrame& frame) {
+    // Drive the animation from the scenario instead of accumulated wall-clock
+    // time; IsAnimationPaused() keeps OnUpdate from advancing it while the
+    // runner is active, without touching the user's pause toggle
+    m_animationOffset = frame.GetObjectPosition("triangle").x;
+
+    // Restart the jitter sequence with each pass so every repetition sees
+    // identical sample positions
+    if (!m_haltonSequence.empty()) {
+        m_haltonIndex = frame.frameIndex % m_haltonSequence.size();
+    }
+}
+
+} // namespace BasicExample
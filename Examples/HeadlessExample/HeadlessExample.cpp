@@ -0,0 +1,210 @@
+#include "Application/HeadlessLoop.h"
+#include "Core/FixedTimestep.h"
+#include "Core/InputQueue.h"
+#include "Core/JobSystem.h"
+#include "Core/Logger.h"
+#include "Core/Utils.h"
+#include "Rendering/FrustumCuller.h"
+#include "Rendering/TransformSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace XeSS;
+using namespace XeSS::Rendering;
+
+// The engine frame loop with no window, GPU or upscaler: input drain,
+// fixed-step simulation, parallel transform propagation and frustum culling
+// of a generated scene, then the null Present. Builds without D3D, so loop
+// performance can be tracked on the Linux build agents; the frame-stats
+// report is logged at the end.
+
+namespace {
+    struct Options {
+        uint64 frames = 1000;
+        uint32 refreshRate = 0;
+        uint32 roots = 1000;
+        uint32 workers = 0;
+    };
+
+    void PrintUsage() {
+        std::printf(
+            "Usage: xess_headless [options]\n"
+            "  --frames <n>     Frames to run (default 1000)\n"
+            "  --refresh <hz>   Simulated vsync rate, 0 for uncapped (default 0)\n"
+            "  --roots <n>      Scene roots, 111 transforms each (default 1000)\n"
+            "  --workers <n>    JobSystem workers, 0 for hardware threads minus one\n");
+    }
+
+    constexpr uint32 ChildrenPerNode = 10;
+    constexpr uint32 ChildLevels = 2;
+    constexpr float32 RootSpacing = 20.0f;
+    constexpr float32 MouseYawPerPixel = 0.005f;
+
+    struct Scene {
+        TransformSystem transforms;
+        std::vector<TransformHandle> roots;
+        CullingBounds bounds;
+        FrustumCuller culler;
+        float32 cameraYaw = 0.0f;
+        float64 time = 0.0;
+    };
+
+    Vector4 RotationY(float32 angle) {
+        return {0.0f, std::sin(angle * 0.5f), 0.0f, std::cos(angle * 0.5f)};
+    }
+
+    Vector3 RootPosition(uint32 index, uint32 rootCount) {
+        uint32 side = static_cast<uint32>(std::ceil(std::sqrt(static_cast<float32>(rootCount))));
+        float32 offset = 0.5f * RootSpacing * static_cast<float32>(side);
+        return {static_cast<float32>(index % side) * RootSpacing - offset, 0.0f,
+                static_cast<float32>(index / side) * RootSpacing - offset};
+    }
+
+    void AddChildren(Scene& scene, TransformHandle parent, uint32 depth) {
+        if (depth == 0) {
+            return;
+        }
+        for (uint32 i = 0; i < ChildrenPerNode; ++i) {
+            float32 angle = 0.6f * static_cast<float32>(i);
+            TransformHandle child = scene.transforms.Create(
+                Transform3x4::FromTranslationRotationScale({1.5f, 0.5f, 0.0f}, RotationY(angle), {0.6f, 0.6f, 0.6f}),
+                parent);
+            scene.transforms.SetLocalBounds(child, {0.0f, 0.0f, 0.0f}, {0.5f, 0.5f, 0.5f});
+            AddChildren(scene, child, depth - 1);
+        }
+    }
+
+    void BuildScene(Scene& scene, uint32 rootCount) {
+        scene.roots.reserve(rootCount);
+        for (uint32 i = 0; i < rootCount; ++i) {
+            TransformHandle root = scene.transforms.Create(Transform3x4::FromTranslation(RootPosition(i, rootCount)));
+            scene.transforms.SetLocalBounds(root, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f});
+            scene.roots.push_back(root);
+            AddChildren(scene, root, ChildLevels);
+        }
+        scene.transforms.Update();
+    }
+
+    // Every root spins about its own y axis, which dirties the whole scene
+    void StepScene(Scene& scene, float64 stepSeconds) {
+        scene.time += stepSeconds;
+        const uint32 rootCount = static_cast<uint32>(scene.roots.size());
+        for (uint32 i = 0; i < rootCount; ++i) {
+            float32 angle = static_cast<float32>(scene.time) + 0.1f * static_cast<float32>(i);
+            scene.transforms.SetLocal(scene.roots[i], Transform3x4::FromTranslationRotationScale(
+                RootPosition(i, rootCount), RotationY(angle), {1.0f, 1.0f, 1.0f}));
+        }
+    }
+
+    // A 90 degree camera at the origin, turned by yaw about y, in the
+    // row-vector convention Frustum::FromViewProjection expects
+    Frustum MakeCameraFrustum(float32 yaw) {
+        const float32 nearZ = 0.1f;
+        const float32 farZ = 1000.0f;
+        const float32 scale = 1.0f / std::tan(0.785398f);
+        const float32 aspect = 16.0f / 9.0f;
+        const float32 range = farZ / (farZ - nearZ);
+        const float32 c = std::cos(yaw);
+        const float32 s = std::sin(yaw);
+
+        // View (rotation by -yaw) times projection, multiplied out
+        const float32 viewProjection[16] = {
+            c * scale / aspect, 0.0f, s * range, s,
+            0.0f, scale, 0.0f, 0.0f,
+            -s * scale / aspect, 0.0f, c * range, c,
+            0.0f, 0.0f, -nearZ * range, 0.0f,
+        };
+        return Frustum::FromViewProjection(viewProjection);
+    }
+
+    Application::NullWindow* s_window = nullptr;
+
+    void OnInterrupt(int) {
+        if (s_window) {
+            s_window->RequestClose();
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--frames" && hasValue) {
+            options.frames = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--refresh" && hasValue) {
+            options.refreshRate = static_cast<uint32>(std::atoi(argv[++i]));
+        } else if (arg == "--roots" && hasValue) {
+            options.roots = static_cast<uint32>(std::atoi(argv[++i]));
+        } else if (arg == "--workers" && hasValue) {
+            options.workers = static_cast<uint32>(std::atoi(argv[++i]));
+        } else {
+            PrintUsage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    Logger::Instance().SetLevel(LogLevel::Info);
+    JobSystem::Instance().Initialize(options.workers);
+
+    Application::HeadlessConfig config;
+    config.refreshRate = options.refreshRate;
+    config.renderSize = {1280, 720};
+    Application::HeadlessLoop loop(config);
+
+    s_window = &loop.GetWindow();
+    std::signal(SIGINT, OnInterrupt);
+
+    Scene scene;
+    BuildScene(scene, options.roots);
+    XESS_INFO("Headless scene: {} transforms, {}, {} Hz simulated refresh", scene.transforms.GetCount(),
+              Utils::WideToString(loop.GetDevice().GetDescription()), options.refreshRate);
+
+    // Scripted camera pan, delivered like OS mouse events
+    InputQueue input;
+    SyntheticInputSource inputSource;
+    for (int32 step = 0; step < 500; ++step) {
+        inputSource.AddMouseMove(std::chrono::milliseconds(4 * step), step * 4, 0);
+    }
+    inputSource.Start(input);
+
+    FixedTimestep timestep;
+    FrameStats stats(static_cast<uint32>(std::min<uint64>(options.frames, 1000000)));
+    uint64 visibleTotal = 0;
+
+    uint64 frames = loop.Run(options.frames, stats, [&](float deltaSeconds) {
+        input.Drain([&](const InputEvent& event) {
+            if (event.type == InputEventType::MouseMove) {
+                scene.cameraYaw = static_cast<float32>(event.x) * MouseYawPerPixel;
+            }
+        });
+
+        timestep.Run(deltaSeconds, [&](float64 stepSeconds, uint64) {
+            StepScene(scene, stepSeconds);
+        });
+
+        scene.transforms.Update();
+        scene.transforms.ExportBounds(scene.bounds);
+        visibleTotal += scene.culler.Cull(MakeCameraFrustum(scene.cameraYaw), scene.bounds);
+
+        loop.PresentFrame();
+        return true;
+    });
+
+    inputSource.Stop();
+    s_window = nullptr;
+
+    stats.LogReport("xess_headless");
+    XESS_INFO("{} frames, {} simulation steps, {} input events, {} visible per frame on average",
+              frames, timestep.GetTotalSteps(), input.GetDrainedEventCount(),
+              frames > 0 ? visibleTotal / frames : 0);
+
+    JobSystem::Instance().Shutdown();
+    return 0;
+}
@@ -11,7 +11,7 @@ Device::~Device() {
     Shutdown();
 }
 
-void Device::Initialize(int32 adapterId, bool useWarp, bool enableDebug) {
+void Device::Initialize(int32 adapterId, bool useWarp, bool enableDebug, bool deferShaderManager) {
     if (m_initialized) {
         XESS_WARNING("Device already initialized");
         return;
@@ -24,7 +24,9 @@ void Device::Initialize(int32 adapterId, bool useWarp, bool enableDebug) {
         SelectAdapter(adapterId, useWarp);
         CreateDevice(enableDebug);
         QueryAdapterInfo();
-        InitializeShaderManager();
+        if (!deferShaderManager) {
+            InitializeShaderManager();
+        }
 
         m_initialized = true;
 
@@ -46,8 +48,9 @@ void Device::Shutdown() {
 
     XESS_INFO("Shutting down DirectX 11 device");
 
-    // Shutdown shader manager first
+    // Shutdown shader manager first; its usage profile seeds the next launch's prefetch
     if (m_shaderManager) {
+        m_shaderManager->SaveUsageProfile();
         m_shaderManager->Shutdown();
         m_shaderManager.reset();
     }
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "Core/Types.h"
-#include "Core/NonCopyable.h"
 #include "Core/Exception.h"
+#include "GraphicsInterfaces.h"
 #include <d3d11.h>
 #include <dxgi1_3.h>
 #include <wrl/client.h>
@@ -28,14 +28,20 @@ struct AdapterInfo {
     bool isSoftware;
 };
 
-class Device : public NonCopyable {
+class Device : public IDevice {
 public:
     Device();
     ~Device();
 
-    void Initialize(int32 adapterId = -1, bool useWarp = false, bool enableDebug = false);
+    // With deferShaderManager the caller runs InitializeShaderManager() itself,
+    // so shader cache loading can overlap other startup work
+    void Initialize(int32 adapterId = -1, bool useWarp = false, bool enableDebug = false,
+                    bool deferShaderManager = false);
     void Shutdown();
 
+    std::wstring GetDescription() const override { return m_adapterInfo.description; }
+    bool IsNull() const override { return false; }
+
     // Getters
     ID3D11Device* GetDevice() const { return m_device.Get(); }
     ID3D11DeviceContext* GetContext() const { return m_context.Get(); }
@@ -51,13 +57,14 @@ public:
 
     // Shader management
     ShaderManager& GetShaderManager();
+    bool HasShaderManager() const { return m_shaderManager != nullptr; }
     const ShaderManager& GetShaderManager() const;
+    void InitializeShaderManager();
 
 private:
     void CreateFactory();
     void SelectAdapter(int32 adapterId, bool useWarp);
     void CreateDevice(bool enableDebug);
-    void InitializeShaderManager();
     void QueryAdapterInfo();
 
     ComPtr<ID3D11Device> m_device;
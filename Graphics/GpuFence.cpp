@@ -0,0 +1,93 @@
+#include "GpuFence.h"
+#include "Device.h"
+#include "Core/Logger.h"
+#include "Core/Exception.h"
+
+namespace XeSS::Graphics {
+
+GpuFenceQueue::GpuFenceQueue() = default;
+
+GpuFenceQueue::~GpuFenceQueue() {
+    Shutdown();
+}
+
+void GpuFenceQueue::Initialize(Device& device) {
+    Shutdown();
+
+    if (!device.GetDevice()) {
+        XESS_DEBUG("GPU fences complete immediately without a D3D device");
+        return;
+    }
+    m_device = device.GetDevice();
+}
+
+void GpuFenceQueue::Shutdown() {
+    // Waiters must not be left suspended forever
+    for (PendingFence& fence : m_pending) {
+        fence.event->Set();
+    }
+    m_pending.clear();
+    m_freeQueries.clear();
+    m_device.Reset();
+}
+
+GpuFence GpuFenceQueue::Signal(ID3D11DeviceContext* context) {
+    auto event = std::make_shared<AsyncEvent>();
+    if (!m_device) {
+        event->Set();
+        return GpuFence(std::move(event));
+    }
+
+    PendingFence fence;
+    if (!m_freeQueries.empty()) {
+        fence.query = std::move(m_freeQueries.back());
+        m_freeQueries.pop_back();
+    } else {
+        D3D11_QUERY_DESC desc{D3D11_QUERY_EVENT, 0};
+        XESS_THROW_IF_FAILED(m_device->CreateQuery(&desc, &fence.query), "Failed to create event query");
+    }
+
+    context->End(fence.query.Get());
+    fence.event = event;
+    m_pending.push_back(std::move(fence));
+    return GpuFence(std::move(event));
+}
+
+uint32 GpuFenceQueue::Poll(ID3D11DeviceContext* context) {
+    uint32 completed = 0;
+    while (TryComplete(context, false)) {
+        ++completed;
+    }
+    return completed;
+}
+
+void GpuFenceQueue::Flush(ID3D11DeviceContext* context) {
+    while (!m_pending.empty()) {
+        TryComplete(context, true);
+    }
+}
+
+bool GpuFenceQueue::TryComplete(ID3D11DeviceContext* context, bool flush) {
+    if (m_pending.empty()) {
+        return false;
+    }
+
+    PendingFence& fence = m_pending.front();
+    BOOL done = FALSE;
+    HRESULT hr = context->GetData(fence.query.Get(), &done, sizeof(done),
+                                  flush ? 0 : D3D11_ASYNC_GETDATA_DONOTFLUSH);
+    if (hr == S_FALSE) {
+        return false;
+    }
+    if (FAILED(hr)) {
+        XESS_WARNING("GPU fence query failed: 0x{:08X}", static_cast<uint32>(hr));
+    }
+
+    // Resumes the waiters as jobs, so this never runs their code here
+    fence.event->Set();
+    m_freeQueries.push_back(std::move(fence.query));
+    m_pending.pop_front();
+    return true;
+}
+
+} // namespace XeSS::Graphics
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include "Core/Task.h"
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace XeSS::Graphics {
+
+using Microsoft::WRL::ComPtr;
+
+class Device;
+
+// A point in the GPU command stream. co_await resumes the coroutine as a job
+// once the GPU has passed it.
+class GpuFence {
+public:
+    bool IsComplete() const { return m_event->IsSet(); }
+    auto operator co_await() const noexcept { return m_event->operator co_await(); }
+
+private:
+    friend class GpuFenceQueue;
+    explicit GpuFence(std::shared_ptr<AsyncEvent> event) : m_event(std::move(event)) {}
+
+    std::shared_ptr<AsyncEvent> m_event;
+};
+
+// Issues GpuFences as D3D11 event queries. Signal() and Poll() run on the
+// thread that owns the immediate context; Poll() never stalls and is meant to
+// be called once per frame. On a null device every fence completes at once.
+class GpuFenceQueue : public NonCopyable {
+public:
+    GpuFenceQueue();
+    ~GpuFenceQueue();
+
+    void Initialize(Device& device);
+
+    // Completes every pending fence, whether or not the GPU reached it
+    void Shutdown();
+
+    GpuFence Signal(ID3D11DeviceContext* context);
+
+    // Completes the fences the GPU has passed; returns how many
+    uint32 Poll(ID3D11DeviceContext* context);
+
+    // Blocks until the GPU passed every pending fence
+    void Flush(ID3D11DeviceContext* context);
+
+    uint32 GetPendingCount() const { return static_cast<uint32>(m_pending.size()); }
+
+private:
+    struct PendingFence {
+        ComPtr<ID3D11Query> query;
+        std::shared_ptr<AsyncEvent> event;
+    };
+
+    bool TryComplete(ID3D11DeviceContext* context, bool flush);
+
+    ComPtr<ID3D11Device> m_device;
+    std::deque<PendingFence> m_pending;          // Submission order; event queries retire in order
+    std::vector<ComPtr<ID3D11Query>> m_freeQueries;
+};
+
+} // namespace XeSS::Graphics
@@ -0,0 +1,144 @@
+#include "GpuTimer.h"
+#include "Device.h"
+#include "Core/Logger.h"
+#include "Core/Exception.h"
+#include <algorithm>
+
+namespace XeSS::Graphics {
+
+GpuTimer::GpuTimer() = default;
+
+GpuTimer::~GpuTimer() {
+    Shutdown();
+}
+
+void GpuTimer::Initialize(Device& device, uint32 framesInFlight) {
+    Shutdown();
+
+    if (!device.GetDevice()) {
+        XESS_DEBUG("GPU timer disabled without a D3D device");
+        return;
+    }
+
+    D3D11_QUERY_DESC disjointDesc{D3D11_QUERY_TIMESTAMP_DISJOINT, 0};
+    D3D11_QUERY_DESC timestampDesc{D3D11_QUERY_TIMESTAMP, 0};
+
+    m_frames.resize(std::max<uint32>(framesInFlight, 2));
+    for (auto& frame : m_frames) {
+        XESS_THROW_IF_FAILED(device.GetDevice()->CreateQuery(&disjointDesc, &frame.disjoint),
+                             "Failed to create disjoint timestamp query");
+        XESS_THROW_IF_FAILED(device.GetDevice()->CreateQuery(&timestampDesc, &frame.begin),
+                             "Failed to create timestamp query");
+        XESS_THROW_IF_FAILED(device.GetDevice()->CreateQuery(&timestampDesc, &frame.end),
+                             "Failed to create timestamp query");
+    }
+}
+
+void GpuTimer::Shutdown() {
+    m_frames.clear();
+    m_writeIndex = 0;
+    m_readIndex = 0;
+    m_pendingCount = 0;
+    m_inFrame = false;
+}
+
+void GpuTimer::BeginFrame(ID3D11DeviceContext* context) {
+    if (!IsEnabled() || m_inFrame) {
+        return;
+    }
+
+    // All query sets busy: skip timing this frame rather than stall
+    if (m_pendingCount == m_frames.size()) {
+        return;
+    }
+
+    FrameQueries& frame = m_frames[m_writeIndex];
+    context->Begin(frame.disjoint.Get());
+    context->End(frame.begin.Get());
+    m_inFrame = true;
+}
+
+void GpuTimer::EndFrame(ID3D11DeviceContext* context) {
+    if (!m_inFrame) {
+        return;
+    }
+
+    FrameQueries& frame = m_frames[m_writeIndex];
+    context->End(frame.end.Get());
+    context->End(frame.disjoint.Get());
+    frame.issued = true;
+
+    m_writeIndex = (m_writeIndex + 1) % static_cast<uint32>(m_frames.size());
+    ++m_pendingCount;
+    m_inFrame = false;
+}
+
+bool GpuTimer::CollectFrame(ID3D11DeviceContext* context, float64& gpuTimeMs) {
+    while (m_pendingCount > 0) {
+        FrameQueries& frame = m_frames[m_readIndex];
+
+        float64 result = 0.0;
+        if (!TryResolve(context, frame, result, false)) {
+            return false;
+        }
+
+        m_readIndex = (m_readIndex + 1) % static_cast<uint32>(m_frames.size());
+        --m_pendingCount;
+
+        // Disjoint frames are dropped, keep looking for a valid one
+        if (result >= 0.0) {
+            gpuTimeMs = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<float64> GpuTimer::Drain(ID3D11DeviceContext* context) {
+    std::vector<float64> timings;
+
+    while (m_pendingCount > 0) {
+        FrameQueries& frame = m_frames[m_readIndex];
+
+        float64 result = 0.0;
+        while (!TryResolve(context, frame, result, true)) {
+        }
+
+        if (result >= 0.0) {
+            timings.push_back(result);
+        }
+
+        m_readIndex = (m_readIndex + 1) % static_cast<uint32>(m_frames.size());
+        --m_pendingCount;
+    }
+
+    return timings;
+}
+
+bool GpuTimer::TryResolve(ID3D11DeviceContext* context, FrameQueries& frame, float64& gpuTimeMs, bool flush) {
+    const UINT flags = flush ? 0 : D3D11_ASYNC_GETDATA_DONOTFLUSH;
+
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint{};
+    if (context->GetData(frame.disjoint.Get(), &disjoint, sizeof(disjoint), flags) != S_OK) {
+        return false;
+    }
+
+    UINT64 begin = 0;
+    UINT64 end = 0;
+    if (context->GetData(frame.begin.Get(), &begin, sizeof(begin), flags) != S_OK ||
+        context->GetData(frame.end.Get(), &end, sizeof(end), flags) != S_OK) {
+        return false;
+    }
+
+    frame.issued = false;
+
+    if (disjoint.Disjoint || disjoint.Frequency == 0) {
+        gpuTimeMs = -1.0;
+    } else {
+        gpuTimeMs = static_cast<float64>(end - begin) * 1000.0 / static_cast<float64>(disjoint.Frequency);
+    }
+    return true;
+}
+
+} // namespace XeSS::Graphics
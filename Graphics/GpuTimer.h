@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <vector>
+
+namespace XeSS::Graphics {
+
+using Microsoft::WRL::ComPtr;
+
+class Device;
+
+// Measures GPU time per frame with D3D11 timestamp queries. Results are read
+// back a few frames later without stalling; a null device disables the timer.
+class GpuTimer : public NonCopyable {
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    void Initialize(Device& device, uint32 framesInFlight = 4);
+    void Shutdown();
+
+    void BeginFrame(ID3D11DeviceContext* context);
+    void EndFrame(ID3D11DeviceContext* context);
+
+    // Non-blocking: returns true for each resolved frame, oldest first
+    bool CollectFrame(ID3D11DeviceContext* context, float64& gpuTimeMs);
+
+    // Blocks until all issued frames are resolved and returns their timings
+    std::vector<float64> Drain(ID3D11DeviceContext* context);
+
+    bool IsEnabled() const { return !m_frames.empty(); }
+
+private:
+    struct FrameQueries {
+        ComPtr<ID3D11Query> disjoint;
+        ComPtr<ID3D11Query> begin;
+        ComPtr<ID3D11Query> end;
+        bool issued = false;
+    };
+
+    bool TryResolve(ID3D11DeviceContext* context, FrameQueries& frame, float64& gpuTimeMs, bool flush);
+
+    std::vector<FrameQueries> m_frames;
+    uint32 m_writeIndex{0};
+    uint32 m_readIndex{0};
+    uint32 m_pendingCount{0};
+    bool m_inFrame{false};
+};
+
+} // namespace XeSS::Graphics
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include <string>
+
+namespace XeSS::Graphics {
+
+// What the frame loop needs from a device and a swap chain. Nothing here
+// names a D3D type, so the null implementations and the headless loop build
+// on every platform. Device and SwapChain are the D3D11 implementations.
+
+class IDevice : public NonCopyable {
+public:
+    virtual ~IDevice() = default;
+
+    virtual std::wstring GetDescription() const = 0;
+
+    // True for NullDevice, which never submits GPU work
+    virtual bool IsNull() const = 0;
+};
+
+class ISwapChain : public NonCopyable {
+public:
+    virtual ~ISwapChain() = default;
+
+    virtual void Present(bool vsync) = 0;
+    virtual void Resize(const Resolution& newResolution) = 0;
+    virtual Resolution GetResolution() const = 0;
+};
+
+} // namespace XeSS::Graphics
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "GraphicsInterfaces.h"
+
+namespace XeSS::Graphics {
+
+// Headless device: owns no GPU objects and never submits work
+class NullDevice : public IDevice {
+public:
+    std::wstring GetDescription() const override { return L"Null Device (headless)"; }
+    bool IsNull() const override { return true; }
+};
+
+} // namespace XeSS::Graphics
@@ -0,0 +1,35 @@
+#include "NullSwapChain.h"
+#include "Core/Logger.h"
+#include <thread>
+
+namespace XeSS::Graphics {
+
+NullSwapChain::NullSwapChain(const Resolution& resolution, uint32 refreshRateHz)
+    : m_resolution(resolution)
+    , m_refreshRateHz(refreshRateHz) {
+    if (refreshRateHz > 0) {
+        m_refreshPeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<float64>(1.0 / refreshRateHz));
+    }
+    m_nextVBlank = std::chrono::steady_clock::now() + m_refreshPeriod;
+
+    XESS_INFO("Null SwapChain {}x{} ({} Hz simulated)", resolution.width, resolution.height, refreshRateHz);
+}
+
+void NullSwapChain::Present(bool) {
+    if (m_refreshPeriod == std::chrono::steady_clock::duration::zero()) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now < m_nextVBlank) {
+        std::this_thread::sleep_until(m_nextVBlank);
+        m_nextVBlank += m_refreshPeriod;
+    } else {
+        // Missed one or more intervals: snap to the next boundary like a real flip would
+        auto missed = (now - m_nextVBlank) / m_refreshPeriod + 1;
+        m_nextVBlank += missed * m_refreshPeriod;
+    }
+}
+
+} // namespace XeSS::Graphics
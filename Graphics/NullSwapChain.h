@@ -0,0 +1,31 @@
+#pragma once
+
+#include "GraphicsInterfaces.h"
+#include <chrono>
+
+namespace XeSS::Graphics {
+
+/**
+ * Headless swap chain. Present() draws nothing and only paces: it waits for
+ * the next simulated vblank of a refreshRateHz display, or returns at once
+ * when refreshRateHz is 0. The vsync argument is ignored; the refresh rate
+ * decides.
+ */
+class NullSwapChain : public ISwapChain {
+public:
+    explicit NullSwapChain(const Resolution& resolution, uint32 refreshRateHz = 0);
+
+    void Present(bool vsync = false) override;
+    void Resize(const Resolution& newResolution) override { m_resolution = newResolution; }
+    Resolution GetResolution() const override { return m_resolution; }
+
+    uint32 GetRefreshRate() const { return m_refreshRateHz; }
+
+private:
+    Resolution m_resolution;
+    uint32 m_refreshRateHz;
+    std::chrono::steady_clock::duration m_refreshPeriod{};
+    std::chrono::steady_clock::time_point m_nextVBlank;
+};
+
+} // namespace XeSS::Graphics
@@ -3,11 +3,10 @@
 #include "ShaderManager.h"
 #include "Core/Logger.h"
 #include "Core/Exception.h"
+#include "Core/FileSystem.h"
 #include <d3d11shader.h>
 #include <d3dcompiler.h>
 #include <filesystem>
-#include <fstream>
-#include <future>
 
 namespace XeSS::Graphics {
 
@@ -55,7 +54,7 @@ void ShaderParameters::Apply(ID3D11DeviceContext* context, const ShaderBinding&
                 if (SUCCEEDED(hr)) {
                     cbData.dirty = false;
                 } else {
-                    XESS_ERROR("Failed to create constant buffer for '{}'", cb.name);
+                    XESS_ERROR_RATE_LIMITED(1, 1, "Failed to create constant buffer for '{}'", cb.name);
                     continue;
                 }
             }
@@ -175,13 +174,20 @@ Shader::Shader(Device& device, ShaderManager& manager)
 }
 
 Shader::~Shader() {
-    if (m_isLoading && m_loadingFuture.valid()) {
-        m_loadingFuture.wait();
-    }
+    // The pipelines capture this; stop them at the next stage and wait them
+    // out. A creation request still queued would only finish a frame later.
+    CancelLoading();
+    m_reloadCancellation.Cancel();
+    m_manager.GetCreationQueue().CompleteCancelled();
+    m_loadingTask.Wait();
+    m_reloadTask.Wait();
 }
 
 bool Shader::LoadFromFile(const std::string& filename, const std::string& entryPoint,
                          ShaderType type, const CompileOptions& options) {
+    // An earlier async load finishing later must not replace this program
+    DiscardAsyncLoad();
+
     m_sourceFile = filename;
     m_entryPoint = entryPoint;
     m_type = type;
@@ -189,20 +195,16 @@ bool Shader::LoadFromFile(const std::string& filename, const std::string& entryP
 
     try {
         // Load source from file
-        std::ifstream file(filename);
-        if (!file.is_open()) {
+        if (!FileSystem::Instance().ReadText(filename, m_sourceCode)) {
             XESS_ERROR("Failed to open shader file: {}", filename);
             return false;
         }
 
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        m_sourceCode = buffer.str();
-
         // Compile shader
-        m_shader = CompileShader(m_sourceCode, entryPoint, type, options, filename);
+        m_manager.RecordShaderUsage(filename, entryPoint, type, options);
+        InstallProgram(CompileShader(m_sourceCode, entryPoint, type, options, filename));
 
-        if (m_shader && m_shader->IsValid()) {
+        if (IsValid()) {
             m_lastFileTime = GetFileTime(filename);
             XESS_INFO("Shader loaded successfully: {}", filename);
             return true;
@@ -220,15 +222,17 @@ bool Shader::LoadFromFile(const std::string& filename, const std::string& entryP
 bool Shader::LoadFromSource(const std::string& source, const std::string& entryPoint,
                            ShaderType type, const CompileOptions& options,
                            const std::string& sourceName) {
+    DiscardAsyncLoad();
+
     m_sourceCode = source;
     m_entryPoint = entryPoint;
     m_type = type;
     m_compileOptions = options;
     m_sourceFile = sourceName; // For debugging
 
-    m_shader = CompileShader(source, entryPoint, type, options, sourceName);
+    InstallProgram(CompileShader(source, entryPoint, type, options, sourceName));
 
-    if (m_shader && m_shader->IsValid()) {
+    if (IsValid()) {
         XESS_INFO("Shader compiled from source successfully");
         return true;
     } else {
@@ -243,69 +247,103 @@ void Shader::LoadFromFileAsync(const std::string& filename, const std::string& e
     m_entryPoint = entryPoint;
     m_type = type;
     m_compileOptions = options;
-    m_isLoading = true;
 
-    m_loadingFuture = std::async(std::launch::async, [this, filename, entryPoint, type, options]() {
-        try {
-            std::ifstream file(filename);
-            if (!file.is_open()) {
-                XESS_ERROR("Failed to open shader file: {}", filename);
-                return std::unique_ptr<CompiledD3DShader>(nullptr);
-            }
+    m_manager.RecordShaderUsage(filename, entryPoint, type, options);
 
-            std::stringstream buffer;
-            buffer << file.rdbuf();
-            std::string source = buffer.str();
+    // A load still in flight is superseded, not waited for
+    CancelLoading();
+    m_loadingCancellation = CancellationSource();
+    m_loadingTask = LoadPipeline(filename, entryPoint, type, options, m_loadingCancellation.GetToken());
+}
 
-            return CompileShader(source, entryPoint, type, options, filename);
-        }
-        catch (const std::exception& e) {
-            XESS_ERROR("Exception in async shader loading {}: {}", filename, e.what());
-            return std::unique_ptr<CompiledD3DShader>(nullptr);
-        }
-    });
+void Shader::CancelLoading() {
+    m_loadingCancellation.Cancel();
 }
 
-void Shader::Bind(ID3D11DeviceContext* context) {
-    if (!IsValid()) {
-        XESS_WARNING("Attempting to bind invalid shader");
+void Shader::DiscardAsyncLoad() {
+    if (!m_loadingTask.IsValid()) {
         return;
     }
 
-    // Update from async loading if needed
+    // Cancelling alone is not enough: a pipeline past its last check still
+    // completes with a valid program, which Bind() would then install
+    CancelLoading();
+    m_manager.GetCreationQueue().CompleteCancelled();
+    m_loadingTask.Wait();
+    m_loadingTask = {};
+}
+
+Task<std::unique_ptr<CompiledD3DShader>> Shader::LoadPipeline(
+    std::string filename, std::string entryPoint, ShaderType type,
+    CompileOptions options, CancellationToken cancellation) {
+
+    FileReadResult file = co_await FileSystem::Instance().ReadTask(filename);
+    if (!file.success) {
+        XESS_ERROR("Failed to open shader file: {} ({})", filename, file.error);
+        co_return nullptr;
+    }
+    cancellation.ThrowIfCancelled();
+
+    // Compile here on the worker; the D3D objects come from the creation
+    // queue, which spreads driver work over frames instead of one spike
+    auto shader = std::make_unique<CompiledD3DShader>();
+    shader->compilationResult = m_manager.GetCompiler().CompileFromSource(
+        file.GetText(), entryPoint, type, options, filename);
+    if (!shader->IsValid()) {
+        co_return shader;
+    }
+    ExtractShaderReflection(*shader);
+    cancellation.ThrowIfCancelled();
+
+    bool created = co_await m_manager.GetCreationQueue().Create(
+        *shader, type, ShaderCreationPriority::Visible, cancellation);
+    cancellation.ThrowIfCancelled();
+    if (!created) {
+        shader->compilationResult.success = false;
+    }
+    co_return shader;
+}
+
+void Shader::Bind(ID3D11DeviceContext* context) {
+    // Pick up a finished async load first, so the first Bind() after it sees the shader
     UpdateFromAsyncLoad();
 
-    if (!m_shader || !m_shader->IsValid()) {
+    // One load per Bind, so a swap on another thread cannot mix two programs
+    const CompiledD3DShader* program = GetProgram();
+    if (!program || !program->IsValid()) {
+        if (!IsLoading()) {
+            XESS_WARNING_RATE_LIMITED(1, 1, "Attempting to bind invalid shader");
+        }
         return;
     }
 
     // Bind the appropriate shader type
     switch (m_type) {
         case ShaderType::Vertex:
-            context->VSSetShader(m_shader->vertexShader.Get(), nullptr, 0);
-            if (m_shader->inputLayoutD3D) {
-                context->IASetInputLayout(m_shader->inputLayoutD3D.Get());
+            context->VSSetShader(program->vertexShader.Get(), nullptr, 0);
+            if (program->inputLayoutD3D) {
+                context->IASetInputLayout(program->inputLayoutD3D.Get());
             }
             break;
         case ShaderType::Hull:
-            context->HSSetShader(m_shader->hullShader.Get(), nullptr, 0);
+            context->HSSetShader(program->hullShader.Get(), nullptr, 0);
             break;
         case ShaderType::Domain:
-            context->DSSetShader(m_shader->domainShader.Get(), nullptr, 0);
+            context->DSSetShader(program->domainShader.Get(), nullptr, 0);
             break;
         case ShaderType::Geometry:
-            context->GSSetShader(m_shader->geometryShader.Get(), nullptr, 0);
+            context->GSSetShader(program->geometryShader.Get(), nullptr, 0);
             break;
         case ShaderType::Pixel:
-            context->PSSetShader(m_shader->pixelShader.Get(), nullptr, 0);
+            context->PSSetShader(program->pixelShader.Get(), nullptr, 0);
             break;
         case ShaderType::Compute:
-            context->CSSetShader(m_shader->computeShader.Get(), nullptr, 0);
+            context->CSSetShader(program->computeShader.Get(), nullptr, 0);
             break;
     }
 
     // Apply parameters
-    m_parameters.Apply(context, m_shader->binding, m_type);
+    m_parameters.Apply(context, program->binding, m_type);
 }
 
 void Shader::Unbind(ID3D11DeviceContext* context) {
@@ -337,74 +375,169 @@ ShaderModel Shader::GetShaderModel() const {
 
 const std::vector<std::string>& Shader::GetErrors() const {
     static const std::vector<std::string> empty;
-    return m_shader ? m_shader->compilationResult.errors : empty;
+    const CompiledD3DShader* program = GetProgram();
+    return program ? program->compilationResult.errors : empty;
 }
 
 const std::vector<std::string>& Shader::GetWarnings() const {
     static const std::vector<std::string> empty;
-    return m_shader ? m_shader->compilationResult.warnings : empty;
+    const CompiledD3DShader* program = GetProgram();
+    return program ? program->compilationResult.warnings : empty;
 }
 
 const ShaderBinding& Shader::GetBinding() const {
     static const ShaderBinding empty;
-    return m_shader ? m_shader->binding : empty;
+    const CompiledD3DShader* program = GetProgram();
+    return program ? program->binding : empty;
 }
 
 void Shader::CheckForReload() {
+    switch (UpdateReload()) {
+        case ReloadState::Ready:
+            PublishReload();
+            break;
+        case ReloadState::Failed:
+            DiscardReload();
+            break;
+        default:
+            break;
+    }
+}
+
+Shader::ReloadState Shader::UpdateReload() {
+    // Called at a frame boundary, so no reader still holds a retired program
+    ReleaseRetiredPrograms(true);
+
     if (!m_hotReloadEnabled || m_sourceFile.empty()) {
-        return;
+        return ReloadState::None;
     }
 
+    if (m_reloadTask.IsValid()) {
+        if (!m_reloadTask.IsReady()) {
+            return ReloadState::Running;
+        }
+
+        Task<std::unique_ptr<CompiledD3DShader>> task = std::move(m_reloadTask);
+        try {
+            std::unique_ptr<CompiledD3DShader> program = std::move(task).Get();
+            if (program && program->IsValid()) {
+                m_reloadedProgram = std::move(program);
+            } else {
+                // The live program stays; the errors would otherwise be lost with the result
+                m_reloadFailed = true;
+                XESS_ERROR("Shader hot reload failed, keeping the previous program: {}", m_sourceFile);
+                if (program) {
+                    for (const std::string& error : program->compilationResult.errors) {
+                        XESS_ERROR("  {}", error);
+                    }
+                }
+            }
+        }
+        catch (const TaskCancelledException&) {
+        }
+        catch (const std::exception& e) {
+            m_reloadFailed = true;
+            XESS_ERROR("Exception in shader hot reload {}: {}", m_sourceFile, e.what());
+        }
+    }
+
+    // A newer save supersedes whatever the last reload produced
     uint64 currentFileTime = GetFileTime(m_sourceFile);
     if (currentFileTime > m_lastFileTime) {
         XESS_INFO("Hot reloading shader: {}", m_sourceFile);
+        m_lastFileTime = currentFileTime;
+        m_reloadedProgram.reset();
+        m_reloadFailed = false;
+        m_reloadCancellation = CancellationSource();
+        m_reloadTask = LoadPipeline(m_sourceFile, m_entryPoint, m_type, m_compileOptions,
+                                    m_reloadCancellation.GetToken());
+        return ReloadState::Running;
+    }
 
-        if (LoadFromFile(m_sourceFile, m_entryPoint, m_type, m_compileOptions)) {
-            XESS_INFO("Shader hot reload successful: {}", m_sourceFile);
-        } else {
-            XESS_ERROR("Shader hot reload failed: {}", m_sourceFile);
-        }
+    if (m_reloadedProgram) {
+        return ReloadState::Ready;
+    }
+    return m_reloadFailed ? ReloadState::Failed : ReloadState::None;
+}
+
+void Shader::PublishReload() {
+    if (m_reloadedProgram) {
+        InstallProgram(std::move(m_reloadedProgram));
+        XESS_INFO("Shader hot reload successful: {}", m_sourceFile);
+    }
+}
+
+void Shader::DiscardReload() {
+    m_reloadedProgram.reset();
+    m_reloadFailed = false;
+}
+
+void Shader::InstallProgram(std::unique_ptr<CompiledD3DShader> program) {
+    ReleaseRetiredPrograms(false);
+
+    // The shadow slot holds the program from the previous swap, which may
+    // have happened this frame, so a reader could still be using it. Retire
+    // it rather than destroy it, then fill the slot and make it live.
+    uint32 version = m_programVersion.load(std::memory_order_relaxed);
+    std::unique_ptr<CompiledD3DShader>& shadow = m_programs[(version + 1) & 1];
+    if (shadow) {
+        m_retiredPrograms.push_back({std::move(shadow), m_manager.GetUsageProfile().GetFrame()});
     }
+    shadow = std::move(program);
+    m_programVersion.store(version + 1, std::memory_order_release);
+}
+
+void Shader::ReleaseRetiredPrograms(bool frameBoundary) {
+    uint64 frame = m_manager.GetUsageProfile().GetFrame();
+    std::erase_if(m_retiredPrograms, [&](const RetiredProgram& retired) {
+        return frameBoundary || retired.frame < frame;
+    });
 }
 
 const std::vector<D3D11_INPUT_ELEMENT_DESC>& Shader::GetInputLayout() const {
     static const std::vector<D3D11_INPUT_ELEMENT_DESC> empty;
-    return m_shader ? m_shader->binding.inputLayout : empty;
+    const CompiledD3DShader* program = GetProgram();
+    return program ? program->binding.inputLayout : empty;
 }
 
 bool Shader::HasConstantBuffer(const std::string& name) const {
-    if (!m_shader) return false;
+    const CompiledD3DShader* program = GetProgram();
+    if (!program) return false;
 
-    for (const auto& cb : m_shader->binding.constantBuffers) {
+    for (const auto& cb : program->binding.constantBuffers) {
         if (cb.name == name) return true;
     }
     return false;
 }
 
 bool Shader::HasTexture(const std::string& name) const {
-    if (!m_shader) return false;
+    const CompiledD3DShader* program = GetProgram();
+    if (!program) return false;
 
-    for (const auto& tex : m_shader->binding.textures) {
+    for (const auto& tex : program->binding.textures) {
         if (tex.name == name) return true;
     }
     return false;
 }
 
 bool Shader::HasSampler(const std::string& name) const {
-    if (!m_shader) return false;
+    const CompiledD3DShader* program = GetProgram();
+    if (!program) return false;
 
-    for (const auto& samp : m_shader->binding.samplers) {
+    for (const auto& samp : program->binding.samplers) {
         if (samp.name == name) return true;
     }
     return false;
 }
 
 uint32 Shader::GetBytecodeSize() const {
-    return m_shader ? static_cast<uint32>(m_shader->compilationResult.bytecode.size()) : 0;
+    const CompiledD3DShader* program = GetProgram();
+    return program ? static_cast<uint32>(program->compilationResult.bytecode.size()) : 0;
 }
 
 std::string Shader::GetDisassembly() const {
-    return m_shader ? m_shader->compilationResult.disassembly : "";
+    const CompiledD3DShader* program = GetProgram();
+    return program ? program->compilationResult.disassembly : "";
 }
 
 std::unique_ptr<CompiledD3DShader> Shader::CompileShader(
@@ -423,34 +556,8 @@ void Shader::CreateD3DShaderObjects(CompiledD3DShader& shader) {
         return;
     }
 
-    const void* bytecode = shader.compilationResult.bytecode.data();
-    size_t bytecodeSize = shader.compilationResult.bytecode.size();
-
-    HRESULT hr = S_OK;
-
-    switch (m_type) {
-        case ShaderType::Vertex:
-            hr = m_device.GetDevice()->CreateVertexShader(bytecode, bytecodeSize, nullptr, &shader.vertexShader);
-            break;
-        case ShaderType::Hull:
-            hr = m_device.GetDevice()->CreateHullShader(bytecode, bytecodeSize, nullptr, &shader.hullShader);
-            break;
-        case ShaderType::Domain:
-            hr = m_device.GetDevice()->CreateDomainShader(bytecode, bytecodeSize, nullptr, &shader.domainShader);
-            break;
-        case ShaderType::Geometry:
-            hr = m_device.GetDevice()->CreateGeometryShader(bytecode, bytecodeSize, nullptr, &shader.geometryShader);
-            break;
-        case ShaderType::Pixel:
-            hr = m_device.GetDevice()->CreatePixelShader(bytecode, bytecodeSize, nullptr, &shader.pixelShader);
-            break;
-        case ShaderType::Compute:
-            hr = m_device.GetDevice()->CreateComputeShader(bytecode, bytecodeSize, nullptr, &shader.computeShader);
-            break;
-    }
-
-    if (FAILED(hr)) {
-        XESS_ERROR("Failed to create D3D11 shader object: 0x{:08X}", hr);
+    // Permutations with identical bytecode share one driver object
+    if (!m_manager.GetCreationQueue().CreateNow(shader, m_type)) {
         shader.compilationResult.success = false;
     }
 }
@@ -472,26 +579,27 @@ void Shader::ExtractShaderReflection(CompiledD3DShader& shader) {
 }
 
 bool Shader::UpdateFromAsyncLoad() {
-    if (!m_isLoading) {
+    if (!m_loadingTask.IsReady()) {
         return false;
     }
 
-    if (m_loadingFuture.valid() &&
-        m_loadingFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-
-        m_shader = m_loadingFuture.get();
-        m_isLoading = false;
-
-        if (m_shader && m_shader->IsValid()) {
+    Task<std::unique_ptr<CompiledD3DShader>> task = std::move(m_loadingTask);
+    try {
+        std::unique_ptr<CompiledD3DShader> shader = std::move(task).Get();
+        if (shader && shader->IsValid()) {
+            InstallProgram(std::move(shader));
             m_lastFileTime = GetFileTime(m_sourceFile);
             XESS_INFO("Async shader loading completed: {}", m_sourceFile);
             return true;
-        } else {
-            XESS_ERROR("Async shader loading failed: {}", m_sourceFile);
-            return false;
         }
+        XESS_ERROR("Async shader loading failed: {}", m_sourceFile);
+    }
+    catch (const TaskCancelledException&) {
+        XESS_DEBUG("Async shader loading cancelled: {}", m_sourceFile);
+    }
+    catch (const std::exception& e) {
+        XESS_ERROR("Exception in async shader loading {}: {}", m_sourceFile, e.what());
     }
-
     return false;
 }
 
@@ -586,12 +694,38 @@ void ShaderEffect::EnableHotReload(bool enable) {
 }
 
 void ShaderEffect::CheckForReload() {
-    if (m_vertexShader) m_vertexShader->CheckForReload();
-    if (m_hullShader) m_hullShader->CheckForReload();
-    if (m_domainShader) m_domainShader->CheckForReload();
-    if (m_geometryShader) m_geometryShader->CheckForReload();
-    if (m_pixelShader) m_pixelShader->CheckForReload();
-    if (m_computeShader) m_computeShader->CheckForReload();
+    std::array<Shader*, 6> stages = GetStages();
+
+    bool running = false;
+    bool ready = false;
+    bool failed = false;
+    for (Shader* stage : stages) {
+        switch (stage ? stage->UpdateReload() : Shader::ReloadState::None) {
+            case Shader::ReloadState::Running: running = true; break;
+            case Shader::ReloadState::Ready: ready = true; break;
+            case Shader::ReloadState::Failed: failed = true; break;
+            default: break;
+        }
+    }
+
+    // Swap only once every reloading stage finished, and all of them or none,
+    // so a frame never binds a new vertex stage with an old pixel stage
+    if (running || (!ready && !failed)) {
+        return;
+    }
+    if (failed) {
+        XESS_ERROR("Effect hot reload failed, keeping the previous programs of all stages");
+    }
+    for (Shader* stage : stages) {
+        if (stage) {
+            failed ? stage->DiscardReload() : stage->PublishReload();
+        }
+    }
+}
+
+std::array<Shader*, 6> ShaderEffect::GetStages() const {
+    return {m_vertexShader.get(), m_hullShader.get(), m_domainShader.get(),
+            m_geometryShader.get(), m_pixelShader.get(), m_computeShader.get()};
 }
 
 void ShaderEffect::ApplyGlobalParameters() {
@@ -2,9 +2,13 @@
 
 #include "Core/Types.h"
 #include "Core/NonCopyable.h"
+#include "Core/Task.h"
 #include "ShaderCompiler/ShaderCompiler.h"
+#include "ShaderObjectTable.h"
 #include <d3d11.h>
 #include <wrl/client.h>
+#include <array>
+#include <atomic>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -40,7 +44,9 @@ struct CompiledD3DShader {
     CompiledShader compilationResult;
     ShaderBinding binding;
 
-    // D3D11 objects
+    // D3D11 objects; the shader object is interned, sharedObject keeps it
+    // registered while this shader uses it
+    std::shared_ptr<const InternedShaderObject> sharedObject;
     ComPtr<ID3D11VertexShader> vertexShader;
     ComPtr<ID3D11HullShader> hullShader;
     ComPtr<ID3D11DomainShader> domainShader;
@@ -68,6 +74,9 @@ public:
     // Clear all parameters
     void Clear();
 
+    // Device used to create constant buffers; Shader sets its own
+    void SetDevice(Device* device) { m_device = device; }
+
 private:
     struct ConstantBufferData {
         std::vector<uint8> data;
@@ -103,7 +112,14 @@ public:
     // Async loading
     void LoadFromFileAsync(const std::string& filename, const std::string& entryPoint,
                           ShaderType type, const CompileOptions& options = {});
-    bool IsLoadingComplete() const { return !m_isLoading; }
+    bool IsLoadingComplete() const { return !m_loadingTask.IsValid(); }
+    void CancelLoading();
+
+    // Read and compile as one coroutine; LoadFromFileAsync runs it and Bind()
+    // picks up the result. Can also be awaited directly or combined with WhenAll.
+    Task<std::unique_ptr<CompiledD3DShader>> LoadPipeline(
+        std::string filename, std::string entryPoint, ShaderType type,
+        CompileOptions options, CancellationToken cancellation = {});
 
     // Bind shader to pipeline
     void Bind(ID3D11DeviceContext* context);
@@ -128,8 +144,11 @@ public:
     }
 
     // State queries
-    bool IsValid() const { return m_shader && m_shader->IsValid(); }
-    bool IsLoading() const { return m_isLoading; }
+    bool IsValid() const {
+        const CompiledD3DShader* program = GetProgram();
+        return program && program->IsValid();
+    }
+    bool IsLoading() const { return m_loadingTask.IsValid(); }
     ShaderType GetType() const { return m_type; }
     ShaderModel GetShaderModel() const;
 
@@ -138,11 +157,29 @@ public:
     const std::vector<std::string>& GetWarnings() const;
     const ShaderBinding& GetBinding() const;
 
-    // Hot reload support
+    // Live program, read without locks. A pointer loaded here stays valid
+    // until a frame boundary (ShaderManager::BeginFrame or UpdateReload) has
+    // passed since it was replaced, however many swaps happen in between.
+    const CompiledD3DShader* GetProgram() const {
+        return m_programs[m_programVersion.load(std::memory_order_acquire) & 1].get();
+    }
+    // Bumped on every swap; render code can key cached state on it
+    uint32 GetProgramVersion() const { return m_programVersion.load(std::memory_order_acquire); }
+
+    // Hot reload: a changed file is recompiled in the background and the
+    // result swapped in by a later call once it compiled and created. Call
+    // once per frame, at a frame boundary; it never blocks on compilation.
+    enum class ReloadState { None, Running, Ready, Failed };
+
     void EnableHotReload(bool enable) { m_hotReloadEnabled = enable; }
     bool IsHotReloadEnabled() const { return m_hotReloadEnabled; }
     void CheckForReload();
 
+    // The steps of CheckForReload, for callers that swap several shaders together
+    ReloadState UpdateReload();     // Starts a reload if the file changed, collects a finished one
+    void PublishReload();           // Makes a Ready reload live
+    void DiscardReload();           // Drops a Ready or Failed reload and keeps the live program
+
     // Reflection data
     const std::vector<D3D11_INPUT_ELEMENT_DESC>& GetInputLayout() const;
     bool HasConstantBuffer(const std::string& name) const;
@@ -158,7 +195,18 @@ private:
     ShaderManager& m_manager;
     ShaderType m_type = ShaderType::Vertex;
 
-    std::unique_ptr<CompiledD3DShader> m_shader;
+    // Live program and shadow slot; the low bit of the version picks the
+    // live one. A swap fills the shadow, then bumps the version.
+    std::unique_ptr<CompiledD3DShader> m_programs[2];
+    std::atomic<uint32> m_programVersion{0};
+
+    // Programs pushed out of the shadow slot, kept until a frame boundary
+    // passed since, as a reader may still hold them
+    struct RetiredProgram {
+        std::unique_ptr<CompiledD3DShader> program;
+        uint64 frame;
+    };
+    std::vector<RetiredProgram> m_retiredPrograms;
     ShaderParameters m_parameters;
 
     // Source tracking for hot reload
@@ -169,9 +217,15 @@ private:
     uint64 m_lastFileTime = 0;
     bool m_hotReloadEnabled = false;
 
-    // Async loading
-    bool m_isLoading = false;
-    std::future<std::unique_ptr<CompiledD3DShader>> m_loadingFuture;
+    // Async loading; the task is reset once Bind() took its result
+    Task<std::unique_ptr<CompiledD3DShader>> m_loadingTask;
+    CancellationSource m_loadingCancellation;
+
+    // Hot reload in flight, or finished and waiting for a swap
+    Task<std::unique_ptr<CompiledD3DShader>> m_reloadTask;
+    CancellationSource m_reloadCancellation;
+    std::unique_ptr<CompiledD3DShader> m_reloadedProgram;
+    bool m_reloadFailed = false;
 
     // Helper methods
     std::unique_ptr<CompiledD3DShader> CompileShader(
@@ -181,7 +235,12 @@ private:
 
     void CreateD3DShaderObjects(CompiledD3DShader& shader);
     void ExtractShaderReflection(CompiledD3DShader& shader);
+    void InstallProgram(std::unique_ptr<CompiledD3DShader> program);
+    // All of them at a frame boundary, otherwise those retired before this frame
+    void ReleaseRetiredPrograms(bool frameBoundary);
     bool UpdateFromAsyncLoad();
+    // Cancels an async load, waits it out and drops it unapplied
+    void DiscardAsyncLoad();
     uint64 GetFileTime(const std::string& filename) const;
 };
 
@@ -225,7 +284,8 @@ public:
     bool IsValid() const;
     bool IsLoading() const;
 
-    // Hot reload
+    // Hot reload; stages reloaded together are swapped in the same call, and
+    // only if all of them compiled, so stages never mix old and new code
     void EnableHotReload(bool enable);
     void CheckForReload();
 
@@ -233,6 +293,8 @@ private:
     Device& m_device;
     ShaderManager& m_manager;
 
+    std::array<Shader*, 6> GetStages() const;
+
     std::shared_ptr<Shader> m_vertexShader;
     std::shared_ptr<Shader> m_hullShader;
     std::shared_ptr<Shader> m_domainShader;
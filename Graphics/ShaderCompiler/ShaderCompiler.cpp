@@ -2,6 +2,9 @@
 #include "Core/Logger.h"
 #include "Core/Exception.h"
 #include "Core/Utils.h"
+#include "Core/MappedFile.h"
+#include "Core/FileSystem.h"
+#include "Core/Lz.h"
 #include <fstream>
 #include <filesystem>
 #include <sstream>
@@ -14,55 +17,167 @@
 namespace XeSS::Graphics {
 
 namespace {
-    constexpr uint32 CACHE_VERSION = 1;
+    constexpr uint32 CACHE_VERSION = 2;
     constexpr char CACHE_MAGIC[] = "XESS";
 
+    // A block is LZ compressed unless storedSize equals size
+    struct CacheBlock {
+        uint32 size;
+        uint32 storedSize;
+    };
+
+    // Shader files hold bytecode and reflection; debug files only the PDB
     struct CacheHeader {
         char magic[4];
         uint32 version;
         uint64 hash;
-        uint32 size;
+        CacheBlock blocks[2];
     };
-}
 
-// ShaderCache Implementation
-bool ShaderCache::GetCachedShader(const std::string& filename, uint64 hash, std::vector<uint8>& bytecode) {
-    // Check memory cache first
-    auto it = m_memoryCache.find(filename);
-    if (it != m_memoryCache.end() && it->second.hash == hash) {
-        bytecode = it->second.bytecode;
-        return true;
+    CacheBlock AppendBlock(std::vector<uint8>& file, const std::vector<uint8>& data) {
+        CacheBlock block{static_cast<uint32>(data.size()), static_cast<uint32>(data.size())};
+        size_t offset = file.size();
+        file.resize(offset + Lz::CompressBound(data.size()));
+
+        size_t compressed = Lz::Compress(data.data(), data.size(), file.data() + offset, file.size() - offset);
+        if (compressed > 0 && compressed < data.size()) {
+            block.storedSize = static_cast<uint32>(compressed);
+        } else if (!data.empty()) {
+            memcpy(file.data() + offset, data.data(), data.size());
+        }
+        file.resize(offset + block.storedSize);
+        return block;
     }
 
-    // Check disk cache
-    std::string cachePath = GetCacheFilePath(filename, hash);
-    if (!std::filesystem::exists(cachePath)) {
-        return false;
+    std::vector<uint8> BuildCacheFile(uint64 hash, const std::vector<uint8>& first, const std::vector<uint8>& second) {
+        CacheHeader header;
+        memcpy(header.magic, CACHE_MAGIC, 4);
+        header.version = CACHE_VERSION;
+        header.hash = hash;
+
+        std::vector<uint8> file(sizeof(header));
+        header.blocks[0] = AppendBlock(file, first);
+        header.blocks[1] = AppendBlock(file, second);
+        memcpy(file.data(), &header, sizeof(header));
+        return file;
     }
 
-    try {
-        std::ifstream file(cachePath, std::ios::binary);
-        if (!file.is_open()) {
+    // Decompresses the block at offset straight into out
+    bool ReadBlock(const std::vector<uint8>& file, size_t& offset, const CacheBlock& block, std::vector<uint8>* out) {
+        if (block.storedSize > block.size || block.storedSize > file.size() - offset) {
             return false;
         }
+        const uint8* stored = file.data() + offset;
+        offset += block.storedSize;
+        if (!out) {
+            return true;
+        }
 
-        CacheHeader header;
-        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        out->resize(block.size);
+        if (block.storedSize == block.size) {
+            if (block.size > 0) {
+                memcpy(out->data(), stored, block.size);
+            }
+            return true;
+        }
+        return Lz::Decompress(stored, block.storedSize, out->data(), block.size);
+    }
 
+    bool ReadCacheFile(const std::vector<uint8>& file, uint64 hash, std::vector<uint8>* first, std::vector<uint8>* second) {
+        if (file.size() < sizeof(CacheHeader)) {
+            return false;
+        }
+
+        CacheHeader header;
+        memcpy(&header, file.data(), sizeof(header));
         if (memcmp(header.magic, CACHE_MAGIC, 4) != 0 ||
             header.version != CACHE_VERSION ||
             header.hash != hash) {
             return false;
         }
 
-        bytecode.resize(header.size);
-        file.read(reinterpret_cast<char*>(bytecode.data()), header.size);
+        size_t offset = sizeof(header);
+        return ReadBlock(file, offset, header.blocks[0], first) &&
+               ReadBlock(file, offset, header.blocks[1], second);
+    }
 
-        // Update memory cache
+    bool WriteCacheFile(const std::string& path, const std::vector<uint8>& file) {
+        std::ofstream stream(path, std::ios::binary);
+        if (!stream.is_open()) {
+            XESS_WARNING("Failed to create cache file: {}", path);
+            return false;
+        }
+        stream.write(reinterpret_cast<const char*>(file.data()), file.size());
+        return stream.good();
+    }
+
+    // DXIL program kinds, as DXC defines __SHADER_TARGET_STAGE
+    int32 GetDxilStage(ShaderType type) {
+        switch (type) {
+            case ShaderType::Pixel: return 0;
+            case ShaderType::Vertex: return 1;
+            case ShaderType::Geometry: return 2;
+            case ShaderType::Hull: return 3;
+            case ShaderType::Domain: return 4;
+            case ShaderType::Compute: return 5;
+            case ShaderType::Mesh: return 13;
+            case ShaderType::Amplification: return 14;
+            default: return -1;
+        }
+    }
+
+    uint64 CombineHash(uint64 hash, uint64 value) {
+        return hash ^ (value + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+    }
+}
+
+// ShaderCache Implementation
+bool ShaderCache::GetCachedShader(const std::string& filename, uint64 hash, std::vector<uint8>& bytecode,
+                                  std::vector<uint8>* reflectionData) {
+    // Check memory cache first; only the lookup holds the lock, so hits on
+    // other threads don't queue behind this one's decompression
+    std::shared_ptr<const std::vector<uint8>> image;
+    {
+        std::lock_guard<std::mutex> lock(m_memoryCacheMutex);
+        auto it = m_memoryCache.find(filename);
+        if (it != m_memoryCache.end() && it->second.hash == hash) {
+            image = it->second.data;
+        }
+    }
+    if (image) {
+        if (ReadCacheFile(*image, hash, &bytecode, reflectionData)) {
+            return true;
+        }
+
+        // A bad image must not fail the compile: drop it, unless another
+        // thread replaced it meanwhile, and try the disk cache, then a recompile
+        XESS_WARNING("Corrupt memory cache entry for shader {}, evicting it", filename);
+        std::lock_guard<std::mutex> lock(m_memoryCacheMutex);
+        auto it = m_memoryCache.find(filename);
+        if (it != m_memoryCache.end() && it->second.data == image) {
+            m_memoryCache.erase(it);
+        }
+    }
+
+    // Check disk cache
+    std::string cachePath = GetCacheFilePath(filename, hash);
+    if (!std::filesystem::exists(cachePath)) {
+        return false;
+    }
+
+    try {
+        std::vector<uint8> data;
+        if (!FileSystem::Instance().ReadFile(cachePath, data) ||
+            !ReadCacheFile(data, hash, &bytecode, reflectionData)) {
+            return false;
+        }
+
+        // Update memory cache; it keeps the compressed image
         CacheEntry entry;
-        entry.bytecode = bytecode;
+        entry.data = std::make_shared<const std::vector<uint8>>(std::move(data));
         entry.hash = hash;
         entry.timestamp = std::filesystem::last_write_time(cachePath).time_since_epoch().count();
+        std::lock_guard<std::mutex> lock(m_memoryCacheMutex);
         m_memoryCache[filename] = std::move(entry);
 
         return true;
@@ -73,44 +188,53 @@ bool ShaderCache::GetCachedShader(const std::string& filename, uint64 hash, std:
     }
 }
 
-void ShaderCache::CacheShader(const std::string& filename, uint64 hash, const std::vector<uint8>& bytecode) {
+bool ShaderCache::CacheShader(const std::string& filename, uint64 hash, const std::vector<uint8>& bytecode,
+                              const std::vector<uint8>& reflectionData, const std::vector<uint8>& debugData) {
     try {
         // Create cache directory if it doesn't exist
         std::filesystem::create_directories(m_cacheDirectory);
 
-        std::string cachePath = GetCacheFilePath(filename, hash);
-        std::ofstream file(cachePath, std::ios::binary);
-        if (!file.is_open()) {
-            XESS_WARNING("Failed to create cache file: {}", cachePath);
-            return;
+        std::vector<uint8> data = BuildCacheFile(hash, bytecode, reflectionData);
+        if (!WriteCacheFile(GetCacheFilePath(filename, hash), data)) {
+            return false;
+        }
+        if (!debugData.empty() && !WriteCacheFile(GetDebugFilePath(filename, hash), BuildCacheFile(hash, debugData, {}))) {
+            return false;
         }
 
-        CacheHeader header;
-        memcpy(header.magic, CACHE_MAGIC, 4);
-        header.version = CACHE_VERSION;
-        header.hash = hash;
-        header.size = static_cast<uint32>(bytecode.size());
-
-        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
-        file.write(reinterpret_cast<const char*>(bytecode.data()), bytecode.size());
+        XESS_DEBUG("Cached shader: {} ({} bytes stored for {})", filename, data.size() - sizeof(CacheHeader),
+                   bytecode.size() + reflectionData.size());
 
         // Update memory cache
         CacheEntry entry;
-        entry.bytecode = bytecode;
+        entry.data = std::make_shared<const std::vector<uint8>>(std::move(data));
         entry.hash = hash;
         entry.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count();
+        std::lock_guard<std::mutex> lock(m_memoryCacheMutex);
         m_memoryCache[filename] = std::move(entry);
 
-        XESS_DEBUG("Cached shader: {}", filename);
+        return true;
     }
     catch (const std::exception& e) {
         XESS_WARNING("Failed to cache shader {}: {}", filename, e.what());
+        return false;
     }
 }
 
+bool ShaderCache::GetDebugData(const std::string& filename, uint64 hash, std::vector<uint8>& debugData) const {
+    std::vector<uint8> data;
+    if (!FileSystem::Instance().ReadFile(GetDebugFilePath(filename, hash), data)) {
+        return false;
+    }
+    return ReadCacheFile(data, hash, &debugData, nullptr);
+}
+
 void ShaderCache::ClearCache() {
-    m_memoryCache.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_memoryCacheMutex);
+        m_memoryCache.clear();
+    }
 
     try {
         if (std::filesystem::exists(m_cacheDirectory)) {
@@ -136,6 +260,13 @@ std::string ShaderCache::GetCacheFilePath(const std::string& filename, uint64 ha
     return ss.str();
 }
 
+std::string ShaderCache::GetDebugFilePath(const std::string& filename, uint64 hash) const {
+    std::stringstream ss;
+    ss << m_cacheDirectory << std::filesystem::path(filename).stem().string()
+       << "_" << std::hex << hash << ".dbg";
+    return ss.str();
+}
+
 uint64 ShaderCache::CalculateFileHash(const std::string& filename) const {
     // Simple hash based on filename and file size/modification time
     std::hash<std::string> hasher;
@@ -217,31 +348,52 @@ CompiledShader ShaderCompiler::CompileFromFile(
     ShaderType type,
     const CompileOptions& options) {
 
-    std::string source = LoadShaderSource(filename);
-    if (source.empty()) {
+    MappedFile file;
+    if (!file.Open(filename) || file.GetSize() == 0) {
         CompiledShader result;
         result.errors.push_back("Failed to load shader file: " + filename);
         return result;
     }
 
-    return CompileFromSource(source, entryPoint, type, options, filename);
+    return CompileFromSource(file.GetText(), entryPoint, type, options, filename);
 }
 
 CompiledShader ShaderCompiler::CompileFromSource(
-    const std::string& source,
+    std::string_view source,
     const std::string& entryPoint,
     ShaderType type,
     const CompileOptions& options,
     const std::string& sourceName) {
 
+    // Expand includes and macros first: the cache key is taken from the result
+    PreprocessResult preprocessed;
+    bool usePreprocessed = false;
+    if (options.preprocess) {
+        preprocessed = Preprocess(source, type, options, sourceName);
+        if (!preprocessed.success) {
+            CompiledShader result;
+            result.errors = std::move(preprocessed.errors);
+            return result;
+        }
+        if (preprocessed.requiresBackendPreprocessor) {
+            XESS_DEBUG("Shader {} tests compiler-defined macros, using the backend preprocessor", sourceName);
+        } else {
+            usePreprocessed = true;
+        }
+    }
+    std::string_view backendSource = usePreprocessed ? std::string_view(preprocessed.output) : source;
+
+    uint64 hash = options.preprocess
+        ? CalculatePreprocessedHash(source, preprocessed, options)
+        : CalculateSourceHash(std::hash<std::string_view>{}(source), options);
+
     // Check cache if enabled
     if (m_cacheEnabled && !sourceName.empty()) {
-        uint64 hash = CalculateSourceHash(source, options);
-        std::vector<uint8> cachedBytecode;
-        if (m_cache.GetCachedShader(sourceName, hash, cachedBytecode)) {
+        CompiledShader result;
+        if (m_cache.GetCachedShader(sourceName, hash, result.bytecode, &result.reflectionData)) {
             XESS_DEBUG("Using cached shader: {}", sourceName);
-            CompiledShader result;
-            result.bytecode = std::move(cachedBytecode);
+            result.dependencies = std::move(preprocessed.dependencies);
+            result.cacheHash = hash;
             result.success = true;
             ExtractReflectionData(result.bytecode, result);
             return result;
@@ -252,47 +404,51 @@ CompiledShader ShaderCompiler::CompileFromSource(
 
     // Use legacy compiler for SM 5.x or if DXC is not available
     if (m_useLegacyCompiler || options.targetModel <= ShaderModel::SM_5_1) {
-        result = CompileWithLegacyCompiler(source, entryPoint, type, options, sourceName);
+        result = CompileWithLegacyCompiler(backendSource, entryPoint, type, options, sourceName, usePreprocessed);
     }
     else {
         // Use DXC for SM 6.0+
         try {
-            std::wstring wSource = Utils::StringToWide(source);
             std::wstring wEntryPoint = Utils::StringToWide(entryPoint);
             std::wstring wSourceName = sourceName.empty() ? L"" : Utils::StringToWide(sourceName);
             std::wstring targetProfile = GetTargetProfile(type, options.targetModel);
 
-            // Create source blob
-            IDxcBlobEncoding* sourceBlob = nullptr;
-            HRESULT hr = m_dxcUtils->CreateBlob(wSource.c_str(),
-                static_cast<UINT32>(wSource.length() * sizeof(wchar_t)),
-                CP_UTF8, &sourceBlob);
-
-            if (FAILED(hr)) {
-                result.errors.push_back("Failed to create source blob");
-                return result;
-            }
-
-            // Build arguments
+            // Build arguments; the source name labels diagnostics and anchors relative includes
             std::vector<LPCWSTR> arguments = BuildCompilerArguments(options);
+            if (!wSourceName.empty()) {
+                arguments.push_back(wSourceName.c_str());
+            }
             arguments.push_back(L"-E");
             arguments.push_back(wEntryPoint.c_str());
             arguments.push_back(L"-T");
             arguments.push_back(targetProfile.c_str());
 
-            // Compile
+            // Raw source goes through DXC's own preprocessor, which needs the macros and paths
+            std::vector<std::wstring> backendArguments;
+            if (!usePreprocessed) {
+                for (const auto& macro : options.macros) {
+                    backendArguments.push_back(L"-D" + Utils::StringToWide(macro.name) +
+                        (macro.definition.empty() ? L"" : L"=" + Utils::StringToWide(macro.definition)));
+                }
+                for (const auto& includePath : options.includePaths) {
+                    backendArguments.push_back(L"-I" + Utils::StringToWide(includePath));
+                }
+                for (const auto& argument : backendArguments) {
+                    arguments.push_back(argument.c_str());
+                }
+            }
+
+            // DXC reads the UTF-8 source where it lies; no blob or wide copy
             DxcBuffer sourceBuffer;
-            sourceBuffer.Ptr = sourceBlob->GetBufferPointer();
-            sourceBuffer.Size = sourceBlob->GetBufferSize();
-            sourceBuffer.Encoding = DXC_CP_ACP;
+            sourceBuffer.Ptr = backendSource.data();
+            sourceBuffer.Size = backendSource.size();
+            sourceBuffer.Encoding = DXC_CP_UTF8;
 
             IDxcResult* compileResult = nullptr;
-            hr = m_dxcCompiler->Compile(&sourceBuffer, arguments.data(),
+            HRESULT hr = m_dxcCompiler->Compile(&sourceBuffer, arguments.data(),
                 static_cast<UINT32>(arguments.size()), m_includeHandler,
                 IID_PPV_ARGS(&compileResult));
 
-            sourceBlob->Release();
-
             if (SUCCEEDED(hr)) {
                 // Get compilation status
                 HRESULT compileStatus;
@@ -309,6 +465,25 @@ CompiledShader ShaderCompiler::CompileFromSource(
                         result.success = true;
                         bytecodeBlob->Release();
                     }
+
+                    // Stripped parts come back as separate outputs
+                    if (options.stripDebugData) {
+                        IDxcBlob* reflectionBlob = nullptr;
+                        if (SUCCEEDED(compileResult->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(&reflectionBlob), nullptr)) &&
+                            reflectionBlob) {
+                            const uint8* data = static_cast<const uint8*>(reflectionBlob->GetBufferPointer());
+                            result.reflectionData.assign(data, data + reflectionBlob->GetBufferSize());
+                            reflectionBlob->Release();
+                        }
+
+                        IDxcBlob* pdbBlob = nullptr;
+                        if (options.enableDebugInfo &&
+                            SUCCEEDED(compileResult->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(&pdbBlob), nullptr)) && pdbBlob) {
+                            const uint8* data = static_cast<const uint8*>(pdbBlob->GetBufferPointer());
+                            result.debugData.assign(data, data + pdbBlob->GetBufferSize());
+                            pdbBlob->Release();
+                        }
+                    }
                 }
 
                 // Get errors/warnings
@@ -335,20 +510,35 @@ CompiledShader ShaderCompiler::CompileFromSource(
         }
     }
 
+    result.dependencies = std::move(preprocessed.dependencies);
+
     // Extract reflection data if compilation succeeded
     if (result.success) {
         ExtractReflectionData(result.bytecode, result);
 
-        // Cache the result
-        if (m_cacheEnabled && !sourceName.empty()) {
-            uint64 hash = CalculateSourceHash(source, options);
-            m_cache.CacheShader(sourceName, hash, result.bytecode);
+        // Cache the result; once the PDB is on disk it is only read back on request
+        result.cacheHash = hash;
+        if (m_cacheEnabled && !sourceName.empty() &&
+            m_cache.CacheShader(sourceName, hash, result.bytecode, result.reflectionData, result.debugData)) {
+            result.debugData.clear();
+            result.debugData.shrink_to_fit();
         }
     }
 
     return result;
 }
 
+bool ShaderCompiler::LoadDebugData(const std::string& sourceName, CompiledShader& shader) {
+    if (!shader.debugData.empty()) {
+        return true;
+    }
+    if (!shader.success || sourceName.empty() || !m_cache.GetDebugData(sourceName, shader.cacheHash, shader.debugData)) {
+        XESS_WARNING("No debug data cached for shader {}", sourceName);
+        return false;
+    }
+    return true;
+}
+
 void ShaderCompiler::CheckForShaderChanges() {
     if (!m_hotReloadEnabled) {
         return;
@@ -413,7 +603,10 @@ std::vector<LPCWSTR> ShaderCompiler::BuildCompilerArguments(const CompileOptions
 
     if (options.enableDebugInfo) {
         args.push_back(L"-Zi");
-        args.push_back(L"-Qembed_debug");
+        args.push_back(options.stripDebugData ? L"-Qstrip_debug" : L"-Qembed_debug");
+    }
+    if (options.stripDebugData) {
+        args.push_back(L"-Qstrip_reflect");
     }
 
     if (options.enableOptimization) {
@@ -442,44 +635,75 @@ std::vector<LPCWSTR> ShaderCompiler::BuildCompilerArguments(const CompileOptions
     return args;
 }
 
-std::string ShaderCompiler::LoadShaderSource(const std::string& filename) const {
-    try {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            XESS_ERROR("Failed to open shader file: {}", filename);
-            return "";
-        }
-
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        return buffer.str();
-    }
-    catch (const std::exception& e) {
-        XESS_ERROR("Exception loading shader file {}: {}", filename, e.what());
-        return "";
-    }
-}
-
-uint64 ShaderCompiler::CalculateSourceHash(const std::string& source, const CompileOptions& options) const {
+uint64 ShaderCompiler::CalculateSourceHash(uint64 sourceHash, const CompileOptions& options) const {
     std::hash<std::string> hasher;
-    uint64 hash = hasher(source);
+    uint64 hash = sourceHash;
 
     // Include options in hash
-    hash ^= static_cast<uint64>(options.targetModel) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-    hash ^= (options.enableDebugInfo ? 1 : 0) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-    hash ^= (options.enableOptimization ? 1 : 0) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-    hash ^= options.optimizationLevel + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash = CombineHash(hash, static_cast<uint64>(options.targetModel));
+    hash = CombineHash(hash, options.enableDebugInfo ? 1 : 0);
+    hash = CombineHash(hash, options.stripDebugData ? 1 : 0);
+    hash = CombineHash(hash, options.enableOptimization ? 1 : 0);
+    hash = CombineHash(hash, options.optimizationLevel);
 
     // Include macros
     for (const auto& macro : options.macros) {
-        hash ^= hasher(macro.name + "=" + macro.definition) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash = CombineHash(hash, hasher(macro.name + "=" + macro.definition));
     }
 
     return hash;
 }
 
+PreprocessResult ShaderCompiler::Preprocess(std::string_view source, ShaderType type,
+                                            const CompileOptions& options, const std::string& sourceName) const {
+    PreprocessOptions preprocessOptions;
+    preprocessOptions.includePaths = options.includePaths;
+
+    // What the backend would predefine; FXC always compiles the 5_0 profiles
+    bool legacy = m_useLegacyCompiler || options.targetModel <= ShaderModel::SM_5_1;
+    uint32 model = legacy ? 0x50 : static_cast<uint32>(options.targetModel);
+    preprocessOptions.macros.push_back({"__SHADER_TARGET_MAJOR", std::to_string(model >> 4)});
+    preprocessOptions.macros.push_back({"__SHADER_TARGET_MINOR", std::to_string(model & 0xF)});
+    if (!legacy && GetDxilStage(type) >= 0) {
+        static const std::pair<const char*, int32> stages[] = {
+            {"__SHADER_STAGE_PIXEL", 0}, {"__SHADER_STAGE_VERTEX", 1}, {"__SHADER_STAGE_GEOMETRY", 2},
+            {"__SHADER_STAGE_HULL", 3}, {"__SHADER_STAGE_DOMAIN", 4}, {"__SHADER_STAGE_COMPUTE", 5},
+            {"__SHADER_STAGE_MESH", 13}, {"__SHADER_STAGE_AMPLIFICATION", 14}
+        };
+        for (const auto& [name, stage] : stages) {
+            preprocessOptions.macros.push_back({name, std::to_string(stage)});
+        }
+        preprocessOptions.macros.push_back({"__SHADER_TARGET_STAGE", std::to_string(GetDxilStage(type))});
+    }
+    preprocessOptions.macros.insert(preprocessOptions.macros.end(), options.macros.begin(), options.macros.end());
+
+    return m_preprocessor.Preprocess(source, sourceName, preprocessOptions);
+}
+
+uint64 ShaderCompiler::CalculatePreprocessedHash(std::string_view source, const PreprocessResult& preprocessed,
+                                                 const CompileOptions& options) const {
+    uint64 sourceHash;
+    if (preprocessed.requiresBackendPreprocessor) {
+        // The backend expands the raw text, so key on it and on every include it reads
+        sourceHash = std::hash<std::string_view>{}(source);
+        for (const std::string& dependency : preprocessed.dependencies) {
+            if (auto file = IncludeCache::Shared().Load(dependency)) {
+                sourceHash = CombineHash(sourceHash, std::hash<std::string>{}(file->content));
+            }
+        }
+    } else if (options.enableDebugInfo) {
+        // Debug info records lines, so layout changes must recompile
+        sourceHash = std::hash<std::string>{}(preprocessed.output);
+    } else {
+        sourceHash = preprocessed.tokenHash;
+    }
+
+    return CalculateSourceHash(sourceHash, options);
+}
+
 void ShaderCompiler::ExtractReflectionData(const std::vector<uint8>& bytecode, CompiledShader& shader) const {
-    // This would implement shader reflection to extract binding information
+    // This would implement shader reflection to extract binding information,
+    // from shader.reflectionData when DXC stripped it out of the bytecode.
     // For now, just clear the reflection data
     shader.inputLayout.clear();
     shader.constantBufferBindings.clear();
@@ -489,11 +713,12 @@ void ShaderCompiler::ExtractReflectionData(const std::vector<uint8>& bytecode, C
 }
 
 CompiledShader ShaderCompiler::CompileWithLegacyCompiler(
-    const std::string& source,
+    std::string_view source,
     const std::string& entryPoint,
     ShaderType type,
     const CompileOptions& options,
-    const std::string& sourceName) const {
+    const std::string& sourceName,
+    bool preprocessed) const {
 
     CompiledShader result;
 
@@ -526,13 +751,15 @@ CompiledShader ShaderCompiler::CompileWithLegacyCompiler(
         flags |= D3DCOMPILE_IEEE_STRICTNESS;
     }
 
-    // Build defines
+    // Build defines; preprocessed source has them applied already
     std::vector<D3D_SHADER_MACRO> defines;
-    for (const auto& macro : options.macros) {
-        D3D_SHADER_MACRO define;
-        define.Name = macro.name.c_str();
-        define.Definition = macro.definition.c_str();
-        defines.push_back(define);
+    if (!preprocessed) {
+        for (const auto& macro : options.macros) {
+            D3D_SHADER_MACRO define;
+            define.Name = macro.name.c_str();
+            define.Definition = macro.definition.c_str();
+            defines.push_back(define);
+        }
     }
     D3D_SHADER_MACRO nullDefine = { nullptr, nullptr };
     defines.push_back(nullDefine);
@@ -542,8 +769,8 @@ CompiledShader ShaderCompiler::CompileWithLegacyCompiler(
     ID3DBlob* errorBlob = nullptr;
 
     HRESULT hr = D3DCompile(
-        source.c_str(),
-        source.length(),
+        source.data(),
+        source.size(),
         sourceName.empty() ? nullptr : sourceName.c_str(),
         defines.data(),
         D3D_COMPILE_STANDARD_FILE_INCLUDE,
@@ -554,6 +781,24 @@ CompiledShader ShaderCompiler::CompileWithLegacyCompiler(
         &bytecodeBlob,
         &errorBlob);
 
+    if (SUCCEEDED(hr) && bytecodeBlob && options.enableDebugInfo && options.stripDebugData) {
+        // Move the PDB out of the container; RDEF stays, D3D11 reflection reads it
+        ID3DBlob* pdbBlob = nullptr;
+        if (SUCCEEDED(D3DGetBlobPart(bytecodeBlob->GetBufferPointer(), bytecodeBlob->GetBufferSize(),
+                                     D3D_BLOB_PDB, 0, &pdbBlob))) {
+            const uint8* data = static_cast<const uint8*>(pdbBlob->GetBufferPointer());
+            result.debugData.assign(data, data + pdbBlob->GetBufferSize());
+            pdbBlob->Release();
+        }
+
+        ID3DBlob* strippedBlob = nullptr;
+        if (SUCCEEDED(D3DStripShader(bytecodeBlob->GetBufferPointer(), bytecodeBlob->GetBufferSize(),
+                                     D3DCOMPILER_STRIP_DEBUG_INFO | D3DCOMPILER_STRIP_TEST_BLOBS, &strippedBlob))) {
+            bytecodeBlob->Release();
+            bytecodeBlob = strippedBlob;
+        }
+    }
+
     if (SUCCEEDED(hr) && bytecodeBlob) {
         result.bytecode.resize(bytecodeBlob->GetBufferSize());
         memcpy(result.bytecode.data(), bytecodeBlob->GetBufferPointer(), bytecodeBlob->GetBufferSize());
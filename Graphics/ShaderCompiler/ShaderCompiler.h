@@ -2,10 +2,13 @@
 
 #include "Core/Types.h"
 #include "Core/NonCopyable.h"
+#include "ShaderPreprocessor.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <d3d11.h>
 #include <d3dcompiler.h>
 
@@ -40,21 +43,22 @@ enum class ShaderType : uint32 {
     AnyHit          // SM 6.5+ (DXR)
 };
 
-struct ShaderMacro {
-    std::string name;
-    std::string definition;
-};
-
 struct CompileOptions {
     ShaderModel targetModel = ShaderModel::SM_6_4;
     std::vector<ShaderMacro> macros;
     std::vector<std::string> includePaths;
     bool enableDebugInfo = false;
+    bool stripDebugData = true;     // PDB and reflection are cached apart from the runtime bytecode
     bool enableOptimization = true;
     bool warningsAsErrors = false;
     bool ieee754Compliance = false;
     bool enableUnboundedResourceArrays = false;  // SM 6.6+
     uint32 optimizationLevel = 3; // 0-3
+
+    // Run the in-tree preprocessor and hand the backend the expanded source.
+    // Cache keys then follow the token stream, so comment and formatting
+    // edits still hit the cache.
+    bool preprocess = true;
 };
 
 struct CompiledShader {
@@ -62,6 +66,10 @@ struct CompiledShader {
     std::string disassembly;
     std::vector<std::string> errors;
     std::vector<std::string> warnings;
+    std::vector<std::string> dependencies;  // Included files, when preprocessed in-tree
+    std::vector<uint8> reflectionData;      // Reflection blob stripped from the bytecode
+    std::vector<uint8> debugData;           // PDB; stays on disk until ShaderCompiler::LoadDebugData()
+    uint64 cacheHash = 0;
     bool success = false;
 
     // Reflection data
@@ -72,24 +80,37 @@ struct CompiledShader {
     std::unordered_map<std::string, uint32> uavBindings;
 };
 
+/**
+ * Compiled shader cache. Entries are LZ compressed on disk and stay
+ * compressed in memory; bytecode is decompressed straight into the caller's
+ * buffer on a hit. Debug data lives in a side file read only on request.
+ * Safe to use from several compile jobs at once.
+ */
 class ShaderCache {
 public:
     struct CacheEntry {
-        std::vector<uint8> bytecode;
+        // The cache file image, header included. Shared so a hit can copy
+        // the pointer under the lock and decompress after releasing it.
+        std::shared_ptr<const std::vector<uint8>> data;
         uint64 hash;
         uint64 timestamp;
     };
 
-    bool GetCachedShader(const std::string& filename, uint64 hash, std::vector<uint8>& bytecode);
-    void CacheShader(const std::string& filename, uint64 hash, const std::vector<uint8>& bytecode);
+    bool GetCachedShader(const std::string& filename, uint64 hash, std::vector<uint8>& bytecode,
+                         std::vector<uint8>* reflectionData = nullptr);
+    bool CacheShader(const std::string& filename, uint64 hash, const std::vector<uint8>& bytecode,
+                     const std::vector<uint8>& reflectionData = {}, const std::vector<uint8>& debugData = {});
+    bool GetDebugData(const std::string& filename, uint64 hash, std::vector<uint8>& debugData) const;
     void ClearCache();
     void SetCacheDirectory(const std::string& directory);
 
 private:
     std::string m_cacheDirectory = "cache/shaders/";
+    std::mutex m_memoryCacheMutex;
     std::unordered_map<std::string, CacheEntry> m_memoryCache;
 
     std::string GetCacheFilePath(const std::string& filename, uint64 hash) const;
+    std::string GetDebugFilePath(const std::string& filename, uint64 hash) const;
     uint64 CalculateFileHash(const std::string& filename) const;
 };
 
@@ -102,21 +123,24 @@ public:
     bool Initialize();
     void Shutdown();
 
-    // Compile from file
+    // Compile from file; the file is memory mapped, not read into a string
     CompiledShader CompileFromFile(
         const std::string& filename,
         const std::string& entryPoint,
         ShaderType type,
         const CompileOptions& options = {});
 
-    // Compile from source string
+    // Compile from UTF-8 source; the text is passed to the compiler in place
     CompiledShader CompileFromSource(
-        const std::string& source,
+        std::string_view source,
         const std::string& entryPoint,
         ShaderType type,
         const CompileOptions& options = {},
         const std::string& sourceName = "");
 
+    // Fills shader.debugData from the cache when it was stripped at compile time
+    bool LoadDebugData(const std::string& sourceName, CompiledShader& shader);
+
     // Hot reload support
     void EnableHotReload(bool enable) { m_hotReloadEnabled = enable; }
     bool IsHotReloadEnabled() const { return m_hotReloadEnabled; }
@@ -154,19 +178,26 @@ private:
     // Helper methods
     std::wstring GetTargetProfile(ShaderType type, ShaderModel model) const;
     std::vector<LPCWSTR> BuildCompilerArguments(const CompileOptions& options) const;
-    std::string LoadShaderSource(const std::string& filename) const;
-    uint64 CalculateSourceHash(const std::string& source, const CompileOptions& options) const;
+    uint64 CalculateSourceHash(uint64 sourceHash, const CompileOptions& options) const;
+
+    // Preprocessing
+    ShaderPreprocessor m_preprocessor;
+    PreprocessResult Preprocess(std::string_view source, ShaderType type,
+                                const CompileOptions& options, const std::string& sourceName) const;
+    uint64 CalculatePreprocessedHash(std::string_view source, const PreprocessResult& preprocessed,
+                                     const CompileOptions& options) const;
 
     // Reflection
     void ExtractReflectionData(const std::vector<uint8>& bytecode, CompiledShader& shader) const;
 
     // Legacy compiler fallback
     CompiledShader CompileWithLegacyCompiler(
-        const std::string& source,
+        std::string_view source,
         const std::string& entryPoint,
         ShaderType type,
         const CompileOptions& options,
-        const std::string& sourceName) const;
+        const std::string& sourceName,
+        bool preprocessed) const;
 };
 
 // Utility functions
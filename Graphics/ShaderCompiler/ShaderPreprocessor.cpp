@@ -0,0 +1,1277 @@
+#include "ShaderPreprocessor.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <unordered_set>
+
+namespace XeSS::Graphics {
+
+namespace {
+    constexpr uint32 MaxIncludeDepth = 64;
+    constexpr uint32 MaxLinePadding = 8;
+
+    constexpr uint64 FnvOffset = 1469598103934665603ull;
+    constexpr uint64 FnvPrime = 1099511628211ull;
+
+    enum class TokenKind : uint8 {
+        Identifier,
+        Number,
+        String,         // String and character literals
+        Punctuator,
+        Other
+    };
+
+    struct Token {
+        TokenKind kind{TokenKind::Other};
+        std::string_view text;
+        uint32 line{0};
+        bool leadingSpace{false};
+        std::vector<uint32> hideSet;    // Macros that must not expand this token again (sorted ids)
+
+        bool Is(std::string_view value) const {
+            return kind == TokenKind::Punctuator && text == value;
+        }
+    };
+
+    using TokenList = std::vector<Token>;
+
+    bool IsIdentifierStart(char c) {
+        return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    bool IsIdentifierChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    /**
+     * Splits text into logical lines of tokens. Backslash-newline splices are
+     * removed up front; comments become whitespace. Line numbers refer to
+     * the physical lines of the original text.
+     */
+    class Lexer {
+    public:
+        Lexer(std::string_view text, std::deque<std::string>& arena) {
+            // Splices are rare, so only text that has them gets copied
+            size_t splice = text.find("\\\n");
+            size_t spliceCrlf = text.find("\\\r\n");
+            if (splice == std::string_view::npos && spliceCrlf == std::string_view::npos) {
+                m_text = text;
+                return;
+            }
+
+            std::string& spliced = arena.emplace_back();
+            spliced.reserve(text.size());
+            for (size_t i = 0; i < text.size(); ++i) {
+                if (text[i] == '\\') {
+                    size_t next = i + 1;
+                    if (next < text.size() && text[next] == '\r') {
+                        ++next;
+                    }
+                    if (next < text.size() && text[next] == '\n') {
+                        m_splices.push_back(spliced.size());
+                        i = next;
+                        continue;
+                    }
+                }
+                spliced += text[i];
+            }
+            m_text = spliced;
+        }
+
+        // Tokens of the next logical line; false once the text is exhausted
+        bool NextLine(TokenList& tokens) {
+            tokens.clear();
+            if (m_pos >= m_text.size()) {
+                return false;
+            }
+
+            bool space = false;
+            while (m_pos < m_text.size()) {
+                char c = m_text[m_pos];
+
+                if (c == '\n') {
+                    Advance(1);
+                    ++m_line;
+                    break;
+                }
+                if (c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f') {
+                    Advance(1);
+                    space = true;
+                    continue;
+                }
+                if (c == '/' && Peek(1) == '/') {
+                    while (m_pos < m_text.size() && m_text[m_pos] != '\n') {
+                        Advance(1);
+                    }
+                    space = true;
+                    continue;
+                }
+                if (c == '/' && Peek(1) == '*') {
+                    Advance(2);
+                    while (m_pos < m_text.size() && !(m_text[m_pos] == '*' && Peek(1) == '/')) {
+                        if (m_text[m_pos] == '\n') {
+                            ++m_line;
+                        }
+                        Advance(1);
+                    }
+                    Advance(m_pos < m_text.size() ? 2 : 0);
+                    space = true;
+                    continue;
+                }
+
+                Token token;
+                token.line = CurrentLine();
+                token.leadingSpace = space;
+                size_t start = m_pos;
+                token.kind = Scan();
+                token.text = m_text.substr(start, m_pos - start);
+                tokens.push_back(std::move(token));
+                space = false;
+            }
+            return true;
+        }
+
+        // Kind of a complete token spelling (results of ## pasting)
+        static TokenKind Classify(std::string_view text) {
+            if (text.empty()) {
+                return TokenKind::Other;
+            }
+            if (IsIdentifierStart(text[0])) {
+                return TokenKind::Identifier;
+            }
+            if (std::isdigit(static_cast<unsigned char>(text[0]))) {
+                return TokenKind::Number;
+            }
+            if (text[0] == '"' || text[0] == '\'') {
+                return TokenKind::String;
+            }
+            return TokenKind::Punctuator;
+        }
+
+    private:
+        char Peek(size_t offset) const {
+            return m_pos + offset < m_text.size() ? m_text[m_pos + offset] : '\0';
+        }
+
+        void Advance(size_t count) {
+            m_pos = std::min(m_pos + count, m_text.size());
+        }
+
+        uint32 CurrentLine() {
+            // Every splice before this point hid one physical newline
+            while (m_spliceIndex < m_splices.size() && m_splices[m_spliceIndex] <= m_pos) {
+                ++m_spliceIndex;
+                ++m_line;
+            }
+            return m_line;
+        }
+
+        TokenKind Scan() {
+            char c = m_text[m_pos];
+
+            if (IsIdentifierStart(c)) {
+                while (m_pos < m_text.size() && IsIdentifierChar(m_text[m_pos])) {
+                    Advance(1);
+                }
+                return TokenKind::Identifier;
+            }
+
+            if (std::isdigit(static_cast<unsigned char>(c)) ||
+                (c == '.' && std::isdigit(static_cast<unsigned char>(Peek(1))))) {
+                // pp-number: digits, letters, '.', and exponent signs
+                Advance(1);
+                while (m_pos < m_text.size()) {
+                    char n = m_text[m_pos];
+                    if ((n == '+' || n == '-') && std::strchr("eEpP", m_text[m_pos - 1])) {
+                        Advance(1);
+                    } else if (IsIdentifierChar(n) || n == '.') {
+                        Advance(1);
+                    } else {
+                        break;
+                    }
+                }
+                return TokenKind::Number;
+            }
+
+            if (c == '"' || c == '\'') {
+                Advance(1);
+                while (m_pos < m_text.size() && m_text[m_pos] != c && m_text[m_pos] != '\n') {
+                    Advance(m_text[m_pos] == '\\' ? 2 : 1);
+                }
+                if (m_pos < m_text.size() && m_text[m_pos] == c) {
+                    Advance(1);
+                    return TokenKind::String;
+                }
+                return TokenKind::Other;    // Unterminated; tolerated in skipped blocks
+            }
+
+            static constexpr std::string_view punctuators[] = {
+                "<<=", ">>=", "...", "##", "<<", ">>", "<=", ">=", "==", "!=", "&&", "||",
+                "++", "--", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "->", "::"
+            };
+            if (std::strchr("<>.#=!&|+-*/%^:", c)) {
+                for (std::string_view p : punctuators) {
+                    if (p[0] == c && m_text.substr(m_pos, p.size()) == p) {
+                        Advance(p.size());
+                        return TokenKind::Punctuator;
+                    }
+                }
+            }
+
+            Advance(1);
+            return std::ispunct(static_cast<unsigned char>(c)) ? TokenKind::Punctuator : TokenKind::Other;
+        }
+
+        std::string_view m_text;
+        size_t m_pos{0};
+        uint32 m_line{1};
+        std::vector<size_t> m_splices;
+        size_t m_spliceIndex{0};
+    };
+
+    bool IsDirective(const TokenList& line) {
+        return !line.empty() && line[0].Is("#");
+    }
+
+    std::string_view DirectiveName(const TokenList& line) {
+        return line.size() > 1 && line[1].kind == TokenKind::Identifier ? line[1].text : std::string_view{};
+    }
+
+    // Whole-file "#ifndef X / #define X ... #endif" with nothing outside it
+    std::string DetectIncludeGuard(std::string_view content) {
+        std::deque<std::string> arena;
+        Lexer lexer(content, arena);
+        TokenList line;
+
+        auto nextNonEmpty = [&]() {
+            while (lexer.NextLine(line)) {
+                if (!line.empty()) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        if (!nextNonEmpty() || DirectiveName(line) != "ifndef" || line.size() != 3) {
+            return {};
+        }
+        std::string guard(line[2].text);
+
+        if (!nextNonEmpty() || DirectiveName(line) != "define" || line.size() < 3 || line[2].text != guard) {
+            return {};
+        }
+
+        uint32 depth = 1;
+        while (nextNonEmpty()) {
+            if (depth == 0) {
+                return {};  // Code after the guard's #endif
+            }
+            std::string_view name = DirectiveName(line);
+            if (!IsDirective(line)) {
+                continue;
+            }
+            if (name == "if" || name == "ifdef" || name == "ifndef") {
+                ++depth;
+            } else if (name == "endif") {
+                --depth;
+            } else if (depth == 1 && (name == "else" || name == "elif")) {
+                return {};
+            }
+        }
+        return depth == 0 ? guard : std::string{};
+    }
+
+    bool HasPragmaOnce(std::string_view content) {
+        std::deque<std::string> arena;
+        Lexer lexer(content, arena);
+        TokenList line;
+        while (lexer.NextLine(line)) {
+            if (DirectiveName(line) == "pragma" && line.size() > 2 && line[2].text == "once") {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void AddToHideSet(std::vector<uint32>& hideSet, uint32 id) {
+        auto it = std::lower_bound(hideSet.begin(), hideSet.end(), id);
+        if (it == hideSet.end() || *it != id) {
+            hideSet.insert(it, id);
+        }
+    }
+
+    std::vector<uint32> IntersectHideSets(const std::vector<uint32>& a, const std::vector<uint32>& b) {
+        std::vector<uint32> result;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        return result;
+    }
+
+    std::vector<uint32> UnionHideSets(const std::vector<uint32>& a, const std::vector<uint32>& b) {
+        std::vector<uint32> result;
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        return result;
+    }
+
+    // Macros only DXC/FXC define; testing them needs the backend's preprocessor
+    bool IsBackendBuiltin(std::string_view name) {
+        return name == "__HLSL_VERSION" || name == "__spirv__" || name == "__hlsl_dx_compiler" ||
+               name.substr(0, 13) == "__DXC_VERSION";
+    }
+
+    struct Macro {
+        uint32 id{0};
+        bool functionLike{false};
+        bool variadic{false};
+        std::vector<std::string_view> params;
+        TokenList body;
+
+        enum class Builtin : uint8 { None, Line, File } builtin{Builtin::None};
+
+        int32 FindParam(std::string_view name) const {
+            for (size_t i = 0; i < params.size(); ++i) {
+                if (params[i] == name) {
+                    return static_cast<int32>(i);
+                }
+            }
+            return -1;
+        }
+    };
+
+    struct Conditional {
+        bool active;        // Lines of the current group are processed
+        bool taken;         // Some group of this #if has been selected
+        bool parentActive;
+        bool sawElse;
+    };
+
+    // Thrown inside a run, turned into a "file(line): message" error
+    struct PreprocessError {
+        explicit PreprocessError(std::string text) : message(std::move(text)) {}
+
+        std::string message;
+        std::string location;   // Filled in by the innermost file being processed
+    };
+
+    /**
+     * State of one Preprocess() call
+     */
+    class Context {
+    public:
+        Context(IncludeCache& cache, const PreprocessOptions& options, PreprocessResult& result)
+            : m_cache(cache), m_options(options), m_result(result) {
+            DefineBuiltin("__LINE__", Macro::Builtin::Line);
+            DefineBuiltin("__FILE__", Macro::Builtin::File);
+
+            for (const ShaderMacro& macro : options.macros) {
+                std::string& text = m_arena.emplace_back(macro.name + " " + macro.definition);
+                Lexer lexer(text, m_arena);
+                TokenList tokens;
+                lexer.NextLine(tokens);
+                if (tokens.empty() || tokens[0].kind != TokenKind::Identifier) {
+                    throw PreprocessError{"invalid macro name '" + macro.name + "'"};
+                }
+                Macro definition;
+                definition.id = m_nextMacroId++;
+                definition.body.assign(tokens.begin() + 1, tokens.end());
+                if (!definition.body.empty()) {
+                    definition.body[0].leadingSpace = false;
+                }
+                m_macros[tokens[0].text] = std::move(definition);
+            }
+        }
+
+        void ProcessFile(std::string_view text, const std::string& path,
+                         const std::filesystem::path& directory, uint32 depth) {
+            Lexer lexer(text, m_arena);
+            File file{path, directory, &lexer, {}, false};
+            File* parent = m_file;
+            m_file = &file;
+            m_needMarker = true;
+
+            std::vector<Conditional> conditionals;
+            TokenList line;
+
+            try {
+                while (NextLine(line)) {
+                    if (line.empty()) {
+                        continue;
+                    }
+                    bool active = conditionals.empty() || conditionals.back().active;
+                    m_currentLine = line[0].line;
+
+                    if (IsDirective(line)) {
+                        HandleDirective(line, conditionals, active, depth);
+                    } else if (active) {
+                        ExpandLine(line);
+                    }
+                }
+
+                if (!conditionals.empty()) {
+                    throw PreprocessError{"unterminated #if"};
+                }
+            }
+            catch (PreprocessError& e) {
+                if (e.location.empty()) {
+                    e.location = m_file->path + "(" + std::to_string(m_currentLine) + ")";
+                }
+                m_file = parent;
+                throw;
+            }
+
+            m_file = parent;
+            m_needMarker = true;
+        }
+
+    private:
+        struct File {
+            std::string path;
+            std::filesystem::path directory;
+            Lexer* lexer;
+            TokenList deferredLine;     // A directive read while collecting macro arguments
+            bool hasDeferredLine{false};
+        };
+
+        // Most lines name no macro; they are emitted without the expansion queue
+        void ExpandLine(TokenList& line) {
+            size_t first = 0;
+            while (first < line.size() &&
+                   (line[first].kind != TokenKind::Identifier || !m_macros.count(line[first].text))) {
+                ++first;
+            }
+            for (size_t i = 0; i < first; ++i) {
+                Emit(line[i]);
+            }
+            if (first == line.size()) {
+                return;
+            }
+
+            m_lineWork.assign(std::make_move_iterator(line.begin() + first), std::make_move_iterator(line.end()));
+            Expand(m_lineWork, nullptr, true);
+        }
+
+        bool NextLine(TokenList& line) {
+            if (m_file->hasDeferredLine) {
+                m_file->hasDeferredLine = false;
+                line = std::move(m_file->deferredLine);
+                return true;
+            }
+            return m_file->lexer->NextLine(line);
+        }
+
+        void DefineBuiltin(std::string_view name, Macro::Builtin builtin) {
+            Macro macro;
+            macro.id = m_nextMacroId++;
+            macro.builtin = builtin;
+            m_macros[name] = std::move(macro);
+        }
+
+        // Directives
+
+        void HandleDirective(TokenList& line, std::vector<Conditional>& conditionals, bool active, uint32 depth) {
+            std::string_view name = DirectiveName(line);
+
+            if (name == "if" || name == "ifdef" || name == "ifndef") {
+                bool value = false;
+                if (active) {
+                    value = name == "if" ? Evaluate(line) : IsDefinedTest(line, name == "ifdef");
+                }
+                conditionals.push_back({active && value, value, active, false});
+                return;
+            }
+            if (name == "elif") {
+                if (conditionals.empty() || conditionals.back().sawElse) {
+                    throw PreprocessError{"#elif without #if"};
+                }
+                Conditional& c = conditionals.back();
+                bool value = c.parentActive && !c.taken && Evaluate(line);
+                c.active = value;
+                c.taken = c.taken || value;
+                return;
+            }
+            if (name == "else") {
+                if (conditionals.empty() || conditionals.back().sawElse) {
+                    throw PreprocessError{"#else without #if"};
+                }
+                Conditional& c = conditionals.back();
+                c.sawElse = true;
+                c.active = c.parentActive && !c.taken;
+                c.taken = true;
+                return;
+            }
+            if (name == "endif") {
+                if (conditionals.empty()) {
+                    throw PreprocessError{"#endif without #if"};
+                }
+                conditionals.pop_back();
+                return;
+            }
+
+            if (!active) {
+                return;
+            }
+
+            if (name == "define") {
+                Define(line);
+            } else if (name == "undef") {
+                if (line.size() < 3 || line[2].kind != TokenKind::Identifier) {
+                    throw PreprocessError{"#undef expects a macro name"};
+                }
+                m_macros.erase(line[2].text);
+            } else if (name == "include") {
+                Include(line, depth);
+            } else if (name == "pragma" && line.size() > 2 && line[2].text == "once") {
+                m_onceFiles.insert(m_file->path);
+            } else if (name == "error") {
+                std::string message;
+                for (size_t i = 2; i < line.size(); ++i) {
+                    message += (i > 2 && line[i].leadingSpace ? " " : "") + std::string(line[i].text);
+                }
+                throw PreprocessError{"#error " + message};
+            } else if (!name.empty() || line.size() > 1) {
+                // #pragma, #line and anything else is the backend's business
+                for (const Token& token : line) {
+                    Emit(token);
+                }
+            }
+        }
+
+        void Define(const TokenList& line) {
+            if (line.size() < 3 || line[2].kind != TokenKind::Identifier) {
+                throw PreprocessError{"#define expects a macro name"};
+            }
+
+            Macro macro;
+            macro.id = m_nextMacroId++;
+            size_t i = 3;
+
+            // Function-like only when '(' directly follows the name
+            if (i < line.size() && line[i].Is("(") && !line[i].leadingSpace) {
+                macro.functionLike = true;
+                ++i;
+                while (i < line.size() && !line[i].Is(")")) {
+                    if (line[i].Is("...")) {
+                        macro.variadic = true;
+                        macro.params.push_back("__VA_ARGS__");
+                    } else if (line[i].kind == TokenKind::Identifier && !macro.variadic) {
+                        macro.params.push_back(line[i].text);
+                    } else {
+                        throw PreprocessError{"invalid parameter list for macro '" + std::string(line[2].text) + "'"};
+                    }
+                    ++i;
+                    if (i < line.size() && line[i].Is(",")) {
+                        ++i;
+                    }
+                }
+                if (i >= line.size()) {
+                    throw PreprocessError{"missing ')' in macro parameter list"};
+                }
+                ++i;
+            }
+
+            macro.body.assign(line.begin() + i, line.end());
+            if (!macro.body.empty()) {
+                macro.body[0].leadingSpace = false;
+                if (macro.body.front().Is("##") || macro.body.back().Is("##")) {
+                    throw PreprocessError{"'##' cannot appear at either end of a macro"};
+                }
+            }
+            m_macros[line[2].text] = std::move(macro);
+        }
+
+        bool IsDefinedTest(const TokenList& line, bool wantDefined) {
+            if (line.size() < 3 || line[2].kind != TokenKind::Identifier) {
+                throw PreprocessError{"expected a macro name"};
+            }
+            bool defined = m_macros.count(line[2].text) > 0;
+            if (!defined && IsBackendBuiltin(line[2].text)) {
+                m_result.requiresBackendPreprocessor = true;
+            }
+            return defined == wantDefined;
+        }
+
+        void Include(const TokenList& line, uint32 depth) {
+            TokenList operand(line.begin() + 2, line.end());
+            if (!operand.empty() && operand[0].kind != TokenKind::String && !operand[0].Is("<")) {
+                // Computed include: expand first
+                std::deque<Token> work(operand.begin(), operand.end());
+                operand.clear();
+                Expand(work, &operand, false);
+            }
+            if (operand.empty()) {
+                throw PreprocessError{"#include expects \"file\" or <file>"};
+            }
+
+            std::string name;
+            bool quoted = operand[0].kind == TokenKind::String;
+            if (quoted) {
+                name = std::string(operand[0].text.substr(1, operand[0].text.size() - 2));
+            } else if (operand[0].Is("<")) {
+                size_t i = 1;
+                for (; i < operand.size() && !operand[i].Is(">"); ++i) {
+                    name += (i > 1 && operand[i].leadingSpace ? " " : "") + std::string(operand[i].text);
+                }
+                if (i == operand.size()) {
+                    throw PreprocessError{"missing '>' in #include"};
+                }
+            } else {
+                throw PreprocessError{"#include expects \"file\" or <file>"};
+            }
+
+            if (depth + 1 >= MaxIncludeDepth) {
+                throw PreprocessError{"#include nested too deeply"};
+            }
+
+            std::filesystem::path resolved = ShaderPreprocessor::ResolveInclude(
+                name, quoted, m_file->directory, m_options.includePaths);
+            std::shared_ptr<const IncludeFile> file = resolved.empty() ? nullptr : m_cache.Load(resolved);
+            if (!file) {
+                throw PreprocessError{"cannot open include file '" + name + "'"};
+            }
+
+            if (m_dependencySet.insert(file->path).second) {
+                m_result.dependencies.push_back(file->path);
+            }
+
+            // Skip files that would contribute nothing, without lexing them
+            if ((file->pragmaOnce && m_onceFiles.count(file->path)) ||
+                (!file->includeGuard.empty() && m_macros.count(file->includeGuard))) {
+                return;
+            }
+
+            m_heldFiles.push_back(file);
+            uint32 line0 = m_currentLine;
+            ProcessFile(file->content, file->path, std::filesystem::path(file->path).parent_path(), depth + 1);
+            m_currentLine = line0;
+        }
+
+        // #if expressions
+
+        int64 Evaluate(const TokenList& line) {
+            // defined X / defined(X) must be resolved before macro expansion
+            std::deque<Token> work;
+            for (size_t i = 2; i < line.size(); ++i) {
+                if (line[i].kind == TokenKind::Identifier && line[i].text == "defined") {
+                    bool parens = i + 1 < line.size() && line[i + 1].Is("(");
+                    size_t nameIndex = i + (parens ? 2 : 1);
+                    if (nameIndex >= line.size() || line[nameIndex].kind != TokenKind::Identifier ||
+                        (parens && (nameIndex + 1 >= line.size() || !line[nameIndex + 1].Is(")")))) {
+                        throw PreprocessError{"invalid 'defined' in #if"};
+                    }
+                    bool defined = m_macros.count(line[nameIndex].text) > 0;
+                    if (!defined && IsBackendBuiltin(line[nameIndex].text)) {
+                        m_result.requiresBackendPreprocessor = true;
+                    }
+                    Token value = line[i];
+                    value.kind = TokenKind::Number;
+                    value.text = defined ? "1" : "0";
+                    work.push_back(value);
+                    i = nameIndex + (parens ? 1 : 0);
+                } else {
+                    work.push_back(line[i]);
+                }
+            }
+
+            TokenList expanded;
+            Expand(work, &expanded, false);
+            if (expanded.empty()) {
+                throw PreprocessError{"#if with no expression"};
+            }
+
+            m_expr = &expanded;
+            m_exprPos = 0;
+            int64 value = ParseTernary();
+            if (m_exprPos != expanded.size()) {
+                throw PreprocessError{"unexpected '" + std::string(expanded[m_exprPos].text) + "' in #if"};
+            }
+            return value;
+        }
+
+        const Token* PeekExpr() const {
+            return m_exprPos < m_expr->size() ? &(*m_expr)[m_exprPos] : nullptr;
+        }
+
+        bool AcceptExpr(std::string_view op) {
+            const Token* token = PeekExpr();
+            if (token && token->Is(op)) {
+                ++m_exprPos;
+                return true;
+            }
+            return false;
+        }
+
+        int64 ParseTernary() {
+            int64 condition = ParseBinary(0);
+            if (AcceptExpr("?")) {
+                m_unevaluated += condition ? 0 : 1;
+                int64 whenTrue = ParseTernary();
+                m_unevaluated -= condition ? 0 : 1;
+                if (!AcceptExpr(":")) {
+                    throw PreprocessError{"expected ':' in #if"};
+                }
+                m_unevaluated += condition ? 1 : 0;
+                int64 whenFalse = ParseTernary();
+                m_unevaluated -= condition ? 1 : 0;
+                return condition ? whenTrue : whenFalse;
+            }
+            return condition;
+        }
+
+        // Precedence climbing over the C binary operators
+        int64 ParseBinary(int32 minPrecedence) {
+            static const std::pair<std::string_view, int32> operators[] = {
+                {"||", 1}, {"&&", 2}, {"|", 3}, {"^", 4}, {"&", 5},
+                {"==", 6}, {"!=", 6}, {"<", 7}, {">", 7}, {"<=", 7}, {">=", 7},
+                {"<<", 8}, {">>", 8}, {"+", 9}, {"-", 9}, {"*", 10}, {"/", 10}, {"%", 10}
+            };
+
+            int64 lhs = ParseUnary();
+            while (const Token* token = PeekExpr()) {
+                if (token->kind != TokenKind::Punctuator) {
+                    break;
+                }
+                int32 precedence = -1;
+                for (const auto& [op, p] : operators) {
+                    if (token->text == op) {
+                        precedence = p;
+                        break;
+                    }
+                }
+                if (precedence < minPrecedence || precedence < 0) {
+                    break;
+                }
+                std::string_view op = token->text;
+                ++m_exprPos;
+
+                // The side && / || / ?: skip is parsed but not evaluated,
+                // so "defined(X) && 1 / X" is fine when X is undefined
+                bool skip = (op == "&&" && !lhs) || (op == "||" && lhs);
+                m_unevaluated += skip ? 1 : 0;
+                int64 rhs = ParseBinary(precedence + 1);
+                m_unevaluated -= skip ? 1 : 0;
+                if (op == "||") lhs = lhs || rhs;
+                else if (op == "&&") lhs = lhs && rhs;
+                else if (op == "|") lhs |= rhs;
+                else if (op == "^") lhs ^= rhs;
+                else if (op == "&") lhs &= rhs;
+                else if (op == "==") lhs = lhs == rhs;
+                else if (op == "!=") lhs = lhs != rhs;
+                else if (op == "<") lhs = lhs < rhs;
+                else if (op == ">") lhs = lhs > rhs;
+                else if (op == "<=") lhs = lhs <= rhs;
+                else if (op == ">=") lhs = lhs >= rhs;
+                else if (op == "<<") lhs = static_cast<int64>(static_cast<uint64>(lhs) << (rhs & 63));
+                else if (op == ">>") lhs >>= (rhs & 63);
+                else if (op == "+") lhs += rhs;
+                else if (op == "-") lhs -= rhs;
+                else if (op == "*") lhs *= rhs;
+                else {
+                    if (rhs == 0) {
+                        if (m_unevaluated > 0) {
+                            lhs = 0;
+                            continue;
+                        }
+                        throw PreprocessError{"division by zero in #if"};
+                    }
+                    lhs = op == "/" ? lhs / rhs : lhs % rhs;
+                }
+            }
+            return lhs;
+        }
+
+        int64 ParseUnary() {
+            if (AcceptExpr("!")) return !ParseUnary();
+            if (AcceptExpr("~")) return ~ParseUnary();
+            if (AcceptExpr("-")) return -ParseUnary();
+            if (AcceptExpr("+")) return ParseUnary();
+            return ParsePrimary();
+        }
+
+        int64 ParsePrimary() {
+            const Token* token = PeekExpr();
+            if (!token) {
+                throw PreprocessError{"unexpected end of #if expression"};
+            }
+            ++m_exprPos;
+
+            if (token->Is("(")) {
+                int64 value = ParseTernary();
+                if (!AcceptExpr(")")) {
+                    throw PreprocessError{"expected ')' in #if"};
+                }
+                return value;
+            }
+            if (token->kind == TokenKind::Number) {
+                return ParseNumber(token->text);
+            }
+            if (token->kind == TokenKind::Identifier) {
+                // Identifiers left after expansion are 0, true/false as in C++
+                if (token->text == "true") {
+                    return 1;
+                }
+                if (token->text.substr(0, 2) == "__") {
+                    m_result.requiresBackendPreprocessor = true;
+                }
+                return 0;
+            }
+            if (token->kind == TokenKind::String && token->text.size() == 3 && token->text[0] == '\'') {
+                return static_cast<unsigned char>(token->text[1]);
+            }
+            throw PreprocessError{"unexpected '" + std::string(token->text) + "' in #if"};
+        }
+
+        static int64 ParseNumber(std::string_view text) {
+            std::string digits(text);
+            while (!digits.empty() && std::strchr("uUlL", digits.back())) {
+                digits.pop_back();
+            }
+            if (digits.find_first_of(".eE") != std::string::npos &&
+                !(digits.size() > 1 && (digits[1] == 'x' || digits[1] == 'X'))) {
+                throw PreprocessError{"floating constant in #if"};
+            }
+            try {
+                size_t used = 0;
+                uint64 value = std::stoull(digits, &used, 0);
+                if (used != digits.size()) {
+                    throw PreprocessError{"invalid number '" + std::string(text) + "' in #if"};
+                }
+                return static_cast<int64>(value);
+            }
+            catch (const std::logic_error&) {
+                throw PreprocessError{"invalid number '" + std::string(text) + "' in #if"};
+            }
+        }
+
+        // Macro expansion (hide-set algorithm after Prosser)
+
+        // Expands work until it is empty. With output null tokens go to the
+        // preprocessed text; pullLines lets a macro call take its arguments
+        // from following lines of the file.
+        void Expand(std::deque<Token>& work, TokenList* output, bool pullLines) {
+            while (!work.empty()) {
+                Token token = std::move(work.front());
+                work.pop_front();
+
+                const Macro* macro = nullptr;
+                if (token.kind == TokenKind::Identifier) {
+                    auto it = m_macros.find(token.text);
+                    if (it != m_macros.end() &&
+                        !std::binary_search(token.hideSet.begin(), token.hideSet.end(), it->second.id)) {
+                        macro = &it->second;
+                    }
+                }
+
+                if (!macro) {
+                    if (output) {
+                        output->push_back(std::move(token));
+                    } else {
+                        Emit(token);
+                    }
+                    continue;
+                }
+
+                if (macro->builtin != Macro::Builtin::None) {
+                    Token value = token;
+                    if (macro->builtin == Macro::Builtin::Line) {
+                        value.kind = TokenKind::Number;
+                        value.text = m_arena.emplace_back(std::to_string(token.line));
+                    } else {
+                        value.kind = TokenKind::String;
+                        value.text = m_arena.emplace_back(Quote(m_file ? m_file->path : std::string()));
+                    }
+                    work.push_front(std::move(value));
+                    AddToHideSet(work.front().hideSet, macro->id);
+                    continue;
+                }
+
+                if (!macro->functionLike) {
+                    std::vector<uint32> hideSet = token.hideSet;
+                    AddToHideSet(hideSet, macro->id);
+                    TokenList body = Substitute(*macro, {}, hideSet, token);
+                    work.insert(work.begin(), std::make_move_iterator(body.begin()),
+                                std::make_move_iterator(body.end()));
+                    continue;
+                }
+
+                if (work.empty() && pullLines) {
+                    PullLine(work);
+                }
+                if (work.empty() || !work.front().Is("(")) {
+                    // A function-like macro name without arguments is an ordinary identifier
+                    if (output) {
+                        output->push_back(std::move(token));
+                    } else {
+                        Emit(token);
+                    }
+                    continue;
+                }
+
+                work.pop_front();
+                std::vector<TokenList> args(1);
+                uint32 nesting = 1;
+                Token closing;
+                while (true) {
+                    if (work.empty() && (!pullLines || !PullLine(work))) {
+                        throw PreprocessError{"unterminated call to macro '" + std::string(token.text) + "'"};
+                    }
+                    Token arg = std::move(work.front());
+                    work.pop_front();
+
+                    if (arg.Is("(")) {
+                        ++nesting;
+                    } else if (arg.Is(")") && --nesting == 0) {
+                        closing = std::move(arg);
+                        break;
+                    } else if (arg.Is(",") && nesting == 1 &&
+                               !(macro->variadic && args.size() == macro->params.size())) {
+                        args.emplace_back();
+                        continue;
+                    }
+                    args.back().push_back(std::move(arg));
+                }
+
+                // F() passes no arguments to a macro without parameters
+                if (macro->params.empty() && args.size() == 1 && args[0].empty()) {
+                    args.clear();
+                }
+                if (macro->variadic && args.size() == macro->params.size() - 1) {
+                    args.emplace_back();
+                }
+                if (args.size() != macro->params.size()) {
+                    throw PreprocessError{"macro '" + std::string(token.text) + "' expects " +
+                                          std::to_string(macro->params.size()) + " arguments, got " +
+                                          std::to_string(args.size())};
+                }
+
+                std::vector<uint32> hideSet = IntersectHideSets(token.hideSet, closing.hideSet);
+                AddToHideSet(hideSet, macro->id);
+                TokenList body = Substitute(*macro, args, hideSet, token);
+                work.insert(work.begin(), std::make_move_iterator(body.begin()),
+                            std::make_move_iterator(body.end()));
+            }
+        }
+
+        // Continues a macro call on the next line of the current file
+        bool PullLine(std::deque<Token>& work) {
+            TokenList line;
+            while (m_file && m_file->lexer->NextLine(line)) {
+                if (IsDirective(line)) {
+                    m_file->deferredLine = std::move(line);
+                    m_file->hasDeferredLine = true;
+                    return false;
+                }
+                if (!line.empty()) {
+                    work.insert(work.end(), std::make_move_iterator(line.begin()),
+                                std::make_move_iterator(line.end()));
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        TokenList Substitute(const Macro& macro, const std::vector<TokenList>& args,
+                             const std::vector<uint32>& hideSet, const Token& invocation) {
+            TokenList result;
+            std::vector<TokenList> expandedArgs(args.size());
+            std::vector<bool> expandedReady(args.size(), false);
+            bool placemarker = false;   // Left operand of a pending ## was an empty argument
+
+            const TokenList& body = macro.body;
+            for (size_t i = 0; i < body.size(); ++i) {
+                const Token& token = body[i];
+                bool beforePaste = i + 1 < body.size() && body[i + 1].Is("##");
+
+                if (macro.functionLike && token.Is("#") && i + 1 < body.size()) {
+                    int32 param = macro.FindParam(body[i + 1].text);
+                    if (param >= 0) {
+                        Token quoted = token;
+                        quoted.kind = TokenKind::String;
+                        quoted.text = m_arena.emplace_back(Stringize(args[param]));
+                        result.push_back(std::move(quoted));
+                        ++i;
+                        placemarker = false;
+                        continue;
+                    }
+                }
+
+                if (token.Is("##")) {
+                    const Token& next = body[++i];
+                    int32 param = macro.functionLike ? macro.FindParam(next.text) : -1;
+                    TokenList rhs = param >= 0 ? args[param] : TokenList{next};
+
+                    if (rhs.empty()) {
+                        continue;
+                    }
+                    if (placemarker || result.empty()) {
+                        result.insert(result.end(), rhs.begin(), rhs.end());
+                    } else {
+                        Token& lhs = result.back();
+                        std::string& pasted = m_arena.emplace_back(std::string(lhs.text) + std::string(rhs[0].text));
+                        lhs.text = pasted;
+                        lhs.kind = Lexer::Classify(pasted);
+                        result.insert(result.end(), rhs.begin() + 1, rhs.end());
+                    }
+                    placemarker = false;
+                    continue;
+                }
+
+                int32 param = macro.functionLike && token.kind == TokenKind::Identifier
+                    ? macro.FindParam(token.text) : -1;
+                if (param >= 0) {
+                    bool afterPaste = i > 0 && body[i - 1].Is("##");
+                    const TokenList* replacement = &args[param];
+                    if (!beforePaste && !afterPaste) {
+                        if (!expandedReady[param]) {
+                            std::deque<Token> work(args[param].begin(), args[param].end());
+                            Expand(work, &expandedArgs[param], false);
+                            expandedReady[param] = true;
+                        }
+                        replacement = &expandedArgs[param];
+                    }
+
+                    size_t first = result.size();
+                    result.insert(result.end(), replacement->begin(), replacement->end());
+                    if (result.size() > first) {
+                        result[first].leadingSpace = token.leadingSpace;
+                    }
+                    placemarker = beforePaste && replacement->empty();
+                    continue;
+                }
+
+                result.push_back(token);
+                placemarker = false;
+            }
+
+            for (size_t i = 0; i < result.size(); ++i) {
+                Token& token = result[i];
+                token.hideSet = UnionHideSets(token.hideSet, hideSet);
+                token.line = invocation.line;
+                if (i == 0) {
+                    token.leadingSpace = invocation.leadingSpace;
+                }
+            }
+            return result;
+        }
+
+        static std::string Quote(const std::string& text) {
+            std::string quoted = "\"";
+            for (char c : text) {
+                if (c == '"' || c == '\\') {
+                    quoted += '\\';
+                }
+                quoted += c;
+            }
+            return quoted + "\"";
+        }
+
+        static std::string Stringize(const TokenList& tokens) {
+            std::string text;
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                if (i > 0 && tokens[i].leadingSpace) {
+                    text += ' ';
+                }
+                text += tokens[i].text;
+            }
+            return Quote(text);
+        }
+
+        // Output
+
+        static bool NeedsSeparation(char previous, char next) {
+            auto word = [](char c) { return IsIdentifierChar(c) || c == '.'; };
+            auto op = [](char c) { return c != '\0' && std::strchr("+-*/%<>=!&|^#:", c) != nullptr; };
+            return (word(previous) && word(next)) || (op(previous) && op(next));
+        }
+
+        void Emit(const Token& token) {
+            std::string& out = m_result.output;
+
+            if (m_needMarker || token.line < m_outLine) {
+                if (m_lineHasContent) {
+                    out += '\n';
+                }
+                if (m_options.emitLineDirectives) {
+                    out += "#line " + std::to_string(token.line) + " " + MarkerPath() + "\n";
+                }
+                m_needMarker = false;
+                m_lineHasContent = false;
+                m_outLine = token.line;
+            } else if (token.line > m_outLine) {
+                uint32 gap = token.line - m_outLine;
+                if (gap <= MaxLinePadding || !m_options.emitLineDirectives) {
+                    out.append(gap, '\n');
+                } else {
+                    out += "\n#line " + std::to_string(token.line) + " " + MarkerPath() + "\n";
+                }
+                m_lineHasContent = false;
+                m_outLine = token.line;
+            } else if (m_lineHasContent && (token.leadingSpace || NeedsSeparation(out.back(), token.text[0]))) {
+                out += ' ';
+            }
+
+            out += token.text;
+            m_lineHasContent = true;
+
+            for (char c : token.text) {
+                m_hash = (m_hash ^ static_cast<unsigned char>(c)) * FnvPrime;
+            }
+            m_hash = (m_hash ^ 0x1F) * FnvPrime;
+            m_result.tokenHash = m_hash;
+        }
+
+        std::string MarkerPath() const {
+            std::string path = m_file ? m_file->path : std::string();
+            std::replace(path.begin(), path.end(), '\\', '/');
+            return Quote(path);
+        }
+
+        IncludeCache& m_cache;
+        const PreprocessOptions& m_options;
+        PreprocessResult& m_result;
+
+        std::deque<std::string> m_arena;    // Text of pasted/stringized tokens and spliced sources
+        std::unordered_map<std::string_view, Macro> m_macros;
+        uint32 m_nextMacroId{0};
+        std::deque<Token> m_lineWork;
+
+        File* m_file{nullptr};
+        uint32 m_currentLine{0};
+        std::vector<std::shared_ptr<const IncludeFile>> m_heldFiles;
+        std::unordered_set<std::string> m_onceFiles;
+        std::unordered_set<std::string> m_dependencySet;
+
+        const TokenList* m_expr{nullptr};
+        size_t m_exprPos{0};
+        uint32 m_unevaluated{0};
+
+        uint64 m_hash{FnvOffset};
+        uint32 m_outLine{1};
+        bool m_lineHasContent{false};
+        bool m_needMarker{true};
+    };
+
+    std::string NormalizePath(const std::filesystem::path& path) {
+        std::error_code error;
+        std::filesystem::path absolute = std::filesystem::absolute(path, error);
+        return (error ? path : absolute).lexically_normal().generic_string();
+    }
+}
+
+// IncludeCache Implementation
+IncludeCache& IncludeCache::Shared() {
+    static IncludeCache instance;
+    return instance;
+}
+
+std::shared_ptr<const IncludeFile> IncludeCache::Load(const std::filesystem::path& path) {
+    std::string key = NormalizePath(path);
+
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(key, error);
+    if (error) {
+        return nullptr;
+    }
+    uint64 size = std::filesystem::file_size(key, error);
+    if (error) {
+        return nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_files.find(key);
+        if (it != m_files.end() && it->second->writeTime == writeTime && it->second->size == size) {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second;
+        }
+    }
+
+    // Read and scan outside the lock; a racing loader just does the same work
+    std::ifstream stream(key, std::ios::binary);
+    if (!stream.is_open()) {
+        return nullptr;
+    }
+    auto file = std::make_shared<IncludeFile>();
+    file->path = key;
+    file->writeTime = writeTime;
+    file->size = size;
+    file->content.resize(size);
+    stream.read(file->content.data(), static_cast<std::streamsize>(size));
+    file->content.resize(static_cast<size_t>(stream.gcount()));
+    file->pragmaOnce = HasPragmaOnce(file->content);
+    file->includeGuard = DetectIncludeGuard(file->content);
+
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files[key] = file;
+    return file;
+}
+
+void IncludeCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files.clear();
+}
+
+// ShaderPreprocessor Implementation
+ShaderPreprocessor::ShaderPreprocessor(IncludeCache& cache)
+    : m_cache(cache) {
+}
+
+std::filesystem::path ShaderPreprocessor::ResolveInclude(const std::string& name, bool quoted,
+                                                         const std::filesystem::path& currentDirectory,
+                                                         const std::vector<std::string>& includePaths) {
+    std::error_code error;
+    std::filesystem::path path(name);
+    if (path.is_absolute()) {
+        return std::filesystem::is_regular_file(path, error) ? path : std::filesystem::path();
+    }
+
+    auto tryDirectory = [&](const std::filesystem::path& directory) {
+        std::filesystem::path candidate = directory / path;
+        return std::filesystem::is_regular_file(candidate, error) ? candidate : std::filesystem::path();
+    };
+
+    if (quoted) {
+        if (auto found = tryDirectory(currentDirectory); !found.empty()) {
+            return found;
+        }
+    }
+    for (const std::string& directory : includePaths) {
+        if (auto found = tryDirectory(directory); !found.empty()) {
+            return found;
+        }
+    }
+    if (!quoted) {
+        return tryDirectory(currentDirectory);
+    }
+    return {};
+}
+
+PreprocessResult ShaderPreprocessor::Preprocess(std::string_view source, const std::string& sourceName,
+                                                const PreprocessOptions& options) const {
+    PreprocessResult result;
+    result.output.reserve(source.size() + source.size() / 4);
+
+    std::filesystem::path directory = !options.baseDirectory.empty()
+        ? std::filesystem::path(options.baseDirectory)
+        : std::filesystem::path(sourceName).parent_path();
+    std::string name = sourceName.empty() ? std::string("<source>") : sourceName;
+
+    try {
+        Context context(m_cache, options, result);
+        context.ProcessFile(source, name, directory, 0);
+        if (!result.output.empty() && result.output.back() != '\n') {
+            result.output += '\n';
+        }
+        result.success = true;
+    }
+    catch (const PreprocessError& e) {
+        std::string location = e.location.empty() ? std::string("<options>") : e.location;
+        result.errors.push_back(location + ": error: " + e.message);
+        result.output.clear();
+    }
+
+    return result;
+}
+
+} // namespace XeSS::Graphics
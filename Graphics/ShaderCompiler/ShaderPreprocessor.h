@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace XeSS::Graphics {
+
+struct ShaderMacro {
+    std::string name;
+    std::string definition;
+};
+
+// A source file as read by the preprocessor, plus what a scan of it found
+struct IncludeFile {
+    std::string path;                       // Normalized absolute path
+    std::string content;
+    std::filesystem::file_time_type writeTime;
+    uint64 size{0};
+    bool pragmaOnce{false};
+    std::string includeGuard;               // Macro of a whole-file #ifndef guard, empty if none
+};
+
+/**
+ * Process-wide cache of include files keyed by normalized path. Every lookup
+ * revalidates the entry against the file's write time and size, so an edited
+ * header is re-read by the next compile that includes it.
+ */
+class IncludeCache : public NonCopyable {
+public:
+    static IncludeCache& Shared();
+
+    // Returns null if the file does not exist or cannot be read
+    std::shared_ptr<const IncludeFile> Load(const std::filesystem::path& path);
+    void Clear();
+
+    uint64 GetHitCount() const { return m_hits.load(std::memory_order_relaxed); }
+    uint64 GetMissCount() const { return m_misses.load(std::memory_order_relaxed); }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::string, std::shared_ptr<const IncludeFile>> m_files;
+    std::atomic<uint64> m_hits{0};
+    std::atomic<uint64> m_misses{0};
+};
+
+struct PreprocessOptions {
+    // Defined before the first line, same as D3D_SHADER_MACRO: the definition is used verbatim
+    std::vector<ShaderMacro> macros;
+    std::vector<std::string> includePaths;
+
+    // Directory for quoted includes of the root source; defaults to the directory of sourceName
+    std::string baseDirectory;
+
+    // Emit #line markers so compiler diagnostics point at the original files
+    bool emitLineDirectives = true;
+};
+
+struct PreprocessResult {
+    bool success{false};
+    std::string output;
+
+    // Hash of the emitted token stream. Whitespace, comments and line breaks
+    // do not contribute, so formatting-only edits keep the same hash.
+    uint64 tokenHash{0};
+
+    std::vector<std::string> dependencies;  // Included files, in first-include order
+    std::vector<std::string> errors;
+
+    // The source tests macros only the compiler backend defines (__HLSL_VERSION, ...);
+    // the raw source has to go to the backend's own preprocessor
+    bool requiresBackendPreprocessor{false};
+};
+
+/**
+ * HLSL preprocessor: #include with the shared IncludeCache, #pragma once and
+ * include-guard skipping, object- and function-like macros (#, ##,
+ * __VA_ARGS__), conditionals with full #if expressions, and #pragma/#line
+ * pass-through. Other directives are passed to the output unchanged.
+ */
+class ShaderPreprocessor {
+public:
+    explicit ShaderPreprocessor(IncludeCache& cache = IncludeCache::Shared());
+
+    PreprocessResult Preprocess(std::string_view source, const std::string& sourceName,
+                                const PreprocessOptions& options) const;
+
+    // Quoted includes search currentDirectory first, angle-bracket includes last;
+    // returns an empty path if the file exists nowhere
+    static std::filesystem::path ResolveInclude(const std::string& name, bool quoted,
+                                                const std::filesystem::path& currentDirectory,
+                                                const std::vector<std::string>& includePaths);
+
+private:
+    IncludeCache& m_cache;
+};
+
+} // namespace XeSS::Graphics
@@ -0,0 +1,250 @@
+#include "ShaderCreationQueue.h"
+#include "Device.h"
+#include "Shader.h"
+#include "Core/Logger.h"
+#include "Core/Metrics.h"
+#include <algorithm>
+
+namespace XeSS::Graphics {
+
+namespace {
+    MetricsRegistry& Registry() { return MetricsRegistry::Instance(); }
+
+    MetricGauge& s_queueDepth = Registry().Gauge("shader.creation_queue_depth", "Shader creations waiting for budget");
+    MetricHistogram& s_latency = Registry().Histogram("shader.creation_latency_ms",
+                                                      "Queued shader creation, submit to completion, in ms",
+                                                      MetricHistogram::ExponentialBounds(0.5, 2.0, 14));
+    MetricHistogram& s_createTime = Registry().Histogram("shader.creation_time_ms",
+                                                         "Driver time of one shader creation in ms",
+                                                         MetricHistogram::ExponentialBounds(0.05, 2.0, 14));
+
+    float64 ElapsedMs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+        return std::chrono::duration<float64, std::milli>(end - start).count();
+    }
+}
+
+ShaderCreationQueue::ShaderCreationQueue(Device& device, ShaderObjectTable& objects)
+    : m_device(device), m_objects(objects) {}
+
+ShaderCreationQueue::~ShaderCreationQueue() {
+    Shutdown();
+}
+
+void ShaderCreationQueue::Submit(CompiledD3DShader& shader, ShaderType type, ShaderCreationPriority priority,
+                                 Completion onComplete, CancellationToken cancellation) {
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_shutdown && !cancellation.IsCancelled()) {
+            m_queues[static_cast<uint32>(priority)].push_back(
+                {&shader, type, std::move(onComplete), std::move(cancellation), Clock::now()});
+            PublishDepth();
+            queued = true;
+        }
+    }
+    if (!queued) {
+        onComplete(false);
+        return;
+    }
+    PumpIfUnpumped(false);
+}
+
+Task<bool> ShaderCreationQueue::Create(CompiledD3DShader& shader, ShaderType type, ShaderCreationPriority priority,
+                                       CancellationToken cancellation) {
+    co_return co_await AwaitCallback<bool>([&](auto complete) {
+        Submit(shader, type, priority, std::move(complete), cancellation);
+    });
+}
+
+bool ShaderCreationQueue::CreateNow(CompiledD3DShader& shader, ShaderType type) {
+    Clock::time_point start = Clock::now();
+    bool created = CreateObjects(shader, type);
+    s_createTime.Observe(ElapsedMs(start, Clock::now()));
+    (created ? m_created : m_failed).fetch_add(1, std::memory_order_relaxed);
+    return created;
+}
+
+void ShaderCreationQueue::ProcessFrame(float64 budgetMs) {
+    m_budgetMs.store(budgetMs, std::memory_order_relaxed);
+    m_lastPumpNanoseconds.store(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count(),
+        std::memory_order_relaxed);
+    Pump(budgetMs, false);
+}
+
+void ShaderCreationQueue::PumpIfUnpumped(bool batchDone) {
+    int64 lastPump = m_lastPumpNanoseconds.load(std::memory_order_relaxed);
+    int64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    if (lastPump != 0 && now - lastPump < std::chrono::nanoseconds(UnpumpedTimeout).count()) {
+        return;
+    }
+    Pump(m_budgetMs.load(std::memory_order_relaxed), batchDone);
+}
+
+void ShaderCreationQueue::Pump(float64 budgetMs, bool batchDone) {
+    // Superseded loads should not take this frame's budget
+    CompleteCancelled();
+
+    std::vector<Request> started;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Work still running from earlier frames counts against this one
+        float64 spent = m_inFlightMs.load(std::memory_order_relaxed);
+        bool idle = batchDone || m_inFlight.IsDone();
+        bool exhausted = false;
+        for (std::deque<Request>& queue : m_queues) {
+            while (!queue.empty() && !exhausted) {
+                // With nothing running one request always starts, so one
+                // costlier than the whole budget still gets made
+                Request& request = queue.front();
+                request.estimatedMs = EstimateMs(request);
+                if (!(idle && started.empty()) && spent + request.estimatedMs > budgetMs) {
+                    exhausted = true;
+                    break;
+                }
+                spent += request.estimatedMs;
+                m_inFlightMs.fetch_add(request.estimatedMs, std::memory_order_relaxed);
+                started.push_back(std::move(request));
+                queue.pop_front();
+            }
+        }
+        if (started.empty()) {
+            return;
+        }
+        PublishDepth();
+    }
+
+    // Spread the frame's share over the workers, a few requests per job
+    JobSystem& jobs = JobSystem::Instance();
+    size_t workers = std::max<size_t>(jobs.GetWorkerCount(), 1);
+    size_t batchSize = std::clamp<size_t>((started.size() + workers - 1) / workers, 1, MaxBatchSize);
+    for (size_t begin = 0; begin < started.size(); begin += batchSize) {
+        size_t end = std::min(begin + batchSize, started.size());
+        auto batch = std::make_shared<std::vector<Request>>(
+            std::make_move_iterator(started.begin() + begin), std::make_move_iterator(started.begin() + end));
+        jobs.Submit([this, batch]() { RunBatch(*batch); }, &m_inFlight);
+    }
+}
+
+void ShaderCreationQueue::CompleteCancelled() {
+    std::vector<Request> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (std::deque<Request>& queue : m_queues) {
+            auto live = std::stable_partition(queue.begin(), queue.end(), [](const Request& request) {
+                return !request.cancellation.IsCancelled();
+            });
+            std::move(live, queue.end(), std::back_inserter(cancelled));
+            queue.erase(live, queue.end());
+        }
+        PublishDepth();
+    }
+    for (Request& request : cancelled) {
+        request.onComplete(false);
+    }
+}
+
+void ShaderCreationQueue::Shutdown() {
+    std::vector<Request> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+        for (std::deque<Request>& queue : m_queues) {
+            std::move(queue.begin(), queue.end(), std::back_inserter(pending));
+            queue.clear();
+        }
+        PublishDepth();
+    }
+    for (Request& request : pending) {
+        request.onComplete(false);
+    }
+    JobSystem::Instance().Wait(m_inFlight);
+}
+
+ShaderCreationStats ShaderCreationQueue::GetStats() const {
+    ShaderCreationStats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stats.queuedVisible = static_cast<uint32>(m_queues[0].size());
+        stats.queuedPrefetch = static_cast<uint32>(m_queues[1].size());
+    }
+    stats.inFlight = m_inFlight.GetPending();
+    stats.created = m_created.load(std::memory_order_relaxed);
+    stats.failed = m_failed.load(std::memory_order_relaxed);
+
+    uint64 completed = m_completedQueued.load(std::memory_order_relaxed);
+    stats.averageLatencyMs = completed > 0
+        ? static_cast<float64>(m_latencyNanoseconds.load(std::memory_order_relaxed)) / completed / 1e6 : 0.0;
+    stats.inFlightMs = std::max(m_inFlightMs.load(std::memory_order_relaxed), 0.0);
+    stats.estimatedMsPerKilobyte = m_msPerKilobyte.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool ShaderCreationQueue::CreateObjects(CompiledD3DShader& shader, ShaderType type) {
+    const std::vector<uint8>& bytecode = shader.compilationResult.bytecode;
+    ID3D11Device* device = m_device.GetDevice();
+    if (!device || bytecode.empty()) {
+        return false;
+    }
+
+    shader.sharedObject = m_objects.Acquire(device, type, bytecode);
+    if (!shader.sharedObject) {
+        return false;
+    }
+    shader.sharedObject->AssignTo(shader);
+
+    // Input layouts are validated against the signature, so they are per shader
+    const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout = shader.binding.inputLayout;
+    if (type == ShaderType::Vertex && !layout.empty() && !shader.inputLayoutD3D) {
+        HRESULT hr = device->CreateInputLayout(layout.data(), static_cast<UINT>(layout.size()),
+                                               bytecode.data(), bytecode.size(), &shader.inputLayoutD3D);
+        if (FAILED(hr)) {
+            XESS_ERROR("Failed to create input layout: 0x{:08X}", static_cast<uint32>(hr));
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShaderCreationQueue::RunBatch(std::vector<Request>& batch) {
+    for (Request& request : batch) {
+        bool created = false;
+        if (!request.cancellation.IsCancelled()) {
+            Clock::time_point start = Clock::now();
+            created = CreateObjects(*request.shader, request.type);
+            float64 elapsedMs = ElapsedMs(start, Clock::now());
+            s_createTime.Observe(elapsedMs);
+
+            // Smoothed cost per KB; racing updates only lose a sample
+            float64 kilobytes = std::max(request.shader->compilationResult.bytecode.size() / 1024.0, 0.25);
+            float64 previous = m_msPerKilobyte.load(std::memory_order_relaxed);
+            m_msPerKilobyte.store(previous * 0.8 + (elapsedMs / kilobytes) * 0.2, std::memory_order_relaxed);
+        }
+        (created ? m_created : m_failed).fetch_add(1, std::memory_order_relaxed);
+        m_inFlightMs.fetch_sub(request.estimatedMs, std::memory_order_relaxed);
+
+        Clock::time_point now = Clock::now();
+        s_latency.Observe(ElapsedMs(request.submitTime, now));
+        m_latencyNanoseconds.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - request.submitTime).count(),
+            std::memory_order_relaxed);
+        m_completedQueued.fetch_add(1, std::memory_order_relaxed);
+
+        request.onComplete(created);
+    }
+
+    // Nobody is calling ProcessFrame(), so start what waited behind this batch
+    PumpIfUnpumped(true);
+}
+
+float64 ShaderCreationQueue::EstimateMs(const Request& request) const {
+    float64 kilobytes = std::max(request.shader->compilationResult.bytecode.size() / 1024.0, 0.25);
+    return kilobytes * m_msPerKilobyte.load(std::memory_order_relaxed);
+}
+
+void ShaderCreationQueue::PublishDepth() {
+    s_queueDepth.Set(static_cast<float64>(m_queues[0].size() + m_queues[1].size()));
+}
+
+} // namespace XeSS::Graphics
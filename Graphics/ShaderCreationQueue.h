@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include "Core/JobSystem.h"
+#include "Core/Task.h"
+#include "ShaderObjectTable.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace XeSS::Graphics {
+
+class Device;
+struct CompiledD3DShader;
+
+enum class ShaderCreationPriority : uint32 {
+    Visible,    // A draw is waiting for it
+    Prefetch    // Speculative; only gets the budget visible work leaves
+};
+
+struct ShaderCreationStats {
+    uint32 queuedVisible{0};
+    uint32 queuedPrefetch{0};
+    uint32 inFlight{0};                 // Batches running on workers
+    float64 inFlightMs{0.0};            // Their estimated driver time
+    uint64 created{0};
+    uint64 failed{0};
+    float64 averageLatencyMs{0.0};      // Submit to completion, queued requests only
+    float64 estimatedMsPerKilobyte{0.0};
+};
+
+/**
+ * Spreads D3D shader and input layout creation over frames. D3D11 creation
+ * is free-threaded, so ProcessFrame() hands queued requests to JobSystem
+ * workers in batches, but only as much as the frame budget allows: each
+ * request's driver time is estimated from its bytecode size and the time
+ * recent creations took, and work still running counts against the budget.
+ * Visible requests go before prefetch ones, and when nothing is running one
+ * request always starts, so nothing starves.
+ *
+ * The frame loop pumps it through ShaderManager::BeginFrame(). When nothing
+ * has pumped for UnpumpedTimeout (tools, loading screens, or a loop that
+ * never calls BeginFrame) the queue pumps itself on Submit and as batches
+ * finish, using the last budget it was given, so async loads still complete.
+ *
+ * Objects go through the ShaderObjectTable, so identical bytecode is still
+ * created once.
+ */
+class ShaderCreationQueue : public NonCopyable {
+public:
+    using Completion = std::function<void(bool created)>;
+
+    static constexpr uint32 MaxBatchSize = 8;
+    static constexpr std::chrono::milliseconds UnpumpedTimeout{250};
+
+    ShaderCreationQueue(Device& device, ShaderObjectTable& objects);
+    ~ShaderCreationQueue();
+
+    // shader must outlive the request; onComplete runs on a worker, or
+    // inline if the request is cancelled or the queue shut down
+    void Submit(CompiledD3DShader& shader, ShaderType type, ShaderCreationPriority priority,
+                Completion onComplete, CancellationToken cancellation = {});
+    Task<bool> Create(CompiledD3DShader& shader, ShaderType type, ShaderCreationPriority priority,
+                      CancellationToken cancellation = {});
+
+    // Creates on the calling thread, bypassing the queue; for loads that block on the result
+    bool CreateNow(CompiledD3DShader& shader, ShaderType type);
+
+    // Starts queued requests up to budgetMs of estimated driver time; once per frame
+    void ProcessFrame(float64 budgetMs);
+
+    // Completes cancelled requests right away, so whoever awaits them can finish
+    void CompleteCancelled();
+
+    // Fails everything still queued and waits for running batches
+    void Shutdown();
+
+    ShaderCreationStats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request {
+        CompiledD3DShader* shader;
+        ShaderType type;
+        Completion onComplete;
+        CancellationToken cancellation;
+        Clock::time_point submitTime;
+        float64 estimatedMs = 0.0;      // Set when started
+    };
+
+    // batchDone: called from a finished batch, which still counts as running
+    void Pump(float64 budgetMs, bool batchDone);
+    void PumpIfUnpumped(bool batchDone);
+    bool CreateObjects(CompiledD3DShader& shader, ShaderType type);
+    void RunBatch(std::vector<Request>& batch);
+    float64 EstimateMs(const Request& request) const;
+    void PublishDepth();
+
+    Device& m_device;
+    ShaderObjectTable& m_objects;
+
+    mutable std::mutex m_mutex;
+    std::deque<Request> m_queues[2];    // Indexed by ShaderCreationPriority
+    bool m_shutdown = false;
+
+    JobCounter m_inFlight;
+    std::atomic<float64> m_inFlightMs{0.0};
+    std::atomic<float64> m_msPerKilobyte{0.25};     // Cautious until measured
+    std::atomic<float64> m_budgetMs{2.0};           // Last ProcessFrame() budget
+    std::atomic<int64> m_lastPumpNanoseconds{0};    // Clock epoch based; 0 if never pumped
+    std::atomic<uint64> m_created{0};
+    std::atomic<uint64> m_failed{0};
+    std::atomic<uint64> m_completedQueued{0};
+    std::atomic<uint64> m_latencyNanoseconds{0};
+};
+
+} // namespace XeSS::Graphics
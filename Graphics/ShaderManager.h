@@ -2,8 +2,16 @@
 
 #include "Core/Types.h"
 #include "Core/NonCopyable.h"
+#include "Core/ConcurrentHashMap.h"
+#include "Core/JobSystem.h"
 #include "ShaderCompiler/ShaderCompiler.h"
 #include "Shader.h"
+#include "ShaderCreationQueue.h"
+#include "ShaderObjectTable.h"
+#include "ShaderStatistics.h"
+#include "ShaderUsageProfile.h"
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -37,12 +45,34 @@ struct ShaderKey {
     };
 };
 
-// Shader cache entry
+// Shader cache entry. Entries are immutable once cached except for the
+// access stamp, which lookups refresh without a lock.
 struct ShaderCacheEntry {
+    explicit ShaderCacheEntry(std::shared_ptr<CompiledD3DShader> compiled, bool precompiled = false)
+        : shader(std::move(compiled)),
+          creationTime(std::chrono::system_clock::now()),
+          lastAccessTime(creationTime.time_since_epoch().count()),
+          isPrecompiled(precompiled) {}
+
+    // Stores at most once per millisecond, so hot entries stay shared in every core's cache
+    void Touch() const {
+        int64 now = std::chrono::system_clock::now().time_since_epoch().count();
+        if (now - lastAccessTime.load(std::memory_order_relaxed) >= AccessStampResolution) {
+            lastAccessTime.store(now, std::memory_order_relaxed);
+        }
+    }
+
+    std::chrono::system_clock::time_point GetLastAccessTime() const {
+        return std::chrono::system_clock::time_point(
+            std::chrono::system_clock::duration(lastAccessTime.load(std::memory_order_relaxed)));
+    }
+
+    static constexpr int64 AccessStampResolution =
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::milliseconds(1)).count();
+
     std::shared_ptr<CompiledD3DShader> shader;
     std::chrono::system_clock::time_point creationTime;
-    std::chrono::system_clock::time_point lastAccessTime;
-    uint32 accessCount = 0;
+    mutable std::atomic<int64> lastAccessTime;  // system_clock ticks
     bool isPrecompiled = false;
 };
 
@@ -80,28 +110,14 @@ struct ShaderManagerConfig {
     std::string shaderDirectory = "shaders/";
     ShaderModel defaultShaderModel = ShaderModel::SM_6_4;
     uint32 hotReloadCheckIntervalMs = 1000;
-};
 
-// Shader compilation statistics
-struct ShaderStatistics {
-    uint32 totalCompilations = 0;
-    uint32 cacheHits = 0;
-    uint32 cacheMisses = 0;
-    uint32 compilationErrors = 0;
-    uint32 asyncCompilations = 0;
-    uint32 hotReloads = 0;
-
-    double averageCompileTimeMs = 0.0;
-    double totalCompileTimeMs = 0.0;
-
-    uint32 currentCacheSize = 0;
-    uint32 currentMemoryUsageMB = 0;
-
-    void Reset() { *this = ShaderStatistics{}; }
-    double GetCacheHitRatio() const {
-        uint32 total = cacheHits + cacheMisses;
-        return total > 0 ? static_cast<double>(cacheHits) / total : 0.0;
-    }
+    // Shader requests of a session are written here and prefetched on the
+    // next launch; empty disables both
+    std::string usageProfileFile = "cache/shaders/usage.profile";
+    uint32 maxPrefetchJobs = 2;  // In flight at once, so startup jobs are not starved
+
+    // Estimated driver time of queued D3D object creation started per frame
+    float64 creationBudgetMs = 2.0;
 };
 
 // Main shader manager class
@@ -149,6 +165,21 @@ public:
     void PrecompileDirectory(const std::string& directory, bool recursive = true);
     void PrecompileFromManifest(const std::string& manifestFile);
 
+    // Once per frame: stamps usage records and starts this frame's share of
+    // queued D3D object creation
+    void BeginFrame(uint64 frameIndex) {
+        m_usageProfile.SetFrame(frameIndex);
+        m_creationQueue.ProcessFrame(m_config.creationBudgetMs);
+    }
+
+    // Usage profile: records which permutations are requested and on which
+    // frame, then compiles them ahead of use on the next launch
+    void RecordShaderUsage(const std::string& filename, const std::string& entryPoint,
+                           ShaderType type, const CompileOptions& options);
+    void PrefetchFromUsageProfile();    // Returns at once; compiles on JobSystem workers
+    void SaveUsageProfile();            // Stops prefetching, then writes this session's profile
+    const ShaderUsageProfile& GetUsageProfile() const { return m_usageProfile; }
+
     // Cache management
     void ClearCache();
     void CompactCache(); // Remove least recently used entries
@@ -165,12 +196,17 @@ public:
     const ShaderManagerConfig& GetConfig() const { return m_config; }
     void UpdateConfig(const ShaderManagerConfig& config);
 
-    // Statistics
-    const ShaderStatistics& GetStatistics() const { return m_statistics; }
-    void ResetStatistics() { m_statistics.Reset(); }
+    // Statistics (backed by the metrics registry, so safe to read while
+    // async compiles are running)
+    ShaderStatistics GetStatistics() const {
+        return ShaderStatistics::FromSnapshot(MetricsRegistry::Instance().Snapshot().Diff(m_statisticsBaseline));
+    }
+    void ResetStatistics() { m_statisticsBaseline = MetricsRegistry::Instance().Snapshot(); }
 
     // Utility
     ShaderCompiler& GetCompiler() { return m_compiler; }
+    ShaderObjectTable& GetShaderObjects() { return m_shaderObjects; }
+    ShaderCreationQueue& GetCreationQueue() { return m_creationQueue; }
     Device& GetDevice() { return m_device; }
 
     // Shader model support
@@ -191,11 +227,13 @@ private:
     Device& m_device;
     ShaderCompiler m_compiler;
     ShaderManagerConfig m_config;
-    ShaderStatistics m_statistics;
+    MetricsSnapshot m_statisticsBaseline;
+
+    // D3D objects shared between permutations with identical bytecode
+    ShaderObjectTable m_shaderObjects;
 
-    // Cache system
-    std::unordered_map<ShaderKey, ShaderCacheEntry, ShaderKey::Hash> m_shaderCache;
-    std::mutex m_cacheMutex;
+    // Cache system: lock-free lookups, inserts lock one shard
+    ConcurrentHashMap<ShaderKey, ShaderCacheEntry, ShaderKey::Hash> m_shaderCache;
 
     // Hot reload system
     FileWatcher m_fileWatcher;
@@ -207,6 +245,16 @@ private:
     // Async compilation
     std::vector<std::future<void>> m_asyncTasks;
 
+    // Usage recording and prefetch
+    ShaderUsageProfile m_usageProfile;
+    std::vector<ShaderUsageEntry> m_prefetchQueue;      // First-use order; fixed while jobs run
+    std::atomic<size_t> m_prefetchNext{0};
+    std::atomic<bool> m_prefetchStopped{false};
+    JobCounter m_prefetchJobs;
+
+    // Last, so it is destroyed first: its jobs write into shaders and the object table
+    ShaderCreationQueue m_creationQueue{m_device, m_shaderObjects};
+
     // Helper methods
     ShaderKey CreateShaderKey(const std::string& source, const std::string& entryPoint,
                              ShaderType type, const CompileOptions& options) const;
@@ -230,12 +278,18 @@ private:
     void SerializeCache(const std::string& filename) const;
     void DeserializeCache(const std::string& filename);
 
+    void PrefetchNext();
+    bool PrefetchEntry(const ShaderUsageEntry& entry);
+
     // Cleanup
     void CleanupAsyncTasks();
     void RemoveLeastRecentlyUsed();
+    void EvictLeastRecentlyUsed(size_t targetSize);
 
     // Statistics tracking
-    void RecordCompilation(double timeMs, bool fromCache, bool error = false);
+    void RecordCompilation(double timeMs, bool fromCache, bool error = false) {
+        ShaderMetrics::RecordCompilation(timeMs, fromCache, error);
+    }
     void RecordCacheAccess(const ShaderKey& key);
 };
 
@@ -0,0 +1,65 @@
+#include "ShaderManager.h"
+#include "Core/Logger.h"
+#include <algorithm>
+
+namespace XeSS::Graphics {
+
+// Shader cache: lookups from the render, async-compile and hot-reload threads
+// never lock; inserts and evictions lock a single shard of m_shaderCache
+
+std::shared_ptr<CompiledD3DShader> ShaderManager::GetFromCache(const ShaderKey& key) {
+    std::shared_ptr<CompiledD3DShader> shader;
+    m_shaderCache.Visit(key, [&shader](const ShaderCacheEntry& entry) {
+        shader = entry.shader;
+        entry.Touch();
+    });
+    return shader;
+}
+
+void ShaderManager::AddToCache(const ShaderKey& key, std::shared_ptr<CompiledD3DShader> shader) {
+    if (m_shaderCache.Size() >= m_config.maxCacheSize) {
+        RemoveLeastRecentlyUsed();
+    }
+    m_shaderCache.InsertOrAssign(key, std::move(shader));
+}
+
+void ShaderManager::RecordCacheAccess(const ShaderKey& key) {
+    m_shaderCache.Visit(key, [](const ShaderCacheEntry& entry) { entry.Touch(); });
+}
+
+void ShaderManager::ClearCache() {
+    m_shaderCache.Clear();
+    XESS_INFO("Shader cache cleared");
+}
+
+void ShaderManager::CompactCache() {
+    EvictLeastRecentlyUsed(m_config.maxCacheSize / 2);
+}
+
+void ShaderManager::RemoveLeastRecentlyUsed() {
+    // Evict a batch, so a full cache does not evict on every insert
+    EvictLeastRecentlyUsed(m_config.maxCacheSize - m_config.maxCacheSize / 4);
+}
+
+void ShaderManager::EvictLeastRecentlyUsed(size_t targetSize) {
+    std::vector<int64> stamps;
+    stamps.reserve(m_shaderCache.Size());
+    m_shaderCache.ForEach([&stamps](const ShaderKey&, const ShaderCacheEntry& entry) {
+        stamps.push_back(entry.lastAccessTime.load(std::memory_order_relaxed));
+    });
+    if (stamps.size() <= targetSize) {
+        return;
+    }
+
+    // Everything stamped at or before the cutoff goes; ties may take a few more
+    size_t evictCount = stamps.size() - targetSize;
+    std::nth_element(stamps.begin(), stamps.begin() + (evictCount - 1), stamps.end());
+    int64 cutoff = stamps[evictCount - 1];
+
+    size_t evicted = m_shaderCache.EraseIf([cutoff](const ShaderKey&, const ShaderCacheEntry& entry) {
+        return entry.lastAccessTime.load(std::memory_order_relaxed) <= cutoff;
+    });
+    XESS_DEBUG("Evicted {} shaders from the cache ({} left)", evicted, m_shaderCache.Size());
+}
+
+} // namespace XeSS::Graphics
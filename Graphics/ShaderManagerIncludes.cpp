@@ -0,0 +1,47 @@
+#include "ShaderManager.h"
+#include "ShaderCompiler/ShaderPreprocessor.h"
+#include "Core/Logger.h"
+#include <algorithm>
+
+namespace XeSS::Graphics {
+
+// Include system: both paths go through the shared IncludeCache, so a header
+// read here is not read again by the next compile that includes it
+
+void ShaderManager::AddIncludeDirectory(const std::string& directory) {
+    std::string normalized = std::filesystem::path(directory).lexically_normal().generic_string();
+    if (std::find(m_includeDirectories.begin(), m_includeDirectories.end(), normalized) == m_includeDirectories.end()) {
+        m_includeDirectories.push_back(std::move(normalized));
+    }
+}
+
+void ShaderManager::RemoveIncludeDirectory(const std::string& directory) {
+    std::string normalized = std::filesystem::path(directory).lexically_normal().generic_string();
+    m_includeDirectories.erase(
+        std::remove(m_includeDirectories.begin(), m_includeDirectories.end(), normalized),
+        m_includeDirectories.end());
+}
+
+std::string ShaderManager::ResolveIncludePath(const std::string& filename) const {
+    std::filesystem::path resolved = ShaderPreprocessor::ResolveInclude(
+        filename, true, m_config.shaderDirectory, m_includeDirectories);
+    return resolved.empty() ? std::string() : resolved.lexically_normal().generic_string();
+}
+
+std::string ShaderManager::ProcessIncludes(const std::string& source, const std::string& baseDir) const {
+    PreprocessOptions options;
+    options.includePaths = m_includeDirectories;
+    options.baseDirectory = baseDir;
+
+    ShaderPreprocessor preprocessor;
+    PreprocessResult result = preprocessor.Preprocess(source, "", options);
+    if (!result.success) {
+        for (const std::string& error : result.errors) {
+            XESS_ERROR("Shader include processing failed: {}", error);
+        }
+        return {};
+    }
+    return std::move(result.output);
+}
+
+} // namespace XeSS::Graphics
@@ -0,0 +1,30 @@
+#include "ShaderManager.h"
+#include "Device.h"
+#include "Core/Logger.h"
+
+namespace XeSS::Graphics {
+
+// D3D object creation: every path goes through m_shaderObjects, so
+// permutations that compile to the same program share one driver object.
+// Async loads and prefetch queue theirs on m_creationQueue instead.
+
+void ShaderManager::CreateD3DShaderFromBytecode(CompiledD3DShader& shader) {
+    const std::vector<uint8>& bytecode = shader.compilationResult.bytecode;
+    if (bytecode.empty() || !m_device.GetDevice()) {
+        return;
+    }
+
+    ShaderType type;
+    if (!ShaderObjectTable::ReadShaderType(bytecode, type)) {
+        XESS_ERROR("Cannot read the shader stage from {} bytes of bytecode", bytecode.size());
+        shader.compilationResult.success = false;
+        return;
+    }
+
+    // Synchronous callers wait on the result, so this skips the creation queue
+    if (!m_creationQueue.CreateNow(shader, type)) {
+        shader.compilationResult.success = false;
+    }
+}
+
+} // namespace XeSS::Graphics
@@ -0,0 +1,113 @@
+#include "ShaderManager.h"
+#include "Core/FileSystem.h"
+#include "Core/Logger.h"
+#include <algorithm>
+
+namespace XeSS::Graphics {
+
+// Usage profile: Shader loads record their permutation with the current
+// frame index; Device::Shutdown saves the profile. On the next launch the
+// startup graph calls PrefetchFromUsageProfile(), which compiles the recorded
+// permutations into the cache in first-use order before they are requested.
+// Their D3D objects are made at prefetch priority on the creation queue, so
+// they only use frame budget that visible loads leave.
+
+namespace {
+    MetricCounter& s_prefetched = MetricsRegistry::Instance().Counter(
+        "shader.prefetched", "Shaders compiled ahead of use from the usage profile");
+}
+
+void ShaderManager::RecordShaderUsage(const std::string& filename, const std::string& entryPoint,
+                                      ShaderType type, const CompileOptions& options) {
+    if (!m_config.usageProfileFile.empty() && !filename.empty()) {
+        m_usageProfile.Record(filename, entryPoint, type, options);
+    }
+}
+
+void ShaderManager::PrefetchFromUsageProfile() {
+    if (m_config.usageProfileFile.empty() || !m_prefetchJobs.IsDone() ||
+        !m_usageProfile.Load(m_config.usageProfileFile)) {
+        return;
+    }
+
+    // Inline jobs would compile everything up front on this thread
+    JobSystem& jobs = JobSystem::Instance();
+    if (!jobs.IsInitialized()) {
+        XESS_DEBUG("JobSystem not running, skipping shader prefetch");
+        return;
+    }
+
+    m_prefetchQueue = m_usageProfile.GetPrefetchList();
+    m_prefetchNext.store(0, std::memory_order_relaxed);
+    m_prefetchStopped.store(false, std::memory_order_release);
+    XESS_INFO("Prefetching {} shader permutations", m_prefetchQueue.size());
+
+    uint32 chains = std::clamp<uint32>(m_config.maxPrefetchJobs, 1, std::max<uint32>(jobs.GetWorkerCount(), 1));
+    for (uint32 i = 0; i < chains; ++i) {
+        PrefetchNext();
+    }
+}
+
+void ShaderManager::PrefetchNext() {
+    if (m_prefetchStopped.load(std::memory_order_acquire)) {
+        return;
+    }
+    size_t index = m_prefetchNext.fetch_add(1, std::memory_order_relaxed);
+    if (index >= m_prefetchQueue.size()) {
+        return;
+    }
+
+    // Each entry queues its successor once done, so no more than
+    // maxPrefetchJobs are in flight and earlier first-use frames go first
+    JobSystem::Instance().Submit([this, index]() {
+        if (m_prefetchStopped.load(std::memory_order_acquire) || !PrefetchEntry(m_prefetchQueue[index])) {
+            PrefetchNext();
+        }
+    }, &m_prefetchJobs);
+}
+
+bool ShaderManager::PrefetchEntry(const ShaderUsageEntry& entry) {
+    try {
+        // The profile may name shaders removed since it was written
+        std::string source;
+        if (!std::filesystem::exists(entry.filename) || !FileSystem::Instance().ReadText(entry.filename, source)) {
+            return false;
+        }
+
+        auto shader = std::make_shared<CompiledD3DShader>();
+        shader->compilationResult = m_compiler.CompileFromSource(
+            source, entry.entryPoint, entry.type, entry.options, entry.filename);
+        if (!shader->IsValid()) {
+            return false;
+        }
+        ExtractShaderReflection(*shader);
+
+        // The chain continues from the completion, which may run inline
+        ShaderKey key = CreateShaderKey(source, entry.entryPoint, entry.type, entry.options);
+        m_creationQueue.Submit(*shader, entry.type, ShaderCreationPriority::Prefetch,
+            [this, shader, key](bool created) {
+                if (created && !m_prefetchStopped.load(std::memory_order_acquire)) {
+                    AddToCache(key, shader);
+                    s_prefetched.Add();
+                }
+                PrefetchNext();
+            });
+        return true;
+    }
+    catch (const std::exception& e) {
+        XESS_WARNING("Shader prefetch of {} failed: {}", entry.filename, e.what());
+        return false;
+    }
+}
+
+void ShaderManager::SaveUsageProfile() {
+    m_prefetchStopped.store(true, std::memory_order_release);
+    JobSystem::Instance().Wait(m_prefetchJobs);
+
+    // A session that loaded no shaders says nothing about the next one
+    if (!m_config.usageProfileFile.empty() && m_usageProfile.GetRecordedCount() > 0) {
+        m_usageProfile.Save(m_config.usageProfileFile);
+    }
+}
+
+} // namespace XeSS::Graphics
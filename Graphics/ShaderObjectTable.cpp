@@ -0,0 +1,223 @@
+#include "ShaderObjectTable.h"
+#include "Shader.h"
+#include "Core/Logger.h"
+#include "Core/Metrics.h"
+#include <cstring>
+#include <string_view>
+
+namespace XeSS::Graphics {
+
+namespace {
+    MetricsRegistry& Registry() { return MetricsRegistry::Instance(); }
+
+    MetricCounter& s_objectsCreated = Registry().Counter("shader.objects_created", "D3D shader objects created");
+    MetricCounter& s_objectsShared = Registry().Counter("shader.objects_shared",
+                                                        "Shader loads that reused an existing D3D object");
+    MetricGauge& s_objectsLive = Registry().Gauge("shader.objects_live", "D3D shader objects alive");
+
+    // DXBC container: "DXBC", 16-byte digest, version, total size, chunk count, chunk offsets
+    constexpr size_t ContainerHeaderSize = 32;
+    constexpr size_t ContainerDigestOffset = 4;
+    constexpr size_t ContainerChunkCountOffset = 28;
+
+    uint32 ReadU32(const std::vector<uint8>& data, size_t offset) {
+        uint32 value;
+        memcpy(&value, data.data() + offset, sizeof(value));
+        return value;
+    }
+
+    uint64 Fnv1a(const std::vector<uint8>& data) {
+        uint64 hash = 0xcbf29ce484222325ull;
+        for (uint8 byte : data) {
+            hash = (hash ^ byte) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+}
+
+void InternedShaderObject::AssignTo(CompiledD3DShader& shader) const {
+    switch (type) {
+        case ShaderType::Vertex: object.As(&shader.vertexShader); break;
+        case ShaderType::Hull: object.As(&shader.hullShader); break;
+        case ShaderType::Domain: object.As(&shader.domainShader); break;
+        case ShaderType::Geometry: object.As(&shader.geometryShader); break;
+        case ShaderType::Pixel: object.As(&shader.pixelShader); break;
+        case ShaderType::Compute: object.As(&shader.computeShader); break;
+        default: break;
+    }
+}
+
+ShaderObjectTable::ShaderObjectTable()
+    : m_state(std::make_shared<State>()) {}
+
+std::shared_ptr<const InternedShaderObject> ShaderObjectTable::Acquire(
+    ID3D11Device* device, ShaderType type, const std::vector<uint8>& bytecode) {
+
+    if (!device || bytecode.empty()) {
+        return nullptr;
+    }
+
+    Key key = MakeKey(type, bytecode);
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        auto it = m_state->objects.find(key);
+        if (it != m_state->objects.end()) {
+            if (auto existing = it->second.lock()) {
+                s_objectsShared.Add();
+                return existing;
+            }
+        }
+    }
+
+    // Driver compilation is the slow part; keep it out of the lock
+    ComPtr<ID3D11DeviceChild> object = CreateObject(device, type, bytecode);
+    if (!object) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    std::weak_ptr<InternedShaderObject>& slot = m_state->objects[key];
+    if (auto existing = slot.lock()) {
+        // Another thread created the same program meanwhile; ours is dropped
+        s_objectsShared.Add();
+        return existing;
+    }
+
+    std::weak_ptr<State> state = m_state;
+    std::shared_ptr<InternedShaderObject> interned(
+        new InternedShaderObject{type, std::move(object)},
+        [state, key](InternedShaderObject* released) {
+            if (auto table = state.lock()) {
+                std::lock_guard<std::mutex> lock(table->mutex);
+                auto it = table->objects.find(key);
+                if (it != table->objects.end() && it->second.expired()) {
+                    table->objects.erase(it);
+                }
+            }
+            s_objectsLive.Add(-1.0);
+            delete released;
+        });
+    slot = interned;
+
+    s_objectsCreated.Add();
+    s_objectsLive.Add(1.0);
+    return interned;
+}
+
+size_t ShaderObjectTable::GetLiveCount() const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    size_t live = 0;
+    for (const auto& [key, object] : m_state->objects) {
+        live += object.expired() ? 0 : 1;
+    }
+    return live;
+}
+
+bool ShaderObjectTable::ReadShaderType(const std::vector<uint8>& bytecode, ShaderType& type) {
+    if (bytecode.size() < ContainerHeaderSize || memcmp(bytecode.data(), "DXBC", 4) != 0) {
+        return false;
+    }
+
+    uint32 chunkCount = ReadU32(bytecode, ContainerChunkCountOffset);
+    for (uint32 i = 0; i < chunkCount; ++i) {
+        size_t offsetPosition = ContainerHeaderSize + size_t(i) * 4;
+        if (offsetPosition + 4 > bytecode.size()) {
+            return false;
+        }
+        size_t chunk = ReadU32(bytecode, offsetPosition);
+        if (chunk + 12 > bytecode.size()) {
+            return false;
+        }
+
+        // FXC program chunks start with the version token, the DXIL part with
+        // its program header; both keep the stage in the upper 16 bits
+        if (memcmp(&bytecode[chunk], "SHDR", 4) != 0 && memcmp(&bytecode[chunk], "SHEX", 4) != 0 &&
+            memcmp(&bytecode[chunk], "DXIL", 4) != 0) {
+            continue;
+        }
+        switch (ReadU32(bytecode, chunk + 8) >> 16) {
+            case 0: type = ShaderType::Pixel; return true;
+            case 1: type = ShaderType::Vertex; return true;
+            case 2: type = ShaderType::Geometry; return true;
+            case 3: type = ShaderType::Hull; return true;
+            case 4: type = ShaderType::Domain; return true;
+            case 5: type = ShaderType::Compute; return true;
+            case 13: type = ShaderType::Mesh; return true;
+            case 14: type = ShaderType::Amplification; return true;
+            default: return false;
+        }
+    }
+    return false;
+}
+
+ShaderObjectTable::Key ShaderObjectTable::MakeKey(ShaderType type, const std::vector<uint8>& bytecode) {
+    Key key{{0, 0}, bytecode.size(), type};
+
+    // Signed containers carry a digest of their contents; unsigned ones leave it zero
+    if (bytecode.size() >= ContainerHeaderSize && memcmp(bytecode.data(), "DXBC", 4) == 0) {
+        memcpy(key.digest, bytecode.data() + ContainerDigestOffset, sizeof(key.digest));
+    }
+    if (key.digest[0] == 0 && key.digest[1] == 0) {
+        key.digest[0] = std::hash<std::string_view>{}(
+            std::string_view(reinterpret_cast<const char*>(bytecode.data()), bytecode.size()));
+        key.digest[1] = Fnv1a(bytecode);
+    }
+    return key;
+}
+
+ComPtr<ID3D11DeviceChild> ShaderObjectTable::CreateObject(ID3D11Device* device, ShaderType type,
+                                                          const std::vector<uint8>& bytecode) {
+    const void* data = bytecode.data();
+    size_t size = bytecode.size();
+
+    HRESULT hr = E_INVALIDARG;
+    ComPtr<ID3D11DeviceChild> object;
+    switch (type) {
+        case ShaderType::Vertex: {
+            ComPtr<ID3D11VertexShader> shader;
+            hr = device->CreateVertexShader(data, size, nullptr, &shader);
+            object = shader;
+            break;
+        }
+        case ShaderType::Hull: {
+            ComPtr<ID3D11HullShader> shader;
+            hr = device->CreateHullShader(data, size, nullptr, &shader);
+            object = shader;
+            break;
+        }
+        case ShaderType::Domain: {
+            ComPtr<ID3D11DomainShader> shader;
+            hr = device->CreateDomainShader(data, size, nullptr, &shader);
+            object = shader;
+            break;
+        }
+        case ShaderType::Geometry: {
+            ComPtr<ID3D11GeometryShader> shader;
+            hr = device->CreateGeometryShader(data, size, nullptr, &shader);
+            object = shader;
+            break;
+        }
+        case ShaderType::Pixel: {
+            ComPtr<ID3D11PixelShader> shader;
+            hr = device->CreatePixelShader(data, size, nullptr, &shader);
+            object = shader;
+            break;
+        }
+        case ShaderType::Compute: {
+            ComPtr<ID3D11ComputeShader> shader;
+            hr = device->CreateComputeShader(data, size, nullptr, &shader);
+            object = shader;
+            break;
+        }
+        default:
+            break;
+    }
+
+    if (FAILED(hr)) {
+        XESS_ERROR("Failed to create D3D11 shader object: 0x{:08X}", static_cast<uint32>(hr));
+        return nullptr;
+    }
+    return object;
+}
+
+} // namespace XeSS::Graphics
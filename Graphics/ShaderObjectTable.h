@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include "ShaderCompiler/ShaderCompiler.h"
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace XeSS::Graphics {
+
+using Microsoft::WRL::ComPtr;
+
+struct CompiledD3DShader;
+
+// Driver shader object shared by every CompiledD3DShader with the same bytecode
+struct InternedShaderObject {
+    ShaderType type;
+    ComPtr<ID3D11DeviceChild> object;
+
+    // Fills the typed pointer of shader that matches type
+    void AssignTo(CompiledD3DShader& shader) const;
+};
+
+/**
+ * Intern table from bytecode to D3D11 shader objects. Permutations that
+ * compile to the same program (common once dead code is eliminated) get one
+ * driver object between them instead of one each.
+ *
+ * Objects are keyed by the container digest, or a hash of the bytes for
+ * unsigned containers, and reference counted through shared_ptr: the table
+ * holds weak references and drops an entry when its last user releases it.
+ */
+class ShaderObjectTable : public NonCopyable {
+public:
+    ShaderObjectTable();
+
+    // Returns the shared object for bytecode, creating it on first use; null
+    // if the driver rejects the bytecode. Thread-safe; creation runs unlocked.
+    std::shared_ptr<const InternedShaderObject> Acquire(ID3D11Device* device, ShaderType type,
+                                                        const std::vector<uint8>& bytecode);
+
+    size_t GetLiveCount() const;
+
+    // Stage recorded in a DXBC or DXIL container; false if it cannot be read
+    static bool ReadShaderType(const std::vector<uint8>& bytecode, ShaderType& type);
+
+private:
+    struct Key {
+        uint64 digest[2];
+        uint64 size;
+        ShaderType type;
+
+        bool operator==(const Key& other) const {
+            return digest[0] == other.digest[0] && digest[1] == other.digest[1] &&
+                   size == other.size && type == other.type;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const { return static_cast<size_t>(key.digest[0] ^ key.size); }
+    };
+
+    // Shared with the deleters, so objects may outlive the table
+    struct State {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, std::weak_ptr<InternedShaderObject>, KeyHash> objects;
+    };
+
+    static Key MakeKey(ShaderType type, const std::vector<uint8>& bytecode);
+    static ComPtr<ID3D11DeviceChild> CreateObject(ID3D11Device* device, ShaderType type,
+                                                  const std::vector<uint8>& bytecode);
+
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace XeSS::Graphics
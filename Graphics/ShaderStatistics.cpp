@@ -0,0 +1,76 @@
+#include "ShaderStatistics.h"
+
+namespace XeSS::Graphics {
+
+namespace {
+    MetricsRegistry& Registry() { return MetricsRegistry::Instance(); }
+
+    MetricCounter& s_compilations = Registry().Counter("shader.compilations", "Shader compilations");
+    MetricCounter& s_cacheHits = Registry().Counter("shader.cache_hits", "Shader cache hits");
+    MetricCounter& s_cacheMisses = Registry().Counter("shader.cache_misses", "Shader cache misses");
+    MetricCounter& s_compileErrors = Registry().Counter("shader.compile_errors", "Failed shader compilations");
+    MetricCounter& s_asyncCompilations = Registry().Counter("shader.async_compilations", "Asynchronous compilations");
+    MetricCounter& s_hotReloads = Registry().Counter("shader.hot_reloads", "Shader hot reloads");
+    MetricHistogram& s_compileTime = Registry().Histogram("shader.compile_time_ms", "Shader compile time in ms",
+                                                          MetricHistogram::ExponentialBounds(0.5, 2.0, 14));
+    MetricGauge& s_cacheEntries = Registry().Gauge("shader.cache_entries", "Shaders in the cache");
+    MetricGauge& s_cacheBytes = Registry().Gauge("shader.cache_bytes", "Shader cache memory in bytes");
+
+    uint32 CounterValue(const MetricsSnapshot& snapshot, const char* name) {
+        return static_cast<uint32>(snapshot.Value(name));
+    }
+}
+
+ShaderStatistics ShaderStatistics::FromSnapshot(const MetricsSnapshot& snapshot) {
+    ShaderStatistics statistics;
+    statistics.totalCompilations = CounterValue(snapshot, "shader.compilations");
+    statistics.cacheHits = CounterValue(snapshot, "shader.cache_hits");
+    statistics.cacheMisses = CounterValue(snapshot, "shader.cache_misses");
+    statistics.compilationErrors = CounterValue(snapshot, "shader.compile_errors");
+    statistics.asyncCompilations = CounterValue(snapshot, "shader.async_compilations");
+    statistics.hotReloads = CounterValue(snapshot, "shader.hot_reloads");
+
+    if (const MetricSample* compileTime = snapshot.Find("shader.compile_time_ms")) {
+        statistics.totalCompileTimeMs = compileTime->sum;
+        statistics.averageCompileTimeMs = compileTime->count > 0 ? compileTime->sum / compileTime->count : 0.0;
+    }
+
+    statistics.currentCacheSize = CounterValue(snapshot, "shader.cache_entries");
+    statistics.currentMemoryUsageMB = static_cast<uint32>(snapshot.Value("shader.cache_bytes") / (1024 * 1024));
+    return statistics;
+}
+
+namespace ShaderMetrics {
+
+void RecordCompilation(double timeMs, bool fromCache, bool error) {
+    if (fromCache) {
+        s_cacheHits.Add();
+        return;
+    }
+
+    s_cacheMisses.Add();
+    if (error) {
+        s_compileErrors.Add();
+        return;
+    }
+
+    s_compilations.Add();
+    s_compileTime.Observe(timeMs);
+}
+
+void RecordAsyncCompilation() {
+    s_asyncCompilations.Add();
+}
+
+void RecordHotReload() {
+    s_hotReloads.Add();
+}
+
+void SetCacheUsage(uint32 entries, uint64 bytes) {
+    s_cacheEntries.Set(entries);
+    s_cacheBytes.Set(static_cast<float64>(bytes));
+}
+
+} // namespace ShaderMetrics
+
+} // namespace XeSS::Graphics
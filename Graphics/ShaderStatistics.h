@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/Metrics.h"
+
+namespace XeSS::Graphics {
+
+// Shader compilation statistics, read from the metrics registry. Values are
+// a snapshot: counters cover the period since the owning ShaderManager last
+// reset its statistics, cache size and memory are current.
+struct ShaderStatistics {
+    uint32 totalCompilations = 0;
+    uint32 cacheHits = 0;
+    uint32 cacheMisses = 0;
+    uint32 compilationErrors = 0;
+    uint32 asyncCompilations = 0;
+    uint32 hotReloads = 0;
+
+    double averageCompileTimeMs = 0.0;
+    double totalCompileTimeMs = 0.0;
+
+    uint32 currentCacheSize = 0;
+    uint32 currentMemoryUsageMB = 0;
+
+    double GetCacheHitRatio() const {
+        uint32 total = cacheHits + cacheMisses;
+        return total > 0 ? static_cast<double>(cacheHits) / total : 0.0;
+    }
+
+    static ShaderStatistics FromSnapshot(const MetricsSnapshot& snapshot);
+};
+
+// Recording side, safe to call from any thread including async compiles
+namespace ShaderMetrics {
+    void RecordCompilation(double timeMs, bool fromCache, bool error = false);
+    void RecordAsyncCompilation();
+    void RecordHotReload();
+    void SetCacheUsage(uint32 entries, uint64 bytes);
+}
+
+} // namespace XeSS::Graphics
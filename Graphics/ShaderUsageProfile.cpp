@@ -0,0 +1,285 @@
+#include "ShaderUsageProfile.h"
+#include "Core/Logger.h"
+#include "Core/FileSystem.h"
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+namespace XeSS::Graphics {
+
+// Profile format: a header line, then one line per permutation with
+// tab-separated fields
+//   firstUseFrame idleSessions type model flags optimizationLevel file entry [D name=value]... [I path]...
+// Backslash, tab and newline inside fields are escaped.
+
+namespace {
+    constexpr char ProfileHeader[] = "# XeSS shader usage profile v1";
+
+    enum OptionFlags : uint32 {
+        DebugInfo = 1 << 0,
+        Optimization = 1 << 1,
+        WarningsAsErrors = 1 << 2,
+        Ieee754 = 1 << 3,
+        UnboundedArrays = 1 << 4,
+        StripDebugData = 1 << 5,
+        Preprocess = 1 << 6
+    };
+
+    uint32 PackFlags(const CompileOptions& options) {
+        return (options.enableDebugInfo ? DebugInfo : 0) |
+               (options.enableOptimization ? Optimization : 0) |
+               (options.warningsAsErrors ? WarningsAsErrors : 0) |
+               (options.ieee754Compliance ? Ieee754 : 0) |
+               (options.enableUnboundedResourceArrays ? UnboundedArrays : 0) |
+               (options.stripDebugData ? StripDebugData : 0) |
+               (options.preprocess ? Preprocess : 0);
+    }
+
+    void UnpackFlags(uint32 flags, CompileOptions& options) {
+        options.enableDebugInfo = (flags & DebugInfo) != 0;
+        options.enableOptimization = (flags & Optimization) != 0;
+        options.warningsAsErrors = (flags & WarningsAsErrors) != 0;
+        options.ieee754Compliance = (flags & Ieee754) != 0;
+        options.enableUnboundedResourceArrays = (flags & UnboundedArrays) != 0;
+        options.stripDebugData = (flags & StripDebugData) != 0;
+        options.preprocess = (flags & Preprocess) != 0;
+    }
+
+    void AppendField(std::string& line, std::string_view field) {
+        line += '\t';
+        for (char c : field) {
+            switch (c) {
+                case '\\': line += "\\\\"; break;
+                case '\t': line += "\\t"; break;
+                case '\n': line += "\\n"; break;
+                case '\r': line += "\\r"; break;
+                default: line += c; break;
+            }
+        }
+    }
+
+    std::string Unescape(std::string_view field) {
+        std::string text;
+        text.reserve(field.size());
+        for (size_t i = 0; i < field.size(); ++i) {
+            if (field[i] != '\\' || i + 1 == field.size()) {
+                text += field[i];
+                continue;
+            }
+            switch (field[++i]) {
+                case 't': text += '\t'; break;
+                case 'n': text += '\n'; break;
+                case 'r': text += '\r'; break;
+                default: text += field[i]; break;
+            }
+        }
+        return text;
+    }
+
+    std::vector<std::string_view> SplitFields(std::string_view line) {
+        std::vector<std::string_view> fields;
+        size_t start = 0;
+        while (true) {
+            size_t tab = line.find('\t', start);
+            fields.push_back(line.substr(start, tab - start));
+            if (tab == std::string_view::npos) {
+                return fields;
+            }
+            start = tab + 1;
+        }
+    }
+
+    template <typename T>
+    bool ParseNumber(std::string_view text, T& value) {
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool ParseEntry(std::string_view line, ShaderUsageEntry& entry) {
+        std::vector<std::string_view> fields = SplitFields(line);
+        if (fields.size() < 8) {
+            return false;
+        }
+
+        uint32 type = 0;
+        uint32 model = 0;
+        uint32 flags = 0;
+        if (!ParseNumber(fields[0], entry.firstUseFrame) || !ParseNumber(fields[1], entry.idleSessions) ||
+            !ParseNumber(fields[2], type) || !ParseNumber(fields[3], model) ||
+            !ParseNumber(fields[4], flags) || !ParseNumber(fields[5], entry.options.optimizationLevel) ||
+            type > static_cast<uint32>(ShaderType::AnyHit)) {
+            return false;
+        }
+        entry.type = static_cast<ShaderType>(type);
+        entry.options.targetModel = static_cast<ShaderModel>(model);
+        UnpackFlags(flags, entry.options);
+        entry.filename = Unescape(fields[6]);
+        entry.entryPoint = Unescape(fields[7]);
+
+        for (size_t i = 8; i < fields.size(); ++i) {
+            std::string value = Unescape(fields[i]);
+            if (value.size() < 2 || value[1] != ' ') {
+                return false;
+            }
+            if (value[0] == 'D') {
+                size_t equals = value.find('=', 2);
+                entry.options.macros.push_back({value.substr(2, equals - 2),
+                                                equals == std::string::npos ? "" : value.substr(equals + 1)});
+            } else if (value[0] == 'I') {
+                entry.options.includePaths.push_back(value.substr(2));
+            } else {
+                return false;
+            }
+        }
+        return !entry.filename.empty() && !entry.entryPoint.empty();
+    }
+
+    std::string FormatEntry(const ShaderUsageEntry& entry, const std::string& identity) {
+        return std::to_string(entry.firstUseFrame) + '\t' + std::to_string(entry.idleSessions) + identity;
+    }
+}
+
+std::string ShaderUsageProfile::MakeIdentity(const ShaderUsageEntry& entry) {
+    std::string identity;
+    AppendField(identity, std::to_string(static_cast<uint32>(entry.type)));
+    AppendField(identity, std::to_string(static_cast<uint32>(entry.options.targetModel)));
+    AppendField(identity, std::to_string(PackFlags(entry.options)));
+    AppendField(identity, std::to_string(entry.options.optimizationLevel));
+    AppendField(identity, entry.filename);
+    AppendField(identity, entry.entryPoint);
+    for (const ShaderMacro& macro : entry.options.macros) {
+        AppendField(identity, "D " + macro.name + "=" + macro.definition);
+    }
+    for (const std::string& includePath : entry.options.includePaths) {
+        AppendField(identity, "I " + includePath);
+    }
+    return identity;
+}
+
+bool ShaderUsageProfile::Load(const std::string& path) {
+    std::string text;
+    if (!std::filesystem::exists(path) || !FileSystem::Instance().ReadText(path, text)) {
+        return false;
+    }
+
+    std::vector<ShaderUsageEntry> entries;
+    uint32 malformed = 0;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        std::string_view line = std::string_view(text).substr(start, end - start);
+        start = end == std::string::npos ? text.size() : end + 1;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        ShaderUsageEntry entry;
+        if (ParseEntry(line, entry)) {
+            entries.push_back(std::move(entry));
+        } else {
+            ++malformed;
+        }
+    }
+    if (malformed > 0) {
+        XESS_WARNING("Skipped {} malformed lines in shader usage profile {}", malformed, path);
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const ShaderUsageEntry& a, const ShaderUsageEntry& b) {
+        return a.firstUseFrame < b.firstUseFrame;
+    });
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loaded = std::move(entries);
+    XESS_INFO("Loaded shader usage profile {} ({} permutations)", path, m_loaded.size());
+    return true;
+}
+
+bool ShaderUsageProfile::Save(const std::string& path) const {
+    std::vector<std::pair<ShaderUsageEntry, std::string>> entries;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const ShaderUsageEntry& entry : m_recorded) {
+            entries.emplace_back(entry, MakeIdentity(entry));
+        }
+
+        // Keep what other sessions used, aging it until it drops out
+        for (const ShaderUsageEntry& entry : m_loaded) {
+            std::string identity = MakeIdentity(entry);
+            if (entry.idleSessions < MaxIdleSessions && !m_recordedIndex.contains(identity)) {
+                entries.emplace_back(entry, std::move(identity));
+                entries.back().first.idleSessions++;
+            }
+        }
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.first.firstUseFrame < b.first.firstUseFrame;
+    });
+
+    try {
+        std::filesystem::path target(path);
+        if (target.has_parent_path()) {
+            std::filesystem::create_directories(target.parent_path());
+        }
+
+        // Write beside the target and rename, so a crash never leaves half a profile
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                XESS_WARNING("Failed to write shader usage profile: {}", temporary);
+                return false;
+            }
+            file << ProfileHeader << '\n';
+            for (const auto& [entry, identity] : entries) {
+                file << FormatEntry(entry, identity) << '\n';
+            }
+            if (!file.good()) {
+                XESS_WARNING("Failed to write shader usage profile: {}", temporary);
+                return false;
+            }
+        }
+        std::filesystem::rename(temporary, target);
+    }
+    catch (const std::exception& e) {
+        XESS_WARNING("Failed to save shader usage profile {}: {}", path, e.what());
+        return false;
+    }
+
+    XESS_DEBUG("Saved shader usage profile {} ({} permutations)", path, entries.size());
+    return true;
+}
+
+void ShaderUsageProfile::Record(const std::string& filename, const std::string& entryPoint,
+                                ShaderType type, const CompileOptions& options) {
+    ShaderUsageEntry entry;
+    entry.filename = filename;
+    entry.entryPoint = entryPoint;
+    entry.type = type;
+    entry.options = options;
+    entry.firstUseFrame = GetFrame();
+
+    std::string identity = MakeIdentity(entry);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_recordedIndex.try_emplace(std::move(identity), m_recorded.size()).second) {
+        m_recorded.push_back(std::move(entry));
+    }
+}
+
+std::vector<ShaderUsageEntry> ShaderUsageProfile::GetPrefetchList() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_loaded;
+}
+
+size_t ShaderUsageProfile::GetRecordedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_recorded.size();
+}
+
+} // namespace XeSS::Graphics
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include "ShaderCompiler/ShaderCompiler.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace XeSS::Graphics {
+
+// One (shader, permutation) request
+struct ShaderUsageEntry {
+    std::string filename;
+    std::string entryPoint;
+    ShaderType type = ShaderType::Vertex;
+    CompileOptions options;
+    uint64 firstUseFrame = 0;
+    uint32 idleSessions = 0;    // Sessions since it was last requested
+};
+
+/**
+ * Records which shader permutations a session requests and the frame each
+ * was first used on, and persists them as a small text profile. The next
+ * launch reads the profile back and prefetches in first-use order.
+ *
+ * Entries no session has requested for MaxIdleSessions launches are dropped
+ * on save, so the profile follows the content being played.
+ */
+class ShaderUsageProfile : public NonCopyable {
+public:
+    static constexpr uint32 MaxIdleSessions = 3;
+
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+
+    void SetFrame(uint64 frame) { m_frame.store(frame, std::memory_order_relaxed); }
+    uint64 GetFrame() const { return m_frame.load(std::memory_order_relaxed); }
+
+    // Thread-safe; only the first request of a permutation is kept
+    void Record(const std::string& filename, const std::string& entryPoint,
+                ShaderType type, const CompileOptions& options);
+
+    // Entries of the loaded profile, by first-use frame
+    std::vector<ShaderUsageEntry> GetPrefetchList() const;
+    size_t GetRecordedCount() const;
+
+private:
+    static std::string MakeIdentity(const ShaderUsageEntry& entry);
+
+    std::atomic<uint64> m_frame{0};
+
+    mutable std::mutex m_mutex;
+    std::vector<ShaderUsageEntry> m_loaded;
+    std::vector<ShaderUsageEntry> m_recorded;
+    std::unordered_map<std::string, size_t> m_recordedIndex;    // Identity -> m_recorded index
+};
+
+} // namespace XeSS::Graphics
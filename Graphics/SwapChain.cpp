@@ -1,6 +1,8 @@
 #include "SwapChain.h"
 #include "Core/Logger.h"
 #include "Core/Exception.h"
+#include "Core/MemoryTags.h"
+#include <thread>
 
 namespace XeSS::Graphics {
 
@@ -171,11 +173,19 @@ void SwapChain::CreateBackBufferViews(Device& device) {
             "Failed to create back buffer RTV " + std::to_string(i)
         );
     }
+
+    const uint64 bytesPerPixel = m_desc.format == DXGI_FORMAT_R16G16B16A16_FLOAT ? 8 : 4;
+    m_trackedBytes = static_cast<uint64>(m_desc.resolution.width) * m_desc.resolution.height *
+                     bytesPerPixel * m_desc.bufferCount;
+    MemoryTags::Allocate(MemoryTag::SwapChain, m_trackedBytes);
 }
 
 void SwapChain::ReleaseBackBufferViews() {
     m_backBufferRTVs.clear();
     m_backBuffers.clear();
+
+    MemoryTags::Free(MemoryTag::SwapChain, m_trackedBytes);
+    m_trackedBytes = 0;
 }
 
 ID3D11Texture2D* SwapChain::GetBackBuffer(uint32 index) const {
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "Core/Types.h"
-#include "Core/NonCopyable.h"
 #include "Device.h"
+#include "GraphicsInterfaces.h"
 #include <dxgi1_3.h>
 #include <wrl/client.h>
 
@@ -19,7 +19,7 @@ struct SwapChainDesc {
     HWND windowHandle{nullptr};
 };
 
-class SwapChain : public NonCopyable {
+class SwapChain : public ISwapChain {
 public:
     SwapChain();
     ~SwapChain();
@@ -27,8 +27,8 @@ public:
     void Initialize(Device& device, const SwapChainDesc& desc);
     void Shutdown();
 
-    void Present(bool vsync = false);
-    void Resize(const Resolution& newResolution);
+    void Present(bool vsync = false) override;
+    void Resize(const Resolution& newResolution) override;
 
     // Getters
     IDXGISwapChain3* GetSwapChain() const { return m_swapChain.Get(); }
@@ -37,7 +37,7 @@ public:
 
     uint32 GetCurrentBackBufferIndex() const;
     const SwapChainDesc& GetDesc() const { return m_desc; }
-    Resolution GetResolution() const { return m_desc.resolution; }
+    Resolution GetResolution() const override { return m_desc.resolution; }
 
     // Utility
     void SetFullscreenState(bool fullscreen);
@@ -54,6 +54,7 @@ private:
 
     SwapChainDesc m_desc{};
     bool m_initialized{false};
+    uint64 m_trackedBytes{0};
 };
 
 } // namespace XeSS::Graphics
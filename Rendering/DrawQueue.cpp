@@ -0,0 +1,73 @@
+#include "DrawQueue.h"
+#include "Core/Logger.h"
+#include <algorithm>
+#include <array>
+
+namespace XeSS::Rendering {
+
+namespace {
+    constexpr uint32 DigitBits = 8;
+    constexpr uint32 DigitCount = 1u << DigitBits;
+    constexpr uint32 PassCount = 64 / DigitBits;
+
+    // Below this a comparison sort wins over eight histogram passes
+    constexpr size_t SmallSortSize = 64;
+}
+
+void DrawKey::ReportOverflow(uint32 pass, uint32 pipeline, uint32 material, uint32 depth) {
+    XESS_WARNING_RATE_LIMITED(1, 1, "Draw key field overflow, draws may share state they should not: "
+                              "pass {}/{}, pipeline {}/{}, material {}/{}, depth {}/{}",
+                              pass, Mask(PassBits), pipeline, Mask(PipelineBits),
+                              material, Mask(MaterialBits), depth, Mask(DepthBits));
+}
+
+void DrawQueue::RadixSort(std::vector<DrawItem>& items, std::vector<DrawItem>& scratch) {
+    const size_t count = items.size();
+    if (count <= SmallSortSize) {
+        std::stable_sort(items.begin(), items.end(),
+                         [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; });
+        return;
+    }
+
+    // All histograms in one read of the keys
+    std::array<std::array<uint32, DigitCount>, PassCount> histograms{};
+    for (const DrawItem& item : items) {
+        uint64 key = item.key;
+        for (uint32 pass = 0; pass < PassCount; ++pass) {
+            ++histograms[pass][(key >> (pass * DigitBits)) & (DigitCount - 1)];
+        }
+    }
+
+    scratch.resize(count);
+    DrawItem* source = items.data();
+    DrawItem* destination = scratch.data();
+    for (uint32 pass = 0; pass < PassCount; ++pass) {
+        std::array<uint32, DigitCount>& histogram = histograms[pass];
+        const uint32 shift = pass * DigitBits;
+
+        // Pass and pipeline ids use few distinct values; a digit shared by
+        // every key leaves the order as it is
+        if (histogram[(source[0].key >> shift) & (DigitCount - 1)] == count) {
+            continue;
+        }
+
+        uint32 offset = 0;
+        for (uint32& bucket : histogram) {
+            uint32 size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const DrawItem& item = source[i];
+            destination[histogram[(item.key >> shift) & (DigitCount - 1)]++] = item;
+        }
+        std::swap(source, destination);
+    }
+
+    // An odd number of scatters leaves the result in scratch
+    if (source != items.data()) {
+        items.swap(scratch);
+    }
+}
+
+} // namespace XeSS::Rendering
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include <bit>
+#include <type_traits>
+#include <vector>
+
+namespace XeSS::Rendering {
+
+/**
+ * 64-bit draw sort key, most significant field first:
+ *
+ *   pass (4) | pipeline (16) | material (20) | depth (24)
+ *
+ * Sorting by the key groups draws by pass, then by pipeline and material so
+ * consecutive draws share state, and orders them by depth within a group.
+ * A value wider than its field is truncated, so unrelated draws could share
+ * a key and skip their state changes; Make() logs a warning when that happens.
+ */
+struct DrawKey {
+    static constexpr uint32 PassBits = 4;
+    static constexpr uint32 PipelineBits = 16;
+    static constexpr uint32 MaterialBits = 20;
+    static constexpr uint32 DepthBits = 24;
+
+    static constexpr uint32 DepthShift = 0;
+    static constexpr uint32 MaterialShift = DepthShift + DepthBits;
+    static constexpr uint32 PipelineShift = MaterialShift + MaterialBits;
+    static constexpr uint32 PassShift = PipelineShift + PipelineBits;
+    static_assert(PassShift + PassBits == 64, "Draw key fields must fill 64 bits");
+
+    enum class DepthOrder { FrontToBack, BackToFront };
+
+    static constexpr uint64 Make(uint32 pass, uint32 pipeline, uint32 material, uint32 depth) {
+        if (!std::is_constant_evaluated() &&
+            (pass > Mask(PassBits) || pipeline > Mask(PipelineBits) ||
+             material > Mask(MaterialBits) || depth > Mask(DepthBits))) {
+            ReportOverflow(pass, pipeline, material, depth);
+        }
+        return (uint64(pass & Mask(PassBits)) << PassShift) |
+               (uint64(pipeline & Mask(PipelineBits)) << PipelineShift) |
+               (uint64(material & Mask(MaterialBits)) << MaterialShift) |
+               (uint64(depth & Mask(DepthBits)) << DepthShift);
+    }
+
+    // View-space distance to a depth field; the bits of a non-negative float
+    // order like its value, so the top ones are a log-scaled quantization
+    static uint32 QuantizeDepth(float32 viewDepth, DepthOrder order = DepthOrder::FrontToBack) {
+        uint32 depth = viewDepth > 0.0f ? std::bit_cast<uint32>(viewDepth) >> (32 - DepthBits - 1) : 0;
+        depth = depth > Mask(DepthBits) ? Mask(DepthBits) : depth;
+        return order == DepthOrder::FrontToBack ? depth : Mask(DepthBits) - depth;
+    }
+
+    static constexpr uint32 Pass(uint64 key) { return Field(key, PassShift, PassBits); }
+    static constexpr uint32 Pipeline(uint64 key) { return Field(key, PipelineShift, PipelineBits); }
+    static constexpr uint32 Material(uint64 key) { return Field(key, MaterialShift, MaterialBits); }
+    static constexpr uint32 Depth(uint64 key) { return Field(key, DepthShift, DepthBits); }
+
+private:
+    static void ReportOverflow(uint32 pass, uint32 pipeline, uint32 material, uint32 depth);
+    static constexpr uint32 Mask(uint32 bits) { return (1u << bits) - 1; }
+    static constexpr uint32 Field(uint64 key, uint32 shift, uint32 bits) {
+        return static_cast<uint32>(key >> shift) & Mask(bits);
+    }
+};
+
+struct DrawItem {
+    uint64 key;
+    uint32 payload;     // Index into the caller's draw commands
+};
+
+// Key fields that differ from the previous draw, so submission only rebinds those
+struct DrawStateChanges {
+    bool pass;
+    bool pipeline;
+    bool material;
+};
+
+/**
+ * Per-frame list of draws. Render code pushes a key and a payload index per
+ * draw, in any order and from any system; Sort() orders them with an LSD
+ * radix sort and Submit() walks the result. Storage is kept between frames,
+ * so a steady frame does not allocate.
+ *
+ * Not thread-safe; one queue per recording thread.
+ */
+class DrawQueue : public NonCopyable {
+public:
+    void Reserve(size_t count) { m_items.reserve(count); }
+    void Clear() { m_items.clear(); }
+
+    void Push(uint64 key, uint32 payload) { m_items.push_back({key, payload}); }
+
+    // Stable, so draws with equal keys keep push order
+    void Sort() { RadixSort(m_items, m_scratch); }
+
+    size_t GetSize() const { return m_items.size(); }
+    bool IsEmpty() const { return m_items.empty(); }
+    const std::vector<DrawItem>& GetItems() const { return m_items; }
+
+    // Calls draw(item, changes) for each item in queue order; the first draw
+    // reports every field as changed
+    template<typename DrawFn>
+    void Submit(DrawFn&& draw) const {
+        uint64 previous = 0;
+        bool first = true;
+        for (const DrawItem& item : m_items) {
+            DrawStateChanges changes{
+                first || DrawKey::Pass(item.key) != DrawKey::Pass(previous),
+                first || DrawKey::Pipeline(item.key) != DrawKey::Pipeline(previous),
+                first || DrawKey::Material(item.key) != DrawKey::Material(previous)};
+            changes.pipeline |= changes.pass;
+            changes.material |= changes.pipeline;
+            draw(item, changes);
+            previous = item.key;
+            first = false;
+        }
+    }
+
+    // Stable LSD radix sort on the key, 8 bits per pass; scratch is resized
+    // to match. Passes where every key has the same digit are skipped.
+    static void RadixSort(std::vector<DrawItem>& items, std::vector<DrawItem>& scratch);
+
+private:
+    std::vector<DrawItem> m_items;
+    std::vector<DrawItem> m_scratch;
+};
+
+} // namespace XeSS::Rendering
@@ -0,0 +1,83 @@
+#include "DrawSubmission.h"
+#include "Core/Logger.h"
+#include "Core/Metrics.h"
+
+namespace XeSS::Rendering {
+
+namespace {
+    MetricsRegistry& Registry() { return MetricsRegistry::Instance(); }
+
+    MetricCounter& s_draws = Registry().Counter("render.draws", "Draws submitted from draw queues");
+    MetricCounter& s_stateCalls = Registry().Counter("render.state_calls", "D3D11 state calls issued by draw queues");
+    MetricCounter& s_stateCallsSkipped = Registry().Counter("render.state_calls_skipped",
+                                                            "Redundant D3D11 state calls filtered by the state cache");
+
+    void ApplyPipeline(const DrawPipeline& pipeline, RenderStateCache& cache) {
+        cache.SetVertexShader(pipeline.vertexShader);
+        cache.SetPixelShader(pipeline.pixelShader);
+        cache.SetInputLayout(pipeline.inputLayout);
+        cache.SetPrimitiveTopology(pipeline.topology);
+        cache.SetBlendState(pipeline.blendState);
+        cache.SetDepthStencilState(pipeline.depthStencilState, pipeline.stencilRef);
+        cache.SetRasterizerState(pipeline.rasterizerState);
+    }
+
+    void ApplyMaterial(const DrawMaterial& material, RenderStateCache& cache) {
+        cache.SetConstantBuffer(MaterialConstantsSlot, material.constants);
+        for (uint32 slot = 0; slot < DrawMaterial::MaxTextures; ++slot) {
+            cache.SetTexture(slot, material.textures[slot]);
+        }
+        cache.SetSampler(0, material.sampler);
+    }
+}
+
+DrawSubmissionStats SubmitDrawQueue(const DrawQueue& queue, std::span<const DrawCommand> commands,
+                                    RenderStateCache& cache) {
+    DrawSubmissionStats stats;
+    uint64 appliedBefore = cache.GetAppliedCount();
+    uint64 skippedBefore = cache.GetSkippedCount();
+    ID3D11DeviceContext* context = cache.GetContext();
+
+    queue.Submit([&](const DrawItem& item, const DrawStateChanges& changes) {
+        if (item.payload >= commands.size()) {
+            XESS_WARNING_RATE_LIMITED(1, 1, "Draw payload {} out of range ({} commands)", item.payload, commands.size());
+            return;
+        }
+        const DrawCommand& command = commands[item.payload];
+
+        if (changes.pipeline && command.pipeline) {
+            ApplyPipeline(*command.pipeline, cache);
+            ++stats.pipelineChanges;
+        }
+        if (changes.material && command.material) {
+            ApplyMaterial(*command.material, cache);
+            ++stats.materialChanges;
+        }
+
+        cache.SetVertexBuffer(command.vertexBuffer, command.vertexStride);
+        cache.SetConstantBuffer(ObjectConstantsSlot, command.objectConstants);
+        if (command.indexBuffer) {
+            cache.SetIndexBuffer(command.indexBuffer, command.indexFormat);
+            if (command.instanceCount > 0) {
+                context->DrawIndexedInstanced(command.count, command.instanceCount, command.start,
+                                              command.baseVertex, command.firstInstance);
+            } else {
+                context->DrawIndexed(command.count, command.start, command.baseVertex);
+            }
+        } else if (command.instanceCount > 0) {
+            context->DrawInstanced(command.count, command.instanceCount, command.start, command.firstInstance);
+        } else {
+            context->Draw(command.count, command.start);
+        }
+        ++stats.draws;
+    });
+
+    stats.stateCallsApplied = cache.GetAppliedCount() - appliedBefore;
+    stats.stateCallsSkipped = cache.GetSkippedCount() - skippedBefore;
+    s_draws.Add(stats.draws);
+    s_stateCalls.Add(stats.stateCallsApplied);
+    s_stateCallsSkipped.Add(stats.stateCallsSkipped);
+    return stats;
+}
+
+} // namespace XeSS::Rendering
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "DrawQueue.h"
+#include "RenderStateCache.h"
+#include <d3d11.h>
+#include <span>
+
+namespace XeSS::Rendering {
+
+// State a pipeline id in the draw key stands for
+struct DrawPipeline {
+    ID3D11VertexShader* vertexShader = nullptr;
+    ID3D11PixelShader* pixelShader = nullptr;
+    ID3D11InputLayout* inputLayout = nullptr;
+    ID3D11BlendState* blendState = nullptr;
+    ID3D11DepthStencilState* depthStencilState = nullptr;
+    ID3D11RasterizerState* rasterizerState = nullptr;
+    D3D11_PRIMITIVE_TOPOLOGY topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+    uint32 stencilRef = 0;
+};
+
+// Bindings a material id stands for
+struct DrawMaterial {
+    static constexpr uint32 MaxTextures = 4;
+
+    ID3D11Buffer* constants = nullptr;     // Slot MaterialConstantsSlot
+    ID3D11ShaderResourceView* textures[MaxTextures]{};
+    ID3D11SamplerState* sampler = nullptr;
+};
+
+// One draw; the queue item's payload indexes an array of these
+struct DrawCommand {
+    const DrawPipeline* pipeline = nullptr;
+    const DrawMaterial* material = nullptr;
+    ID3D11Buffer* vertexBuffer = nullptr;
+    uint32 vertexStride = 0;
+    ID3D11Buffer* indexBuffer = nullptr;   // Null for a non-indexed draw
+    DXGI_FORMAT indexFormat = DXGI_FORMAT_R16_UINT;
+    ID3D11Buffer* objectConstants = nullptr;  // Slot ObjectConstantsSlot
+    uint32 count = 0;                      // Indices, or vertices when not indexed
+    uint32 start = 0;
+    int32 baseVertex = 0;
+    uint32 instanceCount = 0;              // Non-zero for an instanced draw
+    uint32 firstInstance = 0;              // Offsets per-instance vertex streams
+};
+
+// Slot 0 is left to the frame's constants
+constexpr uint32 MaterialConstantsSlot = 1;
+constexpr uint32 ObjectConstantsSlot = 2;
+
+struct DrawSubmissionStats {
+    uint32 draws = 0;
+    uint32 pipelineChanges = 0;
+    uint32 materialChanges = 0;
+    uint64 stateCallsApplied = 0;
+    uint64 stateCallsSkipped = 0;
+};
+
+// Issues a sorted queue in order. Pipeline and material state is only looked
+// at when its key field changes; every call still goes through the cache,
+// so two ids that share objects cost nothing either.
+DrawSubmissionStats SubmitDrawQueue(const DrawQueue& queue, std::span<const DrawCommand> commands,
+                                    RenderStateCache& cache);
+
+} // namespace XeSS::Rendering
@@ -0,0 +1,331 @@
+#include "FrustumCuller.h"
+#include "Core/JobSystem.h"
+#include "Core/Metrics.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define XESS_CULL_AVX2 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// The AVX2 kernel is compiled for AVX2 on its own and only called after a
+// CPU check, so the rest of the build keeps its baseline target
+#if defined(XESS_CULL_AVX2) && (defined(__GNUC__) || defined(__clang__))
+#define XESS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define XESS_TARGET_AVX2
+#endif
+
+namespace XeSS::Rendering {
+
+namespace {
+    MetricsRegistry& Registry() { return MetricsRegistry::Instance(); }
+
+    MetricGauge& s_cullTested = Registry().Gauge("render.cull_tested", "Objects frustum-tested last cull");
+    MetricGauge& s_cullVisible = Registry().Gauge("render.cull_visible", "Objects inside the frustum last cull");
+
+    // Chunks per thread, so uneven chunks still balance
+    constexpr uint32 ChunksPerThread = 4;
+
+    Vector4 NormalizePlane(float32 x, float32 y, float32 z, float32 w) {
+        float32 length = std::sqrt(x * x + y * y + z * z);
+        float32 scale = length > 0.0f ? 1.0f / length : 0.0f;
+        return {x * scale, y * scale, z * scale, w * scale};
+    }
+
+    // Outside when the whole volume is behind some plane. Toward a plane the
+    // volume reaches the smaller of the sphere's radius and the box's
+    // projected half size.
+    // No early out: visibility is close to random per object, so testing
+    // all six planes beats mispredicting the exit
+    inline bool IsVisible(const Frustum& frustum, float32 x, float32 y, float32 z,
+                          float32 radius, float32 ex, float32 ey, float32 ez) {
+        bool outside = false;
+        for (const Vector4& plane : frustum.planes) {
+            float32 distance = plane.x * x + plane.y * y + plane.z * z + plane.w;
+            float32 reach = std::fabs(plane.x) * ex + std::fabs(plane.y) * ey + std::fabs(plane.z) * ez;
+            outside |= distance + std::min(radius, reach) < 0.0f;
+        }
+        return !outside;
+    }
+
+#ifdef XESS_CULL_AVX2
+    // Lane numbers of the set bits of each 8-bit mask, packed low to high
+    constexpr std::array<uint64, 256> MakeCompactTable() {
+        std::array<uint64, 256> table{};
+        for (uint32 mask = 0; mask < 256; ++mask) {
+            uint32 count = 0;
+            for (uint32 lane = 0; lane < 8; ++lane) {
+                if (mask & (1u << lane)) {
+                    table[mask] |= uint64(lane) << (8 * count++);
+                }
+            }
+        }
+        return table;
+    }
+
+    constexpr std::array<uint64, 256> s_compactTable = MakeCompactTable();
+
+    bool DetectAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        bool fma = (info[2] & (1 << 12)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!fma || !osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    }
+
+    // end - begin must be a multiple of 8. Each store writes a full vector
+    // at the output cursor, which never passes the current group's last
+    // object, so a chunk never writes past its own range.
+    XESS_TARGET_AVX2
+    uint32 CullRangeAvx2(const Frustum& frustum, const CullingBounds& bounds, uint32 begin, uint32 end, uint32* out) {
+        __m256 planeX[Frustum::PlaneCount];
+        __m256 planeY[Frustum::PlaneCount];
+        __m256 planeZ[Frustum::PlaneCount];
+        __m256 planeW[Frustum::PlaneCount];
+        __m256 absX[Frustum::PlaneCount];
+        __m256 absY[Frustum::PlaneCount];
+        __m256 absZ[Frustum::PlaneCount];
+        for (uint32 p = 0; p < Frustum::PlaneCount; ++p) {
+            const Vector4& plane = frustum.planes[p];
+            planeX[p] = _mm256_set1_ps(plane.x);
+            planeY[p] = _mm256_set1_ps(plane.y);
+            planeZ[p] = _mm256_set1_ps(plane.z);
+            planeW[p] = _mm256_set1_ps(plane.w);
+            absX[p] = _mm256_set1_ps(std::fabs(plane.x));
+            absY[p] = _mm256_set1_ps(std::fabs(plane.y));
+            absZ[p] = _mm256_set1_ps(std::fabs(plane.z));
+        }
+
+        const float32* centerX = bounds.GetCenterX();
+        const float32* centerY = bounds.GetCenterY();
+        const float32* centerZ = bounds.GetCenterZ();
+        const float32* radii = bounds.GetRadius();
+        const float32* extentX = bounds.GetExtentX();
+        const float32* extentY = bounds.GetExtentY();
+        const float32* extentZ = bounds.GetExtentZ();
+        const __m256 zero = _mm256_setzero_ps();
+
+        uint32 written = 0;
+        for (uint32 i = begin; i < end; i += 8) {
+            __m256 x = _mm256_loadu_ps(centerX + i);
+            __m256 y = _mm256_loadu_ps(centerY + i);
+            __m256 z = _mm256_loadu_ps(centerZ + i);
+            __m256 radius = _mm256_loadu_ps(radii + i);
+            __m256 ex = _mm256_loadu_ps(extentX + i);
+            __m256 ey = _mm256_loadu_ps(extentY + i);
+            __m256 ez = _mm256_loadu_ps(extentZ + i);
+
+            __m256 outside = zero;
+            for (uint32 p = 0; p < Frustum::PlaneCount; ++p) {
+                __m256 distance = _mm256_fmadd_ps(planeX[p], x,
+                                  _mm256_fmadd_ps(planeY[p], y,
+                                  _mm256_fmadd_ps(planeZ[p], z, planeW[p])));
+                __m256 reach = _mm256_fmadd_ps(absX[p], ex,
+                               _mm256_fmadd_ps(absY[p], ey, _mm256_mul_ps(absZ[p], ez)));
+                __m256 nearest = _mm256_add_ps(distance, _mm256_min_ps(radius, reach));
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(nearest, zero, _CMP_LT_OQ));
+            }
+
+            uint32 visible = ~static_cast<uint32>(_mm256_movemask_ps(outside)) & 0xFF;
+            __m128i lanes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&s_compactTable[visible]));
+            __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), _mm256_cvtepu8_epi32(lanes));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + written), indices);
+            written += std::popcount(visible);
+        }
+        return written;
+    }
+#endif
+}
+
+Frustum Frustum::FromViewProjection(const float32 (&matrix)[16]) {
+    // With clip = position * matrix, each clip component is a dot product
+    // with a matrix column; the planes are sums of those (Gribb/Hartmann)
+    auto column = [&](uint32 c) {
+        return Vector4{matrix[c], matrix[4 + c], matrix[8 + c], matrix[12 + c]};
+    };
+    Vector4 x = column(0);
+    Vector4 y = column(1);
+    Vector4 z = column(2);
+    Vector4 w = column(3);
+
+    Frustum frustum;
+    frustum.planes[Left] = NormalizePlane(w.x + x.x, w.y + x.y, w.z + x.z, w.w + x.w);
+    frustum.planes[Right] = NormalizePlane(w.x - x.x, w.y - x.y, w.z - x.z, w.w - x.w);
+    frustum.planes[Bottom] = NormalizePlane(w.x + y.x, w.y + y.y, w.z + y.z, w.w + y.w);
+    frustum.planes[Top] = NormalizePlane(w.x - y.x, w.y - y.y, w.z - y.z, w.w - y.w);
+    frustum.planes[Near] = NormalizePlane(z.x, z.y, z.z, z.w);
+    frustum.planes[Far] = NormalizePlane(w.x - z.x, w.y - z.y, w.z - z.z, w.w - z.w);
+    return frustum;
+}
+
+void CullingBounds::Reserve(size_t count) {
+    for (std::vector<float32>* component : {&m_centerX, &m_centerY, &m_centerZ, &m_radius,
+                                            &m_extentX, &m_extentY, &m_extentZ}) {
+        component->reserve(count);
+    }
+}
+
+void CullingBounds::Resize(size_t count) {
+    for (std::vector<float32>* component : {&m_centerX, &m_centerY, &m_centerZ, &m_radius,
+                                            &m_extentX, &m_extentY, &m_extentZ}) {
+        component->resize(count);
+    }
+}
+
+void CullingBounds::Clear() {
+    for (std::vector<float32>* component : {&m_centerX, &m_centerY, &m_centerZ, &m_radius,
+                                            &m_extentX, &m_extentY, &m_extentZ}) {
+        component->clear();
+    }
+}
+
+uint32 CullingBounds::Add(const Vector3& center, float32 radius, const Vector3& extents) {
+    uint32 index = GetCount();
+    m_centerX.push_back(center.x);
+    m_centerY.push_back(center.y);
+    m_centerZ.push_back(center.z);
+    m_radius.push_back(radius);
+    m_extentX.push_back(extents.x);
+    m_extentY.push_back(extents.y);
+    m_extentZ.push_back(extents.z);
+    return index;
+}
+
+uint32 CullingBounds::AddSphere(const Vector3& center, float32 radius) {
+    return Add(center, radius, {radius, radius, radius});
+}
+
+uint32 CullingBounds::AddBox(const Vector3& center, const Vector3& extents) {
+    float32 radius = std::sqrt(extents.x * extents.x + extents.y * extents.y + extents.z * extents.z);
+    return Add(center, radius, extents);
+}
+
+void CullingBounds::Set(uint32 index, const Vector3& center, float32 radius, const Vector3& extents) {
+    m_centerX[index] = center.x;
+    m_centerY[index] = center.y;
+    m_centerZ[index] = center.z;
+    m_radius[index] = radius;
+    m_extentX[index] = extents.x;
+    m_extentY[index] = extents.y;
+    m_extentZ[index] = extents.z;
+}
+
+uint32 FrustumCuller::Cull(const Frustum& frustum, const CullingBounds& bounds) {
+    const uint32 count = bounds.GetCount();
+    m_stats = {count, 0, 0};
+    m_visibleCount = 0;
+    if (count == 0) {
+        s_cullTested.Set(0);
+        s_cullVisible.Set(0);
+        return 0;
+    }
+
+    // Never shrunk, so a steady frame neither allocates nor clears
+    if (m_visible.size() < count) {
+        m_visible.resize(count);
+        m_scratch.resize(count);
+    }
+
+    JobSystem& jobs = JobSystem::Instance();
+    uint32 threads = jobs.GetWorkerCount() + 1;
+    uint32 chunkSize = (count + threads * ChunksPerThread - 1) / (threads * ChunksPerThread);
+    chunkSize = std::max(MinChunkSize, (chunkSize + 7) & ~7u);
+    uint32 chunks = (count + chunkSize - 1) / chunkSize;
+    m_stats.chunks = chunks;
+
+    // One chunk goes straight to the output
+    if (chunks == 1) {
+        m_visibleCount = CullRange(frustum, bounds, 0, count, m_visible.data());
+    } else {
+        m_chunkCounts.resize(chunks);
+        m_chunkOffsets.resize(chunks);
+        jobs.ParallelFor(chunks, 1, [&](uint32 first, uint32 last) {
+            for (uint32 chunk = first; chunk < last; ++chunk) {
+                uint32 begin = chunk * chunkSize;
+                uint32 end = std::min(begin + chunkSize, count);
+                m_chunkCounts[chunk] = CullRange(frustum, bounds, begin, end, m_scratch.data() + begin);
+            }
+        });
+
+        for (uint32 chunk = 0; chunk < chunks; ++chunk) {
+            m_chunkOffsets[chunk] = m_visibleCount;
+            m_visibleCount += m_chunkCounts[chunk];
+        }
+
+        jobs.ParallelFor(chunks, 1, [&](uint32 first, uint32 last) {
+            for (uint32 chunk = first; chunk < last; ++chunk) {
+                memcpy(m_visible.data() + m_chunkOffsets[chunk], m_scratch.data() + chunk * chunkSize,
+                       m_chunkCounts[chunk] * sizeof(uint32));
+            }
+        });
+    }
+
+    m_stats.visible = m_visibleCount;
+    s_cullTested.Set(count);
+    s_cullVisible.Set(m_visibleCount);
+    return m_visibleCount;
+}
+
+uint32 FrustumCuller::CullRange(const Frustum& frustum, const CullingBounds& bounds,
+                                uint32 begin, uint32 end, uint32* out) {
+#ifdef XESS_CULL_AVX2
+    if (HasAvx2()) {
+        uint32 vectorEnd = begin + ((end - begin) & ~7u);
+        uint32 written = CullRangeAvx2(frustum, bounds, begin, vectorEnd, out);
+        return written + CullRangeScalar(frustum, bounds, vectorEnd, end, out + written);
+    }
+#endif
+    return CullRangeScalar(frustum, bounds, begin, end, out);
+}
+
+uint32 FrustumCuller::CullRangeScalar(const Frustum& frustum, const CullingBounds& bounds,
+                                      uint32 begin, uint32 end, uint32* out) {
+    const float32* centerX = bounds.GetCenterX();
+    const float32* centerY = bounds.GetCenterY();
+    const float32* centerZ = bounds.GetCenterZ();
+    const float32* radii = bounds.GetRadius();
+    const float32* extentX = bounds.GetExtentX();
+    const float32* extentY = bounds.GetExtentY();
+    const float32* extentZ = bounds.GetExtentZ();
+
+    uint32 written = 0;
+    for (uint32 i = begin; i < end; ++i) {
+        // Always store, advance only past visible objects
+        out[written] = i;
+        written += IsVisible(frustum, centerX[i], centerY[i], centerZ[i], radii[i], extentX[i], extentY[i], extentZ[i]);
+    }
+    return written;
+}
+
+bool FrustumCuller::HasAvx2() {
+#ifdef XESS_CULL_AVX2
+    static const bool hasAvx2 = DetectAvx2();
+    return hasAvx2;
+#else
+    return false;
+#endif
+}
+
+} // namespace XeSS::Rendering
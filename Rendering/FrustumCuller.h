@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include <span>
+#include <vector>
+
+namespace XeSS::Rendering {
+
+// Six inward-facing, normalized planes: a point p is inside a plane when
+// dot(plane.xyz, p) + plane.w >= 0, and that value is its distance.
+struct Frustum {
+    enum PlaneIndex : uint32 { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+
+    Vector4 planes[PlaneCount];
+
+    // From a row-major view-projection matrix in the row-vector convention
+    // (clip = position * matrix, as DirectXMath) with D3D's 0..1 depth range
+    static Frustum FromViewProjection(const float32 (&matrix)[16]);
+};
+
+/**
+ * Object bounds for culling, one array per component so the culler loads
+ * eight objects per component at once. Every object has a bounding sphere
+ * and an axis-aligned box around the same center; against each plane the
+ * tighter of the two is used. AddSphere/AddBox derive the other volume.
+ */
+class CullingBounds {
+public:
+    void Reserve(size_t count);
+    void Resize(size_t count);
+    void Clear();
+
+    uint32 Add(const Vector3& center, float32 radius, const Vector3& extents);
+    uint32 AddSphere(const Vector3& center, float32 radius);
+    uint32 AddBox(const Vector3& center, const Vector3& extents);
+
+    // extents are the box's half sizes
+    void Set(uint32 index, const Vector3& center, float32 radius, const Vector3& extents);
+
+    uint32 GetCount() const { return static_cast<uint32>(m_radius.size()); }
+
+    const float32* GetCenterX() const { return m_centerX.data(); }
+    const float32* GetCenterY() const { return m_centerY.data(); }
+    const float32* GetCenterZ() const { return m_centerZ.data(); }
+    const float32* GetRadius() const { return m_radius.data(); }
+    const float32* GetExtentX() const { return m_extentX.data(); }
+    const float32* GetExtentY() const { return m_extentY.data(); }
+    const float32* GetExtentZ() const { return m_extentZ.data(); }
+
+private:
+    std::vector<float32> m_centerX;
+    std::vector<float32> m_centerY;
+    std::vector<float32> m_centerZ;
+    std::vector<float32> m_radius;
+    std::vector<float32> m_extentX;
+    std::vector<float32> m_extentY;
+    std::vector<float32> m_extentZ;
+};
+
+struct CullingStats {
+    uint32 tested = 0;
+    uint32 visible = 0;
+    uint32 chunks = 0;
+};
+
+/**
+ * Frustum culling over CullingBounds. Objects are split into chunks that run
+ * on the job system; each chunk tests eight objects per iteration with AVX2
+ * when the CPU has it (scalar otherwise) and writes the indices of the ones
+ * that survive. A second pass packs the chunks into one ascending list,
+ * which callers walk to push draws.
+ *
+ * Storage is kept between frames. Not thread-safe; one culler per view.
+ */
+class FrustumCuller : public NonCopyable {
+public:
+    // Chunks are multiples of 8 objects and no smaller than this
+    static constexpr uint32 MinChunkSize = 4096;
+
+    // Returns the number of visible objects, also GetVisible().size()
+    uint32 Cull(const Frustum& frustum, const CullingBounds& bounds);
+
+    std::span<const uint32> GetVisible() const { return {m_visible.data(), m_visibleCount}; }
+    const CullingStats& GetStats() const { return m_stats; }
+
+    // Single-threaded test of [begin, end); writes visible indices to out,
+    // which must have room for end - begin, and returns how many
+    static uint32 CullRange(const Frustum& frustum, const CullingBounds& bounds,
+                            uint32 begin, uint32 end, uint32* out);
+    static uint32 CullRangeScalar(const Frustum& frustum, const CullingBounds& bounds,
+                                  uint32 begin, uint32 end, uint32* out);
+
+    // Whether CullRange takes the AVX2 path on this CPU
+    static bool HasAvx2();
+
+private:
+    std::vector<uint32> m_scratch;      // Chunk results, at each chunk's first object
+    std::vector<uint32> m_visible;      // Sized to the object count; m_visibleCount used
+    std::vector<uint32> m_chunkCounts;
+    std::vector<uint32> m_chunkOffsets;
+    uint32 m_visibleCount = 0;
+    CullingStats m_stats;
+};
+
+} // namespace XeSS::Rendering
@@ -0,0 +1,163 @@
+#include "InstanceBatcher.h"
+#include "Core/Exception.h"
+#include "Core/Logger.h"
+#include "Core/Metrics.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+
+namespace XeSS::Rendering {
+
+namespace {
+    MetricsRegistry& Registry() { return MetricsRegistry::Instance(); }
+
+    MetricGauge& s_instancedObjects = Registry().Gauge("render.instanced_objects", "Objects drawn through instancing last frame");
+    MetricGauge& s_instanceBatches = Registry().Gauge("render.instance_batches", "Instanced draw calls last frame");
+    MetricHistogram& s_batchingRatio = Registry().Histogram("render.batching_ratio", "Objects per instanced draw call, per frame",
+                                                            MetricHistogram::ExponentialBounds(1.0, 2.0, 12));
+
+    template<typename T>
+    size_t CombineHash(size_t hash, const T& value) {
+        return hash ^ (std::hash<T>{}(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+    }
+}
+
+size_t InstanceBatcher::BatchKeyHash::operator()(const BatchKey& key) const {
+    size_t hash = std::hash<const void*>{}(key.pipeline);
+    hash = CombineHash(hash, static_cast<const void*>(key.material));
+    hash = CombineHash(hash, static_cast<const void*>(key.vertexBuffer));
+    hash = CombineHash(hash, key.vertexStride);
+    hash = CombineHash(hash, static_cast<const void*>(key.indexBuffer));
+    hash = CombineHash(hash, static_cast<uint32>(key.indexFormat));
+    hash = CombineHash(hash, key.count);
+    hash = CombineHash(hash, key.start);
+    return CombineHash(hash, key.baseVertex);
+}
+
+void InstanceBatcher::Initialize(ID3D11Device* device, uint32 initialCapacity) {
+    Shutdown();
+    m_device = device;
+    m_ring.Initialize(device, sizeof(InstanceData), initialCapacity);
+    EnsureIndexStream(m_ring.GetCapacity());
+}
+
+void InstanceBatcher::Shutdown() {
+    Clear();
+    m_ring.Shutdown();
+    m_indexStream.Reset();
+    m_indexStreamCount = 0;
+    m_device.Reset();
+}
+
+void InstanceBatcher::Clear() {
+    m_batchLookup.clear();
+    m_batches.clear();
+    m_objects.clear();
+    m_commands.clear();
+    m_stats = {};
+}
+
+void InstanceBatcher::Add(uint64 key, const DrawCommand& mesh, const InstanceData& instance) {
+    BatchKey batchKey{mesh.pipeline, mesh.material, mesh.vertexBuffer, mesh.vertexStride,
+                      mesh.indexBuffer, mesh.indexFormat, mesh.count, mesh.start, mesh.baseVertex};
+    auto [it, inserted] = m_batchLookup.try_emplace(batchKey, static_cast<uint32>(m_batches.size()));
+    if (inserted) {
+        m_batches.push_back({key, 0, 0, mesh});
+    }
+
+    Batch& batch = m_batches[it->second];
+    batch.key = std::min(batch.key, key);
+    ++batch.count;
+    m_objects.push_back({instance, it->second});
+}
+
+bool InstanceBatcher::Build(ID3D11DeviceContext* context, DrawQueue& queue) {
+    const uint32 objectCount = static_cast<uint32>(m_objects.size());
+    m_stats = {objectCount, static_cast<uint32>(m_batches.size())};
+    if (objectCount == 0) {
+        return true;
+    }
+
+    // Counting sort by batch, so instance data is written front to back
+    // into write-combined memory
+    uint32 offset = 0;
+    for (Batch& batch : m_batches) {
+        batch.firstObject = offset;
+        offset += batch.count;
+    }
+    m_order.resize(objectCount);
+    m_cursors.resize(m_batches.size());
+    std::transform(m_batches.begin(), m_batches.end(), m_cursors.begin(),
+                   [](const Batch& batch) { return batch.firstObject; });
+    for (uint32 i = 0; i < objectCount; ++i) {
+        m_order[m_cursors[m_objects[i].batch]++] = i;
+    }
+
+    if (!m_ring.Begin(context, objectCount)) {
+        return false;
+    }
+    UploadRing::Allocation allocation = m_ring.Allocate(objectCount);
+    if (allocation) {
+        InstanceData* destination = static_cast<InstanceData*>(allocation.data);
+        for (uint32 i = 0; i < objectCount; ++i) {
+            memcpy(&destination[i], &m_objects[m_order[i]].instance, sizeof(InstanceData));
+        }
+    }
+    m_ring.End(context);
+    if (!allocation) {
+        return false;
+    }
+    EnsureIndexStream(m_ring.GetCapacity());
+
+    m_commands.reserve(m_batches.size());
+    for (const Batch& batch : m_batches) {
+        DrawCommand command = batch.mesh;
+        command.objectConstants = nullptr;
+        command.instanceCount = batch.count;
+        command.firstInstance = allocation.firstElement + batch.firstObject;
+        queue.Push(batch.key, static_cast<uint32>(m_commands.size()));
+        m_commands.push_back(command);
+    }
+
+    s_instancedObjects.Set(objectCount);
+    s_instanceBatches.Set(static_cast<float64>(m_batches.size()));
+    s_batchingRatio.Observe(m_stats.BatchingRatio());
+    return true;
+}
+
+void InstanceBatcher::Bind(ID3D11DeviceContext* context) const {
+    ID3D11ShaderResourceView* view = m_ring.GetView();
+    context->VSSetShaderResources(InstanceDataSlot, 1, &view);
+
+    ID3D11Buffer* stream = m_indexStream.Get();
+    UINT stride = sizeof(uint32);
+    UINT streamOffset = 0;
+    context->IASetVertexBuffers(InstanceIndexSlot, 1, &stream, &stride, &streamOffset);
+}
+
+D3D11_INPUT_ELEMENT_DESC InstanceBatcher::GetInstanceIndexElement() {
+    return {"INSTANCE_INDEX", 0, DXGI_FORMAT_R32_UINT, InstanceIndexSlot, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1};
+}
+
+void InstanceBatcher::EnsureIndexStream(uint32 count) {
+    if (count <= m_indexStreamCount || !m_device) {
+        return;
+    }
+
+    std::vector<uint32> indices(count);
+    std::iota(indices.begin(), indices.end(), 0u);
+
+    D3D11_BUFFER_DESC desc{};
+    desc.ByteWidth = count * sizeof(uint32);
+    desc.Usage = D3D11_USAGE_IMMUTABLE;
+    desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    D3D11_SUBRESOURCE_DATA data{indices.data(), 0, 0};
+
+    ComPtr<ID3D11Buffer> stream;
+    XESS_THROW_IF_FAILED(m_device->CreateBuffer(&desc, &data, &stream), "Failed to create instance index stream");
+    m_indexStream = std::move(stream);
+    m_indexStreamCount = count;
+}
+
+} // namespace XeSS::Rendering
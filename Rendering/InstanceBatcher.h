@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include "DrawQueue.h"
+#include "DrawSubmission.h"
+#include "UploadRing.h"
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <unordered_map>
+#include <vector>
+
+namespace XeSS::Rendering {
+
+// Per-object data instanced shaders read from the instance buffer. Transforms
+// are the rows of a 3x4 object-to-world matrix. The previous transform is
+// last frame's, unjittered; jitter stays in the frame constants, so motion
+// vectors do not pick it up.
+struct InstanceData {
+    Vector4 transform[3];
+    Vector4 previousTransform[3];
+    Vector4 color;
+};
+static_assert(sizeof(InstanceData) % 16 == 0, "Instance data must stay 16-byte aligned");
+
+struct InstanceBatchStats {
+    uint32 objects = 0;
+    uint32 batches = 0;
+
+    // Objects per draw call; 1 means nothing was merged
+    float64 BatchingRatio() const { return batches > 0 ? float64(objects) / batches : 0.0; }
+};
+
+/**
+ * Turns per-object draws into instanced ones. Objects that share pipeline,
+ * material and mesh (buffers with their stride and index format, and index
+ * range) become one DrawIndexedInstanced, and their InstanceData is written
+ * contiguously into a structured buffer through an UploadRing.
+ *
+ * Instanced vertex shaders find their data with an instance index stream:
+ * input slot InstanceIndexSlot carries 0, 1, 2, ... per instance, and the
+ * draw's StartInstanceLocation offsets it to the batch's first element (plain
+ * SV_InstanceID does not include that offset in D3D11). Pipelines add
+ * GetInstanceIndexElement() to their input layout and read
+ *
+ *     StructuredBuffer<InstanceData> instances : register(t<InstanceDataSlot>);
+ *     InstanceData instance = instances[input.instanceIndex];
+ */
+class InstanceBatcher : public NonCopyable {
+public:
+    static constexpr uint32 InstanceIndexSlot = 1;
+    static constexpr uint32 InstanceDataSlot = 8;   // Vertex shader SRV slot
+
+    void Initialize(ID3D11Device* device, uint32 initialCapacity = 4096);
+    void Shutdown();
+
+    void Clear();
+
+    // key orders the object like a DrawQueue key; a batch takes the lowest
+    // key of its objects, so it sorts with its nearest instance
+    void Add(uint64 key, const DrawCommand& mesh, const InstanceData& instance);
+
+    // Groups the objects added since Clear(), uploads their instance data
+    // and pushes one queue item per batch, indexing GetCommands()
+    bool Build(ID3D11DeviceContext* context, DrawQueue& queue);
+
+    // Binds the instance buffer and index stream; once before submission
+    void Bind(ID3D11DeviceContext* context) const;
+
+    const std::vector<DrawCommand>& GetCommands() const { return m_commands; }
+    const InstanceBatchStats& GetStats() const { return m_stats; }
+
+    static D3D11_INPUT_ELEMENT_DESC GetInstanceIndexElement();
+
+private:
+    // Identity of an instancing batch: what a draw call cannot vary per instance
+    struct BatchKey {
+        const DrawPipeline* pipeline;
+        const DrawMaterial* material;
+        ID3D11Buffer* vertexBuffer;
+        uint32 vertexStride;
+        ID3D11Buffer* indexBuffer;
+        DXGI_FORMAT indexFormat;
+        uint32 count;
+        uint32 start;
+        int32 baseVertex;
+
+        bool operator==(const BatchKey&) const = default;
+    };
+
+    struct BatchKeyHash {
+        size_t operator()(const BatchKey& key) const;
+    };
+
+    struct Batch {
+        uint64 key;
+        uint32 firstObject;     // Into m_order once grouped
+        uint32 count;
+        DrawCommand mesh;
+    };
+
+    struct Object {
+        InstanceData instance;
+        uint32 batch;
+    };
+
+    void EnsureIndexStream(uint32 count);
+
+    ComPtr<ID3D11Device> m_device;
+    UploadRing m_ring;
+    ComPtr<ID3D11Buffer> m_indexStream;     // 0, 1, 2, ... as R32_UINT
+    uint32 m_indexStreamCount = 0;
+
+    std::unordered_map<BatchKey, uint32, BatchKeyHash> m_batchLookup;
+    std::vector<Batch> m_batches;
+    std::vector<Object> m_objects;
+    std::vector<uint32> m_order;            // Object indices grouped by batch
+    std::vector<uint32> m_cursors;
+    std::vector<DrawCommand> m_commands;
+    InstanceBatchStats m_stats;
+};
+
+} // namespace XeSS::Rendering
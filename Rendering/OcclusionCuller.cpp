@@ -0,0 +1,505 @@
+#include "OcclusionCuller.h"
+#include "Core/JobSystem.h"
+#include "Core/Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XESS_OCCLUSION_SSE2 1
+#endif
+
+namespace XeSS::Rendering {
+
+namespace {
+    MetricsRegistry& Registry() { return MetricsRegistry::Instance(); }
+
+    MetricGauge& s_occluderTriangles = Registry().Gauge("render.occluder_triangles", "Occluder triangles rasterized last frame");
+    MetricGauge& s_occlusionTested = Registry().Gauge("render.occlusion_tested", "Objects tested against the occlusion buffer last frame");
+    MetricGauge& s_occlusionCulled = Registry().Gauge("render.occlusion_culled", "Objects hidden by occluders last frame");
+
+    constexpr uint32 TransformBatch = 4096;
+    constexpr uint32 SetupBatch = 1024;
+    constexpr uint32 MinTestChunk = 1024;
+    constexpr uint32 ChunksPerThread = 4;
+
+    // Corner i of a box is center +/- extents, bit 0 picking +x, bit 1 +y
+    // and bit 2 +z. Two clockwise triangles per face, seen from outside.
+    constexpr uint32 BoxIndices[36] = {
+        4, 6, 2, 4, 2, 0,   // -x
+        1, 3, 7, 1, 7, 5,   // +x
+        0, 1, 5, 0, 5, 4,   // -y
+        6, 7, 3, 6, 3, 2,   // +y
+        2, 3, 1, 2, 1, 0,   // -z
+        4, 5, 7, 4, 7, 6,   // +z
+    };
+
+    // Writes min(depth, z) where all three edges are non-negative, for the
+    // pixels [x, end) of one row; x and end - x are multiples of 4
+    void RasterizeSpan(float32* row, int32 x, int32 end, float32 px, float32 py,
+                       const float32 (&a)[3], const float32 (&b)[3], const float32 (&c)[3],
+                       float32 depthA, float32 depthB, float32 depthC) {
+#ifdef XESS_OCCLUSION_SSE2
+        const __m128 offsets = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+        const __m128 zero = _mm_setzero_ps();
+        __m128 edge0 = _mm_add_ps(_mm_set1_ps(a[0] * px + b[0] * py + c[0]), _mm_mul_ps(_mm_set1_ps(a[0]), offsets));
+        __m128 edge1 = _mm_add_ps(_mm_set1_ps(a[1] * px + b[1] * py + c[1]), _mm_mul_ps(_mm_set1_ps(a[1]), offsets));
+        __m128 edge2 = _mm_add_ps(_mm_set1_ps(a[2] * px + b[2] * py + c[2]), _mm_mul_ps(_mm_set1_ps(a[2]), offsets));
+        __m128 depth = _mm_add_ps(_mm_set1_ps(depthA * px + depthB * py + depthC), _mm_mul_ps(_mm_set1_ps(depthA), offsets));
+        const __m128 step0 = _mm_set1_ps(a[0] * 4.0f);
+        const __m128 step1 = _mm_set1_ps(a[1] * 4.0f);
+        const __m128 step2 = _mm_set1_ps(a[2] * 4.0f);
+        const __m128 depthStep = _mm_set1_ps(depthA * 4.0f);
+
+        for (; x < end; x += 4) {
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)),
+                                       _mm_cmpge_ps(edge2, zero));
+            __m128 current = _mm_loadu_ps(row + x);
+            __m128 nearer = _mm_min_ps(current, depth);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, current)));
+
+            edge0 = _mm_add_ps(edge0, step0);
+            edge1 = _mm_add_ps(edge1, step1);
+            edge2 = _mm_add_ps(edge2, step2);
+            depth = _mm_add_ps(depth, depthStep);
+        }
+#else
+        for (; x < end; ++x, px += 1.0f) {
+            float32 edge0 = a[0] * px + b[0] * py + c[0];
+            float32 edge1 = a[1] * px + b[1] * py + c[1];
+            float32 edge2 = a[2] * px + b[2] * py + c[2];
+            if (edge0 >= 0.0f && edge1 >= 0.0f && edge2 >= 0.0f) {
+                row[x] = std::min(row[x], depthA * px + depthB * py + depthC);
+            }
+        }
+#endif
+    }
+
+    struct ScreenBounds {
+        float32 minX;
+        float32 maxX;
+        float32 minY;
+        float32 maxY;
+        float32 nearest;
+    };
+
+#ifdef XESS_OCCLUSION_SSE2
+    inline float32 HorizontalMin(__m128 v) {
+        v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(v);
+    }
+
+    inline float32 HorizontalMax(__m128 v) {
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(v);
+    }
+#endif
+
+    // Screen rectangle and nearest depth of a box's eight corners, which are
+    // the center's clip position plus or minus each scaled matrix row. False
+    // when a corner is in front of the near plane.
+    bool ProjectBox(const float32 (&m)[16], float32 width, float32 height,
+                    const Vector3& center, const Vector3& extents, ScreenBounds& screen) {
+#ifdef XESS_OCCLUSION_SSE2
+        // Corners 0-3 in one vector and 4-7 (+z) in the other
+        const __m128 signX = _mm_set_ps(1.0f, -1.0f, 1.0f, -1.0f);
+        const __m128 signY = _mm_set_ps(1.0f, 1.0f, -1.0f, -1.0f);
+        __m128 low[4];
+        __m128 high[4];
+        for (uint32 c = 0; c < 4; ++c) {
+            float32 origin = center.x * m[c] + center.y * m[4 + c] + center.z * m[8 + c] + m[12 + c];
+            __m128 base = _mm_add_ps(_mm_set1_ps(origin),
+                          _mm_add_ps(_mm_mul_ps(signX, _mm_set1_ps(extents.x * m[c])),
+                                     _mm_mul_ps(signY, _mm_set1_ps(extents.y * m[4 + c]))));
+            __m128 axisZ = _mm_set1_ps(extents.z * m[8 + c]);
+            low[c] = _mm_sub_ps(base, axisZ);
+            high[c] = _mm_add_ps(base, axisZ);
+        }
+
+        const __m128 zero = _mm_setzero_ps();
+        __m128 behind = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(low[2], zero), _mm_cmple_ps(low[3], zero)),
+                                  _mm_or_ps(_mm_cmplt_ps(high[2], zero), _mm_cmple_ps(high[3], zero)));
+        if (_mm_movemask_ps(behind) != 0) {
+            return false;
+        }
+
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 halfWidth = _mm_set1_ps(0.5f * width);
+        const __m128 halfHeight = _mm_set1_ps(0.5f * height);
+        __m128 inverseLow = _mm_div_ps(one, low[3]);
+        __m128 inverseHigh = _mm_div_ps(one, high[3]);
+        __m128 xLow = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(low[0], inverseLow), one), halfWidth);
+        __m128 xHigh = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(high[0], inverseHigh), one), halfWidth);
+        __m128 yLow = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(low[1], inverseLow)), halfHeight);
+        __m128 yHigh = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(high[1], inverseHigh)), halfHeight);
+
+        screen.minX = HorizontalMin(_mm_min_ps(xLow, xHigh));
+        screen.maxX = HorizontalMax(_mm_max_ps(xLow, xHigh));
+        screen.minY = HorizontalMin(_mm_min_ps(yLow, yHigh));
+        screen.maxY = HorizontalMax(_mm_max_ps(yLow, yHigh));
+        screen.nearest = HorizontalMin(_mm_min_ps(_mm_mul_ps(low[2], inverseLow), _mm_mul_ps(high[2], inverseHigh)));
+        return true;
+#else
+        auto scaledRow = [&](uint32 row, float32 scale) {
+            return Vector4{scale * m[row * 4], scale * m[row * 4 + 1], scale * m[row * 4 + 2], scale * m[row * 4 + 3]};
+        };
+        Vector4 axisX = scaledRow(0, extents.x);
+        Vector4 axisY = scaledRow(1, extents.y);
+        Vector4 axisZ = scaledRow(2, extents.z);
+        Vector4 origin{center.x * m[0] + center.y * m[4] + center.z * m[8] + m[12],
+                       center.x * m[1] + center.y * m[5] + center.z * m[9] + m[13],
+                       center.x * m[2] + center.y * m[6] + center.z * m[10] + m[14],
+                       center.x * m[3] + center.y * m[7] + center.z * m[11] + m[15]};
+
+        screen = {std::numeric_limits<float32>::max(), std::numeric_limits<float32>::lowest(),
+                  std::numeric_limits<float32>::max(), std::numeric_limits<float32>::lowest(),
+                  std::numeric_limits<float32>::max()};
+        for (uint32 i = 0; i < 8; ++i) {
+            float32 sx = i & 1 ? 1.0f : -1.0f;
+            float32 sy = i & 2 ? 1.0f : -1.0f;
+            float32 sz = i & 4 ? 1.0f : -1.0f;
+            float32 w = origin.w + sx * axisX.w + sy * axisY.w + sz * axisZ.w;
+            float32 z = origin.z + sx * axisX.z + sy * axisY.z + sz * axisZ.z;
+            if (z < 0.0f || w <= 0.0f) {
+                return false;
+            }
+            float32 inverseW = 1.0f / w;
+            float32 x = ((origin.x + sx * axisX.x + sy * axisY.x + sz * axisZ.x) * inverseW + 1.0f) * (0.5f * width);
+            float32 y = (1.0f - (origin.y + sx * axisX.y + sy * axisY.y + sz * axisZ.y) * inverseW) * (0.5f * height);
+            screen.minX = std::min(screen.minX, x);
+            screen.maxX = std::max(screen.maxX, x);
+            screen.minY = std::min(screen.minY, y);
+            screen.maxY = std::max(screen.maxY, y);
+            screen.nearest = std::min(screen.nearest, z * inverseW);
+        }
+        return true;
+#endif
+    }
+}
+
+void OcclusionCuller::Initialize(uint32 width, uint32 height) {
+    m_tilesX = std::max<uint32>((width + TileWidth - 1) / TileWidth, 1);
+    m_tilesY = std::max<uint32>((height + TileHeight - 1) / TileHeight, 1);
+    m_width = m_tilesX * TileWidth;
+    m_height = m_tilesY * TileHeight;
+    m_blocksX = m_width / BlockSize;
+
+    m_depth.assign(size_t(m_width) * m_height, 1.0f);
+    m_blockMaxDepth.assign(size_t(m_blocksX) * (m_height / BlockSize), 1.0f);
+    m_bins.assign(size_t(m_tilesX) * m_tilesY, {});
+}
+
+void OcclusionCuller::BeginFrame(const float32 (&viewProjection)[16]) {
+    memcpy(m_viewProjection, viewProjection, sizeof(m_viewProjection));
+    m_vertices.clear();
+    m_indices.clear();
+    m_stats = {};
+}
+
+void OcclusionCuller::AddOccluder(std::span<const Vector3> vertices, std::span<const uint32> indices) {
+    uint32 base = static_cast<uint32>(m_vertices.size());
+    m_vertices.insert(m_vertices.end(), vertices.begin(), vertices.end());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        m_indices.push_back(base + indices[i]);
+        m_indices.push_back(base + indices[i + 1]);
+        m_indices.push_back(base + indices[i + 2]);
+    }
+}
+
+void OcclusionCuller::AddOccluderBox(const Vector3& center, const Vector3& extents) {
+    Vector3 corners[8];
+    for (uint32 i = 0; i < 8; ++i) {
+        corners[i] = {center.x + (i & 1 ? extents.x : -extents.x),
+                      center.y + (i & 2 ? extents.y : -extents.y),
+                      center.z + (i & 4 ? extents.z : -extents.z)};
+    }
+    AddOccluder(corners, BoxIndices);
+}
+
+Vector4 OcclusionCuller::ToClip(const Vector3& position) const {
+    const float32* m = m_viewProjection;
+    return {position.x * m[0] + position.y * m[4] + position.z * m[8] + m[12],
+            position.x * m[1] + position.y * m[5] + position.z * m[9] + m[13],
+            position.x * m[2] + position.y * m[6] + position.z * m[10] + m[14],
+            position.x * m[3] + position.y * m[7] + position.z * m[11] + m[15]};
+}
+
+bool OcclusionCuller::SetupTriangle(const Vector4& a, const Vector4& b, const Vector4& c, RasterTriangle& triangle) const {
+    // Clipping would add geometry for little gain; dropping only loses occlusion
+    if (a.z < 0.0f || b.z < 0.0f || c.z < 0.0f || a.w <= 0.0f || b.w <= 0.0f || c.w <= 0.0f) {
+        return false;
+    }
+
+    const float32 halfWidth = 0.5f * m_width;
+    const float32 halfHeight = 0.5f * m_height;
+    auto toScreen = [&](const Vector4& clip) {
+        float32 inverseW = 1.0f / clip.w;
+        return Vector3{(clip.x * inverseW + 1.0f) * halfWidth, (1.0f - clip.y * inverseW) * halfHeight, clip.z * inverseW};
+    };
+    Vector3 p0 = toScreen(a);
+    Vector3 p1 = toScreen(b);
+    Vector3 p2 = toScreen(c);
+
+    // Clockwise on screen (y down) is a positive area; the rest faces away
+    float32 area = (p1.x - p0.x) * (p2.y - p0.y) - (p1.y - p0.y) * (p2.x - p0.x);
+    if (!(area > 0.0f)) {
+        return false;
+    }
+
+    // Pixels whose center lies in the bounding box
+    float32 minX = std::min({p0.x, p1.x, p2.x});
+    float32 maxX = std::max({p0.x, p1.x, p2.x});
+    float32 minY = std::min({p0.y, p1.y, p2.y});
+    float32 maxY = std::max({p0.y, p1.y, p2.y});
+    if (maxX < 0.5f || minX > m_width - 0.5f || maxY < 0.5f || minY > m_height - 0.5f) {
+        return false;
+    }
+    // Clamped as floats; a vertex close to w = 0 lands far outside int range
+    triangle.minX = static_cast<int32>(std::ceil(std::max(minX - 0.5f, 0.0f)));
+    triangle.minY = static_cast<int32>(std::ceil(std::max(minY - 0.5f, 0.0f)));
+    triangle.maxX = static_cast<int32>(std::floor(std::min(maxX - 0.5f, m_width - 1.0f)));
+    triangle.maxY = static_cast<int32>(std::floor(std::min(maxY - 0.5f, m_height - 1.0f)));
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+        return false;
+    }
+
+    // Edge i is opposite vertex i and is non-negative on its side
+    const Vector3* points[3] = {&p0, &p1, &p2};
+    for (uint32 i = 0; i < 3; ++i) {
+        const Vector3& from = *points[(i + 1) % 3];
+        const Vector3& to = *points[(i + 2) % 3];
+        triangle.edgeA[i] = from.y - to.y;
+        triangle.edgeB[i] = to.x - from.x;
+        triangle.edgeC[i] = (to.y - from.y) * from.x - (to.x - from.x) * from.y;
+    }
+
+    // Depth is affine in screen space: a blend of the vertex depths weighted
+    // by the edge functions, which sum to the area
+    float32 inverseArea = 1.0f / area;
+    triangle.depthA = (triangle.edgeA[0] * p0.z + triangle.edgeA[1] * p1.z + triangle.edgeA[2] * p2.z) * inverseArea;
+    triangle.depthB = (triangle.edgeB[0] * p0.z + triangle.edgeB[1] * p1.z + triangle.edgeB[2] * p2.z) * inverseArea;
+    triangle.depthC = (triangle.edgeC[0] * p0.z + triangle.edgeC[1] * p1.z + triangle.edgeC[2] * p2.z) * inverseArea;
+
+    // Written at pixel centers; push the depth back to the farthest the
+    // plane gets within the pixel, so the pixel is never nearer than the
+    // occluder anywhere in it
+    triangle.depthC += 0.5f * (std::fabs(triangle.depthA) + std::fabs(triangle.depthB));
+    return true;
+}
+
+void OcclusionCuller::RenderOccluders() {
+    JobSystem& jobs = JobSystem::Instance();
+    const uint32 vertexCount = static_cast<uint32>(m_vertices.size());
+    const uint32 triangleCount = static_cast<uint32>(m_indices.size() / 3);
+    m_stats.occluderTriangles = triangleCount;
+
+    m_clipVertices.resize(vertexCount);
+    jobs.ParallelFor(vertexCount, TransformBatch, [&](uint32 begin, uint32 end) {
+        for (uint32 i = begin; i < end; ++i) {
+            m_clipVertices[i] = ToClip(m_vertices[i]);
+        }
+    });
+
+    m_triangles.resize(triangleCount);
+    jobs.ParallelFor(triangleCount, SetupBatch, [&](uint32 begin, uint32 end) {
+        for (uint32 i = begin; i < end; ++i) {
+            RasterTriangle& triangle = m_triangles[i];
+            triangle.valid = SetupTriangle(m_clipVertices[m_indices[i * 3]], m_clipVertices[m_indices[i * 3 + 1]],
+                                           m_clipVertices[m_indices[i * 3 + 2]], triangle);
+        }
+    });
+
+    // Binning is a few tile ranges per triangle, cheaper than merging
+    // per-thread bins
+    for (std::vector<uint32>& bin : m_bins) {
+        bin.clear();
+    }
+    for (uint32 i = 0; i < triangleCount; ++i) {
+        const RasterTriangle& triangle = m_triangles[i];
+        if (!triangle.valid) {
+            continue;
+        }
+        ++m_stats.rasterizedTriangles;
+        for (uint32 ty = triangle.minY / TileHeight; ty <= uint32(triangle.maxY) / TileHeight; ++ty) {
+            for (uint32 tx = triangle.minX / TileWidth; tx <= uint32(triangle.maxX) / TileWidth; ++tx) {
+                m_bins[ty * m_tilesX + tx].push_back(i);
+            }
+        }
+    }
+
+    jobs.ParallelFor(m_tilesX * m_tilesY, 1, [&](uint32 begin, uint32 end) {
+        for (uint32 tile = begin; tile < end; ++tile) {
+            RasterizeTile(tile);
+        }
+    });
+
+    s_occluderTriangles.Set(m_stats.rasterizedTriangles);
+}
+
+void OcclusionCuller::RasterizeTile(uint32 tile) {
+    const int32 tileX = static_cast<int32>((tile % m_tilesX) * TileWidth);
+    const int32 tileY = static_cast<int32>((tile / m_tilesX) * TileHeight);
+
+    for (int32 y = tileY; y < tileY + int32(TileHeight); ++y) {
+        std::fill_n(m_depth.data() + size_t(y) * m_width + tileX, TileWidth, 1.0f);
+    }
+
+    for (uint32 index : m_bins[tile]) {
+        const RasterTriangle& triangle = m_triangles[index];
+        // Spans start on a multiple of 4 and may run up to 3 pixels past the
+        // triangle; tiles are multiples of 4 wide, so they stay in the tile
+        int32 startX = std::max(triangle.minX, tileX) & ~3;
+        int32 endX = std::min(triangle.maxX + 1, tileX + int32(TileWidth));
+        endX = startX + ((endX - startX + 3) & ~3);
+        int32 startY = std::max(triangle.minY, tileY);
+        int32 endY = std::min(triangle.maxY + 1, tileY + int32(TileHeight));
+
+        for (int32 y = startY; y < endY; ++y) {
+            RasterizeSpan(m_depth.data() + size_t(y) * m_width, startX, endX, startX + 0.5f, y + 0.5f,
+                          triangle.edgeA, triangle.edgeB, triangle.edgeC,
+                          triangle.depthA, triangle.depthB, triangle.depthC);
+        }
+    }
+
+    for (int32 by = tileY; by < tileY + int32(TileHeight); by += BlockSize) {
+        for (int32 bx = tileX; bx < tileX + int32(TileWidth); bx += BlockSize) {
+            float32 farthest = 0.0f;
+            for (int32 y = by; y < by + int32(BlockSize); ++y) {
+                const float32* row = m_depth.data() + size_t(y) * m_width + bx;
+                farthest = std::max(farthest, *std::max_element(row, row + BlockSize));
+            }
+            m_blockMaxDepth[(by / BlockSize) * m_blocksX + bx / BlockSize] = farthest;
+        }
+    }
+}
+
+bool OcclusionCuller::IsOccluded(const Vector3& center, const Vector3& extents) const {
+    ScreenBounds screen;
+    if (!ProjectBox(m_viewProjection, float32(m_width), float32(m_height), center, extents, screen)) {
+        return false;
+    }
+    const float32 minX = screen.minX;
+    const float32 maxX = screen.maxX;
+    const float32 minY = screen.minY;
+    const float32 maxY = screen.maxY;
+    const float32 nearest = screen.nearest;
+
+    if (maxX < 0.0f || minX >= m_width || maxY < 0.0f || minY >= m_height) {
+        return false;   // Off screen; left to the frustum culler
+    }
+
+    // Every pixel the box touches plus a one pixel border. Occluders fill
+    // pixels whose center they cover, so a partly covered pixel on their
+    // silhouette always has an uncovered neighbor the border reaches.
+    // Clamped to the screen first, so truncation is floor
+    int32 x0 = std::max(static_cast<int32>(std::max(minX, 0.0f)) - 1, 0);
+    int32 x1 = std::min(static_cast<int32>(std::min(maxX, float32(m_width))) + 1, static_cast<int32>(m_width) - 1);
+    int32 y0 = std::max(static_cast<int32>(std::max(minY, 0.0f)) - 1, 0);
+    int32 y1 = std::min(static_cast<int32>(std::min(maxY, float32(m_height))) + 1, static_cast<int32>(m_height) - 1);
+
+    // Blocks entirely nearer than the box hide their part of it; the rest
+    // are checked per pixel. Most boxes span at most 2x2 blocks, which one
+    // compare settles without loop branches.
+    const int32 blockX0 = x0 / int32(BlockSize);
+    const int32 blockX1 = x1 / int32(BlockSize);
+    const int32 blockY0 = y0 / int32(BlockSize);
+    const int32 blockY1 = y1 / int32(BlockSize);
+    if (blockX1 - blockX0 <= 1 && blockY1 - blockY0 <= 1) {
+        const float32* top = m_blockMaxDepth.data() + blockY0 * m_blocksX;
+        const float32* bottom = m_blockMaxDepth.data() + blockY1 * m_blocksX;
+        float32 farthest = std::max(std::max(top[blockX0], top[blockX1]), std::max(bottom[blockX0], bottom[blockX1]));
+        if (farthest < nearest) {
+            return true;
+        }
+    }
+
+    for (int32 by = blockY0; by <= blockY1; ++by) {
+        for (int32 bx = blockX0; bx <= blockX1; ++bx) {
+            if (m_blockMaxDepth[by * m_blocksX + bx] < nearest) {
+                continue;
+            }
+            int32 px0 = std::max(x0, bx * int32(BlockSize));
+            int32 px1 = std::min(x1, bx * int32(BlockSize) + int32(BlockSize) - 1);
+            int32 py0 = std::max(y0, by * int32(BlockSize));
+            int32 py1 = std::min(y1, by * int32(BlockSize) + int32(BlockSize) - 1);
+            for (int32 y = py0; y <= py1; ++y) {
+                const float32* row = m_depth.data() + size_t(y) * m_width;
+                for (int32 x = px0; x <= px1; ++x) {
+                    if (row[x] >= nearest) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+uint32 OcclusionCuller::Cull(const CullingBounds& bounds, std::span<const uint32> candidates) {
+    const uint32 count = static_cast<uint32>(candidates.size());
+    m_stats.tested = count;
+    m_visibleCount = 0;
+    if (m_visible.size() < count) {
+        m_visible.resize(count);
+        m_scratch.resize(count);
+    }
+
+    const float32* centerX = bounds.GetCenterX();
+    const float32* centerY = bounds.GetCenterY();
+    const float32* centerZ = bounds.GetCenterZ();
+    const float32* extentX = bounds.GetExtentX();
+    const float32* extentY = bounds.GetExtentY();
+    const float32* extentZ = bounds.GetExtentZ();
+    auto cullRange = [&](uint32 begin, uint32 end, uint32* out) {
+        uint32 written = 0;
+        for (uint32 i = begin; i < end; ++i) {
+            uint32 index = candidates[i];
+            if (!IsOccluded({centerX[index], centerY[index], centerZ[index]},
+                            {extentX[index], extentY[index], extentZ[index]})) {
+                out[written++] = index;
+            }
+        }
+        return written;
+    };
+
+    // Same chunk-and-pack scheme as FrustumCuller::Cull
+    JobSystem& jobs = JobSystem::Instance();
+    uint32 threads = jobs.GetWorkerCount() + 1;
+    uint32 chunkSize = std::max(MinTestChunk, (count + threads * ChunksPerThread - 1) / (threads * ChunksPerThread));
+    uint32 chunks = (count + chunkSize - 1) / chunkSize;
+    if (chunks <= 1) {
+        m_visibleCount = cullRange(0, count, m_visible.data());
+    } else {
+        m_chunkCounts.resize(chunks);
+        m_chunkOffsets.resize(chunks);
+        jobs.ParallelFor(chunks, 1, [&](uint32 first, uint32 last) {
+            for (uint32 chunk = first; chunk < last; ++chunk) {
+                uint32 begin = chunk * chunkSize;
+                m_chunkCounts[chunk] = cullRange(begin, std::min(begin + chunkSize, count), m_scratch.data() + begin);
+            }
+        });
+
+        for (uint32 chunk = 0; chunk < chunks; ++chunk) {
+            m_chunkOffsets[chunk] = m_visibleCount;
+            m_visibleCount += m_chunkCounts[chunk];
+        }
+
+        jobs.ParallelFor(chunks, 1, [&](uint32 first, uint32 last) {
+            for (uint32 chunk = first; chunk < last; ++chunk) {
+                memcpy(m_visible.data() + m_chunkOffsets[chunk], m_scratch.data() + chunk * chunkSize,
+                       m_chunkCounts[chunk] * sizeof(uint32));
+            }
+        });
+    }
+
+    m_stats.occluded = count - m_visibleCount;
+    s_occlusionTested.Set(count);
+    s_occlusionCulled.Set(m_stats.occluded);
+    return m_visibleCount;
+}
+
+} // namespace XeSS::Rendering
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include "FrustumCuller.h"
+#include <span>
+#include <vector>
+
+namespace XeSS::Rendering {
+
+struct OcclusionStats {
+    uint32 occluderTriangles = 0;   // Added this frame
+    uint32 rasterizedTriangles = 0; // Left after near-plane, backface and size rejection
+    uint32 tested = 0;
+    uint32 occluded = 0;
+};
+
+/**
+ * CPU occlusion culling against a small depth buffer. Each frame, a few
+ * large occluders (walls, terrain, buildings) are rasterized into it, and
+ * objects whose bounding box lies behind them everywhere it covers are
+ * dropped before they reach the draw queue.
+ *
+ * The buffer is split into tiles rasterized in parallel on the job system,
+ * four pixels at a time with SSE2 where available. Depth is D3D's 0..1 with
+ * the nearest occluder kept per pixel; a max-depth level per 8x8 block
+ * rejects most occludees without reading pixels.
+ *
+ * The results are conservative. Occluders write their farthest depth
+ * within each pixel, occludees are tested with a one pixel border, triangles
+ * crossing the near plane are skipped, and boxes crossing it are always
+ * visible. Occluders must be clockwise when seen from outside, as D3D's
+ * default front face.
+ */
+class OcclusionCuller : public NonCopyable {
+public:
+    static constexpr uint32 TileWidth = 32;
+    static constexpr uint32 TileHeight = 16;
+    static constexpr uint32 BlockSize = 8;     // Pixels per side of one max-depth entry
+    static constexpr uint32 DefaultWidth = 320;
+    static constexpr uint32 DefaultHeight = 192;
+
+    // Rounds the size up to whole tiles
+    void Initialize(uint32 width = DefaultWidth, uint32 height = DefaultHeight);
+
+    // Same matrix convention as Frustum::FromViewProjection; drops last
+    // frame's occluders
+    void BeginFrame(const float32 (&viewProjection)[16]);
+
+    // World-space triangle list
+    void AddOccluder(std::span<const Vector3> vertices, std::span<const uint32> indices);
+    void AddOccluderBox(const Vector3& center, const Vector3& extents);
+
+    // Rasterizes everything added since BeginFrame
+    void RenderOccluders();
+
+    // Keeps the candidates whose box is not hidden; typically the frustum
+    // culler's output. Returns GetVisible().size().
+    uint32 Cull(const CullingBounds& bounds, std::span<const uint32> candidates);
+
+    // Safe to call from several threads once RenderOccluders returned
+    bool IsOccluded(const Vector3& center, const Vector3& extents) const;
+
+    std::span<const uint32> GetVisible() const { return {m_visible.data(), m_visibleCount}; }
+    const OcclusionStats& GetStats() const { return m_stats; }
+
+    uint32 GetWidth() const { return m_width; }
+    uint32 GetHeight() const { return m_height; }
+    const std::vector<float32>& GetDepth() const { return m_depth; }
+
+private:
+    // Screen-space triangle: three edge functions A*x + B*y + C, non-negative
+    // inside, and the depth plane in the same form
+    struct RasterTriangle {
+        float32 edgeA[3];
+        float32 edgeB[3];
+        float32 edgeC[3];
+        float32 depthA;
+        float32 depthB;
+        float32 depthC;
+        int32 minX;
+        int32 minY;
+        int32 maxX;
+        int32 maxY;
+        bool valid;
+    };
+
+    Vector4 ToClip(const Vector3& position) const;
+    bool SetupTriangle(const Vector4& a, const Vector4& b, const Vector4& c, RasterTriangle& triangle) const;
+    void RasterizeTile(uint32 tile);
+
+    uint32 m_width = 0;
+    uint32 m_height = 0;
+    uint32 m_tilesX = 0;
+    uint32 m_tilesY = 0;
+    uint32 m_blocksX = 0;
+    float32 m_viewProjection[16]{};
+
+    std::vector<float32> m_depth;
+    std::vector<float32> m_blockMaxDepth;
+
+    std::vector<Vector3> m_vertices;
+    std::vector<uint32> m_indices;
+    std::vector<Vector4> m_clipVertices;
+    std::vector<RasterTriangle> m_triangles;
+    std::vector<std::vector<uint32>> m_bins;    // Triangle indices per tile
+
+    std::vector<uint32> m_scratch;
+    std::vector<uint32> m_visible;
+    std::vector<uint32> m_chunkCounts;
+    std::vector<uint32> m_chunkOffsets;
+    uint32 m_visibleCount = 0;
+    OcclusionStats m_stats;
+};
+
+} // namespace XeSS::Rendering
@@ -0,0 +1,80 @@
+#include "RenderStateCache.h"
+
+namespace XeSS::Rendering {
+
+void RenderStateCache::SetVertexShader(ID3D11VertexShader* shader) {
+    if (Update(m_vertexShader, shader)) {
+        m_context->VSSetShader(shader, nullptr, 0);
+    }
+}
+
+void RenderStateCache::SetPixelShader(ID3D11PixelShader* shader) {
+    if (Update(m_pixelShader, shader)) {
+        m_context->PSSetShader(shader, nullptr, 0);
+    }
+}
+
+void RenderStateCache::SetInputLayout(ID3D11InputLayout* layout) {
+    if (Update(m_inputLayout, layout)) {
+        m_context->IASetInputLayout(layout);
+    }
+}
+
+void RenderStateCache::SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) {
+    if (Update(m_topology, topology)) {
+        m_context->IASetPrimitiveTopology(topology);
+    }
+}
+
+void RenderStateCache::SetBlendState(ID3D11BlendState* state) {
+    if (Update(m_blendState, state)) {
+        m_context->OMSetBlendState(state, nullptr, 0xFFFFFFFF);
+    }
+}
+
+void RenderStateCache::SetDepthStencilState(ID3D11DepthStencilState* state, uint32 stencilRef) {
+    if (Update(m_depthStencil, DepthStencilBinding{state, stencilRef})) {
+        m_context->OMSetDepthStencilState(state, stencilRef);
+    }
+}
+
+void RenderStateCache::SetRasterizerState(ID3D11RasterizerState* state) {
+    if (Update(m_rasterizerState, state)) {
+        m_context->RSSetState(state);
+    }
+}
+
+void RenderStateCache::SetVertexBuffer(ID3D11Buffer* buffer, uint32 stride, uint32 offset) {
+    if (Update(m_vertexBuffer, VertexBufferBinding{buffer, stride, offset})) {
+        UINT strides[] = {stride};
+        UINT offsets[] = {offset};
+        m_context->IASetVertexBuffers(0, 1, &buffer, strides, offsets);
+    }
+}
+
+void RenderStateCache::SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, uint32 offset) {
+    if (Update(m_indexBuffer, IndexBufferBinding{buffer, format, offset})) {
+        m_context->IASetIndexBuffer(buffer, format, offset);
+    }
+}
+
+void RenderStateCache::SetConstantBuffer(uint32 slot, ID3D11Buffer* buffer) {
+    if (slot < MaxConstantBuffers && Update(m_constantBuffers[slot], buffer)) {
+        m_context->VSSetConstantBuffers(slot, 1, &buffer);
+        m_context->PSSetConstantBuffers(slot, 1, &buffer);
+    }
+}
+
+void RenderStateCache::SetTexture(uint32 slot, ID3D11ShaderResourceView* view) {
+    if (slot < MaxTextures && Update(m_textures[slot], view)) {
+        m_context->PSSetShaderResources(slot, 1, &view);
+    }
+}
+
+void RenderStateCache::SetSampler(uint32 slot, ID3D11SamplerState* sampler) {
+    if (slot < MaxSamplers && Update(m_samplers[slot], sampler)) {
+        m_context->PSSetSamplers(slot, 1, &sampler);
+    }
+}
+
+} // namespace XeSS::Rendering
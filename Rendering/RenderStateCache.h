@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include <d3d11.h>
+
+namespace XeSS::Rendering {
+
+/**
+ * Filters redundant D3D11 state calls on one context: a call that would bind
+ * the object already bound through the cache is skipped. Code that binds on
+ * the context directly must call Invalidate() afterwards, as must the owner
+ * at the start of each frame.
+ *
+ * Constant buffers go to the vertex and pixel stage, textures and samplers
+ * to the pixel stage.
+ */
+class RenderStateCache : public NonCopyable {
+public:
+    static constexpr uint32 MaxConstantBuffers = 4;
+    static constexpr uint32 MaxTextures = 8;
+    static constexpr uint32 MaxSamplers = 4;
+
+    explicit RenderStateCache(ID3D11DeviceContext* context) : m_context(context) {}
+
+    ID3D11DeviceContext* GetContext() const { return m_context; }
+
+    // Forgets everything, so the next call of each kind reaches the context
+    void Invalidate() { ++m_generation; }
+
+    void SetVertexShader(ID3D11VertexShader* shader);
+    void SetPixelShader(ID3D11PixelShader* shader);
+    void SetInputLayout(ID3D11InputLayout* layout);
+    void SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
+    void SetBlendState(ID3D11BlendState* state);
+    void SetDepthStencilState(ID3D11DepthStencilState* state, uint32 stencilRef);
+    void SetRasterizerState(ID3D11RasterizerState* state);
+    void SetVertexBuffer(ID3D11Buffer* buffer, uint32 stride, uint32 offset = 0);
+    void SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, uint32 offset = 0);
+    void SetConstantBuffer(uint32 slot, ID3D11Buffer* buffer);
+    void SetTexture(uint32 slot, ID3D11ShaderResourceView* view);
+    void SetSampler(uint32 slot, ID3D11SamplerState* sampler);
+
+    // Calls that reached the context, and calls filtered out
+    uint64 GetAppliedCount() const { return m_applied; }
+    uint64 GetSkippedCount() const { return m_skipped; }
+
+private:
+    // A slot is known only if it was set in the current generation
+    template<typename T>
+    struct Slot {
+        T value{};
+        uint32 generation = 0;
+    };
+
+    template<typename T>
+    bool Update(Slot<T>& slot, const T& value) {
+        if (slot.generation == m_generation && slot.value == value) {
+            ++m_skipped;
+            return false;
+        }
+        slot.value = value;
+        slot.generation = m_generation;
+        ++m_applied;
+        return true;
+    }
+
+    struct VertexBufferBinding {
+        ID3D11Buffer* buffer;
+        uint32 stride;
+        uint32 offset;
+        bool operator==(const VertexBufferBinding&) const = default;
+    };
+
+    struct IndexBufferBinding {
+        ID3D11Buffer* buffer;
+        DXGI_FORMAT format;
+        uint32 offset;
+        bool operator==(const IndexBufferBinding&) const = default;
+    };
+
+    struct DepthStencilBinding {
+        ID3D11DepthStencilState* state;
+        uint32 stencilRef;
+        bool operator==(const DepthStencilBinding&) const = default;
+    };
+
+    ID3D11DeviceContext* m_context;
+    uint32 m_generation = 1;
+    uint64 m_applied = 0;
+    uint64 m_skipped = 0;
+
+    Slot<ID3D11VertexShader*> m_vertexShader;
+    Slot<ID3D11PixelShader*> m_pixelShader;
+    Slot<ID3D11InputLayout*> m_inputLayout;
+    Slot<D3D11_PRIMITIVE_TOPOLOGY> m_topology;
+    Slot<ID3D11BlendState*> m_blendState;
+    Slot<DepthStencilBinding> m_depthStencil;
+    Slot<ID3D11RasterizerState*> m_rasterizerState;
+    Slot<VertexBufferBinding> m_vertexBuffer;
+    Slot<IndexBufferBinding> m_indexBuffer;
+    Slot<ID3D11Buffer*> m_constantBuffers[MaxConstantBuffers];
+    Slot<ID3D11ShaderResourceView*> m_textures[MaxTextures];
+    Slot<ID3D11SamplerState*> m_samplers[MaxSamplers];
+};
+
+} // namespace XeSS::Rendering
@@ -0,0 +1,301 @@
+#include "TransformSystem.h"
+#include "Core/JobSystem.h"
+#include "Core/Logger.h"
+#include "Core/Metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XESS_TRANSFORM_SSE2 1
+#endif
+
+namespace XeSS::Rendering {
+
+namespace {
+    MetricsRegistry& Registry() { return MetricsRegistry::Instance(); }
+
+    MetricGauge& s_transforms = Registry().Gauge("render.transforms", "Transforms in the transform system");
+    MetricGauge& s_transformsUpdated = Registry().Gauge("render.transforms_updated", "World matrices recomputed last update");
+
+    constexpr uint32 UpdateBatch = 4096;
+    constexpr uint32 BoundsBatch = 4096;
+
+    // Moves the surviving entries of a per-dense-index array to their new
+    // slots; order[i] is the old index of new index i
+    template<typename T>
+    void Permute(std::vector<T>& values, const std::vector<uint32>& order) {
+        std::vector<T> permuted(order.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            permuted[i] = values[order[i]];
+        }
+        values.swap(permuted);
+    }
+}
+
+Transform3x4 Transform3x4::FromTranslation(const Vector3& translation) {
+    Transform3x4 transform;
+    transform.rows[0].w = translation.x;
+    transform.rows[1].w = translation.y;
+    transform.rows[2].w = translation.z;
+    return transform;
+}
+
+Transform3x4 Transform3x4::FromTranslationRotationScale(const Vector3& translation, const Vector4& rotation,
+                                                        const Vector3& scale) {
+    const float32 x = rotation.x;
+    const float32 y = rotation.y;
+    const float32 z = rotation.z;
+    const float32 w = rotation.w;
+
+    Transform3x4 transform;
+    transform.rows[0] = {(1.0f - 2.0f * (y * y + z * z)) * scale.x, 2.0f * (x * y - w * z) * scale.y,
+                         2.0f * (x * z + w * y) * scale.z, translation.x};
+    transform.rows[1] = {2.0f * (x * y + w * z) * scale.x, (1.0f - 2.0f * (x * x + z * z)) * scale.y,
+                         2.0f * (y * z - w * x) * scale.z, translation.y};
+    transform.rows[2] = {2.0f * (x * z - w * y) * scale.x, 2.0f * (y * z + w * x) * scale.y,
+                         (1.0f - 2.0f * (x * x + y * y)) * scale.z, translation.z};
+    return transform;
+}
+
+Vector3 Transform3x4::TransformPoint(const Vector3& point) const {
+    auto row = [&](const Vector4& r) { return r.x * point.x + r.y * point.y + r.z * point.z + r.w; };
+    return {row(rows[0]), row(rows[1]), row(rows[2])};
+}
+
+Transform3x4 Multiply(const Transform3x4& parent, const Transform3x4& child) {
+    // Each result row is the parent row's weights applied to the child's
+    // rows, plus the parent's translation
+    Transform3x4 result;
+#ifdef XESS_TRANSFORM_SSE2
+    const __m128 child0 = _mm_loadu_ps(&child.rows[0].x);
+    const __m128 child1 = _mm_loadu_ps(&child.rows[1].x);
+    const __m128 child2 = _mm_loadu_ps(&child.rows[2].x);
+    for (uint32 r = 0; r < 3; ++r) {
+        const Vector4& p = parent.rows[r];
+        __m128 row = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), child0), _mm_mul_ps(_mm_set1_ps(p.y), child1)),
+                                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.z), child2), _mm_set_ps(p.w, 0.0f, 0.0f, 0.0f)));
+        _mm_storeu_ps(&result.rows[r].x, row);
+    }
+#else
+    for (uint32 r = 0; r < 3; ++r) {
+        const Vector4& p = parent.rows[r];
+        const Vector4& c0 = child.rows[0];
+        const Vector4& c1 = child.rows[1];
+        const Vector4& c2 = child.rows[2];
+        result.rows[r] = {p.x * c0.x + p.y * c1.x + p.z * c2.x,
+                          p.x * c0.y + p.y * c1.y + p.z * c2.y,
+                          p.x * c0.z + p.y * c1.z + p.z * c2.z,
+                          p.x * c0.w + p.y * c1.w + p.z * c2.w + p.w};
+    }
+#endif
+    return result;
+}
+
+TransformHandle TransformSystem::Create(const Transform3x4& local, TransformHandle parent) {
+    uint32 parentIndex = InvalidTransform;
+    if (parent != InvalidTransform) {
+        if (IsValid(parent)) {
+            parentIndex = m_denseIndex[parent];
+        } else {
+            XESS_WARNING("Transform parent {} is not valid; creating a root", parent);
+        }
+    }
+
+    TransformHandle handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    } else {
+        handle = static_cast<TransformHandle>(m_denseIndex.size());
+        m_denseIndex.push_back(InvalidTransform);
+    }
+
+    // Appended after its parent; Update() moves it into its level
+    uint32 index = GetCount();
+    m_denseIndex[handle] = index;
+    m_local.push_back(local);
+    m_world.push_back(local);
+    m_previousWorld.push_back(local);
+    m_parent.push_back(parentIndex);
+    m_depth.push_back(parentIndex == InvalidTransform ? 0 : static_cast<uint16>(m_depth[parentIndex] + 1));
+    m_flags.push_back(Dirty | Created);
+    m_boundsCenter.push_back({});
+    m_boundsExtents.push_back({});
+    m_handle.push_back(handle);
+    m_needsReorder = true;
+    return handle;
+}
+
+void TransformSystem::Destroy(TransformHandle handle) {
+    if (!IsValid(handle)) {
+        return;
+    }
+    m_flags[m_denseIndex[handle]] |= Destroyed;
+    m_needsReorder = true;
+}
+
+bool TransformSystem::IsValid(TransformHandle handle) const {
+    return handle < m_denseIndex.size() && m_denseIndex[handle] != InvalidTransform &&
+           !(m_flags[m_denseIndex[handle]] & Destroyed);
+}
+
+uint32 TransformSystem::GetDenseIndex(TransformHandle handle) const {
+    return handle < m_denseIndex.size() ? m_denseIndex[handle] : InvalidTransform;
+}
+
+void TransformSystem::SetLocal(TransformHandle handle, const Transform3x4& local) {
+    if (!IsValid(handle)) {
+        XESS_WARNING_RATE_LIMITED(1, 1, "SetLocal on invalid transform {}", handle);
+        return;
+    }
+    uint32 index = m_denseIndex[handle];
+    m_local[index] = local;
+    m_flags[index] |= Dirty;
+}
+
+const Transform3x4& TransformSystem::GetLocal(TransformHandle handle) const {
+    static const Transform3x4 identity;
+    return IsValid(handle) ? m_local[m_denseIndex[handle]] : identity;
+}
+
+void TransformSystem::SetLocalBounds(TransformHandle handle, const Vector3& center, const Vector3& extents) {
+    if (!IsValid(handle)) {
+        return;
+    }
+    uint32 index = m_denseIndex[handle];
+    m_boundsCenter[index] = center;
+    m_boundsExtents[index] = extents;
+}
+
+void TransformSystem::Reorder() {
+    const uint32 count = GetCount();
+
+    // Parents always precede their children in dense order, so one forward
+    // pass carries destruction down whole subtrees
+    std::vector<uint32> levelCounts;
+    for (uint32 i = 0; i < count; ++i) {
+        uint32 parent = m_parent[i];
+        if (parent != InvalidTransform && (m_flags[parent] & Destroyed)) {
+            m_flags[i] |= Destroyed;
+        }
+        if (m_flags[i] & Destroyed) {
+            continue;
+        }
+        if (m_depth[i] >= levelCounts.size()) {
+            levelCounts.resize(m_depth[i] + 1, 0);
+        }
+        ++levelCounts[m_depth[i]];
+    }
+
+    // Stable counting sort by depth
+    m_levelStart.assign(levelCounts.size() + 1, 0);
+    for (size_t depth = 0; depth < levelCounts.size(); ++depth) {
+        m_levelStart[depth + 1] = m_levelStart[depth] + levelCounts[depth];
+    }
+    std::vector<uint32> cursors(m_levelStart.begin(), m_levelStart.end() - 1);
+    std::vector<uint32> order(m_levelStart.back());
+    std::vector<uint32> newIndex(count, InvalidTransform);
+    for (uint32 i = 0; i < count; ++i) {
+        if (m_flags[i] & Destroyed) {
+            m_denseIndex[m_handle[i]] = InvalidTransform;
+            m_freeHandles.push_back(m_handle[i]);
+            continue;
+        }
+        uint32 target = cursors[m_depth[i]]++;
+        order[target] = i;
+        newIndex[i] = target;
+    }
+
+    Permute(m_local, order);
+    Permute(m_world, order);
+    Permute(m_previousWorld, order);
+    Permute(m_parent, order);
+    Permute(m_depth, order);
+    Permute(m_flags, order);
+    Permute(m_boundsCenter, order);
+    Permute(m_boundsExtents, order);
+    Permute(m_handle, order);
+
+    for (uint32 i = 0; i < order.size(); ++i) {
+        if (m_parent[i] != InvalidTransform) {
+            m_parent[i] = newIndex[m_parent[i]];
+        }
+        m_denseIndex[m_handle[i]] = i;
+    }
+    m_needsReorder = false;
+}
+
+void TransformSystem::Update() {
+    m_stats = {};
+    if (m_needsReorder) {
+        Reorder();
+        m_stats.reordered = true;
+    }
+
+    m_stats.transforms = GetCount();
+    m_stats.levels = m_levelStart.empty() ? 0 : static_cast<uint32>(m_levelStart.size() - 1);
+
+    // Levels run in order, since each reads its parents' new world matrices
+    // and change flags; the transforms within a level are independent
+    JobSystem& jobs = JobSystem::Instance();
+    std::atomic<uint32> updated{0};
+    for (uint32 level = 0; level < m_stats.levels; ++level) {
+        uint32 begin = m_levelStart[level];
+        uint32 end = m_levelStart[level + 1];
+        jobs.ParallelFor(end - begin, UpdateBatch, [&](uint32 first, uint32 last) {
+            updated.fetch_add(UpdateRange(begin + first, begin + last), std::memory_order_relaxed);
+        });
+    }
+
+    m_stats.updated = updated.load(std::memory_order_relaxed);
+    s_transforms.Set(m_stats.transforms);
+    s_transformsUpdated.Set(m_stats.updated);
+}
+
+uint32 TransformSystem::UpdateRange(uint32 begin, uint32 end) {
+    uint32 updated = 0;
+    for (uint32 i = begin; i < end; ++i) {
+        uint8 flags = m_flags[i];
+        uint32 parent = m_parent[i];
+        bool dirty = (flags & Dirty) || (parent != InvalidTransform && (m_flags[parent] & Moved));
+
+        // Last frame's world matrix; one that stopped moving needs a final
+        // copy, one that stays still needs nothing
+        if (dirty || (flags & Moved)) {
+            m_previousWorld[i] = m_world[i];
+        }
+        if (dirty) {
+            m_world[i] = parent == InvalidTransform ? m_local[i] : Multiply(m_world[parent], m_local[i]);
+            ++updated;
+        }
+        if (flags & Created) {
+            m_previousWorld[i] = m_world[i];
+        }
+        m_flags[i] = dirty ? Moved : 0;
+    }
+    return updated;
+}
+
+void TransformSystem::ExportBounds(CullingBounds& bounds) const {
+    const uint32 count = GetCount();
+    bounds.Resize(count);
+    JobSystem::Instance().ParallelFor(count, BoundsBatch, [&](uint32 begin, uint32 end) {
+        for (uint32 i = begin; i < end; ++i) {
+            // The box's world extents are its local ones through the
+            // absolute value of the matrix
+            const Transform3x4& world = m_world[i];
+            const Vector3& extents = m_boundsExtents[i];
+            auto reach = [&](const Vector4& row) {
+                return std::fabs(row.x) * extents.x + std::fabs(row.y) * extents.y + std::fabs(row.z) * extents.z;
+            };
+            Vector3 worldExtents{reach(world.rows[0]), reach(world.rows[1]), reach(world.rows[2])};
+            float32 radius = std::sqrt(worldExtents.x * worldExtents.x + worldExtents.y * worldExtents.y +
+                                       worldExtents.z * worldExtents.z);
+            bounds.Set(i, world.TransformPoint(m_boundsCenter[i]), radius, worldExtents);
+        }
+    });
+}
+
+} // namespace XeSS::Rendering
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include "FrustumCuller.h"
+#include <vector>
+
+namespace XeSS::Rendering {
+
+/**
+ * Affine transform stored as the top three rows of a 4x4 matrix applied to
+ * column vectors: rows[i] dotted with (x, y, z, 1) gives component i. This
+ * is the layout InstanceData uploads, so rows can be copied as they are.
+ */
+struct Transform3x4 {
+    Vector4 rows[3]{{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}};
+
+    static Transform3x4 FromTranslation(const Vector3& translation);
+
+    // rotation is a unit quaternion (x, y, z, w); scale is applied first
+    static Transform3x4 FromTranslationRotationScale(const Vector3& translation, const Vector4& rotation,
+                                                     const Vector3& scale);
+
+    Vector3 GetTranslation() const { return {rows[0].w, rows[1].w, rows[2].w}; }
+    Vector3 TransformPoint(const Vector3& point) const;
+};
+
+// parent * child: child's space into parent's parent space
+Transform3x4 Multiply(const Transform3x4& parent, const Transform3x4& child);
+
+using TransformHandle = uint32;
+constexpr TransformHandle InvalidTransform = ~0u;
+
+struct TransformUpdateStats {
+    uint32 transforms = 0;
+    uint32 updated = 0;     // World matrix recomputed this frame
+    uint32 levels = 0;
+    bool reordered = false;
+};
+
+/**
+ * Scene transforms in data-oriented form. Each field (local, world and
+ * previous world matrix, parent, depth, dirty flags, local bounds) lives in
+ * its own array, indexed by a dense index. Dense order is sorted by
+ * hierarchy depth, so every parent comes before its children and one level
+ * is one contiguous range.
+ *
+ * Update() walks the levels in order and runs each one in parallel on the
+ * job system. A transform is recomputed when its local matrix was set or
+ * its parent's world matrix changed this frame; the rest are skipped. The
+ * previous world matrix is the world matrix of the last Update(), for
+ * motion vectors.
+ *
+ * Handles are stable. Dense indices, which GetWorld(), ExportBounds() and
+ * the culling output use, stay valid until the next Create or Destroy is
+ * applied by Update(). Not thread-safe.
+ */
+class TransformSystem : public NonCopyable {
+public:
+    TransformHandle Create(const Transform3x4& local = {}, TransformHandle parent = InvalidTransform);
+
+    // Also destroys the transform's descendants
+    void Destroy(TransformHandle handle);
+
+    bool IsValid(TransformHandle handle) const;
+
+    void SetLocal(TransformHandle handle, const Transform3x4& local);
+    const Transform3x4& GetLocal(TransformHandle handle) const;
+
+    // Box in local space; ExportBounds() takes it to world space
+    void SetLocalBounds(TransformHandle handle, const Vector3& center, const Vector3& extents);
+
+    // Applies pending creations and destructions, then propagates world
+    // matrices level by level
+    void Update();
+
+    uint32 GetCount() const { return static_cast<uint32>(m_world.size()); }
+    uint32 GetDenseIndex(TransformHandle handle) const;
+    TransformHandle GetHandle(uint32 denseIndex) const { return m_handle[denseIndex]; }
+
+    const Transform3x4& GetWorld(uint32 denseIndex) const { return m_world[denseIndex]; }
+    const Transform3x4& GetPreviousWorld(uint32 denseIndex) const { return m_previousWorld[denseIndex]; }
+    const std::vector<Transform3x4>& GetWorldMatrices() const { return m_world; }
+    const std::vector<Transform3x4>& GetPreviousWorldMatrices() const { return m_previousWorld; }
+
+    // World-space boxes of every transform, at their dense index
+    void ExportBounds(CullingBounds& bounds) const;
+
+    const TransformUpdateStats& GetStats() const { return m_stats; }
+
+private:
+    enum Flags : uint8 {
+        Dirty = 1 << 0,         // Local matrix set since the last Update()
+        Moved = 1 << 1,         // World matrix changed in the last Update()
+        Destroyed = 1 << 2,
+        Created = 1 << 3,       // No previous world matrix yet
+    };
+
+    void Reorder();
+
+    // Returns how many world matrices were recomputed
+    uint32 UpdateRange(uint32 begin, uint32 end);
+
+    // Per dense index
+    std::vector<Transform3x4> m_local;
+    std::vector<Transform3x4> m_world;
+    std::vector<Transform3x4> m_previousWorld;
+    std::vector<uint32> m_parent;           // Dense index; InvalidTransform for roots
+    std::vector<uint16> m_depth;
+    std::vector<uint8> m_flags;
+    std::vector<Vector3> m_boundsCenter;
+    std::vector<Vector3> m_boundsExtents;
+    std::vector<TransformHandle> m_handle;
+
+    // Per handle
+    std::vector<uint32> m_denseIndex;
+    std::vector<TransformHandle> m_freeHandles;
+
+    std::vector<uint32> m_levelStart;       // Dense range of depth d is [start[d], start[d + 1])
+    bool m_needsReorder = false;
+    TransformUpdateStats m_stats;
+};
+
+} // namespace XeSS::Rendering
@@ -0,0 +1,91 @@
+#include "UploadRing.h"
+#include "Core/Exception.h"
+#include "Core/Logger.h"
+#include <algorithm>
+
+namespace XeSS::Rendering {
+
+void UploadRing::Initialize(ID3D11Device* device, uint32 elementSize, uint32 capacity) {
+    Shutdown();
+    m_device = device;
+    m_elementSize = elementSize;
+    CreateBuffer(std::max<uint32>(capacity, 1));
+}
+
+void UploadRing::Shutdown() {
+    m_view.Reset();
+    m_buffer.Reset();
+    m_device.Reset();
+    m_capacity = 0;
+    m_used = 0;
+    m_mapped = nullptr;
+}
+
+bool UploadRing::Begin(ID3D11DeviceContext* context, uint32 requiredElements) {
+    if (!m_device || m_mapped) {
+        return false;
+    }
+
+    if (requiredElements > m_capacity) {
+        uint32 capacity = m_capacity;
+        while (capacity < requiredElements) {
+            capacity *= 2;
+        }
+        XESS_DEBUG("Growing upload ring from {} to {} elements", m_capacity, capacity);
+        CreateBuffer(capacity);
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    HRESULT hr = context->Map(m_buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    if (FAILED(hr)) {
+        XESS_ERROR("Failed to map upload ring: 0x{:08X}", static_cast<uint32>(hr));
+        return false;
+    }
+    m_mapped = static_cast<uint8*>(mapped.pData);
+    m_used = 0;
+    return true;
+}
+
+UploadRing::Allocation UploadRing::Allocate(uint32 count) {
+    if (!m_mapped || count > m_capacity - m_used) {
+        return {};
+    }
+    Allocation allocation{m_mapped + size_t(m_used) * m_elementSize, m_used, count};
+    m_used += count;
+    return allocation;
+}
+
+void UploadRing::End(ID3D11DeviceContext* context) {
+    if (m_mapped) {
+        context->Unmap(m_buffer.Get(), 0);
+        m_mapped = nullptr;
+    }
+}
+
+void UploadRing::CreateBuffer(uint32 capacity) {
+    D3D11_BUFFER_DESC desc{};
+    desc.ByteWidth = capacity * m_elementSize;
+    desc.Usage = D3D11_USAGE_DYNAMIC;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    desc.StructureByteStride = m_elementSize;
+
+    ComPtr<ID3D11Buffer> buffer;
+    ComPtr<ID3D11ShaderResourceView> view;
+    XESS_THROW_IF_FAILED(m_device->CreateBuffer(&desc, nullptr, &buffer), "Failed to create upload ring buffer");
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc{};
+    viewDesc.Format = DXGI_FORMAT_UNKNOWN;
+    viewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+    viewDesc.Buffer.FirstElement = 0;
+    viewDesc.Buffer.NumElements = capacity;
+    XESS_THROW_IF_FAILED(m_device->CreateShaderResourceView(buffer.Get(), &viewDesc, &view),
+                         "Failed to create upload ring view");
+
+    m_buffer = std::move(buffer);
+    m_view = std::move(view);
+    m_capacity = capacity;
+}
+
+} // namespace XeSS::Rendering
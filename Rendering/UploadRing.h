@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+#include <d3d11.h>
+#include <wrl/client.h>
+
+namespace XeSS::Rendering {
+
+using Microsoft::WRL::ComPtr;
+
+/**
+ * Per-frame upload space for structured GPU data. Each frame maps one
+ * dynamic structured buffer with WRITE_DISCARD, so the driver renames it
+ * while the GPU still reads earlier frames' copies. Callers bump-allocate
+ * elements between Begin() and End() and address them by element index
+ * through the shader resource view.
+ *
+ * Begin() grows the buffer, by doubling, when the frame needs more than it
+ * holds.
+ */
+class UploadRing : public NonCopyable {
+public:
+    struct Allocation {
+        void* data = nullptr;       // Write-only, write-combined memory
+        uint32 firstElement = 0;
+        uint32 count = 0;
+
+        explicit operator bool() const { return data != nullptr; }
+    };
+
+    void Initialize(ID3D11Device* device, uint32 elementSize, uint32 capacity);
+    void Shutdown();
+
+    // Maps the buffer for this frame with room for at least requiredElements
+    bool Begin(ID3D11DeviceContext* context, uint32 requiredElements);
+    Allocation Allocate(uint32 count);
+    void End(ID3D11DeviceContext* context);
+
+    ID3D11ShaderResourceView* GetView() const { return m_view.Get(); }
+    uint32 GetCapacity() const { return m_capacity; }
+    uint32 GetElementSize() const { return m_elementSize; }
+    uint32 GetUsedElements() const { return m_used; }
+
+private:
+    void CreateBuffer(uint32 capacity);
+
+    ComPtr<ID3D11Device> m_device;
+    ComPtr<ID3D11Buffer> m_buffer;
+    ComPtr<ID3D11ShaderResourceView> m_view;
+    uint32 m_elementSize = 0;
+    uint32 m_capacity = 0;
+    uint32 m_used = 0;
+    uint8* m_mapped = nullptr;
+};
+
+} // namespace XeSS::Rendering
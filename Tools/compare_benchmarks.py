@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""Compare two XeSS Engine benchmark result files and flag regressions.
+
+A metric regresses when it got slower by more than --threshold percent AND
+the difference is statistically significant, p < --alpha. Each statistic
+(mean, p50, p95, p99) is tested on its own: Welch's t-test over its value in
+each repetition. Consecutive frames are correlated, so single frames are not
+independent samples; repetitions are. Significance needs at least two
+repetitions on each side.
+
+memory.peak_bytes is the process-lifetime peak (VmHWM on Linux,
+PeakWorkingSetSize on Windows), including startup, so it is compared by
+threshold only and is not specific to any repetition.
+
+Exits with status 1 if anything regressed.
+
+Usage:
+    compare_benchmarks.py baseline.json current.json [--threshold 3] [--alpha 0.01]
+"""
+
+import argparse
+import json
+import math
+import sys
+
+
+STAT_PERCENTILES = {"p50_ms": 50.0, "p95_ms": 95.0, "p99_ms": 99.0}
+
+
+def percentile(samples, pct):
+    # Nearest rank, as FrameStats computes it
+    ordered = sorted(samples)
+    rank = min(max(math.ceil(pct / 100.0 * len(ordered)), 1), len(ordered))
+    return ordered[rank - 1]
+
+
+def repetition_values(results, kind, stat):
+    """One value of stat per repetition that has samples of this kind."""
+    values = []
+    for repetition in results.get("repetitions", []):
+        summary = repetition.get(kind, {})
+        samples = repetition.get(f"{kind}_samples_ms", [])
+        if not samples:
+            continue
+        if stat in summary:
+            values.append(summary[stat])
+        elif stat == "mean_ms":
+            values.append(sum(samples) / len(samples))
+        else:
+            values.append(percentile(samples, STAT_PERCENTILES[stat]))
+    return values
+
+
+def mean_var(samples):
+    n = len(samples)
+    mean = sum(samples) / n
+    var = sum((x - mean) ** 2 for x in samples) / (n - 1) if n > 1 else 0.0
+    return mean, var
+
+
+def betacf(a, b, x):
+    # Continued fraction for the incomplete beta function (Numerical Recipes)
+    max_iter, eps, tiny = 200, 3e-14, 1e-300
+    qab, qap, qam = a + b, a + 1.0, a - 1.0
+    c, d = 1.0, 1.0 - qab * x / qap
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    h = d
+    for m in range(1, max_iter + 1):
+        m2 = 2 * m
+        aa = m * (b - m) * x / ((qam + m2) * (a + m2))
+        d = 1.0 + aa * d
+        d = 1.0 / (d if abs(d) > tiny else tiny)
+        c = 1.0 + aa / c
+        c = c if abs(c) > tiny else tiny
+        h *= d * c
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2))
+        d = 1.0 + aa * d
+        d = 1.0 / (d if abs(d) > tiny else tiny)
+        c = 1.0 + aa / c
+        c = c if abs(c) > tiny else tiny
+        delta = d * c
+        h *= delta
+        if abs(delta - 1.0) < eps:
+            break
+    return h
+
+
+def regularized_beta(a, b, x):
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    log_front = (math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b)
+                 + a * math.log(x) + b * math.log(1.0 - x))
+    front = math.exp(log_front)
+    if x < (a + 1.0) / (a + b + 2.0):
+        return front * betacf(a, b, x) / a
+    return 1.0 - front * betacf(b, a, 1.0 - x) / b
+
+
+def welch_t_test(baseline, current):
+    """Two-sided p-value for a difference in means; NaN below two values a side."""
+    if len(baseline) < 2 or len(current) < 2:
+        return float("nan")
+    m1, v1 = mean_var(baseline)
+    m2, v2 = mean_var(current)
+    se1, se2 = v1 / len(baseline), v2 / len(current)
+    if se1 + se2 == 0.0:
+        return 0.0 if m1 != m2 else 1.0
+    t = (m2 - m1) / math.sqrt(se1 + se2)
+    dof = (se1 + se2) ** 2 / ((se1 ** 2) / (len(baseline) - 1) + (se2 ** 2) / (len(current) - 1))
+    return regularized_beta(dof / 2.0, 0.5, dof / (dof + t * t))
+
+
+def percent_change(old, new):
+    return (new - old) / old * 100.0 if old else 0.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=3.0, help="minimum slowdown in percent")
+    parser.add_argument("--alpha", type=float, default=0.01, help="significance level")
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.current) as f:
+        current = json.load(f)
+
+    name = current.get("scenario", {}).get("name", "?")
+    if baseline.get("scenario", {}).get("name") != name:
+        print(f"warning: comparing different scenarios ({baseline.get('scenario', {}).get('name')} vs {name})")
+
+    regressions = []
+    print(f"{'metric':<14}{'baseline':>12}{'current':>12}{'change':>10}{'p-value':>12}  verdict")
+
+    untested = False
+    for kind in ("cpu", "gpu"):
+        for stat in ("mean_ms", "p50_ms", "p95_ms", "p99_ms"):
+            base_values = repetition_values(baseline, kind, stat)
+            cur_values = repetition_values(current, kind, stat)
+            if not base_values or not cur_values:
+                continue
+
+            old = baseline[kind][stat]
+            new = current[kind][stat]
+            change = percent_change(old, new)
+
+            # A tail can regress without the mean moving, and the other way
+            # round, so every statistic gets its own test
+            p_value = welch_t_test(base_values, cur_values)
+            if math.isnan(p_value):
+                untested = True
+
+            verdict = "ok"
+            if change > args.threshold and p_value < args.alpha:
+                verdict = "REGRESSION"
+                regressions.append(f"{kind}.{stat}")
+            elif change < -args.threshold and p_value < args.alpha:
+                verdict = "improved"
+
+            print(f"{kind + '.' + stat:<14}{old:>12.3f}{new:>12.3f}{change:>9.1f}%{p_value:>12.2e}  {verdict}")
+
+    base_peak = baseline.get("memory", {}).get("peak_bytes", 0)
+    cur_peak = current.get("memory", {}).get("peak_bytes", 0)
+    if base_peak and cur_peak:
+        change = percent_change(base_peak, cur_peak)
+        verdict = "REGRESSION" if change > args.threshold else "ok"
+        if verdict == "REGRESSION":
+            regressions.append("memory.peak_bytes")
+        print(f"{'memory.peak':<14}{base_peak / 2**20:>10.1f}MB{cur_peak / 2**20:>10.1f}MB{change:>9.1f}%{'':>12}  {verdict}")
+        print("  (process-lifetime peak, not per repetition)")
+
+    if untested:
+        print("\nwarning: fewer than two repetitions on one side; p-values are NaN and nothing can regress")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s): {', '.join(regressions)}")
+        return 1
+
+    print("\nNo significant regressions")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
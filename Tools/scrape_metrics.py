@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Scrape the XeSS Engine metrics endpoint and print the current values.
+
+The endpoint is the same string passed in ApplicationConfig::metricsEndpoint:
+"unix:/path/to/socket" or "localhost:PORT". With --interval the scrape
+repeats and counters are also shown as per-second rates.
+
+Usage:
+    scrape_metrics.py unix:/tmp/xess_metrics.sock [--interval 1] [--count 10] [--filter shader]
+"""
+
+import argparse
+import socket
+import sys
+import time
+
+
+def fetch(endpoint, timeout):
+    if endpoint.startswith("unix:"):
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        address = endpoint[len("unix:"):]
+    elif endpoint.startswith("localhost:"):
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        address = ("127.0.0.1", int(endpoint[len("localhost:"):]))
+    else:
+        raise ValueError(f"endpoint must be unix:<path> or localhost:<port>, got '{endpoint}'")
+
+    sock.settimeout(timeout)
+    with sock:
+        sock.connect(address)
+        sock.sendall(b"GET /metrics HTTP/1.0\r\nHost: localhost\r\n\r\n")
+        chunks = []
+        while True:
+            chunk = sock.recv(65536)
+            if not chunk:
+                break
+            chunks.append(chunk)
+
+    response = b"".join(chunks).decode("utf-8", errors="replace")
+    header, _, body = response.partition("\r\n\r\n")
+    status = header.split("\r\n", 1)[0]
+    if " 200 " not in status:
+        raise RuntimeError(f"unexpected response: {status}")
+    return body
+
+
+def parse(text):
+    """Returns ({series: value}, {metric name: type})."""
+    values, types = {}, {}
+    for line in text.splitlines():
+        if not line:
+            continue
+        if line.startswith("# TYPE "):
+            _, _, name, kind = line.split(" ", 3)
+            types[name] = kind
+            continue
+        if line.startswith("#"):
+            continue
+        series, _, value = line.rpartition(" ")
+        values[series] = float(value)
+    return values, types
+
+
+def metric_name(series):
+    return series.split("{", 1)[0]
+
+
+def print_snapshot(values, types, previous, elapsed, name_filter):
+    width = max((len(s) for s in values), default=20)
+    for series in sorted(values):
+        if name_filter and name_filter not in series:
+            continue
+        line = f"{series:<{width}}  {values[series]:>16.6g}"
+        if previous is not None and types.get(metric_name(series)) == "counter" and series in previous:
+            rate = (values[series] - previous[series]) / elapsed
+            line += f"  {rate:>12.6g}/s"
+        print(line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("endpoint")
+    parser.add_argument("--interval", type=float, default=0.0, help="seconds between scrapes (0 = once)")
+    parser.add_argument("--count", type=int, default=0, help="number of scrapes with --interval (0 = forever)")
+    parser.add_argument("--filter", default="", help="only show series containing this text")
+    parser.add_argument("--timeout", type=float, default=2.0)
+    args = parser.parse_args()
+
+    previous, previous_time, scrapes = None, None, 0
+    while True:
+        try:
+            text = fetch(args.endpoint, args.timeout)
+        except (OSError, RuntimeError, ValueError) as e:
+            print(f"error: {e}", file=sys.stderr)
+            return 1
+
+        now = time.monotonic()
+        values, types = parse(text)
+        elapsed = now - previous_time if previous_time is not None else 0.0
+
+        if scrapes:
+            print()
+        print(f"--- {args.endpoint} ({len(values)} series)")
+        print_snapshot(values, types, previous if elapsed > 0 else None, elapsed, args.filter)
+
+        scrapes += 1
+        if args.interval <= 0 or (args.count and scrapes >= args.count):
+            return 0
+
+        previous, previous_time = values, now
+        time.sleep(args.interval)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
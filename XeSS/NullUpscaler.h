@@ -0,0 +1,33 @@
+#pragma once
+
+#include "UpscalerInterface.h"
+
+namespace XeSS::XeSSModule {
+
+// Headless upscaler: keeps the resolutions it is configured with and only
+// counts Execute() calls
+class NullUpscaler : public IUpscaler {
+public:
+    NullUpscaler(const Resolution& outputResolution, const Resolution& inputResolution)
+        : m_outputResolution(outputResolution)
+        , m_inputResolution(inputResolution) {}
+
+    void Configure(const Resolution& outputResolution, const Resolution& inputResolution) {
+        m_outputResolution = outputResolution;
+        m_inputResolution = inputResolution;
+    }
+
+    void Execute() { ++m_executeCount; }
+
+    Resolution GetInputResolution() const override { return m_inputResolution; }
+    Resolution GetOutputResolution() const override { return m_outputResolution; }
+    float GetLastExecuteTimeMs() const override { return 0.0f; }
+    uint64 GetExecuteCount() const override { return m_executeCount; }
+
+private:
+    Resolution m_outputResolution;
+    Resolution m_inputResolution;
+    uint64 m_executeCount{0};
+};
+
+} // namespace XeSS::XeSSModule
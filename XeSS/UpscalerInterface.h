@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Core/Types.h"
+#include "Core/NonCopyable.h"
+
+namespace XeSS::XeSSModule {
+
+// The upscaler as the frame loop and telemetry see it: render and output
+// resolutions and execution timing. D3D-free like Graphics::IDevice;
+// XeSSContext is the XeSS SDK implementation.
+class IUpscaler : public NonCopyable {
+public:
+    virtual ~IUpscaler() = default;
+
+    virtual Resolution GetInputResolution() const = 0;
+    virtual Resolution GetOutputResolution() const = 0;
+
+    // CPU time spent recording the last upscale, and how many ran
+    virtual float GetLastExecuteTimeMs() const = 0;
+    virtual uint64 GetExecuteCount() const = 0;
+};
+
+} // namespace XeSS::XeSSModule
@@ -2,6 +2,7 @@
 #include "Core/Logger.h"
 #include "Core/Exception.h"
 #include <sstream>
+#include <chrono>
 
 namespace XeSS::XeSSModule {
 
@@ -163,7 +164,12 @@ void XeSSContext::Execute(Graphics::Device& device, const ExecuteParams& params)
     execParams.pResponsivePixelMaskTexture = params.responsiveMaskTexture;
     execParams.pOutputTexture = params.outputTexture;
 
+    auto executeStart = std::chrono::steady_clock::now();
     xess_result_t result = xessD3D11Execute(m_context, &execParams);
+    m_lastExecuteTimeMs = std::chrono::duration<float, std::milli>(
+        std::chrono::steady_clock::now() - executeStart).count();
+    ++m_executeCount;
+
     ThrowIfXeSSFailed(result, "Failed to execute XeSS");
 }
 
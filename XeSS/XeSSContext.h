@@ -1,13 +1,13 @@
 #pragma once
 
 #include "XeSSTypes.h"
-#include "Core/NonCopyable.h"
+#include "UpscalerInterface.h"
 #include "Graphics/Device.h"
 #include "xess/xess_d3d11.h"
 
 namespace XeSS::XeSSModule {
 
-class XeSSContext : public NonCopyable {
+class XeSSContext : public IUpscaler {
 public:
     XeSSContext();
     ~XeSSContext();
@@ -21,11 +21,15 @@ public:
     void Execute(Graphics::Device& device, const ExecuteParams& params);
 
     // Properties
-    Resolution GetInputResolution() const { return m_inputResolution; }
-    Resolution GetOutputResolution() const { return m_outputResolution; }
+    Resolution GetInputResolution() const override { return m_inputResolution; }
+    Resolution GetOutputResolution() const override { return m_outputResolution; }
     QualityMode GetQuality() const { return m_quality; }
     InitFlags GetInitFlags() const { return m_initFlags; }
 
+    // CPU time spent recording the last Execute (GPU time needs a GpuTimer)
+    float GetLastExecuteTimeMs() const override { return m_lastExecuteTimeMs; }
+    uint64 GetExecuteCount() const override { return m_executeCount; }
+
     // Utility
     bool IsInitialized() const { return m_initialized; }
     bool IsOptimalDriver() const;
@@ -47,6 +51,9 @@ private:
     QualityMode m_quality{QualityMode::Performance};
     InitFlags m_initFlags{InitFlags::HighResMotionVectors};
 
+    float m_lastExecuteTimeMs{0.0f};
+    uint64 m_executeCount{0};
+
     bool m_initialized{false};
 };
 